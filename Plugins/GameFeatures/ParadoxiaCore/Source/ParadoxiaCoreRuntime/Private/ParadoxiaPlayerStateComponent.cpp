@@ -7,6 +7,7 @@
 
 #include "OWSTravelToMapActor.h"
 #include "OWSAPISubsystem.h"
+#include "OWSTransportSubsystem.h"
 #include "OWS2API.h"
 
 #include "Net/UnrealNetwork.h"
@@ -157,9 +158,9 @@ void UParadoxiaPlayerStateComponent::LoginAndCreateSessionServer(FString Email,
 	
 	FLoginAndCreateSessionJSONPost LoginAndCreateSessionJSONPost(Email, Password);
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(LoginAndCreateSessionJSONPost, PostParameters))
+	if (OWSEndpoints::LoginAndCreateSession.SerializeRequest(LoginAndCreateSessionJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/LoginAndCreateSession", PostParameters, &UParadoxiaPlayerStateComponent::OnLoginAndCreateSessionResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::LoginAndCreateSession, PostParameters, &UParadoxiaPlayerStateComponent::OnLoginAndCreateSessionResponseReceived);
 	}
 	else
 	{
@@ -288,45 +289,17 @@ void UParadoxiaPlayerStateComponent::TravelToMap2(const FString& ServerAndPort,
 	PlayerController->ClientTravel(URL, TRAVEL_Absolute, false, FGuid());
 }
 
-/*
-Valid values for ApiModuleToCall:
-	PublicAPI
-	InstanceManagementAPI
-	CharacterPersistanceAPI
-*/
-void UParadoxiaPlayerStateComponent::ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UParadoxiaPlayerStateComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+void UParadoxiaPlayerStateComponent::ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UParadoxiaPlayerStateComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
 {
-	Http = &FHttpModule::Get();
-	Http->SetHttpTimeout(TravelTimeout); //Set timeout
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, InMethodPtr);
-
-	FString OWS2APIPathToUse = "";
-
-	if (ApiModuleToCall == "PublicAPI")
-	{
-		OWS2APIPathToUse = OWS2APIPath;
-	}
-	else if (ApiModuleToCall == "InstanceManagementAPI")
-	{
-		OWS2APIPathToUse = OWS2InstanceManagementAPIPath;
-	}
-	else if (ApiModuleToCall == "CharacterPersistenceAPI")
-	{
-		OWS2APIPathToUse = OWS2CharacterPersistenceAPIPath;
-	}
-	else //When an ApiModuleToCall is not specified, use the PublicAPI
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	if (!GameInstance)
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		UE_LOG(LogPersistence, Error, TEXT("UParadoxiaPlayerStateComponent::ProcessOWS2POSTRequest - No Game Instance Found!"));
+		return;
 	}
 
-	Request->SetURL(FString(OWS2APIPathToUse + ApiToCall));
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/json"));
-	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
+	GameInstance->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, TravelTimeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, InMethodPtr));
 }
 
 //SetSelectedCharacterAndConnectToLastZone - Set character name and get user session
@@ -339,9 +312,9 @@ void UParadoxiaPlayerStateComponent::SetSelectedCharacterAndConnectToLastZone(FS
 	SetSelectedCharacterAndConnectToLastZoneJSONPost.UserSessionGUID = UserSessionGUID;
 	SetSelectedCharacterAndConnectToLastZoneJSONPost.SelectedCharacterName = SelectedCharacterName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(SetSelectedCharacterAndConnectToLastZoneJSONPost, PostParameters))
+	if (OWSEndpoints::SetSelectedCharacterAndGetUserSession.SerializeRequest(SetSelectedCharacterAndConnectToLastZoneJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/SetSelectedCharacterAndGetUserSession", PostParameters, &UParadoxiaPlayerStateComponent::OnSetSelectedCharacterAndConnectToLastZoneResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::SetSelectedCharacterAndGetUserSession, PostParameters, &UParadoxiaPlayerStateComponent::OnSetSelectedCharacterAndConnectToLastZoneResponseReceived);
 	}
 	else
 	{
@@ -399,9 +372,9 @@ void UParadoxiaPlayerStateComponent::TravelToLastZoneServer(FString CharacterNam
 	TravelToLastZoneServerJSONPost.ZoneName = "GETLASTZONENAME";
 	TravelToLastZoneServerJSONPost.PlayerGroupType = 0;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(TravelToLastZoneServerJSONPost, PostParameters))
+	if (OWSEndpoints::GetServerToConnectTo.SerializeRequest(TravelToLastZoneServerJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UParadoxiaPlayerStateComponent::OnTravelToLastZoneServerResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetServerToConnectTo, PostParameters, &UParadoxiaPlayerStateComponent::OnTravelToLastZoneServerResponseReceived);
 	}
 	else
 	{
@@ -480,9 +453,9 @@ void UParadoxiaPlayerStateComponent::GetZoneServerToTravelTo(FString CharacterNa
 	TravelToLastZoneServerJSONPost.ZoneName = ZoneName;
 	TravelToLastZoneServerJSONPost.PlayerGroupType = 0;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(TravelToLastZoneServerJSONPost, PostParameters))
+	if (OWSEndpoints::GetServerToConnectTo.SerializeRequest(TravelToLastZoneServerJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UParadoxiaPlayerStateComponent::OnGetZoneServerToTravelToResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetServerToConnectTo, PostParameters, &UParadoxiaPlayerStateComponent::OnGetZoneServerToTravelToResponseReceived);
 	}
 	else
 	{
@@ -552,9 +525,9 @@ void UParadoxiaPlayerStateComponent::GetAllCharacters(FString UserSessionGUID)
 	FGetAllCharactersJSONPost GetAllCharactersJSONPost;
 	GetAllCharactersJSONPost.UserSessionGUID = UserSessionGUID;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetAllCharactersJSONPost, PostParameters))
+	if (OWSEndpoints::GetAllCharacters.SerializeRequest(GetAllCharactersJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetAllCharacters", PostParameters, &UParadoxiaPlayerStateComponent::OnGetAllCharactersResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetAllCharacters, PostParameters, &UParadoxiaPlayerStateComponent::OnGetAllCharactersResponseReceived);
 	}
 	else
 	{
@@ -589,9 +562,9 @@ void UParadoxiaPlayerStateComponent::GetCharacterStats(FString CharName)
 	FGetCharacterStatsJSONPost GetCharacterStatsJSONPost;
 	GetCharacterStatsJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCharacterStatsJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterStats.SerializeRequest(GetCharacterStatsJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/GetByName", PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterStatsResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetCharacterStats, PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterStatsResponseReceived);
 	}
 	else
 	{
@@ -625,9 +598,9 @@ void UParadoxiaPlayerStateComponent::GetCharacterDataAndCustomData(FString UserS
 	GetCharacterDataAndCustomDataJSONPost.UserSessionGUID = UserSessionGUID;
 	GetCharacterDataAndCustomDataJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCharacterDataAndCustomDataJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterDataAndCustomData.SerializeRequest(GetCharacterDataAndCustomDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("OWSPublicAPI", "api/Characters/ByName", PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterDataAndCustomDataResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetCharacterDataAndCustomData, PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterDataAndCustomDataResponseReceived);
 	}
 	else
 	{
@@ -657,7 +630,7 @@ void UParadoxiaPlayerStateComponent::OnGetCharacterDataAndCustomDataResponseRece
 //Update Character Stats
 void UParadoxiaPlayerStateComponent::UpdateCharacterStats(FString JSONString)
 {
-	ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/UpdateCharacterStats", JSONString, &UParadoxiaPlayerStateComponent::OnUpdateCharacterStatsResponseReceived);
+	ProcessOWS2POSTRequest(OWSEndpoints::UpdateCharacterStats, JSONString, &UParadoxiaPlayerStateComponent::OnUpdateCharacterStatsResponseReceived);
 }
 
 void UParadoxiaPlayerStateComponent::OnUpdateCharacterStatsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -688,9 +661,9 @@ void UParadoxiaPlayerStateComponent::GetCustomCharacterData(FString CharName)
 	FGetCustomCharacterDataJSONPost GetCustomCharacterDataJSONPost;
 	GetCustomCharacterDataJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCustomCharacterDataJSONPost, PostParameters))
+	if (OWSEndpoints::GetCustomCharacterData.SerializeRequest(GetCustomCharacterDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/GetCustomData", PostParameters, &UParadoxiaPlayerStateComponent::OnGetCustomCharacterDataResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetCustomCharacterData, PostParameters, &UParadoxiaPlayerStateComponent::OnGetCustomCharacterDataResponseReceived);
 	}
 	else
 	{
@@ -725,9 +698,9 @@ void UParadoxiaPlayerStateComponent::AddOrUpdateCustomCharacterData(FString Char
 	AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.CustomFieldName = CustomFieldName;
 	AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.FieldValue = CustomValue;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(AddOrUpdateCustomCharacterDataJSONPost, PostParameters))
+	if (OWSEndpoints::AddOrUpdateCustomCharacterData.SerializeRequest(AddOrUpdateCustomCharacterDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/AddOrUpdateCustomData", PostParameters, &UParadoxiaPlayerStateComponent::OnAddOrUpdateCustomCharacterDataResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddOrUpdateCustomCharacterData, PostParameters, &UParadoxiaPlayerStateComponent::OnAddOrUpdateCustomCharacterDataResponseReceived);
 	}
 	else
 	{
@@ -850,9 +823,9 @@ void UParadoxiaPlayerStateComponent::AddAbilityToCharacter(FString CharName, FSt
 	AddAbilityToCharacterJSONPost.AbilityLevel = AbilityLevel;
 	AddAbilityToCharacterJSONPost.CharHasAbilitiesCustomJSON = CustomJSON;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(AddAbilityToCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::AddAbilityToCharacter.SerializeRequest(AddAbilityToCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/AddAbilityToCharacter", PostParameters, &UParadoxiaPlayerStateComponent::OnAddAbilityToCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddAbilityToCharacter, PostParameters, &UParadoxiaPlayerStateComponent::OnAddAbilityToCharacterResponseReceived);
 	}
 	else
 	{
@@ -879,9 +852,9 @@ void UParadoxiaPlayerStateComponent::GetCharacterAbilities(FString CharName)
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterAbilities.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/GetCharacterAbilities", PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterAbilitiesResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetCharacterAbilities, PostParameters, &UParadoxiaPlayerStateComponent::OnGetCharacterAbilitiesResponseReceived);
 	}
 	else
 	{
@@ -923,9 +896,9 @@ void UParadoxiaPlayerStateComponent::GetAbilityBars(FString CharName)
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (OWSEndpoints::GetAbilityBars.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/GetAbilityBars", PostParameters, &UParadoxiaPlayerStateComponent::OnGetAbilityBarsResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetAbilityBars, PostParameters, &UParadoxiaPlayerStateComponent::OnGetAbilityBarsResponseReceived);
 	}
 	else
 	{
@@ -970,9 +943,9 @@ void UParadoxiaPlayerStateComponent::UpdateAbilityOnCharacter(FString CharName,
 	UpdateAbilityOnCharacterJSONPost.AbilityLevel = AbilityLevel;
 	UpdateAbilityOnCharacterJSONPost.CharHasAbilitiesCustomJSON = CustomJSON;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(UpdateAbilityOnCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::UpdateAbilityOnCharacter.SerializeRequest(UpdateAbilityOnCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/UpdateAbilityOnCharacter", PostParameters, &UParadoxiaPlayerStateComponent::OnUpdateAbilityOnCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::UpdateAbilityOnCharacter, PostParameters, &UParadoxiaPlayerStateComponent::OnUpdateAbilityOnCharacterResponseReceived);
 	}
 	else
 	{
@@ -1000,9 +973,9 @@ void UParadoxiaPlayerStateComponent::RemoveAbilityFromCharacter(FString CharName
 	RemoveAbilityFromCharacterJSONPost.CharacterName = CharName;
 	RemoveAbilityFromCharacterJSONPost.AbilityName = AbilityName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(RemoveAbilityFromCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::RemoveAbilityFromCharacter.SerializeRequest(RemoveAbilityFromCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/RemoveAbilityFromCharacter", PostParameters, &UParadoxiaPlayerStateComponent::OnRemoveAbilityFromCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::RemoveAbilityFromCharacter, PostParameters, &UParadoxiaPlayerStateComponent::OnRemoveAbilityFromCharacterResponseReceived);
 	}
 	else
 	{
@@ -1035,9 +1008,9 @@ void UParadoxiaPlayerStateComponent::PlayerLogout(FString CharName)
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (OWSEndpoints::PlayerLogout.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/PlayerLogout", PostParameters, &UParadoxiaPlayerStateComponent::OnPlayerLogoutResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::PlayerLogout, PostParameters, &UParadoxiaPlayerStateComponent::OnPlayerLogoutResponseReceived);
 	}
 	else
 	{
@@ -1078,9 +1051,9 @@ void UParadoxiaPlayerStateComponent::CreateCharacter(FString UserSessionGUID, FS
 	CreateCharacterJSONPost.CharacterName = CharacterName;
 	CreateCharacterJSONPost.ClassName = ClassName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CreateCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::CreateCharacter.SerializeRequest(CreateCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/CreateCharacter", PostParameters, &UParadoxiaPlayerStateComponent::OnCreateCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::CreateCharacter, PostParameters, &UParadoxiaPlayerStateComponent::OnCreateCharacterResponseReceived);
 	}
 	else
 	{
@@ -1139,9 +1112,9 @@ void UParadoxiaPlayerStateComponent::RemoveCharacter(FString UserSessionGUID, FS
 	RemoveCharacterJSONPost.UserSessionGUID = UserSessionGUID;
 	RemoveCharacterJSONPost.CharacterName = CharacterName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(RemoveCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::RemoveCharacter.SerializeRequest(RemoveCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/RemoveCharacter", PostParameters, &UParadoxiaPlayerStateComponent::OnRemoveCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::RemoveCharacter, PostParameters, &UParadoxiaPlayerStateComponent::OnRemoveCharacterResponseReceived);
 	}
 	else
 	{
@@ -1185,9 +1158,9 @@ void UParadoxiaPlayerStateComponent::GetPlayerGroupsCharacterIsIn(FString UserSe
 	GetPlayerGroupsCharacterIsInJSONPost.CharacterName = CharacterName;
 	GetPlayerGroupsCharacterIsInJSONPost.PlayerGroupTypeID = PlayerGroupTypeID;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetPlayerGroupsCharacterIsInJSONPost, PostParameters))
+	if (OWSEndpoints::GetPlayerGroupsCharacterIsIn.SerializeRequest(GetPlayerGroupsCharacterIsInJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetPlayerGroupsCharacterIsIn", PostParameters, &UParadoxiaPlayerStateComponent::OnGetPlayerGroupsCharacterIsInResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetPlayerGroupsCharacterIsIn, PostParameters, &UParadoxiaPlayerStateComponent::OnGetPlayerGroupsCharacterIsInResponseReceived);
 	}
 	else
 	{
@@ -1255,14 +1228,15 @@ void UParadoxiaPlayerStateComponent::OnGetPlayerGroupsCharacterIsInResponseRecei
 //LaunchZoneInstance
 void UParadoxiaPlayerStateComponent::LaunchZoneInstance(FString CharacterName, FString ZoneName, ERPGPlayerGroupType::PlayerGroupType GroupType)
 {
-	FLaunchZoneInstance LaunchZoneInstance;
+	//GetServerToConnectTo takes the same body as TravelToLastZoneServer, FLaunchZoneInstance sent PlayerGroupTypeID instead of PlayerGroupType
+	FTravelToLastZoneServerJSONPost LaunchZoneInstance;
 	LaunchZoneInstance.CharacterName = CharacterName;
 	LaunchZoneInstance.ZoneName = ZoneName;
-	LaunchZoneInstance.PlayerGroupTypeID = GroupType;
+	LaunchZoneInstance.PlayerGroupType = GroupType;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(LaunchZoneInstance, PostParameters))
+	if (OWSEndpoints::GetServerToConnectTo.SerializeRequest(LaunchZoneInstance, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UParadoxiaPlayerStateComponent::OnLaunchZoneInstanceResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetServerToConnectTo, PostParameters, &UParadoxiaPlayerStateComponent::OnLaunchZoneInstanceResponseReceived);
 	}
 	else
 	{
@@ -9,6 +9,7 @@
 #include "templates/SharedPointer.h"
 
 #include "OWSCharacter.h"
+#include "OWSEndpoints.h"
 #include "ParadoxiaPlayerStateComponent.generated.h"
 
 
@@ -122,7 +123,6 @@ class PARADOXIACORERUNTIME_API UParadoxiaPlayerStateComponent : public UActorCom
 {
 	GENERATED_BODY()
 
-	FHttpModule* Http;
 public:
 	// Sets default values for this component's properties
 	UParadoxiaPlayerStateComponent();
@@ -381,7 +381,7 @@ protected:
 	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category= "Login")
 	void ServerConnectToPersistence(const FString& UserSessionGUID, const FString& SelectedCharacter);
 
-	void ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UParadoxiaPlayerStateComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
+	void ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UParadoxiaPlayerStateComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
 	void GetPlayerNameAndCharacter(ACharacter* Character, FString& PlayerName);
 	void GetJsonObjectFromResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CallingMethodName, FString& ErrorMsg, TSharedPtr<FJsonObject>& JsonObject);
 
@@ -36,7 +36,8 @@ public class OWSPlugin : ModuleRules
                 "GameplayTags",
                 "GameplayTasks",
                 "ReplicationGraph",
-                "AIModule"
+                "AIModule",
+                "NetCore"
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -1,11 +1,16 @@
 // Copyright 2022 Sabre Dart Studios
 
 #include "OWSAPISubsystem.h"
+#include "OWSTransportSubsystem.h"
+#include "OWSResponseCache.h"
 #include "Runtime/Engine/Classes/Kismet/GameplayStatics.h"
 #include "JsonObjectConverter.h"
 
 void UOWSAPISubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	Collection.InitializeDependency<UOWSTransportSubsystem>();
+	Collection.InitializeDependency<UOWSResponseCache>();
+
 	GConfig->GetString(
 		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
 		TEXT("OWSAPICustomerKey"),
@@ -73,99 +78,63 @@ void UOWSAPISubsystem::GetJsonObjectFromResponse(FHttpRequestPtr Request, FHttpR
 	}
 }
 
-void UOWSAPISubsystem::ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+void UOWSAPISubsystem::ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
 {
-	Http = &FHttpModule::Get();
-	Http->SetHttpTimeout(OWS2APIRequestTimeout); //Set timeout
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, InMethodPtr);
+	GetGameInstance()->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, OWS2APIRequestTimeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, InMethodPtr));
+}
 
-	FString OWS2APIPathToUse = "";
 
-	if (ApiModuleToCall == "PublicAPI")
-	{
-		OWS2APIPathToUse = OWS2APIPath;
-	}
-	else if (ApiModuleToCall == "InstanceManagementAPI")
-	{
-		OWS2APIPathToUse = OWS2InstanceManagementAPIPath;
-	}
-	else if (ApiModuleToCall == "CharacterPersistenceAPI")
-	{
-		OWS2APIPathToUse = OWS2CharacterPersistenceAPIPath;
-	}
-	else if (ApiModuleToCall == "GlobalDataAPI")
-	{
-		OWS2APIPathToUse = OWS2GlobalDataAPIPath;
-	}
-	else //When an ApiModuleToCall is not specified, use the PublicAPI
+//Get Global Data Item
+void UOWSAPISubsystem::GetGlobalDataItem(FString GlobalDataKey)
+{
+	GlobalDataKey.TrimStartAndEndInline();
+
+	UOWSResponseCache* ResponseCache = GetGameInstance()->GetSubsystem<UOWSResponseCache>();
+	FString CachedResponse;
+	if (ResponseCache && ResponseCache->TryGet(EOWSCachedLookup::GlobalDataItem, GlobalDataKey, CachedResponse))
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		HandleGetGlobalDataItemResponse(CachedResponse);
+		return;
 	}
 
-	Request->SetURL(FString(OWS2APIPathToUse + ApiToCall));
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/json"));
-	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
+	const uint32 FetchGeneration = ResponseCache ? ResponseCache->GetGeneration(EOWSCachedLookup::GlobalDataItem) : 0;
+	GetGameInstance()->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2RequestWithPathParameter(OWSEndpoints::GetGlobalDataItem, GlobalDataKey, FString(), OWS2APIRequestTimeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSAPISubsystem::OnGetGlobalDataItemCacheableResponseReceived, GlobalDataKey, FetchGeneration));
 }
 
-void UOWSAPISubsystem::ProcessOWS2GETRequest(FString ApiModuleToCall, FString ApiToCall, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+void UOWSAPISubsystem::OnGetGlobalDataItemCacheableResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString GlobalDataKey, uint32 FetchGeneration)
 {
-	Http = &FHttpModule::Get();
-	Http->SetHttpTimeout(OWS2APIRequestTimeout); //Set timeout
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, InMethodPtr);
-
-	FString OWS2APIPathToUse = "";
-
-	if (ApiModuleToCall == "PublicAPI")
-	{
-		OWS2APIPathToUse = OWS2APIPath;
-	}
-	else if (ApiModuleToCall == "InstanceManagementAPI")
-	{
-		OWS2APIPathToUse = OWS2InstanceManagementAPIPath;
-	}
-	else if (ApiModuleToCall == "CharacterPersistenceAPI")
-	{
-		OWS2APIPathToUse = OWS2CharacterPersistenceAPIPath;
-	}
-	else if (ApiModuleToCall == "GlobalDataAPI")
-	{
-		OWS2APIPathToUse = OWS2GlobalDataAPIPath;
-	}
-	else //When an ApiModuleToCall is not specified, use the PublicAPI
+	UOWSResponseCache* ResponseCache = GetGameInstance()->GetSubsystem<UOWSResponseCache>();
+	if (ResponseCache && bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		ResponseCache->Put(EOWSCachedLookup::GlobalDataItem, GlobalDataKey, Response->GetContentAsString(), FetchGeneration);
 	}
 
-	Request->SetURL(FString(OWS2APIPathToUse + ApiToCall));
-	Request->SetVerb("GET");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/json"));
-	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
-	Request->ProcessRequest();
+	OnGetGlobalDataItemResponseReceived(Request, Response, bWasSuccessful);
 }
 
-
-//Get Global Data Item
-void UOWSAPISubsystem::GetGlobalDataItem(FString GlobalDataKey)
+void UOWSAPISubsystem::OnGetGlobalDataItemResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
-	FString Url = "api/GlobalData/GetGlobalDataItem/" + GlobalDataKey.TrimStartAndEnd();
-	ProcessOWS2GETRequest("GlobalDataAPI", Url, &UOWSAPISubsystem::OnGetGlobalDataItemResponseReceived);
+	if (!bWasSuccessful || !Response.IsValid())
+	{
+		UE_LOG(OWS, Error, TEXT("OnGetGlobalDataItemResponseReceived - Response was unsuccessful or invalid!"));
+		OnErrorGetGlobalDataItemDelegate.ExecuteIfBound(TEXT("OnGetGlobalDataItemResponseReceived - Response was unsuccessful or invalid!"));
+		return;
+	}
+
+	HandleGetGlobalDataItemResponse(Response->GetContentAsString());
 }
 
-void UOWSAPISubsystem::OnGetGlobalDataItemResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UOWSAPISubsystem::HandleGetGlobalDataItemResponse(const FString& ResponseContent)
 {
-	FString ErrorMsg;
 	TSharedPtr<FJsonObject> JsonObject;
-	GetJsonObjectFromResponse(Request, Response, bWasSuccessful, "OnGetGlobalDataItemResponseReceived", ErrorMsg, JsonObject);
-	if (!ErrorMsg.IsEmpty())
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
+
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject))
 	{
-		OnErrorGetGlobalDataItemDelegate.ExecuteIfBound(ErrorMsg);
+		UE_LOG(OWS, Error, TEXT("OnGetGlobalDataItemResponseReceived - Error Deserializing JsonObject!"));
+		OnErrorGetGlobalDataItemDelegate.ExecuteIfBound(TEXT("OnGetGlobalDataItemResponseReceived - Error Deserializing JsonObject!"));
 		return;
 	}
 
@@ -178,13 +147,18 @@ void UOWSAPISubsystem::OnGetGlobalDataItemResponseReceived(FHttpRequestPtr Reque
 //Add or Update Global Data
 void UOWSAPISubsystem::AddOrUpdateGlobalDataItem(FString GlobalDataKey, FString GlobalDataValue)
 {
+	if (UOWSResponseCache* ResponseCache = GetGameInstance()->GetSubsystem<UOWSResponseCache>())
+	{
+		ResponseCache->Invalidate(EOWSCachedLookup::GlobalDataItem, GlobalDataKey.TrimStartAndEnd());
+	}
+
 	FGlobalDataItem GlobalDataItem;
 	GlobalDataItem.GlobalDataKey = GlobalDataKey;
 	GlobalDataItem.GlobalDataValue = GlobalDataValue;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GlobalDataItem, PostParameters))
+	if (OWSEndpoints::AddOrUpdateGlobalDataItem.SerializeRequest(GlobalDataItem, PostParameters))
 	{
-		ProcessOWS2POSTRequest("GlobalDataAPI", "api/GlobalData/AddOrUpdateGlobalDataItem", PostParameters, &UOWSAPISubsystem::OnAddOrUpdateGlobalDataItemResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddOrUpdateGlobalDataItem, PostParameters, &UOWSAPISubsystem::OnAddOrUpdateGlobalDataItemResponseReceived);
 	}
 	else
 	{
@@ -223,9 +197,9 @@ void UOWSAPISubsystem::CreateCharacterUsingDefaultCharacterValues(FString UserSe
 	CreateCharacterUsingDefaultCharacterValues.CharacterName = CharacterName;
 	CreateCharacterUsingDefaultCharacterValues.DefaultSetName = DefaultSetName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CreateCharacterUsingDefaultCharacterValues, PostParameters))
+	if (OWSEndpoints::CreateCharacterUsingDefaultCharacterValues.SerializeRequest(CreateCharacterUsingDefaultCharacterValues, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/CreateCharacterUsingDefaultCharacterValues", PostParameters, 
+		ProcessOWS2POSTRequest(OWSEndpoints::CreateCharacterUsingDefaultCharacterValues, PostParameters, 
 			&UOWSAPISubsystem::OnCreateCharacterUsingDefaultCharacterValuesResponseReceived);
 	}
 	else
@@ -262,9 +236,9 @@ void UOWSAPISubsystem::Logout(FString UserSessionGUID)
 	FLogout Logout;
 	Logout.UserSessionGUID = UserSessionGUID;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(Logout, PostParameters))
+	if (OWSEndpoints::Logout.SerializeRequest(Logout, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/Logout", PostParameters,
+		ProcessOWS2POSTRequest(OWSEndpoints::Logout, PostParameters,
 			&UOWSAPISubsystem::OnLogoutResponseReceived);
 	}
 	else
@@ -8,6 +8,9 @@
 #include "AbilitySystemComponent.h"
 #include "Runtime/Core/Public/Math/TransformNonVectorized.h"
 #include "OWSPlayerController.h"
+#include "OWSProjectilePool.h"
+#include "OWSBatchedProjectileManager.h"
+#include "OWSGameplayAbility.h"
 
 
 
@@ -37,6 +40,44 @@ UOWSAbilityTask_SpawnProjectile* UOWSAbilityTask_SpawnProjectile::SpawnProjectil
 	return MyObj;
 }
 
+bool UOWSAbilityTask_SpawnProjectile::SpawnBatchedProjectile(UWorld* World)
+{
+	//Clients are told about the projectile by the server, there is no fake projectile to fire ahead of it
+	if (!Ability->GetCurrentActorInfo()->IsNetAuthority())
+	{
+		return false;
+	}
+
+	UOWSBatchedProjectileManager* ProjectileManager = World->GetSubsystem<UOWSBatchedProjectileManager>();
+	APawn* MyPawn = Cast<APawn>(Ability->GetCurrentActorInfo()->AvatarActor);
+
+	FTransform SpawnTransform;
+	GetAimTransform(SpawnTransform);
+
+	const int32 ProjectileID = ProjectileManager ? ProjectileManager->SpawnProjectile(ProjectileClass.Get(), SpawnTransform.GetLocation(), SpawnTransform.GetRotation().Rotator(), MyPawn,
+		geshDirectDamageEffect, geshAOEDamageEffect, tagActivateAbilityTagOnImpact) : INDEX_NONE;
+
+	if (ProjectileID == INDEX_NONE)
+	{
+		if (ShouldBroadcastAbilityTaskDelegates())
+		{
+			DidNotSpawn.Broadcast(nullptr);
+		}
+		return false;
+	}
+
+	UE_LOG(OWS, Verbose, TEXT("Server Spawned Batched Projectile %d"), ProjectileID);
+
+	//There is no actor to hand out
+	if (ShouldBroadcastAbilityTaskDelegates())
+	{
+		Success.Broadcast(nullptr);
+	}
+
+	EndTask();
+	return false;
+}
+
 // ---------------------------------------------------------------------------------------
 void UOWSAbilityTask_SpawnProjectile::Activate()
 {
@@ -50,6 +91,13 @@ bool UOWSAbilityTask_SpawnProjectile::BeginSpawningActor(UGameplayAbility* Ownin
 	if (OwningPlayer)
 	{
 		UWorld* const World = GEngine->GetWorldFromContextObject(OwningPlayer, EGetWorldErrorMode::LogAndReturnNull);
+
+		const UOWSGameplayAbility* OWSAbility = Cast<UOWSGameplayAbility>(Ability);
+		if (World && OWSAbility && OWSAbility->bSimulateProjectilesInBatch)
+		{
+			return SpawnBatchedProjectile(World);
+		}
+
 		if (World)
 		{
 			AOWSPlayerController* MyOwningPlayer = Cast<AOWSPlayerController>(Ability->GetCurrentActorInfo()->PlayerController);
@@ -94,15 +142,11 @@ bool UOWSAbilityTask_SpawnProjectile::BeginSpawningActor(UGameplayAbility* Ownin
 			if (Ability->GetCurrentActorInfo()->IsNetAuthority() || (CatchupTickDelta > 0.f))
 			{
 				APawn* MyPawn = Cast<APawn>(Ability->GetCurrentActorInfo()->AvatarActor);
-				FActorSpawnParameters Params;
-				Params.Instigator = MyPawn;
-				Params.Owner = MyPawn;
-				Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 				
 				FTransform SpawnTransform;
 				GetAimTransform(SpawnTransform);
 
-				AOWSAdvancedProjectile* NewProjectile = GetWorld()->SpawnActor<AOWSAdvancedProjectile>(ProjectileClass, SpawnTransform.GetLocation(), SpawnTransform.GetRotation().Rotator(), Params);
+				AOWSAdvancedProjectile* NewProjectile = UOWSProjectilePool::SpawnProjectile(GetWorld(), ProjectileClass.Get(), SpawnTransform.GetLocation(), SpawnTransform.GetRotation().Rotator(), MyPawn);
 				if (NewProjectile)
 				{
 					if (Ability->GetCurrentActorInfo()->IsNetAuthority())
@@ -289,11 +333,7 @@ void UOWSAbilityTask_SpawnProjectile::SpawnDelayedFakeProjectile()
 		float CatchupTickDelta = (OwningPlayer ? OwningPlayer->GetPredictionTime() : 0.f);
 
 		APawn* MyPawn = Cast<APawn>(Ability->GetCurrentActorInfo()->AvatarActor);
-		FActorSpawnParameters Params;
-		Params.Instigator = MyPawn;
-		Params.Owner = MyPawn;
-		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		AOWSAdvancedProjectile* NewProjectile = GetWorld()->SpawnActor<AOWSAdvancedProjectile>(DelayedProjectile.ProjectileClass, DelayedProjectile.SpawnLocation, DelayedProjectile.SpawnRotation, Params);
+		AOWSAdvancedProjectile* NewProjectile = UOWSProjectilePool::SpawnProjectile(GetWorld(), DelayedProjectile.ProjectileClass, DelayedProjectile.SpawnLocation, DelayedProjectile.SpawnRotation, MyPawn);
 		if (NewProjectile)
 		{	
 			NewProjectile->InitFakeProjectile(OwningPlayer);
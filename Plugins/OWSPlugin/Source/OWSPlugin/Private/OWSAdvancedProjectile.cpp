@@ -3,6 +3,8 @@
 #include "OWSAdvancedProjectile.h"
 #include "OWSPlugin.h"
 #include "OWSCharacterWithAbilities.h"
+#include "OWSProjectilePool.h"
+#include "OWSProjectileCatchup.h"
 #include "Net/UnrealNetwork.h"
 #include "Runtime/Engine/Classes/GameFramework/Volume.h"
 #include "Runtime/Engine/Classes/Components/MeshComponent.h"
@@ -74,6 +76,13 @@ AOWSAdvancedProjectile::AOWSAdvancedProjectile(const class FObjectInitializer& O
 	MasterProjectile = NULL;
 	bHasSpawnedFully = false;
 
+	bCanBePooled = true;
+	bPooled = false;
+	bInPool = false;
+	PoolGeneration = 0;
+	LocalPoolGeneration = 0;
+	bDeactivatedForPool = false;
+
 	NetPriority = 2.f;
 	MinNetUpdateFrequency = 100.0f;
 }
@@ -177,82 +186,117 @@ void AOWSAdvancedProjectile::BeginPlay()
 	}
 	else
 	{
+		LocalPoolGeneration = PoolGeneration;
+
+		//A pooled projectile that became relevant while it was waiting in the pool on the server
+		if (bInPool)
+		{
+			DeactivateForPool();
+			return;
+		}
+
 		AOWSPlayerController* MyPlayer = Cast<AOWSPlayerController>(InstigatorController ? InstigatorController : GEngine->GetFirstLocalPlayerController(GetWorld()));
 		if (MyPlayer)
 		{
 			UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth BeginPlay: %s"), *ServerOrClient, *GetName());
 
-			// Move projectile to match where it is on server now (to make up for replication time)
-			float CatchupTickDelta = MyPlayer->GetPredictionTime();
-			if (CatchupTickDelta > 0.f)
-			{
-				CatchupTick(CatchupTickDelta);
-			}
+			CatchupAndMatchFake(MyPlayer);
+		}
+	}
+}
 
-			// look for associated fake client projectile
-			AOWSAdvancedProjectile* BestMatch = NULL;
-			FVector VelDir = GetVelocity().GetSafeNormal();
-			int32 BestMatchIndex = 0;
-			float BestDist = 0.f;
+void AOWSAdvancedProjectile::CatchupAndMatchFake(AOWSPlayerController* MyPlayer)
+{
+	// Move projectile to match where it is on server now (to make up for replication time)
+	float CatchupTickDelta = MyPlayer->GetPredictionTime();
+	if (CatchupTickDelta > 0.f)
+	{
+		// Done together with the other projectiles received this frame, which also matches the fake afterwards
+		if (UOWSProjectileCatchup::RequestCatchup(GetWorld(), this, CatchupTickDelta, true))
+		{
+			return;
+		}
 
-			UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Start Searching Fakes"), *ServerOrClient);
+		CatchupTick(CatchupTickDelta);
+	}
 
-			for (int32 i = 0; i < MyPlayer->FakeProjectiles.Num(); i++)
-			{
-				UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Evaluating Fake #: %d"), *ServerOrClient, i);
+	MatchFake(MyPlayer);
+}
 
-				AOWSAdvancedProjectile* Fake = MyPlayer->FakeProjectiles[i];
-				if (!Fake || Fake->IsPendingKillPending())
-				{
-					UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Invalid Fake or Pending Kill"), *ServerOrClient);
+void AOWSAdvancedProjectile::MatchFake(AOWSPlayerController* MyPlayer)
+{
+	FString ServerOrClient;
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		ServerOrClient = "Server";
+	}
+	else
+	{
+		ServerOrClient = "Client";
+	}
 
-					MyPlayer->FakeProjectiles.RemoveAt(i, 1);
-					i--;
-				}
-				else if (Fake->GetClass() == GetClass())
-				{
-					UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Our Fake Class Matches"), *ServerOrClient);
+	// look for associated fake client projectile
+	AOWSAdvancedProjectile* BestMatch = NULL;
+	FVector VelDir = GetVelocity().GetSafeNormal();
+	int32 BestMatchIndex = 0;
+	float BestDist = 0.f;
+
+	UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Start Searching Fakes"), *ServerOrClient);
+
+	for (int32 i = 0; i < MyPlayer->FakeProjectiles.Num(); i++)
+	{
+		UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Evaluating Fake #: %d"), *ServerOrClient, i);
+
+		AOWSAdvancedProjectile* Fake = MyPlayer->FakeProjectiles[i];
+		if (!Fake || Fake->IsPendingKillPending() || Fake->IsInPool())
+		{
+			UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Invalid Fake, Pending Kill or back in its Pool"), *ServerOrClient);
 
-					// must share direction unless falling! 
-					if (CanMatchFake(Fake, VelDir))
+			MyPlayer->FakeProjectiles.RemoveAt(i, 1);
+			i--;
+		}
+		else if (Fake->GetClass() == GetClass())
+		{
+			UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Our Fake Class Matches"), *ServerOrClient);
+
+			// must share direction unless falling! 
+			if (CanMatchFake(Fake, VelDir))
+			{
+				if (BestMatch)
+				{
+					// see if new one is better
+					float NewDist = (Fake->GetActorLocation() - GetActorLocation()).SizeSquared();
+					if (BestDist > NewDist)
 					{
-						if (BestMatch)
-						{
-							// see if new one is better
-							float NewDist = (Fake->GetActorLocation() - GetActorLocation()).SizeSquared();
-							if (BestDist > NewDist)
-							{
-								BestMatch = Fake;
-								BestMatchIndex = i;
-								BestDist = NewDist;
-
-								UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth Found a better Match"), *ServerOrClient);
-							}
-						}
-						else
-						{
-							BestMatch = Fake;
-							BestMatchIndex = i;
-							BestDist = (BestMatch->GetActorLocation() - GetActorLocation()).SizeSquared();
+						BestMatch = Fake;
+						BestMatchIndex = i;
+						BestDist = NewDist;
 
-							UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth Found a Match"), *ServerOrClient);
-						}
+						UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth Found a better Match"), *ServerOrClient);
 					}
 				}
-			}
-			if (BestMatch)
-			{
-				UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth calling BeginFakeProjectileSynch"), *ServerOrClient);
+				else
+				{
+					BestMatch = Fake;
+					BestMatchIndex = i;
+					BestDist = (BestMatch->GetActorLocation() - GetActorLocation()).SizeSquared();
 
-				MyPlayer->FakeProjectiles.RemoveAt(BestMatchIndex, 1);
-				BeginFakeProjectileSynch(BestMatch);
-			}
-			else
-			{
-				UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth WE DID NOT FIND A FAKE!"), *ServerOrClient);
+					UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth Found a Match"), *ServerOrClient);
+				}
 			}
 		}
 	}
+	if (BestMatch)
+	{
+		UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth calling BeginFakeProjectileSynch"), *ServerOrClient);
+
+		MyPlayer->FakeProjectiles.RemoveAt(BestMatchIndex, 1);
+		BeginFakeProjectileSynch(BestMatch);
+	}
+	else
+	{
+		UE_LOG(OWS, Verbose, TEXT("%s: BeginPlay: Projectile Not Auth WE DID NOT FIND A FAKE!"), *ServerOrClient);
+	}
 }
 
 bool AOWSAdvancedProjectile::CanMatchFake(AOWSAdvancedProjectile* InFakeProjectile, const FVector& VelDir) const
@@ -260,6 +304,21 @@ bool AOWSAdvancedProjectile::CanMatchFake(AOWSAdvancedProjectile* InFakeProjecti
 	return (ProjectileMovement->ProjectileGravityScale > 0.f) || ((InFakeProjectile->GetVelocity().GetSafeNormal() | VelDir) > 0.95f);
 }
 
+void AOWSAdvancedProjectile::FinishCatchup(bool bMatchFake, bool bOnScreen)
+{
+	if (bMatchFake)
+	{
+		AOWSPlayerController* MyPlayer = Cast<AOWSPlayerController>(InstigatorController ? InstigatorController : GEngine->GetFirstLocalPlayerController(GetWorld()));
+		if (MyPlayer)
+		{
+			MatchFake(MyPlayer);
+		}
+		return;
+	}
+
+	SyncFakeOrTickParticles(bOnScreen);
+}
+
 void AOWSAdvancedProjectile::CatchupTick(float CatchupTickDelta)
 {
 	FString ServerOrClient;
@@ -303,7 +362,7 @@ void AOWSAdvancedProjectile::InitFakeProjectile(AOWSPlayerController* OwningPlay
 
 		UE_LOG(OWS, Verbose, TEXT("%s: InitFakeProjectile: Add to Fakes List"), *ServerOrClient);
 
-		OwningPlayer->FakeProjectiles.Add(this);
+		OwningPlayer->FakeProjectiles.AddUnique(this);
 	}
 }
 
@@ -379,7 +438,7 @@ void AOWSAdvancedProjectile::BeginFakeProjectileSynch(AOWSAdvancedProjectile* In
 		SetLifeSpan(FMath::Max(0.001f, GetLifeSpan() - CatchupTickDelta));
 	}
 	MyFakeProjectile->SetLifeSpan(GetLifeSpan());
-	if (bNetTemporary)
+	if (bNetTemporary || bPooled)
 	{
 		UE_LOG(OWS, Verbose, TEXT("%s: BeginFakeProjectileSynch: bNetTemporary Destroy: %s"), *ServerOrClient, *GetNameSafe(this));
 
@@ -450,7 +509,7 @@ void AOWSAdvancedProjectile::GatherCurrentMovement()
 
 void AOWSAdvancedProjectile::OnRep_UTProjReplicatedMovement()
 {
-	if (GetLocalRole() == ROLE_SimulatedProxy)
+	if (GetLocalRole() == ROLE_SimulatedProxy && !bInPool)
 	{
 		//ReplicatedAccel = UTReplicatedMovement.Acceleration;
 		FRepMovement tempRepMovement;
@@ -515,6 +574,14 @@ void AOWSAdvancedProjectile::PostNetReceiveLocationAndRotation()
 			float CatchupTickDelta = MyPlayer->GetPredictionTime();
 			if ((CatchupTickDelta > 0.f) && ProjectileMovement)
 			{
+				// The fake and particles are taken care of once the catch-up has run
+				if (UOWSProjectileCatchup::RequestCatchup(GetWorld(), this, CatchupTickDelta, false))
+				{
+					UE_LOG(OWS, Verbose, TEXT("%s PostNetReceiveLocationAndRotation: Queued Catchup: %s"), *ServerOrClient, *GetNameSafe(this));
+
+					return;
+				}
+
 				UE_LOG(OWS, Verbose, TEXT("%s PostNetReceiveLocationAndRotation: TickComponent: %s"), *ServerOrClient, *GetNameSafe(this));
 
 				ProjectileMovement->TickComponent(CatchupTickDelta, LEVELTICK_All, NULL);
@@ -526,6 +593,21 @@ void AOWSAdvancedProjectile::PostNetReceiveLocationAndRotation()
 		UE_LOG(OWS, Verbose, TEXT("%s PostNetReceiveLocationAndRotation: This projectile is fake: %s"), *ServerOrClient, *GetNameSafe(this));
 	}
 
+	SyncFakeOrTickParticles(true);
+}
+
+void AOWSAdvancedProjectile::SyncFakeOrTickParticles(bool bTickParticles)
+{
+	FString ServerOrClient;
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		ServerOrClient = "Server";
+	}
+	else
+	{
+		ServerOrClient = "Client";
+	}
+
 	if (MyFakeProjectile)
 	{
 		UE_LOG(OWS, Verbose, TEXT("%s PostNetReceiveLocationAndRotation: MyFakeProjectile: %s"), *ServerOrClient, *GetNameSafe(this));
@@ -538,7 +620,7 @@ void AOWSAdvancedProjectile::PostNetReceiveLocationAndRotation()
 		MyFakeProjectile->SetReplicatedMovement(tempRepMovement);
 		MyFakeProjectile->PostNetReceiveLocationAndRotation();
 	}
-	else if (GetLocalRole() != ROLE_Authority)
+	else if (GetLocalRole() != ROLE_Authority && bTickParticles)
 	{
 		UE_LOG(OWS, Verbose, TEXT("%s PostNetReceiveLocationAndRotation: Tick Particle Systems: %s"), *ServerOrClient, *GetNameSafe(this));
 
@@ -584,7 +666,7 @@ void AOWSAdvancedProjectile::Destroyed()
 
 	if (MyFakeProjectile)
 	{
-		MyFakeProjectile->Destroy();
+		MyFakeProjectile->ReleaseProjectile();
 	}
 	GetWorldTimerManager().ClearAllTimersForObject(this);
 	Super::Destroyed();
@@ -614,7 +696,8 @@ void AOWSAdvancedProjectile::ShutDown()
 				// tick the particles one last time for e.g. SpawnPerUnit effects (particularly noticeable improvement for fast moving projectiles)
 				PSC->TickComponent(0.0f, LEVELTICK_All, NULL);
 				PSC->DeactivateSystem();
-				PSC->bAutoDestroy = true;
+				//A pooled projectile keeps its particle systems for the next shot
+				PSC->bAutoDestroy = !bPooled;
 				bFoundParticles = true;
 			}
 			else
@@ -790,7 +873,7 @@ void AOWSAdvancedProjectile::ProcessHit_Implementation(AActor* OtherActor, UPrim
 			if (MyFakeProjectile && !MyFakeProjectile->IsPendingKillPending())
 			{
 				MyFakeProjectile->ProcessHit_Implementation(OtherActor, OtherComp, Hit);
-				Destroy();
+				ReleaseProjectile();
 				return;
 			}
 			if (OtherActor != NULL)
@@ -841,7 +924,7 @@ void AOWSAdvancedProjectile::Explode_Implementation(const FHitResult& Hit, UPrim
 
 	if (FMath::IsNearlyZero(ExplosionDamageRadius) || !AoEDamageEffectOnHit.IsValid())
 	{
-		Destroy();
+		ReleaseProjectile();
 		return;
 	}
 
@@ -906,7 +989,7 @@ void AOWSAdvancedProjectile::Explode_Implementation(const FHitResult& Hit, UPrim
 		}
 	}
 
-	Destroy();
+	ReleaseProjectile();
 }
 
 void AOWSAdvancedProjectile::DamageImpactedActor_Implementation(AActor* OtherActor, UPrimitiveComponent* OtherComp, const FHitResult& Hit)
@@ -1040,6 +1123,250 @@ void AOWSAdvancedProjectile::Tick(float DeltaTime)
 
 }
 
+void AOWSAdvancedProjectile::LifeSpanExpired()
+{
+	if (bPooled)
+	{
+		ReleaseProjectile();
+		return;
+	}
+
+	Super::LifeSpanExpired();
+}
+
+void AOWSAdvancedProjectile::ReleaseProjectile()
+{
+	if (!bPooled)
+	{
+		Destroy();
+		return;
+	}
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		UOWSProjectilePool* ProjectilePool = GetWorld()->GetSubsystem<UOWSProjectilePool>();
+		if (ProjectilePool)
+		{
+			ProjectilePool->ReleaseProjectile(this);
+		}
+		else
+		{
+			Destroy();
+		}
+		return;
+	}
+
+	//The server decides when its projectile goes back in the pool, until then this copy is only put away
+	DeactivateForPool();
+}
+
+void AOWSAdvancedProjectile::ActivateFromPool(const FVector& Location, const FRotator& Rotation, APawn* InInstigator)
+{
+	UE_LOG(OWS, Verbose, TEXT("ActivateFromPool: %s"), *GetName());
+
+	ResetForReuse();
+
+	SetOwner(InInstigator);
+	SetInstigator(InInstigator);
+	OnRep_Instigator();
+
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	RestartMovement();
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		bInPool = false;
+		PoolGeneration++;
+		bForceNextRepMovement = true;
+
+		//Sends this shot once, then the projectile goes back to sleep like a bNetTemporary one would
+		FlushNetDormancy();
+	}
+	LocalPoolGeneration = PoolGeneration;
+
+	SetActorEnableCollision(true);
+	UpdateOverlaps();
+
+	OnTakenFromPool();
+}
+
+void AOWSAdvancedProjectile::DeactivateForPool()
+{
+	//Clients only put their copy away, writing bInPool here would hide the server's next change to it
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		bInPool = true;
+	}
+
+	if (bDeactivatedForPool)
+	{
+		return;
+	}
+
+	UE_LOG(OWS, Verbose, TEXT("DeactivateForPool: %s"), *GetName());
+
+	bDeactivatedForPool = true;
+
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	SetLifeSpan(0.f);
+
+	if (MyFakeProjectile)
+	{
+		MyFakeProjectile->ReleaseProjectile();
+		MyFakeProjectile = NULL;
+	}
+
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
+
+	if (ProjectileMovement)
+	{
+		ProjectileMovement->StopMovementImmediately();
+	}
+
+	TArray<UActorComponent*> Components;
+	GetComponents(Components);
+	for (UActorComponent* Component : Components)
+	{
+		Component->Deactivate();
+	}
+
+	//Warmed up projectiles have never been sent, they stay that way until first used
+	if (GetLocalRole() == ROLE_Authority && NetDormancy != DORM_Initial)
+	{
+		FlushNetDormancy();
+	}
+
+	OnReturnedToPool();
+}
+
+void AOWSAdvancedProjectile::ResetForReuse()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	bDeactivatedForPool = false;
+	bExploded = false;
+	bInOverlap = false;
+	bFakeClientProjectile = false;
+	bForceNextRepMovement = false;
+	MyFakeProjectile = NULL;
+	MasterProjectile = NULL;
+	ImpactedActor = NULL;
+
+	DamageEffectOnHit = FGameplayEffectSpecHandle();
+	AoEDamageEffectOnHit = FGameplayEffectSpecHandle();
+	ActivateAbilityTagOnImpact = GetClass()->GetDefaultObject<AOWSAdvancedProjectile>()->ActivateAbilityTagOnImpact;
+
+	if (RootComponent && RootComponent->GetAttachParent())
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	}
+
+	//ShutDown and BeginFakeProjectileSynch hide components, put back what the class had
+	SetActorHiddenInGame(false);
+	TArray<UActorComponent*> Components;
+	GetComponents(Components);
+	for (UActorComponent* Component : Components)
+	{
+		if (USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+		{
+			if (const USceneComponent* Archetype = Cast<USceneComponent>(SceneComponent->GetArchetype()))
+			{
+				SceneComponent->SetVisibility(Archetype->GetVisibleFlag());
+				SceneComponent->SetHiddenInGame(Archetype->bHiddenInGame);
+			}
+		}
+
+		if (Component->bAutoActivate)
+		{
+			Component->Activate(true);
+		}
+	}
+
+	if (ProjectileMovement)
+	{
+		//Stopping clears the updated component
+		ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	}
+
+	SetActorTickEnabled(PrimaryActorTick.bStartWithTickEnabled);
+	SetLifeSpan(GetClass()->GetDefaultObject<AActor>()->InitialLifeSpan);
+}
+
+void AOWSAdvancedProjectile::RestartMovement()
+{
+	if (!ProjectileMovement)
+	{
+		return;
+	}
+
+	const UProjectileMovementComponent* DefaultMovement = Cast<UProjectileMovementComponent>(ProjectileMovement->GetArchetype());
+	FVector NewVelocity = DefaultMovement ? DefaultMovement->Velocity : FVector(1.f, 0.f, 0.f);
+
+	if (ProjectileMovement->InitialSpeed > 0.f)
+	{
+		NewVelocity = NewVelocity.GetSafeNormal() * ProjectileMovement->InitialSpeed;
+	}
+
+	if (ProjectileMovement->bInitialVelocityInLocalSpace)
+	{
+		ProjectileMovement->SetVelocityInLocalSpace(NewVelocity);
+	}
+	else
+	{
+		ProjectileMovement->Velocity = NewVelocity;
+	}
+
+	ProjectileMovement->UpdateComponentVelocity();
+}
+
+void AOWSAdvancedProjectile::OnRep_PoolState()
+{
+	//BeginPlay handles the first start of a replicated projectile
+	if (!HasActorBegunPlay())
+	{
+		return;
+	}
+
+	//The pool hands out the last projectile returned, so the server can release and take this one again between two updates.
+	//Then only PoolGeneration changes, and it means a new shot whatever this copy did locally.
+	if (PoolGeneration == LocalPoolGeneration)
+	{
+		if (bInPool)
+		{
+			DeactivateForPool();
+		}
+		return;
+	}
+
+	LocalPoolGeneration = PoolGeneration;
+
+	if (bInPool)
+	{
+		DeactivateForPool();
+		return;
+	}
+
+	UE_LOG(OWS, Verbose, TEXT("OnRep_PoolState: Client restarting pooled projectile: %s"), *GetName());
+
+	ResetForReuse();
+	SetActorLocationAndRotation(UTProjReplicatedMovement.Location, UTProjReplicatedMovement.Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	if (ProjectileMovement)
+	{
+		ProjectileMovement->Velocity = UTProjReplicatedMovement.LinearVelocity;
+	}
+	SetActorEnableCollision(true);
+
+	OnTakenFromPool();
+
+	AOWSPlayerController* MyPlayer = Cast<AOWSPlayerController>(InstigatorController ? InstigatorController : GEngine->GetFirstLocalPlayerController(GetWorld()));
+	if (MyPlayer)
+	{
+		CatchupAndMatchFake(MyPlayer);
+	}
+}
+
 void AOWSAdvancedProjectile::SetDamageEffectOnHit(FGameplayEffectSpecHandle DamageEffect)
 {
 	DamageEffectOnHit = DamageEffect;
@@ -1078,6 +1405,9 @@ void AOWSAdvancedProjectile::GetLifetimeReplicatedProps(TArray<class FLifetimePr
 
 	//DOREPLIFETIME(AActor, GetInstigator());
 	DOREPLIFETIME_CONDITION(AOWSAdvancedProjectile, UTProjReplicatedMovement, COND_SimulatedOrPhysics);
+	DOREPLIFETIME_CONDITION(AOWSAdvancedProjectile, bPooled, COND_InitialOnly);
+	DOREPLIFETIME(AOWSAdvancedProjectile, bInPool);
+	DOREPLIFETIME(AOWSAdvancedProjectile, PoolGeneration);
 	//DOREPLIFETIME_CONDITION(AOWSAdvancedProjectile, ProjectilePredictionKey, COND_OwnerOnly);
 
 	
@@ -7,6 +7,100 @@
 #include "GameplayTagsModule.h"
 #include "GameplayEffectExtension.h"
 #include "OWSCharacterWithAbilities.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "HAL/IConsoleManager.h"
+#include "EngineUtils.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+#include "UObject/CoreNet.h"
+
+//A changed property goes out as its handle followed by its value, this measures one attribute the same way
+static int32 MeasureAttributeBits(uint32 Handle, const FGameplayAttributeData& AttributeData)
+{
+	FNetBitWriter Writer(256);
+	float BaseValue = AttributeData.GetBaseValue();
+	float CurrentValue = AttributeData.GetCurrentValue();
+
+	Writer.SerializeIntPacked(Handle);
+	Writer << BaseValue << CurrentValue;
+	return (int32)Writer.GetNumBits();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GOWSAttributeReplicationBenchmarkCmd(
+	TEXT("OWS.Attributes.ReplicationBenchmark"),
+	TEXT("Compares the attribute payload one connection receives for N other characters in each replication mode.  Takes N, 50 by default."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(
+		[](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 NumberOfCharacters = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 50;
+
+			//Measure a live character's values when there is one, packed sizes depend on them
+			const UOWSAttributeSet* AttributeSet = GetDefault<UOWSAttributeSet>();
+			if (World)
+			{
+				for (TActorIterator<AOWSCharacterWithAbilities> It(World); It; ++It)
+				{
+					if (It->OWSAttributes)
+					{
+						AttributeSet = It->OWSAttributes;
+						break;
+					}
+				}
+			}
+
+			static const FName BarAttributes[] = { TEXT("Health"), TEXT("MaxHealth"), TEXT("Mana"), TEXT("MaxMana") };
+			static const FName RegeneratingAttributes[] = { TEXT("Health"), TEXT("Mana"), TEXT("Energy"), TEXT("Fatigue"), TEXT("Stamina"), TEXT("Endurance") };
+
+			int32 AllBits = 0;
+			int32 BarBits = 0;
+			int32 HealthBits = 0;
+			int32 RegenBits = 0;
+			int32 RegenBarBits = 0;
+			uint32 Handle = 1;
+
+			for (TFieldIterator<FStructProperty> It(UOWSAttributeSet::StaticClass()); It; ++It)
+			{
+				if (!It->HasAnyPropertyFlags(CPF_Net) || It->Struct != FGameplayAttributeData::StaticStruct())
+				{
+					continue;
+				}
+
+				const FName AttributeName = It->GetFName();
+				const bool bIsBar = MakeArrayView(BarAttributes).Contains(AttributeName);
+				const int32 Bits = MeasureAttributeBits(Handle++, *It->ContainerPtrToValuePtr<FGameplayAttributeData>(AttributeSet));
+
+				AllBits += Bits;
+				BarBits += bIsBar ? Bits : 0;
+				HealthBits = AttributeName == BarAttributes[0] ? Bits : HealthBits;
+
+				if (MakeArrayView(RegeneratingAttributes).Contains(AttributeName))
+				{
+					RegenBits += Bits;
+					RegenBarBits += bIsBar ? Bits : 0;
+				}
+			}
+
+			FOWSQuantizedAttributeBars Bars;
+			Bars.Health = FMath::Max(0, FMath::RoundToInt(AttributeSet->Health.GetCurrentValue()));
+			Bars.MaxHealth = FMath::Max(0, FMath::RoundToInt(AttributeSet->MaxHealth.GetCurrentValue()));
+			Bars.Mana = FMath::Max(0, FMath::RoundToInt(AttributeSet->Mana.GetCurrentValue()));
+			Bars.MaxMana = FMath::Max(0, FMath::RoundToInt(AttributeSet->MaxMana.GetCurrentValue()));
+
+			FNetBitWriter Writer(256);
+			bool bSuccess = false;
+			Writer.SerializeIntPacked(Handle);
+			Bars.NetSerialize(Writer, nullptr, bSuccess);
+			const int32 QuantizedBits = (int32)Writer.GetNumBits();
+
+			const auto ToBytes = [NumberOfCharacters](int32 Bits) { return (Bits * NumberOfCharacters + 7) / 8; };
+
+			GLog->Logf(TEXT("OWS Attribute Replication: payload for %d other characters, server mode %s, property headers only, no packet overhead"),
+				NumberOfCharacters, *StaticEnum<EOWSAttributeReplicationMode>()->GetNameStringByValue((int64)UOWSAttributeSet::GetReplicationMode()));
+			GLog->Logf(TEXT("  Full:           initial=%d bytes  health change=%d bytes  regen tick=%d bytes"), ToBytes(AllBits), ToBytes(HealthBits), ToBytes(RegenBits));
+			GLog->Logf(TEXT("  RelevancySplit: initial=%d bytes  health change=%d bytes  regen tick=%d bytes"), ToBytes(BarBits), ToBytes(HealthBits), ToBytes(RegenBarBits));
+			GLog->Logf(TEXT("  Quantized:      initial=%d bytes  health change=%d bytes  regen tick=%d bytes, only when a whole point changes"), ToBytes(QuantizedBits),
+				ToBytes(QuantizedBits), ToBytes(QuantizedBits));
+		}),
+	ECVF_Default);
 
 
 UOWSAttributeSet::UOWSAttributeSet(const FObjectInitializer& ObjectInitializer)
@@ -37,6 +131,11 @@ UOWSAttributeSet::UOWSAttributeSet(const FObjectInitializer& ObjectInitializer)
 	CritChance = 0.1f;
 	CritMultiplier = 2.0f;
 	Defense = 0.03f;
+
+	QuantizedBars.Health = 100;
+	QuantizedBars.MaxHealth = 100;
+	QuantizedBars.Mana = 100;
+	QuantizedBars.MaxMana = 100;
 }
 
 bool UOWSAttributeSet::PreGameplayEffectExecute(struct FGameplayEffectModCallbackData &Data)
@@ -341,66 +440,174 @@ void UOWSAttributeSet::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > &
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, HitDie, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Wounds, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Thirst, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Hunger, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxHealth, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Health, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, HealthRegenRate, COND_None, REPNOTIFY_Always);	
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxMana, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Mana, COND_None, REPNOTIFY_Always);	
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ManaRegenRate, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxEnergy, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Energy, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, EnergyRegenRate, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxFatigue, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Fatigue, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, FatigueRegenRate, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxStamina, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Stamina, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, StaminaRegenRate, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxEndurance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Endurance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, EnduranceRegenRate, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Strength, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Dexterity, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Constitution, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Intellect, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Wisdom, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Charisma, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Agility, COND_None, REPNOTIFY_Always);	
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Spirit, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Magic, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Fortitude, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Reflex, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Willpower, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BaseAttack, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BaseAttackBonus, COND_None, REPNOTIFY_Always);
-	
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, AttackPower, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, AttackSpeed, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, CritChance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, CritMultiplier, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Haste, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, SpellPower, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, SpellPenetration, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Defense, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Dodge, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Parry, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Avoidance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Versatility, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Multishot, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Initiative, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, NaturalArmor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, PhysicalArmor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BonusArmor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ForceArmor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MagicArmor, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Resistance, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ReloadSpeed, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Range, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Speed, COND_None, REPNOTIFY_Always);
+	const EOWSAttributeReplicationMode ReplicationMode = GetReplicationMode();
+
+	//Health and mana bars are drawn for other characters too, unless QuantizedBars carries them
+	const ELifetimeCondition BarCondition = ReplicationMode == EOWSAttributeReplicationMode::Quantized ? COND_OwnerOnly : COND_None;
+	const ELifetimeCondition DetailCondition = ReplicationMode == EOWSAttributeReplicationMode::Full ? COND_None : COND_OwnerOnly;
+
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, HitDie, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Wounds, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Thirst, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Hunger, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxHealth, BarCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Health, BarCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, HealthRegenRate, DetailCondition, REPNOTIFY_Always);	
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxMana, BarCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Mana, BarCondition, REPNOTIFY_Always);	
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ManaRegenRate, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxEnergy, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Energy, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, EnergyRegenRate, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxFatigue, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Fatigue, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, FatigueRegenRate, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxStamina, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Stamina, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, StaminaRegenRate, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MaxEndurance, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Endurance, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, EnduranceRegenRate, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Strength, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Dexterity, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Constitution, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Intellect, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Wisdom, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Charisma, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Agility, DetailCondition, REPNOTIFY_Always);	
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Spirit, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Magic, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Fortitude, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Reflex, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Willpower, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BaseAttack, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BaseAttackBonus, DetailCondition, REPNOTIFY_Always);
 	
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, AttackPower, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, AttackSpeed, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, CritChance, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, CritMultiplier, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Haste, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, SpellPower, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, SpellPenetration, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Defense, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Dodge, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Parry, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Avoidance, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Versatility, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Multishot, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Initiative, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, NaturalArmor, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, PhysicalArmor, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, BonusArmor, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ForceArmor, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, MagicArmor, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Resistance, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, ReloadSpeed, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Range, DetailCondition, REPNOTIFY_Always);
+	DOREPLIFETIME_CONDITION_NOTIFY(UOWSAttributeSet, Speed, DetailCondition, REPNOTIFY_Always);
+
+	FDoRepLifetimeParams QuantizedBarsParams;
+	QuantizedBarsParams.Condition = ReplicationMode == EOWSAttributeReplicationMode::Quantized ? COND_SkipOwner : COND_Never;
+	QuantizedBarsParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UOWSAttributeSet, QuantizedBars, QuantizedBarsParams);
+}
+
+EOWSAttributeReplicationMode UOWSAttributeSet::GetReplicationMode()
+{
+	static const EOWSAttributeReplicationMode ReplicationMode = []()
+	{
+		FString ReplicationModeName;
+		GConfig->GetString(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSAttributeReplicationMode"), ReplicationModeName, GGameIni);
+
+		const int64 Value = StaticEnum<EOWSAttributeReplicationMode>()->GetValueByNameString(ReplicationModeName);
+		return Value == INDEX_NONE ? EOWSAttributeReplicationMode::Full : (EOWSAttributeReplicationMode)Value;
+	}();
+
+	return ReplicationMode;
+}
+
+void UOWSAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	Super::PostAttributeChange(Attribute, OldValue, NewValue);
+
+	if (Attribute == GetHealthAttribute() || Attribute == GetMaxHealthAttribute() || Attribute == GetManaAttribute() || Attribute == GetMaxManaAttribute())
+	{
+		UpdateQuantizedBars();
+	}
+}
+
+void UOWSAttributeSet::UpdateQuantizedBars()
+{
+	const AActor* OwningActor = GetOwningActor();
+	if (GetReplicationMode() != EOWSAttributeReplicationMode::Quantized || !OwningActor || !OwningActor->HasAuthority())
+	{
+		return;
+	}
+
+	FOWSQuantizedAttributeBars NewBars;
+	NewBars.Health = FMath::Max(0, FMath::RoundToInt(GetHealth()));
+	NewBars.MaxHealth = FMath::Max(0, FMath::RoundToInt(GetMaxHealth()));
+	NewBars.Mana = FMath::Max(0, FMath::RoundToInt(GetMana()));
+	NewBars.MaxMana = FMath::Max(0, FMath::RoundToInt(GetMaxMana()));
+
+	//Regeneration moves health a fraction of a point at a time, other players only need to see whole points
+	if (NewBars == QuantizedBars)
+	{
+		return;
+	}
+
+	QuantizedBars = NewBars;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UOWSAttributeSet, QuantizedBars, this);
+}
+
+void UOWSAttributeSet::OnRep_QuantizedBars(const FOWSQuantizedAttributeBars& OldQuantizedBars)
+{
+	//Max first so a bar never shows more than full
+	SetQuantizedAttribute(GetMaxHealthAttribute(), MaxHealth, QuantizedBars.MaxHealth);
+	SetQuantizedAttribute(GetHealthAttribute(), Health, QuantizedBars.Health);
+	SetQuantizedAttribute(GetMaxManaAttribute(), MaxMana, QuantizedBars.MaxMana);
+	SetQuantizedAttribute(GetManaAttribute(), Mana, QuantizedBars.Mana);
+}
+
+void UOWSAttributeSet::SetQuantizedAttribute(const FGameplayAttribute& Attribute, FGameplayAttributeData& AttributeData, int32 NewValue)
+{
+	if (AttributeData.GetCurrentValue() == (float)NewValue)
+	{
+		return;
+	}
+
+	const FGameplayAttributeData OldAttributeData = AttributeData;
+	AttributeData.SetBaseValue(NewValue);
+	AttributeData.SetCurrentValue(NewValue);
+
+	//Same notification GAMEPLAYATTRIBUTE_REPNOTIFY gives, so the Health and Mana change delegates still fire
+	if (UAbilitySystemComponent* AbilitySystemComponent = GetOwningAbilitySystemComponent())
+	{
+		AbilitySystemComponent->SetBaseAttributeValueFromReplication(Attribute, AttributeData, OldAttributeData);
+	}
+}
+
+bool FOWSQuantizedAttributeBars::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 PackedHealth = Health;
+	uint32 PackedMaxHealth = MaxHealth;
+	uint32 PackedMana = Mana;
+	uint32 PackedMaxMana = MaxMana;
+
+	Ar.SerializeIntPacked(PackedHealth);
+	Ar.SerializeIntPacked(PackedMaxHealth);
+	Ar.SerializeIntPacked(PackedMana);
+	Ar.SerializeIntPacked(PackedMaxMana);
+
+	if (Ar.IsLoading())
+	{
+		Health = PackedHealth;
+		MaxHealth = PackedMaxHealth;
+		Mana = PackedMana;
+		MaxMana = PackedMaxMana;
+	}
+
+	bOutSuccess = true;
+	return true;
 }
@@ -0,0 +1,470 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSBatchedProjectileManager.h"
+#include "OWSAdvancedProjectile.h"
+#include "OWSCharacterWithAbilities.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "Engine/World.h"
+#include "Engine/OverlapResult.h"
+#include "GameFramework/GameStateBase.h"
+#include "Async/ParallelFor.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSBatchedProjectileManager> GOWSBatchedProjectileStatsCmd(
+	TEXT("OWS.BatchedProjectiles.Stats"),
+	TEXT("Dumps live count, impacts and frame cost of the batched projectile manager.  Pass reset to clear them."));
+
+//Used when a projectile class has no InitialLifeSpan, so a shot into the sky does not live forever
+static constexpr float OWSBatchedProjectileMaxLifeSpan = 10.f;
+
+//Clients move a new projectile forward by its trip time, up to this much
+static constexpr float OWSBatchedProjectileMaxCatchup = 0.5f;
+
+bool UOWSBatchedProjectileManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSBatchedProjectileManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSBatchedProjectileParallelThreshold"), ParallelThreshold, GGameIni);
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSBatchedProjectileAsyncSweeps"), bUseAsyncSweeps, GGameIni);
+}
+
+TStatId UOWSBatchedProjectileManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOWSBatchedProjectileManager, STATGROUP_Tickables);
+}
+
+int32 UOWSBatchedProjectileManager::FindOrAddDefinition(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass)
+{
+	if (!ProjectileClass)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* Found = DefinitionIndexByClass.Find(ProjectileClass.Get()))
+	{
+		return *Found;
+	}
+
+	const AOWSAdvancedProjectile* DefaultProjectile = ProjectileClass->GetDefaultObject<AOWSAdvancedProjectile>();
+
+	FDefinition Definition;
+	Definition.ProjectileClass = ProjectileClass;
+	Definition.Radius = DefaultProjectile->OverlapRadius;
+	Definition.LifeSpan = DefaultProjectile->InitialLifeSpan > 0.f ? DefaultProjectile->InitialLifeSpan : OWSBatchedProjectileMaxLifeSpan;
+	Definition.ExplosionDamageRadius = DefaultProjectile->ExplosionDamageRadius;
+	Definition.ExplosionGameplayCueTag = DefaultProjectile->ExplosionGameplayCueTag;
+	Definition.ActivateAbilityTagOnImpact = DefaultProjectile->ActivateAbilityTagOnImpact;
+
+	if (const UProjectileMovementComponent* Movement = DefaultProjectile->ProjectileMovement)
+	{
+		//Same rule as UProjectileMovementComponent, a zero InitialSpeed keeps the length of Velocity
+		Definition.Speed = Movement->InitialSpeed > 0.f ? Movement->InitialSpeed : Movement->Velocity.Size();
+		Definition.MaxSpeed = Movement->MaxSpeed;
+		Definition.GravityScale = Movement->ProjectileGravityScale;
+	}
+
+	const int32 Index = Definitions.Add(Definition);
+	DefinitionIndexByClass.Add(ProjectileClass.Get(), Index);
+	return Index;
+}
+
+int32 UOWSBatchedProjectileManager::AddProjectile(int32 ID, int32 Definition, const FVector& Location, const FVector& Velocity, APawn* InInstigator)
+{
+	const int32 Index = IDs.Add(ID);
+	DefinitionIndices.Add(Definition);
+	Locations.Add(Location);
+	PreviousLocations.Add(Location);
+	Velocities.Add(Velocity);
+	LifeLeft.Add(Definitions[Definition].LifeSpan);
+	Instigators.Add(InInstigator);
+	PendingSweeps.AddDefaulted();
+	DamageEffects.AddDefaulted();
+	AoEDamageEffects.AddDefaulted();
+	ImpactAbilityTags.AddDefaulted();
+
+	IndexByID.Add(ID, Index);
+	Stats.PeakLive = FMath::Max(Stats.PeakLive, IDs.Num());
+
+	return Index;
+}
+
+void UOWSBatchedProjectileManager::RemoveProjectileAt(int32 Index)
+{
+	IndexByID.Remove(IDs[Index]);
+
+	IDs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	DefinitionIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PreviousLocations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	LifeLeft.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PendingSweeps.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	DamageEffects.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	AoEDamageEffects.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ImpactAbilityTags.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	//The last projectile moved into the gap
+	if (Index < IDs.Num())
+	{
+		IndexByID.Add(IDs[Index], Index);
+	}
+}
+
+int32 UOWSBatchedProjectileManager::SpawnProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator,
+	const FGameplayEffectSpecHandle& DamageEffect, const FGameplayEffectSpecHandle& AoEDamageEffect, const FGameplayTag& ActivateAbilityTagOnImpact)
+{
+	UWorld* World = GetWorld();
+	if (World->GetNetMode() == NM_Client)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Definition = FindOrAddDefinition(ProjectileClass);
+	if (Definition == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ID = NextProjectileID;
+	NextProjectileID = (NextProjectileID == MAX_int32) ? 0 : NextProjectileID + 1;
+
+	const FVector Velocity = Rotation.Vector() * Definitions[Definition].Speed;
+	const int32 Index = AddProjectile(ID, Definition, Location, Velocity, InInstigator);
+	DamageEffects[Index] = DamageEffect;
+	AoEDamageEffects[Index] = AoEDamageEffect;
+	ImpactAbilityTags[Index] = ActivateAbilityTagOnImpact;
+
+	Stats.Spawned++;
+
+	if (AOWSCharacterWithAbilities* InstigatorCharacter = Cast<AOWSCharacterWithAbilities>(InInstigator))
+	{
+		FOWSBatchedProjectileSpawn Spawn;
+		Spawn.ProjectileID = ID;
+		Spawn.ProjectileClass = ProjectileClass;
+		Spawn.Location = Location;
+		Spawn.Velocity = Velocity;
+		Spawn.ServerSpawnTime = World->GetGameState() ? World->GetGameState()->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+
+		InstigatorCharacter->Multicast_BatchedProjectileSpawned(Spawn);
+	}
+
+	if (World->GetNetMode() != NM_DedicatedServer)
+	{
+		OnProjectileSpawned.Broadcast(ID, ProjectileClass, Location);
+	}
+
+	return ID;
+}
+
+void UOWSBatchedProjectileManager::ReceiveSpawn(const FOWSBatchedProjectileSpawn& Spawn, APawn* InInstigator)
+{
+	if (IndexByID.Contains(Spawn.ProjectileID))
+	{
+		return;
+	}
+
+	const int32 Definition = FindOrAddDefinition(Spawn.ProjectileClass);
+	if (Definition == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 Index = AddProjectile(Spawn.ProjectileID, Definition, Spawn.Location, Spawn.Velocity, InInstigator);
+	Stats.Spawned++;
+
+	const UWorld* World = GetWorld();
+	if (const AGameStateBase* GameState = World->GetGameState())
+	{
+		const float Catchup = FMath::Clamp((float)GameState->GetServerWorldTimeSeconds() - Spawn.ServerSpawnTime, 0.f, OWSBatchedProjectileMaxCatchup);
+		if (Catchup > 0.f)
+		{
+			StepProjectile(Index, Catchup, World->GetGravityZ());
+			PreviousLocations[Index] = Locations[Index];
+		}
+	}
+
+	OnProjectileSpawned.Broadcast(Spawn.ProjectileID, Spawn.ProjectileClass, Locations[Index]);
+}
+
+void UOWSBatchedProjectileManager::ReceiveImpact(int32 ProjectileID, const FVector& Location)
+{
+	const int32* Index = IndexByID.Find(ProjectileID);
+	if (!Index)
+	{
+		//Already expired here, or the spawn was lost
+		return;
+	}
+
+	Stats.Impacts++;
+	OnProjectileImpact.Broadcast(ProjectileID, Definitions[DefinitionIndices[*Index]].ProjectileClass, Location);
+	RemoveProjectileAt(*Index);
+}
+
+bool UOWSBatchedProjectileManager::GetProjectileLocation(int32 ProjectileID, FVector& OutLocation) const
+{
+	if (const int32* Index = IndexByID.Find(ProjectileID))
+	{
+		OutLocation = Locations[*Index];
+		return true;
+	}
+
+	return false;
+}
+
+void UOWSBatchedProjectileManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (IDs.Num() == 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bIsServer = GetWorld()->GetNetMode() != NM_Client;
+
+	//Hits are found by ID since resolving one moves another projectile into its slot
+	TArray<TPair<int32, FHitResult>> Impacts;
+
+	if (bIsServer)
+	{
+		ResolvePendingSweeps(Impacts);
+	}
+
+	for (const TPair<int32, FHitResult>& ProjectileImpact : Impacts)
+	{
+		if (const int32* Index = IndexByID.Find(ProjectileImpact.Key))
+		{
+			Impact(*Index, ProjectileImpact.Value);
+			RemoveProjectileAt(*Index);
+		}
+	}
+
+	MoveProjectiles(DeltaTime);
+
+	for (int32 Index = IDs.Num() - 1; Index >= 0; Index--)
+	{
+		if (LifeLeft[Index] <= 0.f)
+		{
+			Stats.Expired++;
+			RemoveProjectileAt(Index);
+		}
+	}
+
+	//Clients wait for the server's impact
+	if (bIsServer)
+	{
+		Impacts.Reset();
+		SweepProjectiles(Impacts);
+
+		for (const TPair<int32, FHitResult>& ProjectileImpact : Impacts)
+		{
+			if (const int32* Index = IndexByID.Find(ProjectileImpact.Key))
+			{
+				Impact(*Index, ProjectileImpact.Value);
+				RemoveProjectileAt(*Index);
+			}
+		}
+	}
+
+	Stats.LastFrameMs = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UOWSBatchedProjectileManager::StepProjectile(int32 Index, float DeltaTime, float GravityZ)
+{
+	const FDefinition& Definition = Definitions[DefinitionIndices[Index]];
+
+	FVector& Velocity = Velocities[Index];
+	Velocity.Z += GravityZ * Definition.GravityScale * DeltaTime;
+	if (Definition.MaxSpeed > 0.f)
+	{
+		Velocity = Velocity.GetClampedToMaxSize(Definition.MaxSpeed);
+	}
+
+	Locations[Index] += Velocity * DeltaTime;
+	LifeLeft[Index] -= DeltaTime;
+}
+
+void UOWSBatchedProjectileManager::MoveProjectiles(float DeltaTime)
+{
+	const float GravityZ = GetWorld()->GetGravityZ();
+
+	PreviousLocations = Locations;
+
+	ParallelFor(IDs.Num(), [this, DeltaTime, GravityZ](int32 Index)
+		{
+			StepProjectile(Index, DeltaTime, GravityZ);
+		},
+		IDs.Num() < ParallelThreshold ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+FCollisionQueryParams UOWSBatchedProjectileManager::MakeQueryParams(int32 Index) const
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(OWSBatchedProjectileSweep), false, Instigators[Index].Get());
+	return Params;
+}
+
+void UOWSBatchedProjectileManager::SweepProjectiles(TArray<TPair<int32, FHitResult>>& OutImpacts)
+{
+	UWorld* World = GetWorld();
+
+	for (int32 Index = 0; Index < IDs.Num(); Index++)
+	{
+		const FCollisionShape Shape = FCollisionShape::MakeSphere(Definitions[DefinitionIndices[Index]].Radius);
+
+		if (bUseAsyncSweeps)
+		{
+			PendingSweeps[Index] = World->AsyncSweepByChannel(EAsyncTraceType::Multi, PreviousLocations[Index], Locations[Index], FQuat::Identity, COLLISION_PROJECTILE,
+				Shape, MakeQueryParams(Index));
+		}
+		else
+		{
+			TArray<FHitResult> Hits;
+			World->SweepMultiByChannel(Hits, PreviousLocations[Index], Locations[Index], FQuat::Identity, COLLISION_PROJECTILE, Shape, MakeQueryParams(Index));
+
+			FHitResult Hit;
+			if (PickImpact(Hits, Hit))
+			{
+				OutImpacts.Emplace(IDs[Index], Hit);
+			}
+		}
+	}
+
+	Stats.Sweeps += IDs.Num();
+}
+
+void UOWSBatchedProjectileManager::ResolvePendingSweeps(TArray<TPair<int32, FHitResult>>& OutImpacts)
+{
+	UWorld* World = GetWorld();
+
+	for (int32 Index = 0; Index < IDs.Num(); Index++)
+	{
+		if (!PendingSweeps[Index].IsValid())
+		{
+			continue;
+		}
+
+		FTraceDatum Datum;
+		if (World->QueryTraceData(PendingSweeps[Index], Datum))
+		{
+			FHitResult Hit;
+			if (PickImpact(Datum.OutHits, Hit))
+			{
+				OutImpacts.Emplace(IDs[Index], Hit);
+			}
+		}
+
+		PendingSweeps[Index] = FTraceHandle();
+	}
+}
+
+bool UOWSBatchedProjectileManager::PickImpact(const TArray<FHitResult>& Hits, FHitResult& OutHit) const
+{
+	//Hits come sorted by distance with the blocking hit last, pawns the projectile only overlaps still count like PawnOverlapSphere
+	for (const FHitResult& Hit : Hits)
+	{
+		const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		if (Hit.bBlockingHit || (HitComponent && HitComponent->GetCollisionObjectType() == ECC_Pawn))
+		{
+			OutHit = Hit;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UOWSBatchedProjectileManager::Impact(int32 Index, const FHitResult& Hit)
+{
+	const FDefinition& Definition = Definitions[DefinitionIndices[Index]];
+	APawn* InstigatorPawn = Instigators[Index].Get();
+	AOWSCharacterWithAbilities* InstigatorCharacter = Cast<AOWSCharacterWithAbilities>(InstigatorPawn);
+	UWorld* World = GetWorld();
+
+	Stats.Impacts++;
+	Locations[Index] = Hit.Location;
+
+	if (AOWSCharacterWithAbilities* CharacterWhoWasHit = Cast<AOWSCharacterWithAbilities>(Hit.GetActor()))
+	{
+		CharacterWhoWasHit->ApplyProjectileDamageEffect(DamageEffects[Index]);
+	}
+
+	//The rest follows AOWSAdvancedProjectile::Explode
+	if (!FMath::IsNearlyZero(Definition.ExplosionDamageRadius) && AoEDamageEffects[Index].IsValid())
+	{
+		if (Definition.ExplosionGameplayCueTag.IsValid() && InstigatorCharacter)
+		{
+			FGameplayCueParameters CueParams;
+			CueParams.Location = Hit.Location;
+			CueParams.Normal = Hit.Normal;
+			CueParams.PhysicalMaterial = Hit.PhysMaterial;
+			CueParams.Instigator = InstigatorCharacter;
+			CueParams.EffectCauser = InstigatorCharacter;
+			InstigatorCharacter->GetAbilitySystemComponent()->ExecuteGameplayCue(Definition.ExplosionGameplayCueTag, CueParams);
+		}
+
+		const FGameplayTag ActivateAbilityTagOnImpact = ImpactAbilityTags[Index].IsValid() ? ImpactAbilityTags[Index] : Definition.ActivateAbilityTagOnImpact;
+		if (ActivateAbilityTagOnImpact.IsValid() && InstigatorPawn)
+		{
+			FHitResult HitResult;
+			HitResult.Location = Hit.Location;
+
+			FGameplayAbilityTargetData_SingleTargetHit* SingleHitTargetData = new FGameplayAbilityTargetData_SingleTargetHit();
+			SingleHitTargetData->ReplaceHitWith(NULL, &HitResult);
+
+			FGameplayEventData Payload;
+			Payload.Instigator = InstigatorPawn;
+			Payload.Target = Hit.GetActor();
+			Payload.EventTag = ActivateAbilityTagOnImpact;
+			Payload.TargetData.Add(SingleHitTargetData);
+
+			UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(InstigatorPawn, ActivateAbilityTagOnImpact, Payload);
+		}
+
+		TArray<FOverlapResult> OverlapResults;
+		FCollisionObjectQueryParams CollisionObjectQueryParams;
+		CollisionObjectQueryParams.AddObjectTypesToQuery(ECollisionChannel::ECC_Pawn);
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(OWSBatchedProjectileExplosion), false, InstigatorPawn);
+
+		World->OverlapMultiByObjectType(OverlapResults, Hit.Location, FQuat::Identity, CollisionObjectQueryParams, FCollisionShape::MakeSphere(Definition.ExplosionDamageRadius), QueryParams);
+
+		for (const FOverlapResult& OverlapResult : OverlapResults)
+		{
+			AOWSCharacterWithAbilities* CharacterWhoWasHit = Cast<AOWSCharacterWithAbilities>(OverlapResult.GetActor());
+			if (IsValid(CharacterWhoWasHit))
+			{
+				CharacterWhoWasHit->ApplyProjectileDamageEffect(AoEDamageEffects[Index]);
+			}
+		}
+	}
+
+	if (InstigatorCharacter)
+	{
+		InstigatorCharacter->Multicast_BatchedProjectileImpact(IDs[Index], Hit.Location);
+	}
+
+	if (World->GetNetMode() != NM_DedicatedServer)
+	{
+		OnProjectileImpact.Broadcast(IDs[Index], Definition.ProjectileClass, Hit.Location);
+	}
+}
+
+void UOWSBatchedProjectileManager::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Batched Projectiles: live=%d peak=%d classes=%d %s sweeps"), IDs.Num(), Stats.PeakLive, Definitions.Num(), bUseAsyncSweeps ? TEXT("async") : TEXT("sync"));
+	Ar.Logf(TEXT("  spawned=%d impacts=%d expired=%d sweeps=%d last frame=%.3fms"), Stats.Spawned, Stats.Impacts, Stats.Expired, Stats.Sweeps, Stats.LastFrameMs);
+}
+
+void UOWSBatchedProjectileManager::ResetStats()
+{
+	Stats = FOWSBatchedProjectileStats();
+}
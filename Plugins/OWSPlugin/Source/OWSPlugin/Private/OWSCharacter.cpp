@@ -9,6 +9,9 @@
 #include "Runtime/Core/Public/Misc/Guid.h"
 #include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
 #include "OWSPlayerController.h"
+#include "OWSCharacterPersistenceCache.h"
+#include "Engine/GameInstance.h"
+#include "Engine/ActorChannel.h"
 #include "Runtime/Engine/Classes/GameFramework/PlayerState.h"
 
 // Sets default values
@@ -32,6 +35,9 @@ AOWSCharacter::AOWSCharacter(const class FObjectInitializer& ObjectInitializer)
 
 	bShouldAutoLoadCustomCharacterStats = false;
 
+	bSendOnlyChangedCharacterStats = false;
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSPartialCharacterStatsUpdates"), bSendOnlyChangedCharacterStats, GGameIni);
+
 	//AlwaysRelevantPartyID = 0;
 }
 
@@ -39,6 +45,28 @@ AOWSCharacter::AOWSCharacter(const class FObjectInitializer& ObjectInitializer)
 void AOWSCharacter::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		if (UOWSCharacterPersistenceCache* PersistenceCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UOWSCharacterPersistenceCache>() : nullptr)
+		{
+			CharacterStatsDroppedHandle = PersistenceCache->OnCharacterStatsDropped.AddUObject(this, &AOWSCharacter::OnCharacterStatsDropped);
+		}
+	}
+}
+
+void AOWSCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (CharacterStatsDroppedHandle.IsValid())
+	{
+		if (UOWSCharacterPersistenceCache* PersistenceCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UOWSCharacterPersistenceCache>() : nullptr)
+		{
+			PersistenceCache->OnCharacterStatsDropped.Remove(CharacterStatsDroppedHandle);
+		}
+		CharacterStatsDroppedHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AOWSCharacter::PossessedBy(AController* NewController)
@@ -257,6 +285,92 @@ void AOWSCharacter::LoadCharacterStatsFromJSON(TSharedPtr<FJsonObject>JsonObject
 }
 
 
+void AOWSCharacter::SendCharacterStats(AOWSPlayerController* PC, const FCharacterStats& CurrentStats)
+{
+	FString PostParameters = "";
+
+	if (bSendOnlyChangedCharacterStats && bHasPersistedStats)
+	{
+		TSharedRef<FJsonObject> ChangedStats = MakeShared<FJsonObject>();
+		int32 NumberOfChangedStats = 0;
+
+		for (TFieldIterator<FProperty> It(FCharacterStats::StaticStruct()); It; ++It)
+		{
+			const FProperty* Property = *It;
+
+			//The backend needs these to find the character
+			const bool bAlwaysSent = Property->GetFName() == GET_MEMBER_NAME_CHECKED(FCharacterStats, CharName)
+				|| Property->GetFName() == GET_MEMBER_NAME_CHECKED(FCharacterStats, CustomerGUID);
+
+			if (!bAlwaysSent && Property->Identical_InContainer(&CurrentStats, &LastPersistedStats))
+			{
+				continue;
+			}
+
+			TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Property), Property->ContainerPtrToValuePtr<void>(&CurrentStats));
+			if (!Value.IsValid())
+			{
+				UE_LOG(OWS, Error, TEXT("UpdateCharacterStats Error serializing %s!"), *Property->GetName());
+				return;
+			}
+
+			//Same field names UStructToJsonObjectString writes
+			ChangedStats->SetField(FJsonObjectConverter::StandardizeCase(Property->GetAuthoredName()), Value);
+
+			if (!bAlwaysSent)
+			{
+				NumberOfChangedStats++;
+			}
+		}
+
+		if (NumberOfChangedStats == 0)
+		{
+			UE_LOG(OWS, Verbose, TEXT("UpdateCharacterStats: No stats changed since the last update"));
+			return;
+		}
+
+		TSharedRef<FJsonObject> UpdateCharacterStats = MakeShared<FJsonObject>();
+		UpdateCharacterStats->SetObjectField(FJsonObjectConverter::StandardizeCase(TEXT("UpdateCharacterStats")), ChangedStats);
+
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&PostParameters);
+		if (!FJsonSerializer::Serialize(UpdateCharacterStats, JsonWriter))
+		{
+			UE_LOG(OWS, Error, TEXT("UpdateCharacterStats Error serializing CharacterStats!"));
+			return;
+		}
+	}
+	else
+	{
+		FUpdateCharacterStatsJSONPost CharacterStats;
+		CharacterStats.UpdateCharacterStats = CurrentStats;
+
+		if (!FJsonObjectConverter::UStructToJsonObjectString(CharacterStats, PostParameters))
+		{
+			UE_LOG(OWS, Error, TEXT("UpdateCharacterStats Error serializing CharacterStats!"));
+			return;
+		}
+	}
+
+	PC->OWSPlayerControllerComponent->UpdateCharacterStats(PostParameters);
+
+	LastPersistedStats = CurrentStats;
+	bHasPersistedStats = true;
+}
+
+void AOWSCharacter::ResetPersistedCharacterStats()
+{
+	bHasPersistedStats = false;
+}
+
+void AOWSCharacter::OnCharacterStatsDropped(const FString& CharName)
+{
+	//The cache keys stats by the player state's name
+	if (GetPlayerState() && GetPlayerState()->GetPlayerName() == CharName)
+	{
+		ResetPersistedCharacterStats();
+	}
+}
+
 void AOWSCharacter::UpdateCharacterStatsBase()
 {
 	AOWSPlayerController* PC = Cast<AOWSPlayerController>(this->Controller);
@@ -347,16 +461,8 @@ void AOWSCharacter::UpdateCharacterStatsBase()
 		CharacterStats.UpdateCharacterStats.Acrobatics = Acrobatics;
 		CharacterStats.UpdateCharacterStats.Climb = Climb;
 		CharacterStats.UpdateCharacterStats.Stealth = Stealth;
-		
-		FString PostParameters = "";
-		if (FJsonObjectConverter::UStructToJsonObjectString(CharacterStats, PostParameters))
-		{
-			PC->OWSPlayerControllerComponent->UpdateCharacterStats(PostParameters);
-		}
-		else
-		{
-			UE_LOG(OWS, Error, TEXT("UpdateCharacterStats Error serializing CharacterStats!"));
-		}
+
+		SendCharacterStats(PC, CharacterStats.UpdateCharacterStats);
 	}
 
 	/*
@@ -898,8 +1004,6 @@ void AOWSCharacter::AddItemToInventory(FString InventoryName, FString ItemName,
 
 		UniqueItemGUID = FGuid::NewGuid();
 
-		Client_AddItemToInventory(FName(*InventoryName), ItemName, 1, InSlotNumber, NumberOfUsesLeft, Condition, "", UniqueItemGUID, 0);
-
 		TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
 		Request->OnProcessRequestComplete().BindUObject(this, &AOWSCharacter::OnAddItemToInventoryResponseReceived);
 		//This is the url on which to process the request
@@ -973,8 +1077,6 @@ void AOWSCharacter::AddItemToInventoryWithCustomData(FString InventoryName, FStr
 
 		UniqueItemGUID = FGuid::NewGuid();
 
-		Client_AddItemToInventory(FName(*InventoryName), ItemName, 1, InSlotNumber, NumberOfUsesLeft, Condition, CustomData, UniqueItemGUID, 0);
-
 		TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
 		Request->OnProcessRequestComplete().BindUObject(this, &AOWSCharacter::OnAddItemToInventoryWithCustomDataResponseReceived);
 		//This is the url on which to process the request
@@ -1518,81 +1620,54 @@ AOWSGameMode* AOWSCharacter::GetGameMode()
 //HUD Inventory System
 void AOWSCharacter::OnRep_InventoriesToManage()
 {
-	if (InventoriesToManage.Num() < 1)
-	{
-		UE_LOG(OWS, Error, TEXT("OnRep_InventoriesToManage.Num() < 1"));
-		return;
-	}
-
-	if (InventoriesToManage[0])
+	for (UOWSInventory* Inventory : InventoriesToManage)
 	{
-		UE_LOG(OWS, Error, TEXT("OnRep_InventoriesToManage First Entry is Valid!"));
-		return;
+		if (Inventory)
+		{
+			Inventory->SetOwningPlayerCharacter(this);
+		}
 	}
-
-	UE_LOG(OWS, Error, TEXT("OnRep_InventoriesToManage"));
 }
 
-UOWSInventory* AOWSCharacter::CreateHUDInventory(FName InventoryName, int32 Size, int32 NumberOfColumns)
+bool AOWSCharacter::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
 {
-	if (GetLocalRole() == ROLE_Authority)
+	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+
+	//Inventories are only sent to the owning client
+	if (RepFlags->bNetOwner)
 	{
-		UOWSInventory* Inventory = NewObject<UOWSInventory>();
-		Inventory->SetInventoryName(InventoryName);
-		Inventory->SetInventorySize(Size, NumberOfColumns);
-		Inventory->SetOwningPlayerCharacter(this);
-		InventoriesToManage.Add(Inventory);
-		Client_CreateHUDInventory(InventoryName, Size, NumberOfColumns);
-		return Inventory;
+		for (UOWSInventory* Inventory : InventoriesToManage)
+		{
+			if (IsValid(Inventory))
+			{
+				bWroteSomething |= Channel->ReplicateSubobject(Inventory, *Bunch, *RepFlags);
+			}
+		}
 	}
 
-	return nullptr;
+	return bWroteSomething;
 }
 
-void AOWSCharacter::Client_CreateHUDInventory_Implementation(FName InventoryName, int32 Size, int32 NumberOfColumns)
+UOWSInventory* AOWSCharacter::CreateHUDInventory(FName InventoryName, int32 Size, int32 NumberOfColumns)
 {
-	if (GetLocalRole() != ROLE_Authority)
+	if (GetLocalRole() == ROLE_Authority)
 	{
-		UOWSInventory* Inventory = NewObject<UOWSInventory>();
+		//Outered to the character so it can replicate to the owning client as a subobject
+		UOWSInventory* Inventory = NewObject<UOWSInventory>(this);
 		Inventory->SetInventoryName(InventoryName);
 		Inventory->SetInventorySize(Size, NumberOfColumns);
 		Inventory->SetOwningPlayerCharacter(this);
 		InventoriesToManage.Add(Inventory);
-	}
-}
-
-void AOWSCharacter::Client_AddItemToInventory_Implementation(const FName& InventoryName, const FString& ItemName, const int32 StackSize, const int32 InSlotNumber, const int32 NumberOfUsesLeft, const int32 Condition,
-	const FString& PerInstanceCustomData, const FGuid UniqueItemGUID, const int32 ItemMeshID)
-{
-	AOWSInventoryItem* Item = NewObject<AOWSInventoryItem>();
-	Item->ItemName = ItemName;
-	Item->StackSize = StackSize;
-	Item->NumberOfUsesLeft = NumberOfUsesLeft;
-	Item->Condition = Condition;
-	Item->PerInstanceCustomData = PerInstanceCustomData;
-	Item->UniqueItemGUID = UniqueItemGUID;
-	Item->ItemMeshID = ItemMeshID;
-
-	auto FoundEntry = LocalInventoryItems.FindByPredicate([&](FInventoryItemStruct& InItem)
-	{
-		return InItem.ItemName == ItemName;
-	});
 
-	if (FoundEntry)
-	{
-		AOWSPlayerController* PlayerController = Cast<AOWSPlayerController>(GetController());
+		if (IsUsingRegisteredSubObjectList())
+		{
+			AddReplicatedSubObject(Inventory, COND_OwnerOnly);
+		}
 
-		Item->IconTexture = PlayerController->LoadTextureReference(FoundEntry->TextureToUseForIcon);
-		Item->IconSlotWidth = FoundEntry->IconSlotWidth;
-		Item->IconSlotHeight = FoundEntry->IconSlotHeight;
+		return Inventory;
 	}
 
-	UOWSInventory* FoundInventory = GetHUDInventoryFromName(InventoryName);
-
-	if (FoundInventory)
-	{
-		FoundInventory->AddItemToSlot_Internal(Item, InSlotNumber);
-	}
+	return nullptr;
 }
 
 bool AOWSCharacter::AddItemToLocalInventoryItems(const FString& ItemName, const bool ItemCanStack, const bool IsUsable, const bool IsConsumedOnUse, const int32 ItemTypeID,
@@ -1681,6 +1756,104 @@ UOWSInventory* AOWSCharacter::GetHUDInventoryFromName(FName InventoryName)
 	}
 }
 
+bool AOWSCharacter::Server_SwapSlots_Validate(FName InventoryName, int32 SlotA, int32 SlotB)
+{
+	return SlotA >= 0 && SlotB >= 0;
+}
+
+void AOWSCharacter::Server_SwapSlots_Implementation(FName InventoryName, int32 SlotA, int32 SlotB)
+{
+	UOWSInventory* Inventory = GetHUDInventoryFromName(InventoryName);
+
+	if (!Inventory || SlotA == SlotB)
+		return;
+
+	Inventory->SwapSlots(SlotA, SlotB);
+	SerializeAndSaveInventory(InventoryName);
+}
+
+bool AOWSCharacter::Server_MoveStack_Validate(FName FromInventoryName, int32 FromSlot, FName ToInventoryName, int32 ToSlot)
+{
+	return FromSlot >= 0 && ToSlot >= 0;
+}
+
+void AOWSCharacter::Server_MoveStack_Implementation(FName FromInventoryName, int32 FromSlot, FName ToInventoryName, int32 ToSlot)
+{
+	UOWSInventory* SourceInventory = GetHUDInventoryFromName(FromInventoryName);
+	UOWSInventory* DestInventory = GetHUDInventoryFromName(ToInventoryName);
+
+	if (!SourceInventory || !DestInventory || (SourceInventory == DestInventory && FromSlot == ToSlot))
+		return;
+
+	UOWSInventoryItemStack* InventoryItemStackSource = SourceInventory->GetStackInSlot(FromSlot);
+	UOWSInventoryItemStack* InventoryItemStackDest = DestInventory->GetStackInSlot(ToSlot);
+
+	if (!InventoryItemStackSource || !InventoryItemStackDest)
+		return;
+
+	AOWSInventoryItem* SourceItem = InventoryItemStackSource->GetTopItemFromStack();
+
+	//Nothing to move out of an empty slot
+	if (!SourceItem)
+		return;
+
+	if (SourceInventory == DestInventory)
+	{
+		AOWSInventoryItem* DestItem = InventoryItemStackDest->GetTopItemFromStack();
+		if (DestItem
+			&& SourceItem->UniqueItemGUID == DestItem->UniqueItemGUID
+			&& SourceItem->CanStack
+			&& InventoryItemStackDest->InventoryItems.Num() < DestItem->StackSize)
+		{
+			InventoryItemStackDest->AddToStack(InventoryItemStackSource);
+			SourceInventory->RemoveStackFromSlot(FromSlot);
+		}
+		else
+		{
+			DestInventory->SwapSlots(ToSlot, FromSlot);
+		}
+	}
+	else
+	{
+		SourceInventory->AddStackToSlot(InventoryItemStackDest, FromSlot);
+		DestInventory->AddStackToSlot(InventoryItemStackSource, ToSlot);
+		SerializeAndSaveInventory(FromInventoryName);
+	}
+
+	SerializeAndSaveInventory(ToInventoryName);
+}
+
+bool AOWSCharacter::Server_SplitStack_Validate(FName InventoryName, int32 Slot)
+{
+	return Slot >= 0;
+}
+
+void AOWSCharacter::Server_SplitStack_Implementation(FName InventoryName, int32 Slot)
+{
+	UOWSInventory* Inventory = GetHUDInventoryFromName(InventoryName);
+
+	//Splitting needs at least two items in the stack
+	if (!Inventory || Inventory->GetItemCountInSlot(Slot) < 2)
+		return;
+
+	UOWSInventoryItemStack* InventoryItemStack = Inventory->GetStackInSlot(Slot);
+	AOWSInventoryItem* TopItem = InventoryItemStack ? InventoryItemStack->GetTopItemFromStack() : nullptr;
+
+	if (!TopItem)
+		return;
+
+	int32 EmptySlot = Inventory->FindFirstEmptySlotToFitItemOfSize(TopItem->IconSlotWidth, TopItem->IconSlotHeight);
+	if (EmptySlot == -1)
+		return;
+
+	AOWSInventoryItem* SplitItem = InventoryItemStack->RemoveFromTopOfStack();
+	if (SplitItem)
+	{
+		Inventory->AddItemToSlot(SplitItem, EmptySlot);
+		SerializeAndSaveInventory(InventoryName);
+	}
+}
+
 
 FString AOWSCharacter::SerializeInventory(FName InventoryName)
 {
@@ -1690,15 +1863,14 @@ FString AOWSCharacter::SerializeInventory(FName InventoryName)
 
 	if (InventoryToSerialize)
 	{
-		//Loop through the ItemStacks and serialize them to a string
-		for (auto ItemStack : InventoryToSerialize->InventoryItemStacks)
+		//Loop through the slots and serialize them to a string
+		const FOWSInventorySlots& Slots = InventoryToSerialize->GetSlots();
+		for (int32 Slot = 0; Slot < Slots.Num(); Slot++)
 		{
-			AOWSInventoryItem* InventoryItem = ItemStack->GetTopItemFromStack();
-
 			//Only save valid items
-			if (InventoryItem)
+			if (Slots.IsFilled(Slot))
 			{
-				output += InventoryItem->UniqueItemGUID.ToString() + "*" + FString::FromInt(ItemStack->SlotNumber) + "*" + FString::FromInt(ItemStack->InventoryItems.Num()) + "*" + FString::FromInt(InventoryItem->NumberOfUsesLeft) + "*" + FString::FromInt(InventoryItem->Condition);
+				output += Slots.UniqueItemGUIDs[Slot].ToString() + "*" + FString::FromInt(Slot) + "*" + FString::FromInt(Slots.Counts[Slot]) + "*" + FString::FromInt(Slots.NumberOfUsesLeft[Slot]) + "*" + FString::FromInt(Slots.Conditions[Slot]);
 				output += "|";
 			}
 		}
@@ -1720,6 +1892,7 @@ void AOWSCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & Out
 
 	// Replicate to everyone
 	DOREPLIFETIME(AOWSCharacter, CharacterName);
+	DOREPLIFETIME_CONDITION(AOWSCharacter, InventoriesToManage, COND_OwnerOnly);
 	DOREPLIFETIME(AOWSCharacter, ClassName);	
 	DOREPLIFETIME(AOWSCharacter, Gender);
 	DOREPLIFETIME(AOWSCharacter, IsEnemy);
@@ -6,6 +6,7 @@
 #include "DrawDebugHelpers.h"
 #include "Kismet/GameplayStaticsTypes.h"
 #include "Kismet/GameplayStatics.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
 
 UOWSCharacterMovementComponent::UOWSCharacterMovementComponent(const class FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -15,6 +16,8 @@ UOWSCharacterMovementComponent::UOWSCharacterMovementComponent(const class FObje
 	bIsClimbing = false;
 	bIsExitingClimb = false;
 
+	bUseAsyncClimbingChecks = false;
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSAsyncClimbingChecks"), bUseAsyncClimbingChecks, GGameIni);
 }
 
 
@@ -123,6 +126,9 @@ void UOWSCharacterMovementComponent::OnMovementUpdated(float DeltaTime, const FV
 
 		StopActiveMovement();
 
+		//A wall check left over from an earlier climb says nothing about this wall
+		ResetClimbingWallCheck();
+
 		SetMovementMode(MOVE_Custom);
 		bIsClimbing = true;
 		bOrientRotationToMovement = false;
@@ -560,7 +566,16 @@ bool UOWSCharacterMovementComponent::CheckForExitToClimbing(FVector CheckPoint,
 	InitCollisionParams(CapsuleParams, ResponseParam);
 	FCollisionShape CapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_None);
 	const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
-	bool bHit = GetWorld()->SweepSingleByChannel(HitInfo, UpdatedComponent->GetComponentLocation(), CheckPoint, FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+
+	bool bHit = false;
+	if (bUseAsyncClimbingChecks && CanUseAsyncClimbingChecks())
+	{
+		bHit = AsyncClimbingWallCheck(UpdatedComponent->GetComponentLocation(), CheckPoint, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+	}
+	else
+	{
+		bHit = GetWorld()->SweepSingleByChannel(HitInfo, UpdatedComponent->GetComponentLocation(), CheckPoint, FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+	}
 
 	//DrawDebugLine(GetWorld(), UpdatedComponent->GetComponentLocation(), CheckPoint, FColor(255, 0, 0), false, -1, 0, 12.333);
 
@@ -574,6 +589,56 @@ bool UOWSCharacterMovementComponent::CheckForExitToClimbing(FVector CheckPoint,
 }
 
 
+bool UOWSCharacterMovementComponent::CanUseAsyncClimbingChecks() const
+{
+	//A client predicts its own moves and the server replays them, so both have to see the same sweep on the same move
+	return CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() != ROLE_AutonomousProxy;
+}
+
+bool UOWSCharacterMovementComponent::AsyncClimbingWallCheck(const FVector& Start, const FVector& End, ECollisionChannel CollisionChannel, const FCollisionShape& CapsuleShape,
+	const FCollisionQueryParams& CapsuleParams, const FCollisionResponseParams& ResponseParam)
+{
+	UWorld* World = GetWorld();
+
+	FTraceDatum TraceDatum;
+	if (ClimbingWallSweep.IsValid() && World->QueryTraceData(ClimbingWallSweep, TraceDatum))
+	{
+		bClimbingWallHit = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) != nullptr;
+		bHasClimbingWallResult = true;
+		ClimbingWallSweep = FTraceHandle();
+	}
+	else if (ClimbingWallSweep.IsValid() && !World->IsTraceHandleValid(ClimbingWallSweep, false))
+	{
+		//Too old to read back
+		ClimbingWallSweep = FTraceHandle();
+	}
+
+	//PhysCustomClimb can run several times a frame, one sweep a frame is enough
+	if (!ClimbingWallSweep.IsValid() && ClimbingWallSweepFrame != GFrameCounter)
+	{
+		ClimbingWallSweepFrame = GFrameCounter;
+		ClimbingWallSweep = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+	}
+
+	//Nothing back yet on the first check of a climb
+	if (!bHasClimbingWallResult)
+	{
+		FHitResult HitInfo(1.f);
+		bClimbingWallHit = World->SweepSingleByChannel(HitInfo, Start, End, FQuat::Identity, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+		bHasClimbingWallResult = true;
+	}
+
+	return bClimbingWallHit;
+}
+
+void UOWSCharacterMovementComponent::ResetClimbingWallCheck()
+{
+	ClimbingWallSweep = FTraceHandle();
+	bHasClimbingWallResult = false;
+	bClimbingWallHit = false;
+}
+
+
 void UOWSCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations)
 {
 	Super::ProcessLanded(Hit, remainingTime, Iterations);
@@ -673,8 +738,38 @@ void UOWSCharacterMovementComponent::SetClimbing(bool bClimbing, FRotator newRot
 
 
 //Animation Distance Matching
+void UOWSCharacterMovementComponent::BeginPredictionFrame()
+{
+	if (PredictionFrame != GFrameCounter)
+	{
+		PredictionFrame = GFrameCounter;
+		JumpApexPredictions.Reset();
+		StoppingDistancePredictions.Reset();
+	}
+}
+
 void UOWSCharacterMovementComponent::PredictJumpApex(const FVector& CharacterLocation, FVector& outApexLocation, FVector& outLandLocation, float& outTimeToApex, bool Debug)
 {
+	BeginPredictionFrame();
+
+	//AI asks for the same jump from several places in a frame, the path prediction traces every step
+	if (!Debug)
+	{
+		for (const FJumpApexPrediction& Prediction : JumpApexPredictions)
+		{
+			if (Prediction.CharacterLocation == CharacterLocation && Prediction.Velocity == Velocity)
+			{
+				outApexLocation = Prediction.ApexLocation;
+				outTimeToApex = Prediction.TimeToApex;
+				if (Prediction.bLands)
+				{
+					outLandLocation = Prediction.LandLocation;
+				}
+				return;
+			}
+		}
+	}
+
 	const float Gravity = GetGravityZ();
 	float height = GetMaxJumpHeight();
 	outTimeToApex = JumpZVelocity / Gravity * -1;
@@ -701,10 +796,30 @@ void UOWSCharacterMovementComponent::PredictJumpApex(const FVector& CharacterLoc
 
 	if (Debug) DrawDebugSphere(GetWorld(), outApexLocation, 20, 26, FColor::Blue, true);
 
+	FJumpApexPrediction& Prediction = JumpApexPredictions.AddDefaulted_GetRef();
+	Prediction.CharacterLocation = CharacterLocation;
+	Prediction.Velocity = Velocity;
+	Prediction.ApexLocation = outApexLocation;
+	Prediction.LandLocation = OutResults.HitResult.Location;
+	Prediction.TimeToApex = outTimeToApex;
+	Prediction.bLands = bhit;
 }
 
 FVector UOWSCharacterMovementComponent::GetStoppingDistance(const FVector& CharacterLocation, float Local_WorldDeltaSecond, bool Debug)
 {
+	BeginPredictionFrame();
+
+	if (!Debug)
+	{
+		for (const FStoppingDistancePrediction& Prediction : StoppingDistancePredictions)
+		{
+			if (Prediction.CharacterLocation == CharacterLocation && Prediction.Velocity == Velocity && Prediction.DeltaSeconds == Local_WorldDeltaSecond)
+			{
+				return Prediction.StopLocation;
+			}
+		}
+	}
+
 	if (Debug) DrawDebugSphere(GetWorld(), CharacterLocation, 20, 26, FColor::Green, true);
 
 	// Small number break loop when velocity is less than this value
@@ -744,5 +859,11 @@ FVector UOWSCharacterMovementComponent::GetStoppingDistance(const FVector& Chara
 	// return stopping distance from player position in previous frame
 	if (Debug) DrawDebugSphere(GetWorld(), CharacterLocation + CurrentVelocityDirection * StoppingDistance, 20, 26, FColor::Red, true);
 
-	return CharacterLocation + CurrentVelocityDirection * StoppingDistance;
+	FStoppingDistancePrediction& Prediction = StoppingDistancePredictions.AddDefaulted_GetRef();
+	Prediction.CharacterLocation = CharacterLocation;
+	Prediction.Velocity = Velocity;
+	Prediction.DeltaSeconds = Local_WorldDeltaSecond;
+	Prediction.StopLocation = CharacterLocation + CurrentVelocityDirection * StoppingDistance;
+
+	return Prediction.StopLocation;
 }
\ No newline at end of file
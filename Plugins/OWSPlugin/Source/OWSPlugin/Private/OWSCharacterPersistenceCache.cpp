@@ -0,0 +1,543 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSCharacterPersistenceCache.h"
+#include "OWS2API.h"
+#include "JsonObjectConverter.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "OWSDebugCommands.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSCharacterPersistenceCache> GOWSPersistenceStatsCmd(
+	TEXT("OWS.Persistence.Stats"),
+	TEXT("Dumps pending and flushed write counters of the character persistence cache.  Pass reset to clear them or flush to save everything now."),
+	[](UOWSCharacterPersistenceCache& Cache, const FString& Arg)
+	{
+		if (Arg == TEXT("flush"))
+		{
+			Cache.FlushAll();
+		}
+	});
+
+void UOWSCharacterPersistenceCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Collection.InitializeDependency<UOWSTransportSubsystem>();
+
+	//Optional tuning, the defaults above are used when these are missing from DefaultGame.ini
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSPersistenceFlushInterval"), FlushInterval, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSPersistenceMaxWritesPerFlush"), MaxWritesPerFlush, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSPersistenceMaxFlushAttempts"), MaxFlushAttempts, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSPersistenceFinalFlushTimeout"), FinalFlushTimeout, GGameIni);
+}
+
+void UOWSCharacterPersistenceCache::Deinitialize()
+{
+	//Last chance to save.  Normally the game mode has already flushed in EndPlay and there is nothing left.
+	if (DirtyCharacters.Num() > 0 || NumInFlight > 0)
+	{
+		UE_LOG(OWS, Log, TEXT("OWS Persistence - Final flush of %d characters (%lld bytes)"), Stats.DirtyCharacters, Stats.PendingBytes);
+		FlushAll(true);
+	}
+
+	if (Stats.PendingWrites > 0 || NumInFlight > 0)
+	{
+		UE_LOG(OWS, Error, TEXT("OWS Persistence - Shutting down with %d unsaved writes and %d requests still in flight!"), Stats.PendingWrites, NumInFlight);
+	}
+
+	if (UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().ClearTimer(FlushTimerHandle);
+	}
+
+	DirtyCharacters.Empty();
+	InFlightFields.Empty();
+	FlushWaiters.Empty();
+}
+
+FString UOWSCharacterPersistenceCache::GetFieldKey(EPendingWriteType Type, const FString& Key)
+{
+	switch (Type)
+	{
+	case EPendingWriteType::Stats:
+		//Partial stats updates are merged under the one stats field per character
+		return TEXT("Stats");
+	case EPendingWriteType::CustomData:
+		return TEXT("Custom:") + Key;
+	default:
+		return TEXT("Ability:") + Key;
+	}
+}
+
+void UOWSCharacterPersistenceCache::QueueCharacterStats(const FString& CharName, const FString& JSONString)
+{
+	FPendingWrite Write;
+	Write.Type = EPendingWriteType::Stats;
+	Write.Value = JSONString;
+
+	//A partial update only carries the stats that changed, so it is merged into the unsaved update instead of replacing it
+	if (const FDirtyCharacter* DirtyCharacter = DirtyCharacters.Find(CharName))
+	{
+		if (const FPendingWrite* Existing = DirtyCharacter->Writes.Find(GetFieldKey(EPendingWriteType::Stats, FString())))
+		{
+			Write.Value = MergeCharacterStats(Existing->Value, JSONString);
+		}
+	}
+
+	QueueWrite(CharName, MoveTemp(Write));
+}
+
+FString UOWSCharacterPersistenceCache::MergeCharacterStats(const FString& OlderJSON, const FString& NewerJSON)
+{
+	TSharedPtr<FJsonObject> Older;
+	TSharedPtr<FJsonObject> Newer;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(OlderJSON), Older) || !Older.IsValid()
+		|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(NewerJSON), Newer) || !Newer.IsValid())
+	{
+		return NewerJSON;
+	}
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Newer->Values)
+	{
+		const TSharedPtr<FJsonObject>* OlderStats = nullptr;
+		const TSharedPtr<FJsonObject>* NewerStats = nullptr;
+		if (Older->TryGetObjectField(Field.Key, OlderStats) && Field.Value->TryGetObject(NewerStats))
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Stat : (*NewerStats)->Values)
+			{
+				(*OlderStats)->SetField(Stat.Key, Stat.Value);
+			}
+		}
+		else
+		{
+			Older->SetField(Field.Key, Field.Value);
+		}
+	}
+
+	FString MergedJSON;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&MergedJSON);
+	if (!FJsonSerializer::Serialize(Older.ToSharedRef(), JsonWriter))
+	{
+		return NewerJSON;
+	}
+
+	return MergedJSON;
+}
+
+void UOWSCharacterPersistenceCache::QueueCustomCharacterData(const FString& CharName, const FString& CustomFieldName, const FString& CustomValue)
+{
+	FPendingWrite Write;
+	Write.Type = EPendingWriteType::CustomData;
+	Write.Key = CustomFieldName;
+	Write.Value = CustomValue;
+	QueueWrite(CharName, MoveTemp(Write));
+}
+
+void UOWSCharacterPersistenceCache::QueueAbility(const FString& CharName, const FString& AbilityName, int32 AbilityLevel, const FString& CustomJSON, bool bAddAbility)
+{
+	FPendingWrite Write;
+	Write.Type = bAddAbility ? EPendingWriteType::AddAbility : EPendingWriteType::UpdateAbility;
+	Write.Key = AbilityName;
+	Write.Value = CustomJSON;
+	Write.AbilityLevel = AbilityLevel;
+	QueueWrite(CharName, MoveTemp(Write));
+}
+
+void UOWSCharacterPersistenceCache::QueueWrite(const FString& CharName, FPendingWrite&& Write)
+{
+	FDirtyCharacter& DirtyCharacter = DirtyCharacters.FindOrAdd(CharName);
+	if (DirtyCharacter.Writes.Num() == 0)
+	{
+		DirtyCharacter.FirstDirtyTime = FPlatformTime::Seconds();
+	}
+
+	const FString FieldKey = GetFieldKey(Write.Type, Write.Key);
+	Stats.WritesQueued++;
+
+	if (FPendingWrite* Existing = DirtyCharacter.Writes.Find(FieldKey))
+	{
+		//The backend has not seen the add yet, so the update has to stay an add
+		if (Existing->Type == EPendingWriteType::AddAbility && Write.Type == EPendingWriteType::UpdateAbility)
+		{
+			Write.Type = EPendingWriteType::AddAbility;
+		}
+
+		UpdatePendingStats(Write.GetPayloadSize() - Existing->GetPayloadSize(), 0);
+		*Existing = MoveTemp(Write);
+		Stats.WritesCoalesced++;
+	}
+	else
+	{
+		UpdatePendingStats(Write.GetPayloadSize(), 1);
+		DirtyCharacter.Writes.Add(FieldKey, MoveTemp(Write));
+	}
+
+	Stats.DirtyCharacters = DirtyCharacters.Num();
+	EnsureFlushTimer();
+}
+
+void UOWSCharacterPersistenceCache::DiscardAbility(const FString& CharName, const FString& AbilityName)
+{
+	FDirtyCharacter* DirtyCharacter = DirtyCharacters.Find(CharName);
+	if (!DirtyCharacter)
+	{
+		return;
+	}
+
+	FPendingWrite Removed;
+	if (DirtyCharacter->Writes.RemoveAndCopyValue(GetFieldKey(EPendingWriteType::UpdateAbility, AbilityName), Removed))
+	{
+		UpdatePendingStats(-Removed.GetPayloadSize(), -1);
+	}
+
+	if (DirtyCharacter->Writes.Num() == 0)
+	{
+		DirtyCharacters.Remove(CharName);
+		Stats.DirtyCharacters = DirtyCharacters.Num();
+	}
+}
+
+bool UOWSCharacterPersistenceCache::HasPendingWrites(const FString& CharName) const
+{
+	return DirtyCharacters.Contains(CharName) || InFlightFields.Contains(CharName);
+}
+
+void UOWSCharacterPersistenceCache::FlushCharacter(const FString& CharName, FSimpleDelegate OnFlushed)
+{
+	SendDirtyWrites(CharName, MAX_int32);
+
+	//Writes held back behind an in flight request are sent from OnWriteResponseReceived while someone is waiting
+	if (InFlightFields.Contains(CharName))
+	{
+		if (OnFlushed.IsBound())
+		{
+			FlushWaiters.FindOrAdd(CharName).Add(MoveTemp(OnFlushed));
+		}
+	}
+	else
+	{
+		OnFlushed.ExecuteIfBound();
+	}
+}
+
+void UOWSCharacterPersistenceCache::SendAfterFlush(const FString& CharName, const FOWSEndpoint& Endpoint, const FString& PostParameters, FOWSTransportRequestCompleteDelegate OnComplete)
+{
+	//Endpoints are static, so holding on to one until the flush completes is safe
+	const FOWSEndpoint* EndpointToCall = &Endpoint;
+	FlushCharacter(CharName, FSimpleDelegate::CreateWeakLambda(this, [this, EndpointToCall, PostParameters, OnComplete]()
+	{
+		UGameInstance* GameInstance = GetGameInstance();
+		UOWSTransportSubsystem* Transport = GameInstance ? GameInstance->GetSubsystem<UOWSTransportSubsystem>() : nullptr;
+
+		if (!Transport)
+		{
+			OnComplete.ExecuteIfBound(nullptr, nullptr, false);
+			return;
+		}
+
+		Transport->ProcessOWS2Request(*EndpointToCall, PostParameters, 0.f, OnComplete);
+	}));
+}
+
+void UOWSCharacterPersistenceCache::FlushAll(bool bWaitForCompletion)
+{
+	TArray<FString> CharNames;
+	DirtyCharacters.GetKeys(CharNames);
+	for (const FString& CharName : CharNames)
+	{
+		SendDirtyWrites(CharName, MAX_int32);
+	}
+
+	if (!bWaitForCompletion)
+	{
+		return;
+	}
+
+	//There may be no world ticking any more, so pump the HTTP manager ourselves the same way FHttpManager::Flush does
+	const double Deadline = FPlatformTime::Seconds() + FinalFlushTimeout;
+	double LastTime = FPlatformTime::Seconds();
+	bWaitingForFinalFlush = true;
+	while (NumInFlight > 0 && FPlatformTime::Seconds() < Deadline)
+	{
+		const double Now = FPlatformTime::Seconds();
+		FHttpModule::Get().GetHttpManager().Tick((float)(Now - LastTime));
+		LastTime = Now;
+		FPlatformProcess::Sleep(0.01f);
+	}
+	bWaitingForFinalFlush = false;
+
+	if (NumInFlight > 0)
+	{
+		UE_LOG(OWS, Error, TEXT("OWS Persistence - Final flush timed out after %f seconds with %d requests still in flight!"), FinalFlushTimeout, NumInFlight);
+	}
+}
+
+void UOWSCharacterPersistenceCache::OnFlushTimer()
+{
+	if (DirtyCharacters.Num() == 0)
+	{
+		return;
+	}
+
+	//Oldest unsaved data first so a capped flush cannot starve anyone
+	TArray<TPair<double, FString>> FlushOrder;
+	FlushOrder.Reserve(DirtyCharacters.Num());
+	for (const TPair<FString, FDirtyCharacter>& Entry : DirtyCharacters)
+	{
+		FlushOrder.Emplace(Entry.Value.FirstDirtyTime, Entry.Key);
+	}
+	FlushOrder.Sort([](const TPair<double, FString>& A, const TPair<double, FString>& B) { return A.Key < B.Key; });
+
+	int32 WritesLeft = MaxWritesPerFlush;
+	for (const TPair<double, FString>& Entry : FlushOrder)
+	{
+		if (WritesLeft <= 0)
+		{
+			break;
+		}
+
+		WritesLeft -= SendDirtyWrites(Entry.Value, WritesLeft);
+	}
+}
+
+void UOWSCharacterPersistenceCache::EnsureFlushTimer()
+{
+	UGameInstance* GameInstance = GetGameInstance();
+	if (!GameInstance || FlushTimerHandle.IsValid())
+	{
+		return;
+	}
+
+	GameInstance->GetTimerManager().SetTimer(FlushTimerHandle, this, &UOWSCharacterPersistenceCache::OnFlushTimer, FlushInterval, true);
+}
+
+int32 UOWSCharacterPersistenceCache::SendDirtyWrites(const FString& CharName, int32 MaxWrites)
+{
+	FDirtyCharacter* DirtyCharacter = DirtyCharacters.Find(CharName);
+	if (!DirtyCharacter)
+	{
+		return 0;
+	}
+
+	//Take the writes out before sending, a failed request puts its write back into DirtyCharacters.  A field that still has a
+	//request in flight stays dirty, so an older value can never land after a newer one.
+	const TSet<FString>* CharacterInFlight = InFlightFields.Find(CharName);
+	TArray<TPair<FString, FPendingWrite>> WritesToSend;
+	for (auto It = DirtyCharacter->Writes.CreateIterator(); It && WritesToSend.Num() < MaxWrites; ++It)
+	{
+		if (CharacterInFlight && CharacterInFlight->Contains(It.Key()))
+		{
+			continue;
+		}
+
+		WritesToSend.Emplace(It.Key(), MoveTemp(It.Value()));
+		It.RemoveCurrent();
+	}
+
+	if (DirtyCharacter->Writes.Num() == 0)
+	{
+		DirtyCharacters.Remove(CharName);
+		Stats.DirtyCharacters = DirtyCharacters.Num();
+	}
+
+	for (const TPair<FString, FPendingWrite>& Entry : WritesToSend)
+	{
+		UpdatePendingStats(-Entry.Value.GetPayloadSize(), -1);
+		SendWrite(CharName, Entry.Key, Entry.Value);
+	}
+
+	return WritesToSend.Num();
+}
+
+void UOWSCharacterPersistenceCache::SendWrite(const FString& CharName, const FString& FieldKey, const FPendingWrite& Write)
+{
+	const FOWSEndpoint* Endpoint = nullptr;
+	FString PostParameters;
+	bool bSerialized = false;
+
+	switch (Write.Type)
+	{
+	case EPendingWriteType::Stats:
+		Endpoint = &OWSEndpoints::UpdateCharacterStats;
+		bSerialized = OWSEndpoints::UpdateCharacterStats.SerializeRequest(Write.Value, PostParameters);
+		break;
+	case EPendingWriteType::CustomData:
+	{
+		FAddOrUpdateCustomCharacterDataJSONPost AddOrUpdateCustomCharacterDataJSONPost;
+		AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.CharacterName = CharName;
+		AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.CustomFieldName = Write.Key;
+		AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.FieldValue = Write.Value;
+		Endpoint = &OWSEndpoints::AddOrUpdateCustomCharacterData;
+		bSerialized = OWSEndpoints::AddOrUpdateCustomCharacterData.SerializeRequest(AddOrUpdateCustomCharacterDataJSONPost, PostParameters);
+		break;
+	}
+	case EPendingWriteType::AddAbility:
+	{
+		FAddAbilityToCharacterJSONPost AddAbilityToCharacterJSONPost;
+		AddAbilityToCharacterJSONPost.CharacterName = CharName;
+		AddAbilityToCharacterJSONPost.AbilityName = Write.Key;
+		AddAbilityToCharacterJSONPost.AbilityLevel = Write.AbilityLevel;
+		AddAbilityToCharacterJSONPost.CharHasAbilitiesCustomJSON = Write.Value;
+		Endpoint = &OWSEndpoints::AddAbilityToCharacter;
+		bSerialized = OWSEndpoints::AddAbilityToCharacter.SerializeRequest(AddAbilityToCharacterJSONPost, PostParameters);
+		break;
+	}
+	case EPendingWriteType::UpdateAbility:
+	{
+		FUpdateAbilityOnCharacterJSONPost UpdateAbilityOnCharacterJSONPost;
+		UpdateAbilityOnCharacterJSONPost.CharacterName = CharName;
+		UpdateAbilityOnCharacterJSONPost.AbilityName = Write.Key;
+		UpdateAbilityOnCharacterJSONPost.AbilityLevel = Write.AbilityLevel;
+		UpdateAbilityOnCharacterJSONPost.CharHasAbilitiesCustomJSON = Write.Value;
+		Endpoint = &OWSEndpoints::UpdateAbilityOnCharacter;
+		bSerialized = OWSEndpoints::UpdateAbilityOnCharacter.SerializeRequest(UpdateAbilityOnCharacterJSONPost, PostParameters);
+		break;
+	}
+	}
+
+	UGameInstance* GameInstance = GetGameInstance();
+	UOWSTransportSubsystem* Transport = GameInstance ? GameInstance->GetSubsystem<UOWSTransportSubsystem>() : nullptr;
+
+	if (!bSerialized || !Endpoint || !Transport)
+	{
+		UE_LOG(OWS, Error, TEXT("OWS Persistence - Unable to send %s for %s!"), *FieldKey, *CharName);
+		DropWrite(CharName, FieldKey, Write);
+		return;
+	}
+
+	InFlightFields.FindOrAdd(CharName).Add(FieldKey);
+	NumInFlight++;
+	Stats.RequestsSent++;
+	Stats.BytesFlushed += PostParameters.Len();
+
+	Transport->ProcessOWS2Request(*Endpoint, PostParameters, 0.f,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSCharacterPersistenceCache::OnWriteResponseReceived, CharName, FieldKey, Write));
+}
+
+void UOWSCharacterPersistenceCache::OnWriteResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CharName, FString FieldKey, FPendingWrite Write)
+{
+	NumInFlight = FMath::Max(0, NumInFlight - 1);
+
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		Stats.RequestsFailed++;
+		Write.Attempts++;
+
+		FDirtyCharacter* DirtyCharacter = DirtyCharacters.Find(CharName);
+		FPendingWrite* Pending = DirtyCharacter ? DirtyCharacter->Writes.Find(FieldKey) : nullptr;
+		if (Pending && Write.Type == EPendingWriteType::Stats)
+		{
+			//A partial stats update only carries its own changes, so the failed fields are kept under the newer ones
+			UE_LOG(OWS, Verbose, TEXT("OWS Persistence - %s for %s failed, merged into the pending update"), *FieldKey, *CharName);
+			const int64 OldPayloadSize = Pending->GetPayloadSize();
+			Pending->Value = MergeCharacterStats(Write.Value, Pending->Value);
+			UpdatePendingStats(Pending->GetPayloadSize() - OldPayloadSize, 0);
+		}
+		//A newer value for the same field supersedes the one that failed
+		else if (Pending)
+		{
+			UE_LOG(OWS, Verbose, TEXT("OWS Persistence - %s for %s failed, a newer value is already pending"), *FieldKey, *CharName);
+
+			//The backend never got the add, so the pending update has to become one
+			if (Write.Type == EPendingWriteType::AddAbility && Pending->Type == EPendingWriteType::UpdateAbility)
+			{
+				Pending->Type = EPendingWriteType::AddAbility;
+			}
+		}
+		else if (Write.Attempts >= MaxFlushAttempts)
+		{
+			UE_LOG(OWS, Error, TEXT("OWS Persistence - Giving up on %s for %s after %d attempts!"), *FieldKey, *CharName, Write.Attempts);
+			DropWrite(CharName, FieldKey, Write);
+		}
+		else
+		{
+			UE_LOG(OWS, Warning, TEXT("OWS Persistence - %s for %s failed, it will be retried on the next flush"), *FieldKey, *CharName);
+			FDirtyCharacter& Retry = DirtyCharacters.FindOrAdd(CharName);
+			if (Retry.Writes.Num() == 0)
+			{
+				Retry.FirstDirtyTime = FPlatformTime::Seconds();
+			}
+			UpdatePendingStats(Write.GetPayloadSize(), 1);
+			Retry.Writes.Add(FieldKey, MoveTemp(Write));
+			Stats.DirtyCharacters = DirtyCharacters.Num();
+			EnsureFlushTimer();
+		}
+	}
+
+	TSet<FString>* CharacterInFlight = InFlightFields.Find(CharName);
+	if (!CharacterInFlight)
+	{
+		return;
+	}
+
+	CharacterInFlight->Remove(FieldKey);
+	if (CharacterInFlight->Num() == 0)
+	{
+		InFlightFields.Remove(CharName);
+	}
+
+	//A newer value queued while this one was in flight can go now if a flush is waiting on the character
+	if (bWaitingForFinalFlush || FlushWaiters.Contains(CharName))
+	{
+		SendDirtyWrites(CharName, MAX_int32);
+	}
+
+	if (!InFlightFields.Contains(CharName))
+	{
+		OnCharacterWritesComplete(CharName);
+	}
+}
+
+void UOWSCharacterPersistenceCache::OnCharacterWritesComplete(const FString& CharName)
+{
+	TArray<FSimpleDelegate> Waiters;
+	if (!FlushWaiters.RemoveAndCopyValue(CharName, Waiters))
+	{
+		return;
+	}
+
+	for (FSimpleDelegate& Waiter : Waiters)
+	{
+		Waiter.ExecuteIfBound();
+	}
+}
+
+void UOWSCharacterPersistenceCache::DropWrite(const FString& CharName, const FString& FieldKey, const FPendingWrite& Write)
+{
+	Stats.WritesDropped++;
+
+	if (Write.Type == EPendingWriteType::Stats)
+	{
+		OnCharacterStatsDropped.Broadcast(CharName);
+	}
+}
+
+void UOWSCharacterPersistenceCache::UpdatePendingStats(int64 BytesDelta, int32 WritesDelta)
+{
+	Stats.PendingBytes = FMath::Max<int64>(0, Stats.PendingBytes + BytesDelta);
+	Stats.PendingWrites = FMath::Max(0, Stats.PendingWrites + WritesDelta);
+	Stats.PeakPendingBytes = FMath::Max(Stats.PeakPendingBytes, Stats.PendingBytes);
+}
+
+void UOWSCharacterPersistenceCache::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Persistence: %d dirty characters, %d pending writes, %lld pending bytes (peak %lld), %d requests in flight"),
+		Stats.DirtyCharacters, Stats.PendingWrites, Stats.PendingBytes, Stats.PeakPendingBytes, NumInFlight);
+	Ar.Logf(TEXT("  queued=%d coalesced=%d sent=%d failed=%d dropped=%d flushed=%lld bytes"),
+		Stats.WritesQueued, Stats.WritesCoalesced, Stats.RequestsSent, Stats.RequestsFailed, Stats.WritesDropped, Stats.BytesFlushed);
+}
+
+void UOWSCharacterPersistenceCache::ResetStats()
+{
+	//Keep the live pending counters, only the running totals are reset
+	const int32 DirtyCharacterCount = Stats.DirtyCharacters;
+	const int32 PendingWrites = Stats.PendingWrites;
+	const int64 PendingBytes = Stats.PendingBytes;
+
+	Stats = FOWSPersistenceCacheStats();
+	Stats.DirtyCharacters = DirtyCharacterCount;
+	Stats.PendingWrites = PendingWrites;
+	Stats.PendingBytes = PendingBytes;
+	Stats.PeakPendingBytes = PendingBytes;
+}
@@ -13,6 +13,7 @@
 #include "GameplayTagsModule.h"
 #include "OWSAttributeSet.h"
 #include "OWSAdvancedProjectile.h"
+#include "OWSRegeneration.h"
 //#include "OWSGameplayAbility.h"
 #include "Runtime/Engine/Classes/GameFramework/PlayerState.h"
 
@@ -45,11 +46,26 @@ void AOWSCharacterWithAbilities::BeginPlay()
 		{
 			OnOWSAttributeInitalizationComplete();
 		}
+
+		if (UOWSRegeneration* Regeneration = GetWorld()->GetSubsystem<UOWSRegeneration>())
+		{
+			Regeneration->RegisterAttributeSet(OWSAttributes);
+		}
 	}
 
 	SetupAttributeChangeDelegates();
 }
 
+void AOWSCharacterWithAbilities::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UOWSRegeneration* Regeneration = GetWorld()->GetSubsystem<UOWSRegeneration>())
+	{
+		Regeneration->UnregisterAttributeSet(OWSAttributes);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AOWSCharacterWithAbilities::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
@@ -347,6 +363,45 @@ void AOWSCharacterWithAbilities::HandleProjectileDamage(AOWSAdvancedProjectile*
 	}
 }
 
+void AOWSCharacterWithAbilities::ApplyProjectileDamageEffect(const FGameplayEffectSpecHandle& DamageEffect)
+{
+	FGameplayEffectSpec* Spec = DamageEffect.Data.Get();
+
+	if (!Spec || GetLocalRole() != ROLE_Authority || GetAbilitySystemComponent() == nullptr)
+	{
+		return;
+	}
+
+	GetAbilitySystemComponent()->ApplyGameplayEffectSpecToTarget(*Spec, GetAbilitySystemComponent());
+}
+
+void AOWSCharacterWithAbilities::Multicast_BatchedProjectileSpawned_Implementation(const FOWSBatchedProjectileSpawn& Spawn)
+{
+	//The server already simulates it
+	if (GetNetMode() != NM_Client)
+	{
+		return;
+	}
+
+	if (UOWSBatchedProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UOWSBatchedProjectileManager>())
+	{
+		ProjectileManager->ReceiveSpawn(Spawn, this);
+	}
+}
+
+void AOWSCharacterWithAbilities::Multicast_BatchedProjectileImpact_Implementation(int32 ProjectileID, FVector_NetQuantize Location)
+{
+	if (GetNetMode() != NM_Client)
+	{
+		return;
+	}
+
+	if (UOWSBatchedProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UOWSBatchedProjectileManager>())
+	{
+		ProjectileManager->ReceiveImpact(ProjectileID, Location);
+	}
+}
+
 /*
 void AOWSCharacterWithAbilities::HandleProjectileEffectApplicationPrediction(AOWSAdvancedProjectile* FakeProjectile, AActor* TargetActor)
 {
@@ -737,15 +792,7 @@ void AOWSCharacterWithAbilities::UpdateCharacterStats()
 		CharacterStats.UpdateCharacterStats.Range = OWSAttributes->Range.GetBaseValue();
 		CharacterStats.UpdateCharacterStats.Speed = OWSAttributes->Speed.GetBaseValue();
 
-		FString PostParameters = "";
-		if (FJsonObjectConverter::UStructToJsonObjectString(CharacterStats, PostParameters))
-		{
-			PC->OWSPlayerControllerComponent->UpdateCharacterStats(PostParameters);
-		}
-		else
-		{
-			UE_LOG(OWS, Error, TEXT("UpdateCharacterStats Error serializing CharacterStats!"));
-		}
+		SendCharacterStats(PC, CharacterStats.UpdateCharacterStats);
 	}
 }
 
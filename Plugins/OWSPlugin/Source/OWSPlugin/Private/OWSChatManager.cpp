@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "OWSChatManager.h"
+#include "OWSChatRouter.h"
 #include "OWSPlugin.h"
 #include "Runtime/Online/HTTP/Public/Http.h"
 #include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
@@ -31,28 +32,10 @@ void AOWSChatManager::Tick( float DeltaTime )
 
 void AOWSChatManager::SendGlobalChat(FString SentFromCharacterName, FString Message)
 {
-	/*
-	FString PlayerName = SentFromCharacterName;
-	PlayerName = PlayerName.Replace(TEXT(" "), TEXT("%20"));
-
-	FString FullMessageToSend = SentFromCharacterName + FString(TEXT(": ")) + Message;
-
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AOWSChatManager::OnSendGlobalChatResponseReceived);
-	//This is the url on which to process the request
-	FString url = FString(TEXT("http://" +  + "/Chat/AddGlobalChatMessage"));	
-
-	FString PostParameters = FString(TEXT("id=")) + PlayerName
-		+ FString(TEXT("&Message=")) + FullMessageToSend
-		+ FString(TEXT("&CustomerGUID=")) + RPGAPICustomerKey;
-
-	Request->SetURL(url);
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/x-www-form-urlencoded"));
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
-	*/
+	if (UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>())
+	{
+		ChatRouter->SendGlobalChat(SentFromCharacterName, Message);
+	}
 }
 
 void AOWSChatManager::OnSendGlobalChatResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -62,29 +45,10 @@ void AOWSChatManager::OnSendGlobalChatResponseReceived(FHttpRequestPtr Request,
 
 void AOWSChatManager::SendChatToChannel(FString SentFromCharacterName, FString Message, FString ChatChannelName)
 {
-	/*
-	FString PlayerName = SentFromCharacterName;
-	PlayerName = PlayerName.Replace(TEXT(" "), TEXT("%20"));
-
-	FString FullMessageToSend = SentFromCharacterName + FString(TEXT(": ")) + Message;
-
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AOWSChatManager::OnSendChatToChannelResponseReceived);
-	//This is the url on which to process the request
-	FString url = FString(TEXT("http://" +  + "/Chat/AddGroupChatMessage"));
-
-	FString PostParameters = FString(TEXT("id=")) + PlayerName
-		+ FString(TEXT("&Message=")) + FullMessageToSend		
-		+ FString(TEXT("&ChatGroupName=")) + ChatChannelName
-		+ FString(TEXT("&CustomerGUID=")) + RPGAPICustomerKey;
-
-	Request->SetURL(url);
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/x-www-form-urlencoded"));
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
-	*/
+	if (UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>())
+	{
+		ChatRouter->SendChatToChannel(SentFromCharacterName, Message, ChatChannelName);
+	}
 }
 
 void AOWSChatManager::OnSendChatToChannelResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -94,29 +58,10 @@ void AOWSChatManager::OnSendChatToChannelResponseReceived(FHttpRequestPtr Reques
 
 void AOWSChatManager::SendPrivateChatMessage(FString SentFromCharacterName, FString SendToCharacterName, FString Message)
 {
-	/*
-	FString PlayerName = SentFromCharacterName;
-	PlayerName = PlayerName.Replace(TEXT(" "), TEXT("%20"));
-
-	FString FullMessageToSend = SentFromCharacterName + FString(TEXT(": ")) + Message;
-
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AOWSChatManager::OnSendPrivateChatMessageResponseReceived);
-	//This is the url on which to process the request
-	FString url = FString(TEXT("http://" +  + "/Chat/AddPrivateChatMessage"));
-
-	FString PostParameters = FString(TEXT("id=")) + PlayerName
-		+ FString(TEXT("Message=")) + FullMessageToSend
-		+ FString(TEXT("&ToCharName=")) + SendToCharacterName
-		+ FString(TEXT("&CustomerGUID=")) + RPGAPICustomerKey;
-
-	Request->SetURL(url);
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/x-www-form-urlencoded"));
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
-	*/
+	if (UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>())
+	{
+		ChatRouter->SendPrivateChatMessage(SentFromCharacterName, SendToCharacterName, Message);
+	}
 }
 
 void AOWSChatManager::OnSendPrivateChatMessageResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -200,26 +145,10 @@ void AOWSChatManager::OnGetNewChatMessagesResponseReceived(FHttpRequestPtr Reque
 
 void AOWSChatManager::AddOrJoinChatGroup(FString CharacterNameToAdd, FString ChatGroupName)
 {
-	/*
-	FString PlayerName = CharacterNameToAdd;
-	PlayerName = PlayerName.Replace(TEXT(" "), TEXT("%20"));
-
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AOWSChatManager::OnAddOrJoinChatGroupResponseReceived);
-	//This is the url on which to process the request
-	FString url = FString(TEXT("http://" +  + "/Chat/AddOrJoinChatGroup"));
-
-	FString PostParameters = FString(TEXT("id=")) + PlayerName
-		+ FString(TEXT("&ChatGroupName=")) + ChatGroupName
-		+ FString(TEXT("&CustomerGUID=")) + RPGAPICustomerKey;
-
-	Request->SetURL(url);
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/x-www-form-urlencoded"));
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
-	*/
+	if (UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>())
+	{
+		ChatRouter->JoinChannel(CharacterNameToAdd, ChatGroupName);
+	}
 }
 
 void AOWSChatManager::OnAddOrJoinChatGroupResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -239,26 +168,10 @@ void AOWSChatManager::OnAddOrJoinChatGroupResponseReceived(FHttpRequestPtr Reque
 
 void AOWSChatManager::LeaveChatGroup(FString CharacterNameToRemove, FString ChatGroupName)
 {
-	/*
-	FString PlayerName = CharacterNameToRemove;
-	PlayerName = PlayerName.Replace(TEXT(" "), TEXT("%20"));
-
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AOWSChatManager::OnLeaveChatGroupResponseReceived);
-	//This is the url on which to process the request
-	FString url = FString(TEXT("http://" +  + "/Chat/LeaveChatGroup"));
-
-	FString PostParameters = FString(TEXT("id=")) + PlayerName
-		+ FString(TEXT("&ChatGroupName=")) + ChatGroupName
-		+ FString(TEXT("&CustomerGUID=")) + RPGAPICustomerKey;
-
-	Request->SetURL(url);
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/x-www-form-urlencoded"));
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
-	*/
+	if (UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>())
+	{
+		ChatRouter->LeaveChannel(CharacterNameToRemove, ChatGroupName);
+	}
 }
 
 void AOWSChatManager::OnLeaveChatGroupResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -0,0 +1,487 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSChatRouter.h"
+#include "OWSGameMode.h"
+#include "OWSPlayerController.h"
+#include "OWSTransportSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "OWSDebugCommands.h"
+#include "JsonObjectConverter.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSChatRouter> GOWSChatStatsCmd(
+	TEXT("OWS.Chat.Stats"),
+	TEXT("Dumps local delivery, remote queue and rate limit counters of the chat router.  Pass reset to clear them."));
+
+//Bounds what is held for the chat service while it is unreachable, or by the local stand-in for a router that stopped flushing
+static constexpr int32 OWSMaxChatBacklog = 4096;
+
+FOWSHttpChatBackend::FOWSHttpChatBackend(const FString& InURL, const FString& InCustomerKey)
+	: URL(InURL)
+	, CustomerKey(InCustomerKey)
+	, ServerID(FGuid::NewGuid().ToString())
+{
+}
+
+void FOWSHttpChatBackend::Flush(UOWSChatRouter* Router, TArray<FChatMessage>&& Messages)
+{
+	Outgoing.Append(MoveTemp(Messages));
+
+	if (Outgoing.Num() > OWSMaxChatBacklog)
+	{
+		//The front of Outgoing is the post in flight and is removed when it succeeds, so the oldest unsent messages go.
+		//A post never carries more than the backlog holds, so there are always enough of them.
+		const int32 FirstUnsent = bInFlight ? NumberInFlight : 0;
+		UE_LOG(OWS, Warning, TEXT("FOWSHttpChatBackend - Dropping %d chat messages the chat service has not taken"), Outgoing.Num() - OWSMaxChatBacklog);
+		Outgoing.RemoveAt(FirstUnsent, Outgoing.Num() - OWSMaxChatBacklog);
+	}
+
+	if (bInFlight)
+	{
+		return;
+	}
+
+	FOWSChatFlushRequest FlushRequest;
+	FlushRequest.ServerID = ServerID;
+	FlushRequest.LastMessageID = LastMessageID;
+	FlushRequest.Messages = Outgoing;
+
+	FString PostParameters = "";
+	if (!FJsonObjectConverter::UStructToJsonObjectString(FlushRequest, PostParameters))
+	{
+		UE_LOG(OWS, Error, TEXT("FOWSHttpChatBackend - Unable to serialize %d chat messages"), Outgoing.Num());
+		return;
+	}
+
+	bInFlight = true;
+	NumberInFlight = Outgoing.Num();
+
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->OnProcessRequestComplete().BindSP(this, &FOWSHttpChatBackend::OnResponseReceived, TWeakObjectPtr<UOWSChatRouter>(Router));
+	Request->SetURL(URL);
+	Request->SetVerb(TEXT("POST"));
+	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
+	Request->SetHeader("Content-Type", TEXT("application/json"));
+	Request->SetHeader(TEXT("X-CustomerGUID"), CustomerKey);
+	Request->SetContentAsString(PostParameters);
+	Request->ProcessRequest();
+}
+
+void FOWSHttpChatBackend::OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TWeakObjectPtr<UOWSChatRouter> Router)
+{
+	bInFlight = false;
+
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		//Kept in Outgoing and sent again with the next flush
+		UE_LOG(OWS, Warning, TEXT("FOWSHttpChatBackend - Chat service did not take %d messages"), NumberInFlight);
+		return;
+	}
+
+	Outgoing.RemoveAt(0, FMath::Min(NumberInFlight, Outgoing.Num()));
+
+	FOWSChatFlushResponse FlushResponse;
+	if (!FJsonObjectConverter::JsonObjectStringToUStruct(Response->GetContentAsString(), &FlushResponse, 0, 0))
+	{
+		UE_LOG(OWS, Error, TEXT("FOWSHttpChatBackend - Unable to decode the chat service response"));
+		return;
+	}
+
+	LastMessageID = FMath::Max(LastMessageID, FlushResponse.LastMessageID);
+
+	if (UOWSChatRouter* ChatRouter = Router.Get())
+	{
+		ChatRouter->ReceiveRemoteMessages(FlushResponse.Messages);
+	}
+}
+
+TSharedRef<FOWSLocalChatBackend> FOWSLocalChatBackend::Get()
+{
+	static TSharedRef<FOWSLocalChatBackend> Instance = MakeShared<FOWSLocalChatBackend>();
+	return Instance;
+}
+
+void FOWSLocalChatBackend::Connect(UOWSChatRouter* Router)
+{
+	//A router that connects late is not handed what was said before it
+	AcknowledgedMessageIDs.FindOrAdd(Router, LastMessageID);
+}
+
+void FOWSLocalChatBackend::Disconnect(UOWSChatRouter* Router)
+{
+	AcknowledgedMessageIDs.Remove(Router);
+	TrimBacklog();
+}
+
+void FOWSLocalChatBackend::Flush(UOWSChatRouter* Router, TArray<FChatMessage>&& Messages)
+{
+	int32* AcknowledgedMessageID = AcknowledgedMessageIDs.Find(Router);
+	if (!AcknowledgedMessageID)
+	{
+		return;
+	}
+
+	for (FChatMessage& ChatMessage : Messages)
+	{
+		FBacklogMessage& BacklogMessage = Backlog.AddDefaulted_GetRef();
+		BacklogMessage.MessageID = ++LastMessageID;
+		BacklogMessage.Sender = Router;
+		BacklogMessage.ChatMessage = MoveTemp(ChatMessage);
+	}
+
+	TArray<FChatMessage> Received;
+	for (const FBacklogMessage& BacklogMessage : Backlog)
+	{
+		if (BacklogMessage.MessageID > *AcknowledgedMessageID && BacklogMessage.Sender != Router)
+		{
+			Received.Add(BacklogMessage.ChatMessage);
+		}
+	}
+
+	*AcknowledgedMessageID = LastMessageID;
+	TrimBacklog();
+
+	//Last, since the router may connect or disconnect routers while handling the messages
+	if (Received.Num() > 0)
+	{
+		Router->ReceiveRemoteMessages(Received);
+	}
+}
+
+void FOWSLocalChatBackend::TrimBacklog()
+{
+	int32 OldestAcknowledgedMessageID = LastMessageID;
+	for (auto It = AcknowledgedMessageIDs.CreateIterator(); It; ++It)
+	{
+		//A world torn down without disconnecting would otherwise hold the backlog forever
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		OldestAcknowledgedMessageID = FMath::Min(OldestAcknowledgedMessageID, It.Value());
+	}
+
+	int32 NumberToRemove = 0;
+	while (NumberToRemove < Backlog.Num() && Backlog[NumberToRemove].MessageID <= OldestAcknowledgedMessageID)
+	{
+		NumberToRemove++;
+	}
+
+	//A router that stopped flushing must not hold more than the chat service would
+	NumberToRemove = FMath::Max(NumberToRemove, Backlog.Num() - OWSMaxChatBacklog);
+	Backlog.RemoveAt(0, NumberToRemove);
+}
+
+bool UOWSChatRouter::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSChatRouter::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	//Optional tuning, the defaults above are used when these are missing from DefaultGame.ini
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSChatMessagesPerSecond"), MessagesPerSecond, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSChatMessageBurst"), MessageBurst, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSChatMaxMessageLength"), MaxMessageLength, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSChatFlushInterval"), FlushInterval, GGameIni);
+}
+
+void UOWSChatRouter::Deinitialize()
+{
+	SetBackend(nullptr);
+
+	Super::Deinitialize();
+}
+
+void UOWSChatRouter::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	//A backend set by hand before play began is kept
+	if (!Backend.IsValid())
+	{
+		FString ChatServiceURL;
+		bool bUseLocalChatService = false;
+		GConfig->GetString(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSChatServiceURL"), ChatServiceURL, GGameIni);
+		GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSUseLocalChatService"), bUseLocalChatService, GGameIni);
+
+		if (bUseLocalChatService)
+		{
+			SetBackend(FOWSLocalChatBackend::Get());
+		}
+		else if (!ChatServiceURL.IsEmpty())
+		{
+			const UOWSTransportSubsystem* Transport = InWorld.GetGameInstance() ? InWorld.GetGameInstance()->GetSubsystem<UOWSTransportSubsystem>() : nullptr;
+			SetBackend(MakeShared<FOWSHttpChatBackend>(ChatServiceURL, Transport ? Transport->OWSAPICustomerKey : FString()));
+		}
+	}
+
+	InWorld.GetTimerManager().SetTimer(FlushTimerHandle, this, &UOWSChatRouter::Flush, FMath::Max(FlushInterval, 0.05f), true);
+}
+
+void UOWSChatRouter::SetBackend(TSharedPtr<IOWSChatBackend> InBackend)
+{
+	if (Backend.IsValid())
+	{
+		Backend->Disconnect(this);
+	}
+
+	Backend = InBackend;
+
+	if (Backend.IsValid())
+	{
+		Backend->Connect(this);
+	}
+}
+
+bool UOWSChatRouter::PassesRateLimit(const FString& CharacterName)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	FRateLimit* RateLimit = RateLimits.Find(CharacterName);
+	if (!RateLimit)
+	{
+		RateLimit = &RateLimits.Add(CharacterName);
+		RateLimit->Tokens = (float)MessageBurst;
+		RateLimit->LastRefillTime = Now;
+	}
+
+	RateLimit->Tokens = FMath::Min((float)MessageBurst, RateLimit->Tokens + (float)(Now - RateLimit->LastRefillTime) * MessagesPerSecond);
+	RateLimit->LastRefillTime = Now;
+
+	if (RateLimit->Tokens < 1.f)
+	{
+		Stats.RateLimited++;
+		return false;
+	}
+
+	RateLimit->Tokens -= 1.f;
+	return true;
+}
+
+FChatMessage UOWSChatRouter::MakeMessage(const FString& SentFromCharacterName, const FString& Message) const
+{
+	FChatMessage ChatMessage;
+	ChatMessage.SentByCharName = SentFromCharacterName;
+	ChatMessage.ChatMessage = (MaxMessageLength > 0) ? Message.Left(MaxMessageLength) : Message;
+	return ChatMessage;
+}
+
+bool UOWSChatRouter::SendGlobalChat(const FString& SentFromCharacterName, const FString& Message)
+{
+	if (GetWorld()->GetNetMode() == NM_Client || !PassesRateLimit(SentFromCharacterName))
+	{
+		return false;
+	}
+
+	const FChatMessage ChatMessage = MakeMessage(SentFromCharacterName, Message);
+	SendToEveryone(ChatMessage);
+	QueueRemote(ChatMessage);
+	return true;
+}
+
+bool UOWSChatRouter::SendChatToChannel(const FString& SentFromCharacterName, const FString& Message, const FString& ChatChannelName)
+{
+	if (GetWorld()->GetNetMode() == NM_Client || !PassesRateLimit(SentFromCharacterName))
+	{
+		return false;
+	}
+
+	FChatMessage ChatMessage = MakeMessage(SentFromCharacterName, Message);
+	ChatMessage.ChatGroupName = ChatChannelName;
+	SendToChannelMembers(ChatMessage);
+	QueueRemote(ChatMessage);
+	return true;
+}
+
+bool UOWSChatRouter::SendPrivateChatMessage(const FString& SentFromCharacterName, const FString& SendToCharacterName, const FString& Message)
+{
+	if (GetWorld()->GetNetMode() == NM_Client || !PassesRateLimit(SentFromCharacterName))
+	{
+		return false;
+	}
+
+	FChatMessage ChatMessage = MakeMessage(SentFromCharacterName, Message);
+	ChatMessage.SentToCharName = SendToCharacterName;
+
+	//The sender sees their own message either way
+	SendToCharacter(SentFromCharacterName, ChatMessage);
+
+	if (SendToCharacterName != SentFromCharacterName && SendToCharacter(SendToCharacterName, ChatMessage))
+	{
+		Stats.PrivateMessagesKeptLocal++;
+		return true;
+	}
+
+	QueueRemote(ChatMessage);
+	return true;
+}
+
+void UOWSChatRouter::JoinChannel(const FString& CharacterName, const FString& ChatChannelName)
+{
+	ChannelMembers.FindOrAdd(ChatChannelName).Add(CharacterName);
+}
+
+void UOWSChatRouter::LeaveChannel(const FString& CharacterName, const FString& ChatChannelName)
+{
+	if (TSet<FString>* Members = ChannelMembers.Find(ChatChannelName))
+	{
+		Members->Remove(CharacterName);
+
+		if (Members->Num() == 0)
+		{
+			ChannelMembers.Remove(ChatChannelName);
+		}
+	}
+}
+
+void UOWSChatRouter::RemoveCharacter(const FString& CharacterName)
+{
+	for (auto It = ChannelMembers.CreateIterator(); It; ++It)
+	{
+		It.Value().Remove(CharacterName);
+
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	RateLimits.Remove(CharacterName);
+}
+
+void UOWSChatRouter::ReceiveRemoteMessages(const TArray<FChatMessage>& Messages)
+{
+	Stats.RemoteMessagesReceived += Messages.Num();
+
+	for (const FChatMessage& ChatMessage : Messages)
+	{
+		if (!ChatMessage.SentToCharName.IsEmpty())
+		{
+			SendToCharacter(ChatMessage.SentToCharName, ChatMessage);
+		}
+		else if (!ChatMessage.ChatGroupName.IsEmpty())
+		{
+			SendToChannelMembers(ChatMessage);
+		}
+		else
+		{
+			SendToEveryone(ChatMessage);
+		}
+	}
+}
+
+bool UOWSChatRouter::SendToCharacter(const FString& CharacterName, const FChatMessage& ChatMessage)
+{
+	const AOWSGameMode* OWSGameMode = Cast<AOWSGameMode>(GetWorld()->GetAuthGameMode());
+	AOWSPlayerController* PlayerController = OWSGameMode ? OWSGameMode->FindOnlinePlayerController(CharacterName) : nullptr;
+
+	if (!PlayerController)
+	{
+		return false;
+	}
+
+	PlayerController->Client_ReceiveChatMessage(ChatMessage);
+	Stats.LocalDeliveries++;
+	return true;
+}
+
+bool UOWSChatRouter::SendToChannelMembers(const FChatMessage& ChatMessage)
+{
+	const TSet<FString>* Members = ChannelMembers.Find(ChatMessage.ChatGroupName);
+	if (!Members)
+	{
+		return false;
+	}
+
+	bool bDeliveredToAnyone = false;
+	for (const FString& Member : *Members)
+	{
+		bDeliveredToAnyone |= SendToCharacter(Member, ChatMessage);
+	}
+
+	return bDeliveredToAnyone;
+}
+
+void UOWSChatRouter::SendToEveryone(const FChatMessage& ChatMessage)
+{
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		if (AOWSPlayerController* PlayerController = Cast<AOWSPlayerController>(Iterator->Get()))
+		{
+			PlayerController->Client_ReceiveChatMessage(ChatMessage);
+			Stats.LocalDeliveries++;
+		}
+	}
+}
+
+void UOWSChatRouter::QueueRemote(const FChatMessage& ChatMessage)
+{
+	if (!Backend.IsValid() || PendingRemoteMessages.Num() >= MaxQueuedRemoteMessages)
+	{
+		Stats.RemoteMessagesDropped++;
+		return;
+	}
+
+	PendingRemoteMessages.Add(ChatMessage);
+	Stats.RemoteMessagesQueued++;
+}
+
+void UOWSChatRouter::Flush()
+{
+	if (Backend.IsValid())
+	{
+		Stats.Flushes++;
+
+		//Keep the backend alive even if it disconnects this router while flushing
+		TSharedPtr<IOWSChatBackend> FlushingBackend = Backend;
+		FlushingBackend->Flush(this, MoveTemp(PendingRemoteMessages));
+		PendingRemoteMessages.Reset();
+	}
+
+	PruneRateLimits();
+}
+
+void UOWSChatRouter::PruneRateLimits()
+{
+	//A full bucket is the same as no bucket
+	const double Now = FPlatformTime::Seconds();
+	for (auto It = RateLimits.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Tokens + (float)(Now - It.Value().LastRefillTime) * MessagesPerSecond >= (float)MessageBurst)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UOWSChatRouter::DumpStats(FOutputDevice& Ar) const
+{
+	int32 ChannelMemberships = 0;
+	for (const TPair<FString, TSet<FString>>& Pair : ChannelMembers)
+	{
+		ChannelMemberships += Pair.Value.Num();
+	}
+
+	Ar.Logf(TEXT("OWS Chat Router: backend=%s channels=%d memberships=%d queued=%d"),
+		Backend.IsValid() ? TEXT("yes") : TEXT("none"), ChannelMembers.Num(), ChannelMemberships, PendingRemoteMessages.Num());
+	Ar.Logf(TEXT("  local deliveries=%d private kept local=%d remote queued=%d remote received=%d flushes=%d rate limited=%d remote dropped=%d"),
+		Stats.LocalDeliveries, Stats.PrivateMessagesKeptLocal, Stats.RemoteMessagesQueued, Stats.RemoteMessagesReceived, Stats.Flushes,
+		Stats.RateLimited, Stats.RemoteMessagesDropped);
+}
+
+void UOWSChatRouter::ResetStats()
+{
+	Stats = FOWSChatRouterStats();
+}
@@ -0,0 +1,83 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSEndpoints.h"
+
+const TCHAR* LexToString(EOWSApiModule Module)
+{
+	switch (Module)
+	{
+	case EOWSApiModule::PublicAPI:
+		return TEXT("PublicAPI");
+	case EOWSApiModule::InstanceManagementAPI:
+		return TEXT("InstanceManagementAPI");
+	case EOWSApiModule::CharacterPersistenceAPI:
+		return TEXT("CharacterPersistenceAPI");
+	case EOWSApiModule::GlobalDataAPI:
+		return TEXT("GlobalDataAPI");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+static TArray<const FOWSEndpoint*>& GetMutableEndpointRegistry()
+{
+	static TArray<const FOWSEndpoint*> Registry;
+	return Registry;
+}
+
+FOWSEndpoint::FOWSEndpoint(EOWSApiModule InModule, const TCHAR* InPath, const TCHAR* InVerb, bool bInIdempotent)
+	: Module(InModule)
+	, Path(InPath)
+	, Verb(InVerb)
+	, bIdempotent(bInIdempotent)
+	, Index(GetMutableEndpointRegistry().Add(this))
+	, Name(FString(LexToString(InModule)) + TEXT(":") + InPath)
+{
+}
+
+const TArray<const FOWSEndpoint*>& FOWSEndpoint::GetAll()
+{
+	return GetMutableEndpointRegistry();
+}
+
+namespace OWSEndpoints
+{
+	//PublicAPI
+	const TOWSEndpoint<FLoginAndCreateSessionJSONPost, FLoginAndCreateSession> LoginAndCreateSession(EOWSApiModule::PublicAPI, TEXT("api/Users/LoginAndCreateSession"), TEXT("POST"), false);
+	const TOWSEndpoint<FLogout, FSuccessAndErrorMessage> Logout(EOWSApiModule::PublicAPI, TEXT("api/Users/Logout"), TEXT("POST"), false);
+	const TOWSEndpoint<FGetAllCharactersJSONPost, TArray<FUserCharacter>> GetAllCharacters(EOWSApiModule::PublicAPI, TEXT("api/Users/GetAllCharacters"), TEXT("POST"), true);
+	const TOWSEndpoint<FSetSelectedCharacterAndConnectToLastZoneJSONPost, TSharedPtr<FJsonObject>> SetSelectedCharacterAndGetUserSession(EOWSApiModule::PublicAPI, TEXT("api/Users/SetSelectedCharacterAndGetUserSession"), TEXT("POST"), false);
+	//Not idempotent, it may spin up a new zone instance
+	const TOWSEndpoint<FTravelToLastZoneServerJSONPost, TSharedPtr<FJsonObject>> GetServerToConnectTo(EOWSApiModule::PublicAPI, TEXT("api/Users/GetServerToConnectTo"), TEXT("POST"), false);
+	const TOWSEndpoint<FCreateCharacterJSONPost, FCreateCharacter> CreateCharacter(EOWSApiModule::PublicAPI, TEXT("api/Users/CreateCharacter"), TEXT("POST"), false);
+	const TOWSEndpoint<FCreateCharacterUsingDefaultCharacterValues, FSuccessAndErrorMessage> CreateCharacterUsingDefaultCharacterValues(EOWSApiModule::PublicAPI, TEXT("api/Users/CreateCharacterUsingDefaultCharacterValues"), TEXT("POST"), false);
+	const TOWSEndpoint<FRemoveCharacterJSONPost, FSuccessAndErrorMessage> RemoveCharacter(EOWSApiModule::PublicAPI, TEXT("api/Users/RemoveCharacter"), TEXT("POST"), false);
+	const TOWSEndpoint<FGetPlayerGroupsCharacterIsInJSONPost, TSharedPtr<FJsonObject>> GetPlayerGroupsCharacterIsIn(EOWSApiModule::PublicAPI, TEXT("api/Users/GetPlayerGroupsCharacterIsIn"), TEXT("POST"), true);
+	const TOWSEndpoint<FGetCharacterDataAndCustomData, TSharedPtr<FJsonObject>> GetCharacterDataAndCustomData(EOWSApiModule::PublicAPI, TEXT("api/Characters/ByName"), TEXT("POST"), true);
+
+	//CharacterPersistenceAPI
+	const TOWSEndpoint<FGetCharacterStatsJSONPost, TSharedPtr<FJsonObject>> GetCharacterStats(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/GetByName"), TEXT("POST"), true);
+	const TOWSEndpoint<FString, FSuccessAndErrorMessage> UpdateCharacterStats(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/UpdateCharacterStats"), TEXT("POST"), false);
+	const TOWSEndpoint<FGetCustomCharacterDataJSONPost, TSharedPtr<FJsonObject>> GetCustomCharacterData(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/GetCustomData"), TEXT("POST"), true);
+	const TOWSEndpoint<FAddOrUpdateCustomCharacterDataJSONPost, FSuccessAndErrorMessage> AddOrUpdateCustomCharacterData(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/AddOrUpdateCustomData"), TEXT("POST"), false);
+	const TOWSEndpoint<FCharacterNameJSONPost, FSuccessAndErrorMessage> PlayerLogout(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/PlayerLogout"), TEXT("POST"), false);
+	const TOWSEndpoint<FUpdateAllPlayerPositionsJSONPost, FSuccessAndErrorMessage> UpdateAllPlayerPositions(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/UpdateAllPlayerPositions"), TEXT("POST"), false);
+	const TOWSEndpoint<FUpdateAllPlayerPositionsCompactJSONPost, FSuccessAndErrorMessage> UpdateAllPlayerPositionsCompact(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Characters/UpdateAllPlayerPositionsCompact"), TEXT("POST"), false);
+	const TOWSEndpoint<FAddAbilityToCharacterJSONPost, FSuccessAndErrorMessage> AddAbilityToCharacter(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Abilities/AddAbilityToCharacter"), TEXT("POST"), false);
+	const TOWSEndpoint<FUpdateAbilityOnCharacterJSONPost, FSuccessAndErrorMessage> UpdateAbilityOnCharacter(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Abilities/UpdateAbilityOnCharacter"), TEXT("POST"), false);
+	const TOWSEndpoint<FRemoveAbilityFromCharacterJSONPost, FSuccessAndErrorMessage> RemoveAbilityFromCharacter(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Abilities/RemoveAbilityFromCharacter"), TEXT("POST"), false);
+	const TOWSEndpoint<FCharacterNameJSONPost, TArray<FAbility>> GetCharacterAbilities(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Abilities/GetCharacterAbilities"), TEXT("POST"), true);
+	const TOWSEndpoint<FCharacterNameJSONPost, TArray<FAbilityBar>> GetAbilityBars(EOWSApiModule::CharacterPersistenceAPI, TEXT("api/Abilities/GetAbilityBars"), TEXT("POST"), true);
+
+	//InstanceManagementAPI
+	const TOWSEndpoint<FGetZoneInstancesForZoneJSONPost, TArray<FZoneInstance>> GetZoneInstancesForZone(EOWSApiModule::InstanceManagementAPI, TEXT("api/Instance/GetZoneInstancesForZone"), TEXT("POST"), true);
+	const TOWSEndpoint<FString, FGetServerInstanceFromPort> GetZoneInstance(EOWSApiModule::InstanceManagementAPI, TEXT("api/Instance/GetZoneInstance"), TEXT("POST"), true);
+	const TOWSEndpoint<FUpdateNumberOfPlayersJSONPost, FSuccessAndErrorMessage> UpdateNumberOfPlayers(EOWSApiModule::InstanceManagementAPI, TEXT("api/Instance/UpdateNumberOfPlayers"), TEXT("POST"), false);
+	const TOWSEndpoint<FString, TSharedPtr<FJsonObject>> GetCurrentWorldTime(EOWSApiModule::InstanceManagementAPI, TEXT("api/Instance/GetCurrentWorldTime"), TEXT("POST"), true);
+	const TOWSEndpoint<FAddZoneJSONPost, FSuccessAndErrorMessage> AddZone(EOWSApiModule::InstanceManagementAPI, TEXT("api/Zones/AddZone"), TEXT("POST"), false);
+	const TOWSEndpoint<FUpdateZoneJSONPost, FSuccessAndErrorMessage> UpdateZone(EOWSApiModule::InstanceManagementAPI, TEXT("api/Zones/UpdateZone"), TEXT("POST"), false);
+
+	//GlobalDataAPI
+	const TOWSEndpoint<FGlobalDataItem, FSuccessAndErrorMessage> AddOrUpdateGlobalDataItem(EOWSApiModule::GlobalDataAPI, TEXT("api/GlobalData/AddOrUpdateGlobalDataItem"), TEXT("POST"), false);
+	const TOWSEndpoint<FString, FGlobalDataItem> GetGlobalDataItem(EOWSApiModule::GlobalDataAPI, TEXT("api/GlobalData/GetGlobalDataItem"), TEXT("GET"), true);
+}
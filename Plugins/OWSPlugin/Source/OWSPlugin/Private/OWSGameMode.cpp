@@ -6,8 +6,62 @@
 #include "OWSPlayerState.h"
 #include "OWSPlayerController.h"
 #include "OWSAPISubsystem.h"
+#include "OWSTransportSubsystem.h"
+#include "OWSCharacterPersistenceCache.h"
+#include "OWSChatRouter.h"
+#include "OWSResponseCache.h"
 #include "Runtime/Engine/Classes/Kismet/GameplayStatics.h"
 #include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+#include "HAL/IConsoleManager.h"
+#include "OWSDebugCommands.h"
+
+static TAutoConsoleVariable<int32> CVarOWSSaveLocationsLocalStandIn(
+	TEXT("OWS.SaveLocations.LocalStandIn"),
+	0,
+	TEXT("When non-zero, SaveAllPlayerLocations batches are decoded and acknowledged locally instead of being sent to the CharacterPersistenceAPI."),
+	ECVF_Default);
+
+//Local stand-in for the UpdateAllPlayerPositions endpoints.  Decodes the payload the same way the persistence API would and logs it.
+static void HandleLocationSaveWithLocalStandIn(const FOWSEndpoint& Endpoint, const FString& PostParameters)
+{
+	if (&Endpoint == &OWSEndpoints::UpdateAllPlayerPositionsCompact)
+	{
+		FUpdateAllPlayerPositionsCompactJSONPost CompactPost;
+		if (!FJsonObjectConverter::JsonObjectStringToUStruct(PostParameters, &CompactPost, 0, 0))
+		{
+			UE_LOG(OWS, Error, TEXT("OWS.SaveLocations.LocalStandIn - Error deserializing UpdateAllPlayerPositionsCompactJSONPost!"));
+			return;
+		}
+
+		const int32 NumPlayers = CompactPost.CharacterNames.Num();
+		if (CompactPost.Locations.Num() != NumPlayers * 3 || CompactPost.Rotations.Num() != NumPlayers * 3)
+		{
+			UE_LOG(OWS, Error, TEXT("OWS.SaveLocations.LocalStandIn - Mismatched array sizes in UpdateAllPlayerPositionsCompactJSONPost!"));
+			return;
+		}
+
+		for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; PlayerIndex++)
+		{
+			const int32 Offset = PlayerIndex * 3;
+			UE_LOG(OWS, Verbose, TEXT("OWS.SaveLocations.LocalStandIn - %s: %f, %f, %f / %f, %f, %f"), *CompactPost.CharacterNames[PlayerIndex],
+				CompactPost.Locations[Offset] * CompactPost.LocationQuantization,
+				CompactPost.Locations[Offset + 1] * CompactPost.LocationQuantization,
+				CompactPost.Locations[Offset + 2] * CompactPost.LocationQuantization,
+				FRotator::DecompressAxisFromShort((uint16)CompactPost.Rotations[Offset]),
+				FRotator::DecompressAxisFromShort((uint16)CompactPost.Rotations[Offset + 1]),
+				FRotator::DecompressAxisFromShort((uint16)CompactPost.Rotations[Offset + 2]));
+		}
+
+		UE_LOG(OWS, Log, TEXT("OWS.SaveLocations.LocalStandIn - Saved %d players in %d bytes"), NumPlayers, PostParameters.Len());
+		return;
+	}
+
+	UE_LOG(OWS, Log, TEXT("OWS.SaveLocations.LocalStandIn - Saved delimited batch in %d bytes"), PostParameters.Len());
+}
+
+static TOWSStatsConsoleCommand<AOWSGameMode, &AOWSGameMode::DumpLocationSaveStats, &AOWSGameMode::ResetLocationSaveStats> GOWSSaveLocationsStatsCmd(
+	TEXT("OWS.SaveLocations.Stats"),
+	TEXT("Dumps how many players SaveAllPlayerLocations saved and deferred, the bytes it sent and the longest time a player's movement has gone unsaved.  Pass reset to clear the counters."));
 
 AOWSGameMode::AOWSGameMode()
 {
@@ -88,39 +142,17 @@ void AOWSGameMode::AddOrUpdateGlobalDataItemError(const FString& ErrorMsg)
 	ErrorAddOrUpdateGlobalDataItem(ErrorMsg);
 }
 
-void AOWSGameMode::ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (AOWSGameMode::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+void AOWSGameMode::ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (AOWSGameMode::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
 {
-	Http = &FHttpModule::Get();
-	Http->SetHttpTimeout(30); //Set timeout
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, InMethodPtr);
-
-	FString OWS2APIPathToUse = "";
-
-	if (ApiModuleToCall == "PublicAPI")
-	{
-		OWS2APIPathToUse = OWS2APIPath;
-	}
-	else if (ApiModuleToCall == "InstanceManagementAPI")
-	{
-		OWS2APIPathToUse = OWS2InstanceManagementAPIPath;
-	}
-	else if (ApiModuleToCall == "CharacterPersistenceAPI")
-	{
-		OWS2APIPathToUse = OWS2CharacterPersistenceAPIPath;
-	}
-	else //When an ApiModuleToCall is not specified, use the PublicAPI
+	UGameInstance* GameInstance = GetGameInstance();
+	if (!GameInstance)
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		UE_LOG(OWS, Error, TEXT("AOWSGameMode::ProcessOWS2POSTRequest - No Game Instance Found!"));
+		return;
 	}
 
-	Request->SetURL(FString(OWS2APIPathToUse + ApiToCall));
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/json"));
-	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
+	GameInstance->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, 30.f,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, InMethodPtr));
 }
 
 void AOWSGameMode::GetJsonObjectFromResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CallingMethodName, FString& ErrorMsg, TSharedPtr<FJsonObject>& JsonObject)
@@ -151,6 +183,9 @@ void AOWSGameMode::StartPlay()
 {
 	Super::StartPlay();
 
+	//Entries set in the class defaults are indexed like any other
+	ReindexCharactersOnline();
+
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		//Get a list of all item definitions
@@ -169,9 +204,9 @@ void AOWSGameMode::StartPlay()
 		//Change Status of the Zone Instance to 2 (ready for players to connect)
 		UpdateNumberOfPlayers();
 
-		if (GetCharactersOnlineIntervalInSeconds > 0.f)
+		if (bReportServerLoad)
 		{
-			GetWorld()->GetTimerManager().SetTimer(OnGetAllCharactersOnlineTimerHandle, this, &AOWSGameMode::GetAllCharactersOnline, GetCharactersOnlineIntervalInSeconds, true);
+			ServerLoadSampler.Start();
 		}
 
 		if (UpdateServerStatusEveryXSeconds > 0.f)
@@ -186,6 +221,22 @@ void AOWSGameMode::StartPlay()
 	}
 }
 
+void AOWSGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ServerLoadSampler.Stop();
+
+	//Server shutdown or map change, make sure every unsaved character write reaches the backend before the world goes away
+	if (GetLocalRole() == ROLE_Authority && GetGameInstance())
+	{
+		if (UOWSCharacterPersistenceCache* PersistenceCache = GetGameInstance()->GetSubsystem<UOWSCharacterPersistenceCache>())
+		{
+			PersistenceCache->FlushAll(true);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 FString AOWSGameMode::InitNewPlayer(APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal)
 {
 	FString retString = Super::InitNewPlayer(NewPlayerController, UniqueId, Options, Portal);
@@ -448,73 +499,241 @@ void AOWSGameMode::SaveAllPlayerLocations()
 {
 	UE_LOG(OWS, Verbose, TEXT("SaveAllPlayerLocations Started"));
 
-	FString DataToSave;
-	int PlayerIndex = 0;
+	const double Now = FPlatformTime::Seconds();
+	TArray<FLocationSaveCandidate> Candidates;
 
-	if (NextSaveGroupIndex < SplitSaveIntoHowManyGroups)
+	LocationSaveStats.WorstUnsavedSeconds = 0.f;
+	LocationSaveStats.WorstUnsavedCharacterName.Empty();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
 	{
-		NextSaveGroupIndex++;
+		AOWSPlayerController* PlayerControllerToSave = Cast<AOWSPlayerController>(Iterator->Get());
+
+		if (!PlayerControllerToSave || !PlayerControllerToSave->PlayerState)
+		{
+			continue;
+		}
+
+		APawn* MyPawn = PlayerControllerToSave->GetPawn();
+
+		if (MyPawn)
+		{
+			PlayerControllerToSave->LastCharacterLocation = MyPawn->GetActorLocation();
+			PlayerControllerToSave->LastCharacterRotation = MyPawn->GetActorRotation();
+		}
+
+		if (!HasMovedSinceLastSave(PlayerControllerToSave))
+		{
+			PlayerControllerToSave->UnsavedLocationSince = 0.0;
+			continue;
+		}
+
+		if (PlayerControllerToSave->UnsavedLocationSince <= 0.0)
+		{
+			PlayerControllerToSave->UnsavedLocationSince = Now;
+		}
+
+		const float UnsavedSeconds = (float)(Now - PlayerControllerToSave->UnsavedLocationSince);
+		if (UnsavedSeconds > LocationSaveStats.WorstUnsavedSeconds)
+		{
+			LocationSaveStats.WorstUnsavedSeconds = UnsavedSeconds;
+			LocationSaveStats.WorstUnsavedCharacterName = PlayerControllerToSave->PlayerState->GetPlayerName();
+		}
+
+		//The previous save for this player has not been acknowledged yet, sending another one would only race it
+		if (PlayerControllerToSave->bLocationSaveInFlight)
+		{
+			continue;
+		}
+
+		FLocationSaveCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.PlayerController = PlayerControllerToSave;
+		Candidate.Priority = GetLocationSavePriority(PlayerControllerToSave, Now);
+		Candidate.EstimatedBytes = EstimateLocationSaveBytes(PlayerControllerToSave->PlayerState->GetPlayerName());
 	}
-	else
+
+	LocationSaveStats.PeakUnsavedSeconds = FMath::Max(LocationSaveStats.PeakUnsavedSeconds, LocationSaveStats.WorstUnsavedSeconds);
+
+	if (Candidates.Num() < 1)
 	{
-		NextSaveGroupIndex = 0;
+		UE_LOG(OWS, Verbose, TEXT("SaveAllPlayerLocations - No players to save"));
+		return;
 	}
 
-	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	Candidates.Sort([](const FLocationSaveCandidate& A, const FLocationSaveCandidate& B) { return A.Priority > B.Priority; });
+
+	TArray<FPendingLocationSave> Batch;
+	int32 EstimatedBatchBytes = 0;
+
+	for (const FLocationSaveCandidate& Candidate : Candidates)
 	{
-		if (NextSaveGroupIndex == PlayerIndex % SplitSaveIntoHowManyGroups)
+		//Always send at least one player, and never hold back a player that is logging out
+		const bool bFits = MaxLocationSaveBytesPerFlush <= 0 || Batch.Num() == 0 || EstimatedBatchBytes + Candidate.EstimatedBytes <= MaxLocationSaveBytesPerFlush;
+		if (!bFits && !Candidate.PlayerController->bPendingDisconnect)
 		{
-			AOWSPlayerController* PlayerControllerToSave = Cast<AOWSPlayerController>(Iterator->Get());
+			LocationSaveStats.PlayersDeferred++;
+			continue;
+		}
 
-			if (PlayerControllerToSave)
-			{
-				APawn* MyPawn = Iterator->Get()->GetPawn();
+		Batch.Add(MakePendingLocationSave(Candidate.PlayerController));
+		EstimatedBatchBytes += Candidate.EstimatedBytes;
+	}
 
-				if (MyPawn)
-				{
-					PlayerControllerToSave->LastCharacterLocation = MyPawn->GetActorLocation();
-					PlayerControllerToSave->LastCharacterRotation = MyPawn->GetActorRotation();
-				}
+	LocationSaveStats.Flushes++;
+	SaveLocations(MoveTemp(Batch));
+}
 
-				FVector PawnLocation = PlayerControllerToSave->LastCharacterLocation;
-				FRotator PawnRotation = PlayerControllerToSave->LastCharacterRotation;
-
-				DataToSave.Append(PlayerControllerToSave->PlayerState->GetPlayerName());
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnLocation.X));
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnLocation.Y));
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnLocation.Z));
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnRotation.Roll));
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnRotation.Pitch));
-				DataToSave.Append(":");
-				DataToSave.Append(FString::SanitizeFloat(PawnRotation.Yaw));
-				DataToSave.Append("|");
-			}
+float AOWSGameMode::GetLocationSavePriority(const AOWSPlayerController* PlayerController, double Now) const
+{
+	if (PlayerController->bPendingDisconnect)
+	{
+		return MAX_flt;
+	}
+
+	//Never saved, there is nothing on the backend to fall back to
+	const float DistanceMoved = PlayerController->bHasSavedCharacterLocation
+		? FVector::Dist(PlayerController->LastCharacterLocation, PlayerController->LastSavedCharacterLocation)
+		: WORLD_MAX;
+	const float UnsavedSeconds = (float)(Now - PlayerController->UnsavedLocationSince);
+
+	return DistanceMoved * SaveDistanceWeight + UnsavedSeconds * SaveAgeWeight;
+}
+
+int32 AOWSGameMode::EstimateLocationSaveBytes(const FString& CharacterName) const
+{
+	//Rough size of one player's entry: the name plus six quantized integers in JSON arrays, or six floats in the delimited string
+	return CharacterName.Len() + (bUseCompactLocationSave ? 48 : 72);
+}
+
+AOWSGameMode::FPendingLocationSave AOWSGameMode::MakePendingLocationSave(AOWSPlayerController* PlayerController)
+{
+	FPendingLocationSave PendingSave;
+	PendingSave.PlayerController = PlayerController;
+	PendingSave.CharacterName = PlayerController->PlayerState->GetPlayerName();
+	PendingSave.Location = PlayerController->LastCharacterLocation;
+	PendingSave.Rotation = PlayerController->LastCharacterRotation;
+	return PendingSave;
+}
+
+void AOWSGameMode::PostLogin(APlayerController* NewPlayer)
+{
+	Super::PostLogin(NewPlayer);
+
+	if (AOWSPlayerController* PlayerController = Cast<AOWSPlayerController>(NewPlayer))
+	{
+		AddCharacterOnline(PlayerController);
+	}
+
+	//The character may have been changed on another zone server since we cached it, load it fresh
+	UOWSResponseCache* ResponseCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UOWSResponseCache>() : nullptr;
+	if (ResponseCache && NewPlayer && NewPlayer->PlayerState)
+	{
+		ResponseCache->InvalidateCharacter(NewPlayer->PlayerState->GetPlayerName());
+	}
+}
+
+void AOWSGameMode::Logout(AController* Exiting)
+{
+	RemoveCharacterOnline(Cast<AOWSPlayerController>(Exiting));
+
+	UOWSChatRouter* ChatRouter = GetWorld()->GetSubsystem<UOWSChatRouter>();
+	if (ChatRouter && Exiting && Exiting->PlayerState)
+	{
+		ChatRouter->RemoveCharacter(Exiting->PlayerState->GetPlayerName());
+	}
+
+	//The character goes on to another zone server, which can change it before it comes back here
+	UOWSResponseCache* ResponseCache = GetGameInstance() ? GetGameInstance()->GetSubsystem<UOWSResponseCache>() : nullptr;
+	if (ResponseCache && Exiting && Exiting->PlayerState)
+	{
+		ResponseCache->InvalidateCharacter(Exiting->PlayerState->GetPlayerName());
+	}
+
+	//The player is gone before the next scheduled save, so anything unsaved is sent now
+	AOWSPlayerController* PlayerController = Cast<AOWSPlayerController>(Exiting);
+	if (PlayerController && PlayerController->PlayerState && SaveIntervalInSeconds > 0.f)
+	{
+		if (APawn* MyPawn = PlayerController->GetPawn())
+		{
+			PlayerController->LastCharacterLocation = MyPawn->GetActorLocation();
+			PlayerController->LastCharacterRotation = MyPawn->GetActorRotation();
 		}
 
-		PlayerIndex++;
+		if (HasMovedSinceLastSave(PlayerController))
+		{
+			TArray<FPendingLocationSave> Batch;
+			Batch.Add(MakePendingLocationSave(PlayerController));
+			SaveLocations(MoveTemp(Batch));
+		}
 	}
 
-	if (DataToSave.Len() < 1)
+	Super::Logout(Exiting);
+}
+
+void AOWSGameMode::SaveLocations(TArray<FPendingLocationSave>&& Batch)
+{
+	FString PostParameters = "";
+
+	if (bUseCompactLocationSave)
 	{
-		UE_LOG(OWS, Verbose, TEXT("SaveAllPlayerLocations - No players to save in batch #: %i"), NextSaveGroupIndex);
+		const float Quantization = FMath::Max(LocationSaveQuantization, KINDA_SMALL_NUMBER);
+
+		FUpdateAllPlayerPositionsCompactJSONPost UpdateAllPlayerPositionsCompactJSONPost;
+		UpdateAllPlayerPositionsCompactJSONPost.LocationQuantization = Quantization;
+		UpdateAllPlayerPositionsCompactJSONPost.MapName = "";
+		UpdateAllPlayerPositionsCompactJSONPost.CharacterNames.Reserve(Batch.Num());
+		UpdateAllPlayerPositionsCompactJSONPost.Locations.Reserve(Batch.Num() * 3);
+		UpdateAllPlayerPositionsCompactJSONPost.Rotations.Reserve(Batch.Num() * 3);
+
+		for (const FPendingLocationSave& PendingSave : Batch)
+		{
+			UpdateAllPlayerPositionsCompactJSONPost.CharacterNames.Add(PendingSave.CharacterName);
+			UpdateAllPlayerPositionsCompactJSONPost.Locations.Add(FMath::RoundToInt(PendingSave.Location.X / Quantization));
+			UpdateAllPlayerPositionsCompactJSONPost.Locations.Add(FMath::RoundToInt(PendingSave.Location.Y / Quantization));
+			UpdateAllPlayerPositionsCompactJSONPost.Locations.Add(FMath::RoundToInt(PendingSave.Location.Z / Quantization));
+			UpdateAllPlayerPositionsCompactJSONPost.Rotations.Add(FRotator::CompressAxisToShort(PendingSave.Rotation.Roll));
+			UpdateAllPlayerPositionsCompactJSONPost.Rotations.Add(FRotator::CompressAxisToShort(PendingSave.Rotation.Pitch));
+			UpdateAllPlayerPositionsCompactJSONPost.Rotations.Add(FRotator::CompressAxisToShort(PendingSave.Rotation.Yaw));
+		}
+
+		if (!OWSEndpoints::UpdateAllPlayerPositionsCompact.SerializeRequest(UpdateAllPlayerPositionsCompactJSONPost, PostParameters))
+		{
+			UE_LOG(OWS, Error, TEXT("SaveAllPlayerLocations Error serializing UpdateAllPlayerPositionsCompactJSONPost!"));
+			return;
+		}
+
+		SendLocationSaveBatch(OWSEndpoints::UpdateAllPlayerPositionsCompact, PostParameters, MoveTemp(Batch));
 		return;
 	}
 
+	FString DataToSave;
+	for (const FPendingLocationSave& PendingSave : Batch)
+	{
+		DataToSave.Append(PendingSave.CharacterName);
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Location.X));
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Location.Y));
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Location.Z));
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Rotation.Roll));
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Rotation.Pitch));
+		DataToSave.Append(":");
+		DataToSave.Append(FString::SanitizeFloat(PendingSave.Rotation.Yaw));
+		DataToSave.Append("|");
+	}
+
 	DataToSave = DataToSave.Left(DataToSave.Len() - 1);
 	UE_LOG(OWS, Verbose, TEXT("SaveAllPlayerLocations - Data to save: %s"), *DataToSave);
 
 	FUpdateAllPlayerPositionsJSONPost UpdateAllPlayerPositionsJSONPost;
 	UpdateAllPlayerPositionsJSONPost.SerializedPlayerLocationData = DataToSave;
 	UpdateAllPlayerPositionsJSONPost.MapName = "";
-	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(UpdateAllPlayerPositionsJSONPost, PostParameters))
+	if (OWSEndpoints::UpdateAllPlayerPositions.SerializeRequest(UpdateAllPlayerPositionsJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/UpdateAllPlayerPositions", PostParameters, &AOWSGameMode::OnSaveAllPlayerLocationsResponseReceived);
+		SendLocationSaveBatch(OWSEndpoints::UpdateAllPlayerPositions, PostParameters, MoveTemp(Batch));
 	}
 	else
 	{
@@ -522,16 +741,95 @@ void AOWSGameMode::SaveAllPlayerLocations()
 	}
 }
 
-void AOWSGameMode::OnSaveAllPlayerLocationsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void AOWSGameMode::DumpLocationSaveStats(FOutputDevice& Ar) const
 {
-	if (bWasSuccessful)
+	Ar.Logf(TEXT("OWS Location Saves: flushes=%d players saved=%d deferred=%d bytes=%d in flight batches=%d"),
+		LocationSaveStats.Flushes, LocationSaveStats.PlayersSaved, LocationSaveStats.PlayersDeferred, LocationSaveStats.BytesSent, LocationSavesInFlight.Num());
+	Ar.Logf(TEXT("  worst unsaved=%.1fs (%s) peak unsaved=%.1fs"),
+		LocationSaveStats.WorstUnsavedSeconds, *LocationSaveStats.WorstUnsavedCharacterName, LocationSaveStats.PeakUnsavedSeconds);
+}
+
+void AOWSGameMode::ResetLocationSaveStats()
+{
+	LocationSaveStats = FOWSLocationSaveStats();
+}
+
+bool AOWSGameMode::HasMovedSinceLastSave(const AOWSPlayerController* PlayerController) const
+{
+	if (!PlayerController->bHasSavedCharacterLocation)
 	{
-		UE_LOG(OWS, Verbose, TEXT("OnSaveAllPlayerLocationsResponseReceived Success!"));
+		return true;
 	}
-	else
+
+	if (FVector::DistSquared(PlayerController->LastCharacterLocation, PlayerController->LastSavedCharacterLocation) > FMath::Square(SaveLocationThreshold))
 	{
-		UE_LOG(OWS, Error, TEXT("OnSaveAllPlayerLocationsResponseReceived Error accessing server!"));
+		return true;
 	}
+
+	return !PlayerController->LastCharacterRotation.Equals(PlayerController->LastSavedCharacterRotation, SaveRotationThreshold);
+}
+
+void AOWSGameMode::SendLocationSaveBatch(const FOWSEndpoint& Endpoint, const FString& PostParameters, TArray<FPendingLocationSave>&& Batch)
+{
+	const int32 BatchID = NextLocationSaveBatchID++;
+
+	for (const FPendingLocationSave& PendingSave : Batch)
+	{
+		if (AOWSPlayerController* PlayerController = PendingSave.PlayerController.Get())
+		{
+			PlayerController->bLocationSaveInFlight = true;
+		}
+	}
+
+	LocationSaveStats.PlayersSaved += Batch.Num();
+	LocationSaveStats.BytesSent += PostParameters.Len();
+	LocationSavesInFlight.Add(BatchID, MoveTemp(Batch));
+
+	if (CVarOWSSaveLocationsLocalStandIn.GetValueOnGameThread())
+	{
+		HandleLocationSaveWithLocalStandIn(Endpoint, PostParameters);
+		OnLocationSaveBatchResponseReceived(nullptr, nullptr, true, BatchID);
+		return;
+	}
+
+	UGameInstance* GameInstance = GetGameInstance();
+	if (!GameInstance)
+	{
+		UE_LOG(OWS, Error, TEXT("SendLocationSaveBatch - No Game Instance Found!"));
+		OnLocationSaveBatchResponseReceived(nullptr, nullptr, false, BatchID);
+		return;
+	}
+
+	GameInstance->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, 30.f,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, &AOWSGameMode::OnLocationSaveBatchResponseReceived, BatchID));
+}
+
+void AOWSGameMode::OnLocationSaveBatchResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 BatchID)
+{
+	TArray<FPendingLocationSave> Batch;
+	LocationSavesInFlight.RemoveAndCopyValue(BatchID, Batch);
+
+	//Only acknowledged saves move the baseline, so a failed batch is resent on the next pass
+	const bool bSaved = bWasSuccessful && (!Response.IsValid() || EHttpResponseCodes::IsOk(Response->GetResponseCode()));
+
+	for (const FPendingLocationSave& PendingSave : Batch)
+	{
+		if (AOWSPlayerController* PlayerController = PendingSave.PlayerController.Get())
+		{
+			PlayerController->bLocationSaveInFlight = false;
+
+			if (bSaved)
+			{
+				PlayerController->LastSavedCharacterLocation = PendingSave.Location;
+				PlayerController->LastSavedCharacterRotation = PendingSave.Rotation;
+				PlayerController->bHasSavedCharacterLocation = true;
+				//Movement made while the save was in flight is picked up again by the next pass
+				PlayerController->UnsavedLocationSince = 0.0;
+			}
+		}
+	}
+
+	OnSaveAllPlayerLocationsResponseReceived(Request, Response, bWasSuccessful);
 }
 
 
@@ -587,6 +885,8 @@ void AOWSGameMode::OnGetAllCharactersOnlineResponseReceived(FHttpRequestPtr Requ
 					CharactersOnline.Add(tempCharacterOnline);
 				}
 			}
+
+			ReindexCharactersOnline();
 			//NotifyGetAllCharactersOnline(CharactersOnline);
 
 			//UE_LOG(OWS, Error, TEXT("Total number of players online: %d"), CharactersOnline.Num());
@@ -605,9 +905,147 @@ void AOWSGameMode::OnGetAllCharactersOnlineResponseReceived(FHttpRequestPtr Requ
 	*/
 }
 
-bool AOWSGameMode::IsPlayerOnline(FString CharacterName)
+bool AOWSGameMode::IsPlayerOnline(const FString& CharacterName) const
 {
-	return CharactersOnline.ContainsByPredicate([&](FCharactersOnlineStruct Result) {return CharacterName == Result.CharName; });
+	return OnlinePlayersByName.Contains(CharacterName);
+}
+
+const FCharactersOnlineStruct* AOWSGameMode::FindCharacterOnline(const FString& CharacterName) const
+{
+	//A Blueprint that edited CharactersOnline in place may have moved the character out from under the index
+	const FOnlinePlayerEntry* Entry = OnlinePlayersByName.Find(CharacterName);
+	if (!Entry || !CharactersOnline.IsValidIndex(Entry->Index) || CharactersOnline[Entry->Index].CharName != CharacterName)
+	{
+		return nullptr;
+	}
+
+	return &CharactersOnline[Entry->Index];
+}
+
+void AOWSGameMode::SetCharactersOnline(const TArray<FCharactersOnlineStruct>& InCharactersOnline)
+{
+	CharactersOnline = InCharactersOnline;
+	ReindexCharactersOnline();
+}
+
+void AOWSGameMode::ReindexCharactersOnline()
+{
+	TMap<FString, FOnlinePlayerEntry> OldEntries = MoveTemp(OnlinePlayersByName);
+	OnlinePlayersByName.Reset();
+
+	for (int32 Index = 0; Index < CharactersOnline.Num();)
+	{
+		const FString CharacterName = CharactersOnline[Index].CharName;
+		if (OnlinePlayersByName.Contains(CharacterName))
+		{
+			UE_LOG(OWS, Warning, TEXT("AOWSGameMode - CharactersOnline lists %s more than once, keeping the first"), *CharacterName);
+			CharactersOnline.RemoveAt(Index);
+			continue;
+		}
+
+		FOnlinePlayerEntry& Entry = OnlinePlayersByName.Add(CharacterName);
+		Entry.Index = Index;
+
+		if (const FOnlinePlayerEntry* OldEntry = OldEntries.Find(CharacterName))
+		{
+			Entry.PlayerController = OldEntry->PlayerController;
+		}
+
+		Index++;
+	}
+}
+
+AOWSPlayerController* AOWSGameMode::FindOnlinePlayerController(const FString& CharacterName) const
+{
+	const FOnlinePlayerEntry* Entry = OnlinePlayersByName.Find(CharacterName);
+	return Entry ? Entry->PlayerController.Get() : nullptr;
+}
+
+AOWSGameMode::FOnlinePlayerEntry* AOWSGameMode::FindOnlinePlayerEntry(const FString& CharacterName)
+{
+	FOnlinePlayerEntry* Entry = OnlinePlayersByName.Find(CharacterName);
+
+	//Only a Blueprint editing CharactersOnline in place gets the index out of step
+	if (Entry && (!CharactersOnline.IsValidIndex(Entry->Index) || CharactersOnline[Entry->Index].CharName != CharacterName))
+	{
+		ReindexCharactersOnline();
+		Entry = OnlinePlayersByName.Find(CharacterName);
+	}
+
+	return Entry;
+}
+
+void AOWSGameMode::AddCharacterOnline(AOWSPlayerController* PlayerController)
+{
+	AOWSPlayerState* OWSPlayerState = PlayerController ? Cast<AOWSPlayerState>(PlayerController->PlayerState) : nullptr;
+	if (!OWSPlayerState || OWSPlayerState->GetPlayerName().IsEmpty())
+	{
+		return;
+	}
+
+	const FString CharacterName = OWSPlayerState->GetPlayerName();
+
+	//A reconnect can log the character in again before the old connection has timed out, the newest connection wins
+	FOnlinePlayerEntry* Entry = FindOnlinePlayerEntry(CharacterName);
+	if (!Entry)
+	{
+		Entry = &OnlinePlayersByName.Add(CharacterName);
+		Entry->Index = CharactersOnline.AddDefaulted();
+	}
+
+	Entry->PlayerController = PlayerController;
+
+	FCharactersOnlineStruct& CharacterOnline = CharactersOnline[Entry->Index];
+	CharacterOnline = FCharactersOnlineStruct();
+	CharacterOnline.CharName = CharacterName;
+	FGuid::Parse(OWSPlayerState->UserSessionGUID, CharacterOnline.UserSessionGUID);
+	CharacterOnline.LoginDate = FDateTime::UtcNow().ToString();
+	CharacterOnline.MapInstanceID = ZoneInstanceID;
+	CharacterOnline.ZoneName = IAmZoneName;
+
+	ScheduleOnlinePlayersSync();
+}
+
+void AOWSGameMode::RemoveCharacterOnline(AOWSPlayerController* PlayerController)
+{
+	if (!PlayerController || !PlayerController->PlayerState)
+	{
+		return;
+	}
+
+	const FString CharacterName = PlayerController->PlayerState->GetPlayerName();
+	const FOnlinePlayerEntry* Entry = FindOnlinePlayerEntry(CharacterName);
+
+	//Not registered, or the character has already logged in again on a newer connection
+	if (!Entry || (Entry->PlayerController.IsValid() && Entry->PlayerController.Get() != PlayerController))
+	{
+		return;
+	}
+
+	const int32 RemovedIndex = Entry->Index;
+	OnlinePlayersByName.Remove(CharacterName);
+
+	//Swap the last entry into the freed slot so removal stays O(1)
+	CharactersOnline.RemoveAtSwap(RemovedIndex, 1, EAllowShrinking::No);
+	if (CharactersOnline.IsValidIndex(RemovedIndex))
+	{
+		if (FOnlinePlayerEntry* MovedEntry = OnlinePlayersByName.Find(CharactersOnline[RemovedIndex].CharName))
+		{
+			MovedEntry->Index = RemovedIndex;
+		}
+	}
+
+	ScheduleOnlinePlayersSync();
+}
+
+void AOWSGameMode::ScheduleOnlinePlayersSync()
+{
+	if (OnlinePlayersSyncDelayInSeconds < 0.f || !GetWorld() || GetWorld()->GetTimerManager().IsTimerActive(OnlinePlayersSyncTimerHandle))
+	{
+		return;
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(OnlinePlayersSyncTimerHandle, this, &AOWSGameMode::UpdateNumberOfPlayers, FMath::Max(OnlinePlayersSyncDelayInSeconds, 0.01f), false);
 }
 
 
@@ -616,9 +1054,9 @@ void AOWSGameMode::GetZoneInstancesForZone(FString ZoneName)
 	FGetZoneInstancesForZoneJSONPost GetZoneInstancesForZoneJSONPost;
 	GetZoneInstancesForZoneJSONPost.Request.ZoneName = ZoneName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetZoneInstancesForZoneJSONPost, PostParameters))
+	if (OWSEndpoints::GetZoneInstancesForZone.SerializeRequest(GetZoneInstancesForZoneJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Instance/GetZoneInstancesForZone", PostParameters, &AOWSGameMode::OnGetZoneInstancesForZoneResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetZoneInstancesForZone, PostParameters, &AOWSGameMode::OnGetZoneInstancesForZoneResponseReceived);
 	}
 	else
 	{
@@ -665,7 +1103,7 @@ void AOWSGameMode::GetZoneInstanceFromZoneInstanceID(int32 LookupZoneInstanceID)
 	FormatParams.Add(LookupZoneInstanceID);
 	FString PostParameters = FString::Format(TEXT("{ \"ZoneInstanceId\": {0} }"), FormatParams);
 
-	ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Instance/GetZoneInstance", PostParameters, &AOWSGameMode::OnGetZoneInstanceFromZoneInstanceIDResponseReceived);
+	ProcessOWS2POSTRequest(OWSEndpoints::GetZoneInstance, PostParameters, &AOWSGameMode::OnGetZoneInstanceFromZoneInstanceIDResponseReceived);
 }
 
 void AOWSGameMode::OnGetZoneInstanceFromZoneInstanceIDResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -716,10 +1154,30 @@ void AOWSGameMode::UpdateNumberOfPlayers()
 	FUpdateNumberOfPlayersJSONPost UpdateNumberOfPlayersJSONPost;
 	UpdateNumberOfPlayersJSONPost.ZoneInstanceId = ZoneInstanceID;
 	UpdateNumberOfPlayersJSONPost.NumberOfConnectedPlayers = NumberOfConnectedPlayers;
+
+	if (bReportServerLoad)
+	{
+		//IsSoftFull compares against the previous report, so LastServerLoad is only replaced afterwards
+		FOWSZoneServerLoad Load = ServerLoadSampler.TakeSample(GetWorld());
+		Load.NumberOfConnectedPlayers = NumPlayers;
+		Load.bSoftFull = IsSoftFull(Load);
+		LastServerLoad = Load;
+
+		UpdateNumberOfPlayersJSONPost.AverageFrameTimeMs = LastServerLoad.AverageFrameTimeMs;
+		UpdateNumberOfPlayersJSONPost.P99FrameTimeMs = LastServerLoad.P99FrameTimeMs;
+		UpdateNumberOfPlayersJSONPost.ReplicatedActors = LastServerLoad.ReplicatedActors;
+		UpdateNumberOfPlayersJSONPost.OutgoingKBps = LastServerLoad.OutgoingKBps;
+		UpdateNumberOfPlayersJSONPost.UsedMemoryMB = LastServerLoad.UsedMemoryMB;
+		UpdateNumberOfPlayersJSONPost.bSoftFull = LastServerLoad.bSoftFull;
+
+		UE_LOG(OWS, Verbose, TEXT("UpdateNumberOfPlayers - avg %.1fms p99 %.1fms over %d frames, %d replicated actors, %.1f KB/s out, %.0f MB%s"),
+			LastServerLoad.AverageFrameTimeMs, LastServerLoad.P99FrameTimeMs, LastServerLoad.FramesSampled, LastServerLoad.ReplicatedActors,
+			LastServerLoad.OutgoingKBps, LastServerLoad.UsedMemoryMB, LastServerLoad.bSoftFull ? TEXT(", soft-full") : TEXT(""));
+	}
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(UpdateNumberOfPlayersJSONPost, PostParameters))
+	if (OWSEndpoints::UpdateNumberOfPlayers.SerializeRequest(UpdateNumberOfPlayersJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Instance/UpdateNumberOfPlayers", PostParameters, &AOWSGameMode::OnUpdateNumberOfPlayersResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::UpdateNumberOfPlayers, PostParameters, &AOWSGameMode::OnUpdateNumberOfPlayersResponseReceived);
 	}
 	else
 	{
@@ -727,6 +1185,24 @@ void AOWSGameMode::UpdateNumberOfPlayers()
 	}
 }
 
+bool AOWSGameMode::IsSoftFull(const FOWSZoneServerLoad& Load) const
+{
+	//Until enough frames are in, e.g. for a report right after a login, keep whatever was reported last
+	if (Load.FramesSampled < 10)
+	{
+		return LastServerLoad.bSoftFull;
+	}
+
+	//Clearing uses lower thresholds than setting, so a server hovering around a threshold does not flap
+	const float Scale = LastServerLoad.bSoftFull ? SoftFullRecoveryFraction : 1.f;
+	auto Exceeds = [Scale](float Value, float Threshold) { return Threshold > 0.f && Value > Threshold * Scale; };
+
+	return Exceeds(Load.P99FrameTimeMs, SoftFullP99FrameTimeMs)
+		|| Exceeds(Load.AverageFrameTimeMs, SoftFullAverageFrameTimeMs)
+		|| Exceeds(Load.OutgoingKBps, SoftFullOutgoingKBps)
+		|| Exceeds(Load.UsedMemoryMB, SoftFullMemoryMB);
+}
+
 void AOWSGameMode::OnUpdateNumberOfPlayersResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
 	if (bWasSuccessful)
@@ -743,7 +1219,7 @@ void AOWSGameMode::OnUpdateNumberOfPlayersResponseReceived(FHttpRequestPtr Reque
 void AOWSGameMode::GetCurrentWorldTime()
 {
 	FString PostParameters = "{}";
-	ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Instance/GetCurrentWorldTime", PostParameters, &AOWSGameMode::OnGetCurrentWorldTimeResponseReceived);
+	ProcessOWS2POSTRequest(OWSEndpoints::GetCurrentWorldTime, PostParameters, &AOWSGameMode::OnGetCurrentWorldTimeResponseReceived);
 }
 
 void AOWSGameMode::OnGetCurrentWorldTimeResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -784,9 +1260,9 @@ void AOWSGameMode::AddZone(FString ZoneName, FString MapName, int SoftPlayerCap,
 	AddZoneJSONPost.AddOrUpdateZone.HardPlayerCap = HardPlayerCap;
 	AddZoneJSONPost.AddOrUpdateZone.MapMode = MapMode;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(AddZoneJSONPost, PostParameters))
+	if (OWSEndpoints::AddZone.SerializeRequest(AddZoneJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Zones/AddZone", PostParameters, &AOWSGameMode::OnAddZoneResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddZone, PostParameters, &AOWSGameMode::OnAddZoneResponseReceived);
 	}
 	else
 	{
@@ -829,9 +1305,9 @@ void AOWSGameMode::UpdateZone(int32 MapID, FString ZoneName, FString MapName, in
 	UpdateZoneJSONPost.AddOrUpdateZone.HardPlayerCap = HardPlayerCap;
 	UpdateZoneJSONPost.AddOrUpdateZone.MapMode = MapMode;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(UpdateZoneJSONPost, PostParameters))
+	if (OWSEndpoints::UpdateZone.SerializeRequest(UpdateZoneJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("InstanceManagementAPI", "api/Zones/UpdateZone", PostParameters, &AOWSGameMode::OnUpdateZoneResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::UpdateZone, PostParameters, &AOWSGameMode::OnUpdateZoneResponseReceived);
 	}
 	else
 	{
@@ -2,6 +2,32 @@
 
 
 #include "OWSGameplayAbility.h"
+#include "OWSProjectilePool.h"
+#include "AbilitySystemComponent.h"
+
+void UOWSGameplayAbility::OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	Super::OnGiveAbility(ActorInfo, Spec);
+
+	if (ProjectilePoolWarmUp.Num() == 0 || !ActorInfo || !ActorInfo->AbilitySystemComponent.IsValid())
+	{
+		return;
+	}
+
+	//Runs on the server and on the owning client, which fires fake projectiles from its own pool
+	UWorld* World = ActorInfo->AbilitySystemComponent->GetWorld();
+	UOWSProjectilePool* ProjectilePool = World ? World->GetSubsystem<UOWSProjectilePool>() : nullptr;
+
+	if (!ProjectilePool)
+	{
+		return;
+	}
+
+	for (const TPair<TSubclassOf<AOWSAdvancedProjectile>, int32>& WarmUp : ProjectilePoolWarmUp)
+	{
+		ProjectilePool->WarmUp(WarmUp.Key, WarmUp.Value);
+	}
+}
 
 AOWSCharacterWithAbilities* UOWSGameplayAbility::GetOWSAvatarActor()
 {
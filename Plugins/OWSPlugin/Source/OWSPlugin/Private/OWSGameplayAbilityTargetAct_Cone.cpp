@@ -5,6 +5,7 @@
 #include "WorldCollision.h"
 #include "Engine/OverlapResult.h"
 #include "Abilities/GameplayAbility.h"
+#include "OWSTargetingQueries.h"
 
 AOWSGameplayAbilityTargetAct_Cone::AOWSGameplayAbilityTargetAct_Cone(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -49,17 +50,33 @@ TArray<TWeakObjectPtr<AActor> >	AOWSGameplayAbilityTargetAct_Cone::PerformOverla
 	FCollisionQueryParams Params(SCENE_QUERY_STAT(RadiusTargetingOverlap), bTraceComplex);
 	Params.bReturnPhysicalMaterial = false;
 
-	TArray<FOverlapResult> Overlaps;
+	//Each pawn once, however many of its components overlap
+	TArray<APawn*> Pawns;
 
-	SourceActor->GetWorld()->OverlapMultiByObjectType(Overlaps, Origin, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Radius), Params);
+	if (UOWSTargetingQueries* TargetingQueries = SourceActor->GetWorld()->GetSubsystem<UOWSTargetingQueries>())
+	{
+		TargetingQueries->OverlapPawns(Origin, Radius, Params, Pawns);
+	}
+	else
+	{
+		TArray<FOverlapResult> Overlaps;
+		SourceActor->GetWorld()->OverlapMultiByObjectType(Overlaps, Origin, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Radius), Params);
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			if (APawn* PawnActor = Cast<APawn>(Overlap.GetActor()))
+			{
+				Pawns.AddUnique(PawnActor);
+			}
+		}
+	}
 
 	TArray<TWeakObjectPtr<AActor>>	HitActors;
 
-	for (int32 i = 0; i < Overlaps.Num(); ++i)
+	for (APawn* PawnActor : Pawns)
 	{
 		//Should this check to see if these pawns are in the AimTarget list?
-		APawn* PawnActor = Cast<APawn>(Overlaps[i].GetActor());
-		if (PawnActor && !HitActors.Contains(PawnActor) && Filter.FilterPassesForActor(PawnActor))
+		if (Filter.FilterPassesForActor(PawnActor))
 		{
 			FVector ActorOrigin;
 			FVector ActorBoxExtent;
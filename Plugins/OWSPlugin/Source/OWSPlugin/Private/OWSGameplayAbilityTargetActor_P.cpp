@@ -6,6 +6,7 @@
 #include "Abilities/GameplayAbility.h"
 #include "AbilitySystemLog.h"
 #include "Abilities/GameplayAbilityWorldReticle_ActorVisualization.h"
+#include "OWSTargetingQueries.h"
 
 
 
@@ -24,6 +25,14 @@ void AOWSGameplayAbilityTargetActor_P::EndPlay(const EEndPlayReason::Type EndPla
 	Super::EndPlay(EndPlayReason);
 }
 
+void AOWSGameplayAbilityTargetActor_P::Tick(float DeltaSeconds)
+{
+	//Only moves the reticle, so the camera trace may be the one started last frame
+	bIsReticleTrace = true;
+	Super::Tick(DeltaSeconds);
+	bIsReticleTrace = false;
+}
+
 void AOWSGameplayAbilityTargetActor_P::StartTargeting(UGameplayAbility* InAbility)
 {
 	Super::StartTargeting(InAbility);
@@ -105,8 +114,10 @@ void AOWSGameplayAbilityTargetActor_P::AimWithPlayerController(const AActor* InS
 
 		ClipCameraRayToAbilityRange(ViewStart, ViewDir, TraceStart, MaxRange, MinimumTargetingDistance, ViewEnd);
 
+		//Every targeting actor of this player aims through the same camera ray, so the trace is shared
 		FHitResult HitResult;
-		LineTraceWithFilter(HitResult, InSourceActor->GetWorld(), Filter, ViewStart, ViewEnd, TraceProfile.Name, Params);
+		UOWSTargetingQueries::LineTraceWithFilter(HitResult, InSourceActor->GetWorld(), Filter, ViewStart, ViewEnd, TraceProfile.Name, Params,
+			bIsReticleTrace ? PC : nullptr);
 
 		const bool bUseTraceResult = HitResult.bBlockingHit && (FVector::DistSquared(TraceStart, HitResult.Location) <= (MaxRange * MaxRange));
 
@@ -165,7 +176,7 @@ FHitResult AOWSGameplayAbilityTargetActor_P::PerformTrace(AActor* InSourceActor)
 	else
 	{
 		//Use a line trace initially to see where the player is actually pointing
-		LineTraceWithFilter(ReturnHitResult, InSourceActor->GetWorld(), Filter, TraceStart, TraceEnd, TraceProfile.Name, Params);
+		UOWSTargetingQueries::LineTraceWithFilter(ReturnHitResult, InSourceActor->GetWorld(), Filter, TraceStart, TraceEnd, TraceProfile.Name, Params);
 		//Default to end of trace line if we don't hit anything.
 		if (!ReturnHitResult.bBlockingHit)
 		{
@@ -179,7 +190,7 @@ FHitResult AOWSGameplayAbilityTargetActor_P::PerformTrace(AActor* InSourceActor)
 	TraceEnd = TraceStart;
 	TraceStart.Z += CollisionHeightOffset;
 	TraceEnd.Z -= 99999.0f;
-	LineTraceWithFilter(ReturnHitResult, InSourceActor->GetWorld(), Filter, TraceStart, TraceEnd, TraceProfile.Name, Params);
+	UOWSTargetingQueries::LineTraceWithFilter(ReturnHitResult, InSourceActor->GetWorld(), Filter, TraceStart, TraceEnd, TraceProfile.Name, Params);
 	//if (!ReturnHitResult.bBlockingHit) then our endpoint may be off the map. Hopefully this is only possible in debug maps.
 
 	bLastTraceWasGood = true;		//So far, we're good. If we need a ground spot and can't find one, we'll come back.
@@ -4,6 +4,7 @@
 #include "DrawDebugHelpers.h"
 #include "GameFramework/PlayerController.h"
 #include "Abilities/GameplayAbility.h"
+#include "OWSTargetingQueries.h"
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------
 //
@@ -35,25 +36,7 @@ void AOWSGameplayAbilityTargetActor_Tr::EndPlay(const EEndPlayReason::Type EndPl
 
 void AOWSGameplayAbilityTargetActor_Tr::LineTraceWithFilter(FHitResult& OutHitResult, const UWorld* World, const FOWSGameplayTargetDataFilterHandle FilterHandle, const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams Params)
 {
-	check(World);
-
-	TArray<FHitResult> HitResults;
-	World->LineTraceMultiByProfile(HitResults, Start, End, ProfileName, Params);
-
-	OutHitResult.TraceStart = Start;
-	OutHitResult.TraceEnd = End;
-
-	for (int32 HitIdx = 0; HitIdx < HitResults.Num(); ++HitIdx)
-	{
-		const FHitResult& Hit = HitResults[HitIdx];
-
-		if (!Hit.HitObjectHandle.IsValid() || FilterHandle.FilterPassesForActor(Hit.HitObjectHandle.FetchActor()))
-		{
-			OutHitResult = Hit;
-			OutHitResult.bBlockingHit = true; // treat it as a blocking hit
-			return;
-		}
-	}
+	UOWSTargetingQueries::LineTraceWithFilter(OutHitResult, World, FilterHandle, Start, End, ProfileName, Params);
 }
 
 void AOWSGameplayAbilityTargetActor_Tr::SweepWithFilter(FHitResult& OutHitResult, const UWorld* World, const FOWSGameplayTargetDataFilterHandle FilterHandle, const FVector& Start, const FVector& End, const FQuat& Rotation, const FCollisionShape CollisionShape, FName ProfileName, const FCollisionQueryParams Params)
@@ -98,8 +81,10 @@ void AOWSGameplayAbilityTargetActor_Tr::AimWithPlayerController(const AActor* In
 
 	ClipCameraRayToAbilityRange(ViewStart, ViewDir, TraceStart, MaxRange, ViewEnd);
 
+	//Every targeting actor of this player aims through the same camera ray, so the trace is shared
 	FHitResult HitResult;
-	LineTraceWithFilter(HitResult, InSourceActor->GetWorld(), OWSFilter, ViewStart, ViewEnd, TraceProfile.Name, Params);
+	UOWSTargetingQueries::LineTraceWithFilter(HitResult, InSourceActor->GetWorld(), OWSFilter, ViewStart, ViewEnd, TraceProfile.Name, Params,
+		bIsReticleTrace ? PC : nullptr);
 
 	const bool bUseTraceResult = HitResult.bBlockingHit && (FVector::DistSquared(TraceStart, HitResult.Location) <= (MaxRange * MaxRange));
 
@@ -180,7 +165,11 @@ void AOWSGameplayAbilityTargetActor_Tr::Tick(float DeltaSeconds)
 	// very temp - do a mostly hardcoded trace from the source actor
 	if (SourceActor)
 	{
+		//Only moves the reticle, so the camera trace may be the one started last frame
+		bIsReticleTrace = true;
 		FHitResult HitResult = PerformTrace(SourceActor);
+		bIsReticleTrace = false;
+
 		FVector EndPoint = HitResult.Component.IsValid() ? HitResult.ImpactPoint : HitResult.TraceEnd;
 
 #if ENABLE_DRAW_DEBUG
@@ -1222,21 +1222,10 @@ void AOWSHUD::NotifyHitBoxClick(const FName BoxName)
 	}
 	else if (BoxName == "SplitStackButton")
 	{
-		if (InventoryItemStackToSplit)
+		if (InventoryItemStackToSplit && OWSChar)
 		{
-			UOWSInventory* Inventory = OWSChar->GetHUDInventoryFromName(InventoryBeingDraggedFrom);
-			if (Inventory)
-			{
-				AOWSInventoryItem* SplitItem = InventoryItemStackToSplit->RemoveFromTopOfStack();
-				if (SplitItem)
-				{
-					int32 Slot = Inventory->FindFirstEmptySlotToFitItemOfSize(SplitItem->IconSlotWidth, SplitItem->IconSlotHeight);
-					if (Slot != -1)
-					{
-						Inventory->AddItemToSlot(SplitItem, Slot);
-					}
-				}
-			}
+			//The server splits the stack and the new slot replicates back
+			OWSChar->Server_SplitStack(InventoryBeingDraggedFrom, InventoryItemStackToSplit->SlotNumber);
 		}
 		SplitDialogOpen = false;
 	}
@@ -1346,41 +1335,21 @@ void AOWSHUD::GetInput()
 				UOWSInventory* Inventory = OWSChar->GetHUDInventoryFromName(InventoryName);
 				if (Inventory)
 				{
-					UOWSInventory* SourceInventory = OWSChar->GetHUDInventoryFromName(InventoryBeingDraggedFrom);
-					UOWSInventoryItemStack* InventoryItemStackSource = SourceInventory->GetStackInSlot(SlotBeingDraggedFrom);
-					UOWSInventoryItemStack* InventoryItemStackDest = Inventory->GetStackInSlot(Slot);
-
+					//The server makes the move and saves the inventory, the slots replicate back to us
 					if (InventoryBeingDraggedFrom == InventoryName && Slot != SlotBeingDraggedFrom)
 					{
-						AOWSInventoryItem* SourceItem = InventoryItemStackSource->GetTopItemFromStack();
-						AOWSInventoryItem* DestItem = InventoryItemStackDest->GetTopItemFromStack();
-						if (DestItem)
+						if (Inventory->GetItemCountInSlot(Slot) > 0)
 						{
-							if (SourceItem->UniqueItemGUID == DestItem->UniqueItemGUID
-								&& SourceItem->CanStack
-								&& InventoryItemStackDest->InventoryItems.Num() < DestItem->StackSize)
-							{
-								InventoryItemStackDest->AddToStack(InventoryItemStackSource);
-								SourceInventory->RemoveStackFromSlot(SlotBeingDraggedFrom);
-								OWSChar->SerializeAndSaveInventory(InventoryName);
-							}
-							else
-							{
-								Inventory->SwapSlots(Slot, SlotBeingDraggedFrom);
-								OWSChar->SerializeAndSaveInventory(InventoryName);
-							}
+							OWSChar->Server_MoveStack(InventoryBeingDraggedFrom, SlotBeingDraggedFrom, InventoryName, Slot);
 						}
 						else
 						{
-							Inventory->SwapSlots(Slot, SlotBeingDraggedFrom);
-							OWSChar->SerializeAndSaveInventory(InventoryName);
+							OWSChar->Server_SwapSlots(InventoryName, Slot, SlotBeingDraggedFrom);
 						}
 					}
 					else if (InventoryBeingDraggedFrom != InventoryName)
 					{
-						SourceInventory->AddStackToSlot(InventoryItemStackDest, SlotBeingDraggedFrom);
-						Inventory->AddStackToSlot(InventoryItemStackSource, Slot);
-						OWSChar->SerializeAndSaveInventory(InventoryName);
+						OWSChar->Server_MoveStack(InventoryBeingDraggedFrom, SlotBeingDraggedFrom, InventoryName, Slot);
 					}
 
 				}
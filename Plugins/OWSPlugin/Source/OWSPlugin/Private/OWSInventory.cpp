@@ -3,25 +3,137 @@
 #include "OWSInventory.h"
 #include "OWSPlugin.h"
 #include "OWSGameMode.h"
+#include "Net/UnrealNetwork.h"
+
+void FOWSInventorySlotList::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+	for (int32 Index : RemovedIndices)
+	{
+		OwningInventory->ClearReplicatedSlot(Entries[Index]);
+	}
+}
+
+void FOWSInventorySlotList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+	for (int32 Index : AddedIndices)
+	{
+		OwningInventory->ApplyReplicatedSlot(Entries[Index]);
+	}
+}
+
+void FOWSInventorySlotList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+	for (int32 Index : ChangedIndices)
+	{
+		OwningInventory->ApplyReplicatedSlot(Entries[Index]);
+	}
+}
 
 UOWSInventory::UOWSInventory(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	//SetReplicates(true);
-	//bOnlyRelevantToOwner = true;
+	ReplicatedSlots.OwningInventory = this;
+}
+
+void UOWSInventory::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	//The character only replicates its inventories to the owner
+	DOREPLIFETIME(UOWSInventory, InventoryName);
+	DOREPLIFETIME(UOWSInventory, NumberOfGroupsUnlocked);
+	DOREPLIFETIME(UOWSInventory, SlotsPerGroup);
+	DOREPLIFETIME(UOWSInventory, NumberOfSlots);
+	DOREPLIFETIME(UOWSInventory, NumberOfColumns);
+	DOREPLIFETIME(UOWSInventory, ItemTypes);
+	DOREPLIFETIME(UOWSInventory, ReplicatedSlots);
+}
+
+void FOWSInventorySlots::Init(int32 NumberOfSlots)
+{
+	ItemTypes.Init(INDEX_NONE, NumberOfSlots);
+	Counts.Init(0, NumberOfSlots);
+	Conditions.Init(0, NumberOfSlots);
+	NumberOfUsesLeft.Init(0, NumberOfSlots);
+	UniqueItemGUIDs.Init(FGuid(), NumberOfSlots);
+	ItemMeshIDs.Init(0, NumberOfSlots);
+	PerInstanceCustomData.Init(FString(), NumberOfSlots);
+}
+
+void FOWSInventorySlots::Clear(int32 Slot)
+{
+	ItemTypes[Slot] = INDEX_NONE;
+	Counts[Slot] = 0;
+	Conditions[Slot] = 0;
+	NumberOfUsesLeft[Slot] = 0;
+	UniqueItemGUIDs[Slot] = FGuid();
+	ItemMeshIDs[Slot] = 0;
+	PerInstanceCustomData[Slot].Reset();
+}
+
+void FOWSInventorySlots::Swap(int32 SlotA, int32 SlotB)
+{
+	ItemTypes.Swap(SlotA, SlotB);
+	Counts.Swap(SlotA, SlotB);
+	Conditions.Swap(SlotA, SlotB);
+	NumberOfUsesLeft.Swap(SlotA, SlotB);
+	UniqueItemGUIDs.Swap(SlotA, SlotB);
+	ItemMeshIDs.Swap(SlotA, SlotB);
+	PerInstanceCustomData.Swap(SlotA, SlotB);
 }
 
 void UOWSInventory::SetInventorySize(int32 Size, int32 inNumberOfColumns)
 {
+	if (inNumberOfColumns < 1 || inNumberOfColumns > OWS_MAXNUMBEROFINVENTORYCOLUMNS)
+	{
+		UE_LOG(OWS, Error, TEXT("UOWSInventory - SetInventorySize - %s can't have %d columns, using %d"), *InventoryName.ToString(), inNumberOfColumns, FMath::Clamp(inNumberOfColumns, 1, OWS_MAXNUMBEROFINVENTORYCOLUMNS));
+		inNumberOfColumns = FMath::Clamp(inNumberOfColumns, 1, OWS_MAXNUMBEROFINVENTORYCOLUMNS);
+	}
+
 	NumberOfSlots = Size;
 	this->NumberOfColumns = inNumberOfColumns;
-	InventoryItemStacks.Empty();
-	SlotsFilled.Empty();
-	for (int32 CurSlot = 0; CurSlot < Size; CurSlot++)
+	Slots.Init(Size);
+	InventoryItemStacks.Init(nullptr, Size);
+	RebuildOccupancy();
+
+	if (IsReplicatingSlots())
+	{
+		ReplicatedSlots.Entries.Reset();
+		ReplicatedSlots.MarkArrayDirty();
+	}
+}
+
+void UOWSInventory::OnRep_InventorySize()
+{
+	//Both values arrive before this is called, slots that came in ahead of them are applied again once the arrays exist
+	if (Slots.Num() != NumberOfSlots || OccupiedRows.Num() != GetNumberOfRows())
+	{
+		SetInventorySize(NumberOfSlots, NumberOfColumns);
+
+		for (const FOWSInventorySlotEntry& Entry : ReplicatedSlots.Entries)
+		{
+			ApplyReplicatedSlot(Entry);
+		}
+	}
+}
+
+void UOWSInventory::OnRep_ItemTypes()
+{
+	ItemTypeIndexByName.Reset();
+	for (int32 ItemType = 0; ItemType < ItemTypes.Num(); ItemType++)
+	{
+		ItemTypeIndexByName.Add(ItemTypes[ItemType].ItemName, ItemType);
+	}
+
+	//Slots may have arrived before their item type, their footprints and stacks are rebuilt with it
+	RebuildOccupancy();
+
+	for (int32 Slot = 0; Slot < InventoryItemStacks.Num(); Slot++)
 	{
-		UOWSInventoryItemStack* tempInventoryItemStack = NewObject<UOWSInventoryItemStack>();
-		InventoryItemStacks.Add(tempInventoryItemStack);
-		SlotsFilled.Add(false);
+		if (InventoryItemStacks[Slot])
+		{
+			RefreshStack(Slot);
+		}
 	}
 }
 
@@ -32,21 +144,36 @@ void UOWSInventory::SetInventoryName(FName inInventoryName)
 
 void UOWSInventory::AddStackToSlot(UOWSInventoryItemStack* ItemStack, int32 Slot)
 {
-	if (InventoryItemStacks.IsValidIndex(Slot))
+	if (!CanChangeSlots(TEXT("AddStackToSlot")))
+		return;
+
+	if (ItemStack && InventoryItemStacks.IsValidIndex(Slot))
 	{
 		ItemStack->SlotNumber = Slot;
+		ItemStack->OwningInventory = this;
 		InventoryItemStacks[Slot] = ItemStack;
-		UpdateSlotsFilled();
+		WriteSlotFromStack(Slot, ItemStack);
+		SlotChanged(Slot);
 	}
 }
 
 void UOWSInventory::RemoveStackFromSlot(int32 Slot)
 {
+	if (!CanChangeSlots(TEXT("RemoveStackFromSlot")))
+		return;
+
 	if (InventoryItemStacks.IsValidIndex(Slot))
 	{
-		UOWSInventoryItemStack* tempInventoryItemStack = NewObject<UOWSInventoryItemStack>();
-		InventoryItemStacks[Slot] = tempInventoryItemStack;
-		UpdateSlotsFilled();
+		//The removed stack may already be in another slot or inventory, only let go of it if it is still ours
+		UOWSInventoryItemStack* RemovedStack = InventoryItemStacks[Slot];
+		if (RemovedStack && RemovedStack->OwningInventory == this && RemovedStack->SlotNumber == Slot)
+		{
+			RemovedStack->OwningInventory = nullptr;
+		}
+
+		InventoryItemStacks[Slot] = nullptr;
+		Slots.Clear(Slot);
+		SlotChanged(Slot);
 	}
 }
 
@@ -61,42 +188,52 @@ bool UOWSInventory::AddItemToInventory(AOWSInventoryItem* Item)
 	int32 Slot = FindFirstEmptySlotToFitItemOfSize(Item->IconSlotWidth, Item->IconSlotHeight);
 	if (Slot != -1 && Slot < (NumberOfGroupsUnlocked * SlotsPerGroup)) //-1 = Full Inventory
 	{
-		//Add item on the server
-		//AddItemToSlot_Internal(Item, Slot);
 		//Call AddItemToInventory on OWSCharacter
 		FGuid UniqueItemGUID;
 
 		//Replicate item definition if it does not already exist
-		AOWSGameMode* OWSGameMode = OwningPlayerCharacter->GetGameMode();
-
-		if (!OWSGameMode)
+		if (!ReplicateItemDefinition(Item->ItemName))
 			return false;
 
-		FInventoryItemStruct& ItemDefinition = OWSGameMode->FindItemDefinition(Item->ItemName);
-
-		bool bWasItemAdded = OwningPlayerCharacter->AddItemToLocalInventoryItems(Item->ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
-			ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+		//Add item to server side inventory
+		OwningPlayerCharacter->AddItemToInventory(InventoryName.ToString(), Item->ItemName, Slot, Item->StackSize, Item->NumberOfUsesLeft, Item->Condition, UniqueItemGUID);
 
-		if (bWasItemAdded)
+		//Add item on the server, the slot replicates to the owning client
+		if (UniqueItemGUID.IsValid())
 		{
-			UE_LOG(OWS, Warning, TEXT("UOWSInventory - AddItemToInventory - AddItemMeshToAllPlayers Called"));
-			OwningPlayerCharacter->GetGameMode()->AddItemMeshToAllPlayers(Item->ItemName, ItemDefinition.ItemMeshID);
-
-			OwningPlayerCharacter->Client_AddItemToLocalInventoryItems(Item->ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
-				ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+			Item->UniqueItemGUID = UniqueItemGUID;
 		}
-
-		//Add item to server side inventory
-		OwningPlayerCharacter->AddItemToInventory(InventoryName.ToString(), Item->ItemName, Slot, Item->StackSize, Item->NumberOfUsesLeft, Item->Condition, UniqueItemGUID);
-		//Call the Owning client to add the item locally
-		OwningPlayerCharacter->Client_AddItemToInventory(InventoryName, Item->ItemName, Item->StackSize, Slot, Item->NumberOfUsesLeft, Item->Condition,
-			Item->PerInstanceCustomData, UniqueItemGUID, Item->ItemMeshID);
+		AddItemToSlot_Internal(Item, Slot);
 		return true;
 	}
 
 	return false;
 }
 
+bool UOWSInventory::ReplicateItemDefinition(const FString& ItemName)
+{
+	AOWSGameMode* OWSGameMode = OwningPlayerCharacter->GetGameMode();
+
+	if (!OWSGameMode)
+		return false;
+
+	FInventoryItemStruct& ItemDefinition = OWSGameMode->FindItemDefinition(ItemName);
+
+	bool bWasItemAdded = OwningPlayerCharacter->AddItemToLocalInventoryItems(ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
+		ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+
+	if (bWasItemAdded)
+	{
+		UE_LOG(OWS, Warning, TEXT("UOWSInventory - ReplicateItemDefinition - AddItemMeshToAllPlayers Called"));
+		OWSGameMode->AddItemMeshToAllPlayers(ItemName, ItemDefinition.ItemMeshID);
+
+		OwningPlayerCharacter->Client_AddItemToLocalInventoryItems(ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
+			ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+	}
+
+	return true;
+}
+
 //Can only be called on the Server side
 void UOWSInventory::AddItemToSlot(AOWSInventoryItem* Item, int32 Slot)
 {	
@@ -104,258 +241,597 @@ void UOWSInventory::AddItemToSlot(AOWSInventoryItem* Item, int32 Slot)
 
 	AddItemToSlot_Internal(Item, Slot);
 
-	//Replicate item definition if it does not already exist
-	AOWSGameMode* OWSGameMode = OwningPlayerCharacter->GetGameMode();
+	//Replicate item definition if it does not already exist, the slot itself replicates to the owning client
+	ReplicateItemDefinition(Item->ItemName);
+}
 
-	if (!OWSGameMode)
+void UOWSInventory::AddItemToSlot_Internal(AOWSInventoryItem* Item, int32 Slot)
+{
+	if (!CanChangeSlots(TEXT("AddItemToSlot")))
 		return;
 
-	FInventoryItemStruct& ItemDefinition = OWSGameMode->FindItemDefinition(Item->ItemName);
+	if (!Item || !Slots.IsValidIndex(Slot))
+	{
+		return;
+	}
 
-	bool bWasItemAdded = OwningPlayerCharacter->AddItemToLocalInventoryItems(Item->ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
-		ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+	//The new item goes on top of whatever is in the slot
+	WriteSlotFromItem(Slot, Item, Slots.Counts[Slot] + 1);
 
-	if (bWasItemAdded)
+	if (UOWSInventoryItemStack* InventoryItemStack = InventoryItemStacks[Slot])
 	{
-		UE_LOG(OWS, Warning, TEXT("UOWSInventory - AddItemToSlot - AddItemMeshToAllPlayers Called"));
-		OwningPlayerCharacter->GetGameMode()->AddItemMeshToAllPlayers(Item->ItemName, ItemDefinition.ItemMeshID);
+		InventoryItemStack->InventoryItems.Push(Item);
+	}
 
-		OwningPlayerCharacter->Client_AddItemToLocalInventoryItems(Item->ItemName, ItemDefinition.ItemCanStack, ItemDefinition.IsUsable, ItemDefinition.IsConsumedOnUse, ItemDefinition.ItemTypeID,
-			ItemDefinition.TextureToUseForIcon, ItemDefinition.IconSlotWidth, ItemDefinition.IconSlotHeight, ItemDefinition.ItemMeshID, ItemDefinition.CustomData);
+	SlotChanged(Slot);
+}
+
+//Can only be called on the Server side
+void UOWSInventory::AddItemsFromInventoryItemStruct(const TArray<FInventoryItemStruct>& ItemsToAdd)
+{
+	UE_LOG(OWS, Warning, TEXT("UOWSInventory - AddItemsFromInventoryItemStruct"));
+
+	AddItemsFromInventoryItemStruct_Internal(ItemsToAdd);
+
+	if (!OwningPlayerCharacter)
+		return;
+
+	//Each item definition is checked once, however many rows hold the item
+	TSet<FString> ItemNamesReplicated;
+	for (const FInventoryItemStruct& CurItem : ItemsToAdd)
+	{
+		bool bAlreadyReplicated = false;
+		ItemNamesReplicated.Add(CurItem.ItemName, &bAlreadyReplicated);
+
+		if (!bAlreadyReplicated && !ReplicateItemDefinition(CurItem.ItemName))
+			return;
 	}
+}
+
+void UOWSInventory::AddItemsFromInventoryItemStruct_Internal(const TArray<FInventoryItemStruct>& ItemsToAdd)
+{
+	if (!CanChangeSlots(TEXT("AddItemsFromInventoryItemStruct")))
+		return;
+
+	for (const FInventoryItemStruct& CurItem : ItemsToAdd)
+	{
+		const int32 Slot = CurItem.InSlotNumber;
+		if (!Slots.IsValidIndex(Slot))
+		{
+			UE_LOG(OWS, Warning, TEXT("UOWSInventory - AddItemsFromInventoryItemStruct - %s is in slot %d which is outside of %s"), *CurItem.ItemName, Slot, *InventoryName.ToString());
+			continue;
+		}
+
+		//Like adding the row's item Quantity times, it stacks on top of what is already in the slot
+		Slots.ItemTypes[Slot] = FindOrAddItemType(CurItem.ItemName, CurItem.TextureIcon, CurItem.IconSlotWidth, CurItem.IconSlotHeight, CurItem.ItemStackSize, CurItem.ItemCanStack);
+		Slots.Counts[Slot] += FMath::Max(CurItem.Quantity, 1);
+		Slots.Conditions[Slot] = CurItem.Condition;
+		Slots.NumberOfUsesLeft[Slot] = CurItem.NumberOfUsesLeft;
+		Slots.UniqueItemGUIDs[Slot] = CurItem.UniqueItemGUID;
+		Slots.ItemMeshIDs[Slot] = CurItem.ItemMeshID;
+		Slots.PerInstanceCustomData[Slot] = CurItem.PerInstanceCustomData;
 
-	//Call the Owning client to add the item locally
-	OwningPlayerCharacter->Client_AddItemToInventory(InventoryName, Item->ItemName, Item->StackSize, Slot, Item->NumberOfUsesLeft, Item->Condition,
-		Item->PerInstanceCustomData, Item->UniqueItemGUID, Item->ItemMeshID);
+		if (InventoryItemStacks[Slot])
+		{
+			RefreshStack(Slot);
+		}
+
+		SlotChanged(Slot);
+	}
 }
 
-void UOWSInventory::AddItemToSlot_Internal(AOWSInventoryItem* Item, int32 Slot)
+AOWSInventoryItem* UOWSInventory::RemoveOneItemFromSlot(int32 Slot)
 {
-	UOWSInventoryItemStack* InventoryItemStack = GetStackInSlot(Slot);
-	if (InventoryItemStack)
+	if (!CanChangeSlots(TEXT("RemoveOneItemFromSlot")))
+		return nullptr;
+
+	if (!Slots.IsValidIndex(Slot) || !Slots.IsFilled(Slot))
+	{
+		return nullptr;
+	}
+
+	UOWSInventoryItemStack* InventoryItemStack = InventoryItemStacks[Slot];
+	AOWSInventoryItem* InventoryItemRemoved = (InventoryItemStack && InventoryItemStack->InventoryItems.Num() > 0) ? InventoryItemStack->InventoryItems.Pop() : MaterializeItem(Slot);
+
+	Slots.Counts[Slot]--;
+	if (!Slots.IsFilled(Slot))
 	{
-		if (!InventoryItemStack->GetTopItemFromStack())
+		Slots.Clear(Slot);
+	}
+
+	SlotChanged(Slot);
+	return InventoryItemRemoved;
+}
+
+void UOWSInventory::SwapSlots(int32 SlotA, int32 SlotB)
+{
+	if (!CanChangeSlots(TEXT("SwapSlots")))
+		return;
+
+	if (InventoryItemStacks.IsValidIndex(SlotA) && InventoryItemStacks.IsValidIndex(SlotB))
+	{
+		//Change the SlotNumber's of any stacks handed out to their new values
+		if (InventoryItemStacks[SlotA])
 		{
-			InventoryItemStack = NewObject<UOWSInventoryItemStack>();
-			InventoryItemStack->AddToStack(Item);
-			//Set the SlotNumber
-			InventoryItemStack->SlotNumber = Slot;
-			AddStackToSlot(InventoryItemStack, Slot);
+			InventoryItemStacks[SlotA]->SlotNumber = SlotB;
 		}
-		else
+		if (InventoryItemStacks[SlotB])
 		{
-			InventoryItemStack->AddToStack(Item);
+			InventoryItemStacks[SlotB]->SlotNumber = SlotA;
 		}
+
+		//Then swap the locations in the TArrays
+		InventoryItemStacks.Swap(SlotA, SlotB);
+		Slots.Swap(SlotA, SlotB);
+
+		SlotChanged(SlotA);
+		SlotChanged(SlotB);
 	}
 }
 
+UOWSInventoryItemStack* UOWSInventory::GetStackInSlot(int32 SlotNumber)
+{
+	if (!InventoryItemStacks.IsValidIndex(SlotNumber))
+	{
+		return nullptr;
+	}
 
-void UOWSInventory::AddItemsFromInventoryItemStruct(const TArray<FInventoryItemStruct>& ItemsToAdd)
+	if (!InventoryItemStacks[SlotNumber])
+	{
+		UOWSInventoryItemStack* InventoryItemStack = NewObject<UOWSInventoryItemStack>();
+		InventoryItemStack->SlotNumber = SlotNumber;
+		InventoryItemStack->OwningInventory = this;
+		InventoryItemStacks[SlotNumber] = InventoryItemStack;
+		RefreshStack(SlotNumber);
+	}
+
+	return InventoryItemStacks[SlotNumber];
+}
+
+TArray<UOWSInventoryItemStack*> UOWSInventory::GetAllStacks()
 {
-	UE_LOG(OWS, Warning, TEXT("UOWSInventory - AddItemsFromInventoryItemStruct"));
+	for (int32 Slot = 0; Slot < InventoryItemStacks.Num(); Slot++)
+	{
+		GetStackInSlot(Slot);
+	}
+
+	return InventoryItemStacks;
+}
+
+TArray<UOWSInventoryItemStack*> UOWSInventory::GetInventoryItemStacks() const
+{
+	//Stacks are a view of the slots, creating them doesn't change the inventory
+	return const_cast<UOWSInventory*>(this)->GetAllStacks();
+}
+
+int32 UOWSInventory::GetItemCountInSlot(int32 Slot) const
+{
+	return Slots.IsValidIndex(Slot) ? Slots.Counts[Slot] : 0;
+}
 
-	for (auto CurItem : ItemsToAdd)
+FString UOWSInventory::GetItemNameInSlot(int32 Slot) const
+{
+	if (!Slots.IsValidIndex(Slot) || !ItemTypes.IsValidIndex(Slots.ItemTypes[Slot]))
 	{
-		AOWSInventoryItem* ItemToAdd = NewObject<AOWSInventoryItem>();
+		return FString();
+	}
 
-		ItemToAdd->UniqueItemGUID = CurItem.UniqueItemGUID;
-		ItemToAdd->ItemName = CurItem.ItemName;
-		ItemToAdd->StackSize = CurItem.ItemStackSize;
-		ItemToAdd->Condition = CurItem.Condition;
-		ItemToAdd->IconTexture = CurItem.TextureIcon;
-		ItemToAdd->ItemMeshID = CurItem.ItemMeshID;
+	return ItemTypes[Slots.ItemTypes[Slot]].ItemName;
+}
 
-		for (int CurItemToAddToStack = 0; CurItemToAddToStack < FMath::Max(CurItem.Quantity, 1); CurItemToAddToStack++)
+void UOWSInventory::SyncSlotFromStack(UOWSInventoryItemStack* ItemStack)
+{
+	if (ItemStack && InventoryItemStacks.IsValidIndex(ItemStack->SlotNumber) && InventoryItemStacks[ItemStack->SlotNumber] == ItemStack)
+	{
+		//A stack changed on the owning client goes back to what the server sent
+		if (!HasSlotAuthority())
 		{
-			AddItemToSlot(ItemToAdd, CurItem.InSlotNumber);
+			RefreshStack(ItemStack->SlotNumber);
+			return;
 		}
+
+		WriteSlotFromStack(ItemStack->SlotNumber, ItemStack);
+		SlotChanged(ItemStack->SlotNumber);
 	}
 }
 
-AOWSInventoryItem* UOWSInventory::RemoveOneItemFromSlot(int32 Slot)
+int32 UOWSInventory::FindOrAddItemType(const FString& ItemName, UTexture2D* IconTexture, int32 IconSlotWidth, int32 IconSlotHeight, int32 StackSize, bool bCanStack)
 {
-	UOWSInventoryItemStack* InventoryItemStack = GetStackInSlot(Slot);
-	if (InventoryItemStack)
+	if (const int32* FoundIndex = ItemTypeIndexByName.Find(ItemName))
 	{
-		AOWSInventoryItem* InventoryItem = InventoryItemStack->GetTopItemFromStack();
-		if (InventoryItem)
+		//The icon can arrive after the item, on clients it is loaded from the item definition
+		if (IconTexture && !ItemTypes[*FoundIndex].IconTexture)
 		{
-			AOWSInventoryItem* InventoryItemRemoved = InventoryItemStack->RemoveFromTopOfStack();
-			UpdateSlotsFilled();
-			return InventoryItemRemoved;
+			ItemTypes[*FoundIndex].IconTexture = IconTexture;
 		}
 
-		return nullptr;
+		return *FoundIndex;
 	}
 
-	return nullptr;
+	//ItemTypes replicates from the server, an entry added here would take an index the server gives to another item
+	if (!HasSlotAuthority())
+	{
+		return INDEX_NONE;
+	}
+
+	FOWSInventoryItemType& ItemType = ItemTypes.AddDefaulted_GetRef();
+	ItemType.ItemName = ItemName;
+	ItemType.IconTexture = IconTexture;
+	ItemType.IconSlotWidth = FMath::Max(IconSlotWidth, 1);
+	ItemType.IconSlotHeight = FMath::Max(IconSlotHeight, 1);
+	ItemType.StackSize = StackSize;
+	ItemType.bCanStack = bCanStack;
+
+	return ItemTypeIndexByName.Add(ItemName, ItemTypes.Num() - 1);
 }
 
-void UOWSInventory::SwapSlots(int32 SlotA, int32 SlotB)
+void UOWSInventory::WriteSlotFromItem(int32 Slot, const AOWSInventoryItem* Item, int32 Count)
 {
-	if (InventoryItemStacks.IsValidIndex(SlotA) && InventoryItemStacks.IsValidIndex(SlotB))
-	{
-		//Change the SlotNumber's to their new values
-		InventoryItemStacks[SlotA]->SlotNumber = SlotB;
-		InventoryItemStacks[SlotB]->SlotNumber = SlotA;
-		//Then swap the locations in the TArray
-		InventoryItemStacks.Swap(SlotA, SlotB);
+	Slots.ItemTypes[Slot] = FindOrAddItemType(Item->ItemName, Item->IconTexture, Item->IconSlotWidth, Item->IconSlotHeight, Item->StackSize, Item->CanStack);
+	Slots.Counts[Slot] = Count;
+	Slots.Conditions[Slot] = Item->Condition;
+	Slots.NumberOfUsesLeft[Slot] = Item->NumberOfUsesLeft;
+	Slots.UniqueItemGUIDs[Slot] = Item->UniqueItemGUID;
+	Slots.ItemMeshIDs[Slot] = Item->ItemMeshID;
+	Slots.PerInstanceCustomData[Slot] = Item->PerInstanceCustomData;
+}
 
-		UpdateSlotsFilled();
+void UOWSInventory::WriteSlotFromStack(int32 Slot, UOWSInventoryItemStack* ItemStack)
+{
+	AOWSInventoryItem* TopItem = ItemStack->GetTopItemFromStack();
+	if (TopItem)
+	{
+		WriteSlotFromItem(Slot, TopItem, ItemStack->InventoryItems.Num());
+	}
+	else
+	{
+		Slots.Clear(Slot);
 	}
 }
 
-UOWSInventoryItemStack* UOWSInventory::GetStackInSlot(int32 SlotNumber)
+AOWSInventoryItem* UOWSInventory::MaterializeItem(int32 Slot) const
 {
-	if (InventoryItemStacks.Num() > 0 && InventoryItemStacks.IsValidIndex(SlotNumber))
+	AOWSInventoryItem* Item = NewObject<AOWSInventoryItem>();
+
+	if (ItemTypes.IsValidIndex(Slots.ItemTypes[Slot]))
 	{
-		return InventoryItemStacks[SlotNumber];
+		const FOWSInventoryItemType& ItemType = ItemTypes[Slots.ItemTypes[Slot]];
+		Item->ItemName = ItemType.ItemName;
+		Item->IconTexture = ItemType.IconTexture;
+		Item->IconSlotWidth = ItemType.IconSlotWidth;
+		Item->IconSlotHeight = ItemType.IconSlotHeight;
+		Item->StackSize = ItemType.StackSize;
+		Item->CanStack = ItemType.bCanStack;
 	}
 
-	return nullptr;
+	Item->Condition = Slots.Conditions[Slot];
+	Item->NumberOfUsesLeft = Slots.NumberOfUsesLeft[Slot];
+	Item->UniqueItemGUID = Slots.UniqueItemGUIDs[Slot];
+	Item->ItemMeshID = Slots.ItemMeshIDs[Slot];
+	Item->PerInstanceCustomData = Slots.PerInstanceCustomData[Slot];
+
+	return Item;
+}
+
+void UOWSInventory::RefreshStack(int32 Slot)
+{
+	UOWSInventoryItemStack* InventoryItemStack = InventoryItemStacks[Slot];
+	InventoryItemStack->InventoryItems.Reset();
+
+	//One object per item, an item taken off the stack must not share its uses left or custom data with the ones left behind
+	if (Slots.IsFilled(Slot))
+	{
+		InventoryItemStack->InventoryItems.Reserve(Slots.Counts[Slot]);
+		for (int32 ItemIndex = 0; ItemIndex < Slots.Counts[Slot]; ItemIndex++)
+		{
+			InventoryItemStack->InventoryItems.Add(MaterializeItem(Slot));
+		}
+	}
 }
 
 bool UOWSInventory::IsSlotFilled(int32 Slot)
 {
-	if (Slot < 0 || Slot >= NumberOfSlots)
+	if (Slot < 0 || Slot >= NumberOfSlots || NumberOfColumns < 1 || !OccupiedRows.IsValidIndex(Slot / NumberOfColumns))
 		return false;
 
-	return SlotsFilled[Slot];
+	return (OccupiedRows[Slot / NumberOfColumns] >> (Slot % NumberOfColumns)) & 1;
 }
 
-void UOWSInventory::UpdateSlotsFilled()
+//Bits 0..Width-1 set
+static uint64 OWSColumnsMask(int32 Width)
 {
-	int32 Slot = 0;
-	for (TArray<UOWSInventoryItemStack*>::TConstIterator StackIter(InventoryItemStacks); StackIter; ++StackIter)
+	return Width >= 64 ? ~0ull : ((1ull << Width) - 1);
+}
+
+int32 UOWSInventory::GetNumberOfRows() const
+{
+	return NumberOfColumns > 0 ? FMath::DivideAndRoundUp(NumberOfSlots, NumberOfColumns) : 0;
+}
+
+void UOWSInventory::RebuildOccupancy()
+{
+	const int32 NumberOfRows = GetNumberOfRows();
+
+	OccupiedRows.Init(0, NumberOfRows);
+	CellCoverage.Init(0, NumberOfRows * NumberOfColumns);
+	StampedFootprints.Init(FIntPoint::ZeroValue, Slots.Num());
+	FirstFitCache.Reset();
+
+	//Cells past the last slot of a partial last row are never free
+	for (int32 Cell = NumberOfSlots; Cell < NumberOfRows * NumberOfColumns; Cell++)
 	{
-		SlotsFilled[Slot] = false;
-		Slot++;
+		OccupiedRows[Cell / NumberOfColumns] |= 1ull << (Cell % NumberOfColumns);
 	}
 
-	Slot = 0;
-	for (TArray<UOWSInventoryItemStack*>::TConstIterator StackIter(InventoryItemStacks); StackIter; ++StackIter)
+	for (int32 Slot = 0; Slot < Slots.Num(); Slot++)
 	{
-		AOWSInventoryItem* ItemInSlot = (*StackIter)->GetTopItemFromStack();
+		UpdateSlotOccupancy(Slot);
+	}
+}
 
-		if (ItemInSlot)
-		{
-			SlotsFilled[Slot] = true;
+void UOWSInventory::SlotChanged(int32 Slot)
+{
+	UpdateSlotOccupancy(Slot);
 
-			if (ItemInSlot->IconSlotWidth > 1 || ItemInSlot->IconSlotHeight)
-			{
-				float SlotNumberDividedByNumberOfColumns = Slot / NumberOfColumns;
-				int32 StartingRow = FMath::FloorToInt(SlotNumberDividedByNumberOfColumns);
-				int32 StartingCol = Slot % NumberOfColumns;
-
-				for (int32 CurRow = StartingRow; CurRow < StartingRow + ItemInSlot->IconSlotHeight; CurRow++) {
-					for (int32 CurCol = StartingCol; CurCol < StartingCol + ItemInSlot->IconSlotWidth; CurCol++) {
-						if (CurRow != StartingRow || CurCol != StartingCol)
-						{
-							//SlotsFilled.EmplaceAt((CurRow * NumberOfColumns) + CurCol, true);
-							int32 SlotToSet = (CurRow * NumberOfColumns) + CurCol;
-							if (SlotToSet < 0 || SlotToSet >= NumberOfSlots)
-								continue;
-
-							SlotsFilled[SlotToSet] = true;
-						}
-					}
-				}
-			}
+	if (IsReplicatingSlots())
+	{
+		UpdateReplicatedSlot(Slot);
+	}
+}
+
+bool UOWSInventory::HasSlotAuthority() const
+{
+	const AActor* OwningActor = GetTypedOuter<AActor>();
+	return !OwningActor || OwningActor->HasAuthority();
+}
+
+bool UOWSInventory::CanChangeSlots(const TCHAR* Caller) const
+{
+	if (HasSlotAuthority())
+	{
+		return true;
+	}
+
+	UE_LOG(OWS, Warning, TEXT("UOWSInventory - %s - %s can only be changed on the server, use the AOWSCharacter inventory server RPCs"), Caller, *InventoryName.ToString());
+	return false;
+}
+
+bool UOWSInventory::IsReplicatingSlots() const
+{
+	const AActor* OwningActor = GetTypedOuter<AActor>();
+	return OwningActor && OwningActor->GetIsReplicated() && OwningActor->HasAuthority();
+}
+
+void UOWSInventory::UpdateReplicatedSlot(int32 Slot)
+{
+	const int32 EntryIndex = ReplicatedSlots.Entries.IndexOfByPredicate([Slot](const FOWSInventorySlotEntry& Entry)
+	{
+		return Entry.Slot == Slot;
+	});
+
+	if (!Slots.IsValidIndex(Slot) || !Slots.IsFilled(Slot))
+	{
+		if (EntryIndex != INDEX_NONE)
+		{
+			ReplicatedSlots.Entries.RemoveAtSwap(EntryIndex);
+			ReplicatedSlots.MarkArrayDirty();
 		}
+		return;
+	}
 
-		Slot++;
+	FOWSInventorySlotEntry& Entry = (EntryIndex != INDEX_NONE) ? ReplicatedSlots.Entries[EntryIndex] : ReplicatedSlots.Entries.AddDefaulted_GetRef();
+
+	//Slot writes that leave the slot as it was are not sent
+	if (EntryIndex != INDEX_NONE
+		&& Entry.ItemType == Slots.ItemTypes[Slot]
+		&& Entry.Count == Slots.Counts[Slot]
+		&& Entry.Condition == Slots.Conditions[Slot]
+		&& Entry.NumberOfUsesLeft == Slots.NumberOfUsesLeft[Slot]
+		&& Entry.UniqueItemGUID == Slots.UniqueItemGUIDs[Slot]
+		&& Entry.ItemMeshID == Slots.ItemMeshIDs[Slot]
+		&& Entry.PerInstanceCustomData == Slots.PerInstanceCustomData[Slot])
+	{
+		return;
 	}
+
+	Entry.Slot = Slot;
+	Entry.ItemType = Slots.ItemTypes[Slot];
+	Entry.Count = Slots.Counts[Slot];
+	Entry.Condition = Slots.Conditions[Slot];
+	Entry.NumberOfUsesLeft = Slots.NumberOfUsesLeft[Slot];
+	Entry.UniqueItemGUID = Slots.UniqueItemGUIDs[Slot];
+	Entry.ItemMeshID = Slots.ItemMeshIDs[Slot];
+	Entry.PerInstanceCustomData = Slots.PerInstanceCustomData[Slot];
+	ReplicatedSlots.MarkItemDirty(Entry);
 }
 
-int32 UOWSInventory::FindFirstEmptySlotToFitItemOfSize(int32 IconSlotWidth, int32 IconSlotHeight)
+void UOWSInventory::ApplyReplicatedSlot(const FOWSInventorySlotEntry& Entry)
+{
+	//Applied again from OnRep_InventorySize if the slot arrived before the inventory size
+	if (!Slots.IsValidIndex(Entry.Slot))
+	{
+		return;
+	}
+
+	const int32 Slot = Entry.Slot;
+	Slots.ItemTypes[Slot] = Entry.ItemType;
+	Slots.Counts[Slot] = Entry.Count;
+	Slots.Conditions[Slot] = Entry.Condition;
+	Slots.NumberOfUsesLeft[Slot] = Entry.NumberOfUsesLeft;
+	Slots.UniqueItemGUIDs[Slot] = Entry.UniqueItemGUID;
+	Slots.ItemMeshIDs[Slot] = Entry.ItemMeshID;
+	Slots.PerInstanceCustomData[Slot] = Entry.PerInstanceCustomData;
+
+	if (InventoryItemStacks[Slot])
+	{
+		RefreshStack(Slot);
+	}
+
+	UpdateSlotOccupancy(Slot);
+}
+
+void UOWSInventory::ClearReplicatedSlot(const FOWSInventorySlotEntry& Entry)
+{
+	if (!Slots.IsValidIndex(Entry.Slot))
+	{
+		return;
+	}
+
+	Slots.Clear(Entry.Slot);
+
+	if (InventoryItemStacks[Entry.Slot])
+	{
+		RefreshStack(Entry.Slot);
+	}
+
+	UpdateSlotOccupancy(Entry.Slot);
+}
+
+void UOWSInventory::UpdateSlotOccupancy(int32 Slot)
 {
-	int32 Slot = 0;
+	if (!StampedFootprints.IsValidIndex(Slot))
+	{
+		return;
+	}
 
-	UpdateSlotsFilled();
+	FIntPoint Footprint = FIntPoint::ZeroValue;
+	if (Slots.IsFilled(Slot))
+	{
+		Footprint = FIntPoint(1, 1);
+		if (ItemTypes.IsValidIndex(Slots.ItemTypes[Slot]))
+		{
+			Footprint = FIntPoint(ItemTypes[Slots.ItemTypes[Slot]].IconSlotWidth, ItemTypes[Slots.ItemTypes[Slot]].IconSlotHeight);
+		}
+	}
 
-	Slot = 0;
-	for (TArray<UOWSInventoryItemStack*>::TConstIterator StackIter(InventoryItemStacks); StackIter; ++StackIter)
+	if (Footprint == StampedFootprints[Slot])
 	{
-		AOWSInventoryItem* ItemInSlot = (*StackIter)->GetTopItemFromStack();
+		return;
+	}
+
+	StampFootprint(Slot, StampedFootprints[Slot], -1);
+	StampFootprint(Slot, Footprint, 1);
+	StampedFootprints[Slot] = Footprint;
+	FirstFitCache.Reset();
+}
 
-		bool SlotIsFilled = false;
+void UOWSInventory::StampFootprint(int32 Slot, FIntPoint Footprint, int32 Delta)
+{
+	const int32 StartingRow = Slot / NumberOfColumns;
+	const int32 StartingCol = Slot % NumberOfColumns;
+	const int32 EndRow = FMath::Min(StartingRow + Footprint.Y, GetNumberOfRows());
+	const int32 EndCol = FMath::Min(StartingCol + Footprint.X, NumberOfColumns);
 
-		if (!ItemInSlot)
+	for (int32 CurRow = StartingRow; CurRow < EndRow; CurRow++)
+	{
+		for (int32 CurCol = StartingCol; CurCol < EndCol; CurCol++)
 		{
-			if (SlotsFilled[Slot])
-			{
-				Slot++;
+			const int32 Cell = (CurRow * NumberOfColumns) + CurCol;
+			if (Cell >= NumberOfSlots)
 				continue;
-			}
 
-			if (IconSlotWidth > 1 || IconSlotHeight)
+			//Footprints can overlap when items are put in slots without checking they fit, a cell is free once nothing covers it
+			CellCoverage[Cell] = (uint8)(CellCoverage[Cell] + Delta);
+
+			if (CellCoverage[Cell] > 0)
+			{
+				OccupiedRows[CurRow] |= 1ull << CurCol;
+			}
+			else
 			{
-				float SlotDividedByNumberOfColumns = (float)Slot / (float)NumberOfColumns;
-				int32 StartingRow = FMath::FloorToInt(SlotDividedByNumberOfColumns);
-				int32 StartingCol = Slot % NumberOfColumns;
-
-				for (int32 CurRow = StartingRow; CurRow < StartingRow + IconSlotHeight; CurRow++) {
-					for (int32 CurCol = StartingCol; CurCol < StartingCol + IconSlotWidth; CurCol++) {
-						if (CurRow != StartingRow || CurCol != StartingCol)
-						{
-							//We are outside the bounds of the inventory on the right side
-							if (CurCol >= NumberOfColumns)
-							{
-								SlotIsFilled = true;
-								break;
-							}
-
-							//We are outside the bounds of the inventory on the bottom side
-							if (CurRow >= NumberOfColumns)
-							{
-								SlotIsFilled = true;
-								break;
-							}
-
-							int32 SlotToCheck = (CurRow * NumberOfColumns) + CurCol;
-							if (SlotToCheck < 0 || SlotToCheck >= NumberOfSlots)
-							{
-								continue;
-							}
-
-							if (SlotsFilled[SlotToCheck])
-							{
-								SlotIsFilled = true;
-								break;
-							}
-						}
-					}
-				}
+				OccupiedRows[CurRow] &= ~(1ull << CurCol);
 			}
 		}
-		else
+	}
+}
+
+bool UOWSInventory::CanFitItemOfSizeAtSlot(int32 Slot, int32 IconSlotWidth, int32 IconSlotHeight) const
+{
+	IconSlotWidth = FMath::Max(IconSlotWidth, 1);
+	IconSlotHeight = FMath::Max(IconSlotHeight, 1);
+
+	if (Slot < 0 || Slot >= NumberOfSlots)
+		return false;
+
+	const int32 StartingRow = Slot / NumberOfColumns;
+	const int32 StartingCol = Slot % NumberOfColumns;
+
+	if (StartingCol + IconSlotWidth > NumberOfColumns || StartingRow + IconSlotHeight > GetNumberOfRows())
+		return false;
+
+	const uint64 FootprintMask = OWSColumnsMask(IconSlotWidth) << StartingCol;
+	for (int32 CurRow = StartingRow; CurRow < StartingRow + IconSlotHeight; CurRow++)
+	{
+		if (OccupiedRows[CurRow] & FootprintMask)
+			return false;
+	}
+
+	return true;
+}
+
+bool UOWSInventory::CanFitItemOfSize(int32 IconSlotWidth, int32 IconSlotHeight)
+{
+	return FindFirstEmptySlotToFitItemOfSize(IconSlotWidth, IconSlotHeight) != -1;
+}
+
+int32 UOWSInventory::FindFirstEmptySlotToFitItemOfSize(int32 IconSlotWidth, int32 IconSlotHeight)
+{
+	IconSlotWidth = FMath::Max(IconSlotWidth, 1);
+	IconSlotHeight = FMath::Max(IconSlotHeight, 1);
+
+	const int32 NumberOfRows = GetNumberOfRows();
+	if (IconSlotWidth > NumberOfColumns || IconSlotHeight > NumberOfRows)
+		return -1; //Inventory is Full
+
+	//Answers stay valid until a footprint changes
+	const FIntPoint Size(IconSlotWidth, IconSlotHeight);
+	if (const int32* CachedSlot = FirstFitCache.Find(Size))
+	{
+		return *CachedSlot;
+	}
+
+	//A bit is set in FreeRuns when IconSlotWidth cells starting at that column are free in the row
+	const uint64 AllColumns = OWSColumnsMask(NumberOfColumns);
+	TArray<uint64, TInlineAllocator<32>> FreeRuns;
+	FreeRuns.SetNumUninitialized(NumberOfRows);
+	for (int32 CurRow = 0; CurRow < NumberOfRows; CurRow++)
+	{
+		const uint64 FreeCells = ~OccupiedRows[CurRow] & AllColumns;
+		uint64 FreeRun = FreeCells;
+		for (int32 Width = 1; Width < IconSlotWidth && FreeRun; Width++)
 		{
-			Slot++;
-			continue;
+			FreeRun &= FreeCells >> Width;
 		}
+		FreeRuns[CurRow] = FreeRun;
+	}
 
-		if (!SlotIsFilled)
+	int32 FoundSlot = -1; //-1 = Inventory is Full
+	for (int32 CurRow = 0; CurRow + IconSlotHeight <= NumberOfRows; CurRow++)
+	{
+		uint64 Fits = FreeRuns[CurRow];
+		for (int32 Height = 1; Height < IconSlotHeight && Fits; Height++)
 		{
-			return Slot;
+			Fits &= FreeRuns[CurRow + Height];
 		}
 
-		Slot++;
+		if (Fits)
+		{
+			FoundSlot = (CurRow * NumberOfColumns) + FMath::CountTrailingZeros64(Fits);
+			break;
+		}
 	}
 
-	return -1; //Inventory is Full
+	FirstFitCache.Add(Size, FoundSlot);
+	return FoundSlot;
 }
 
 int32 UOWSInventory::FindItemIndex(FString ItemName)
 {
-	int32 Slot = 0;
-	for (TArray<UOWSInventoryItemStack*>::TConstIterator StackIter(InventoryItemStacks); StackIter; ++StackIter)
+	const int32* ItemType = ItemTypeIndexByName.Find(ItemName);
+	if (!ItemType)
 	{
-		if ((*StackIter)->GetTopItemFromStack() && (*StackIter)->GetTopItemFromStack()->ItemName == ItemName)
-		{
-			return Slot;
-		}
-		Slot++;
+		return -1; //Item not found
 	}
 
-	return -1; //Item not found
-}
\ No newline at end of file
+	return Slots.ItemTypes.IndexOfByKey(*ItemType);
+}
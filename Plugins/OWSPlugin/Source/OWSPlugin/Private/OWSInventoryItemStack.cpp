@@ -1,6 +1,7 @@
 // Copyright 2018 Sabre Dart Studios
 
 #include "OWSInventoryItemStack.h"
+#include "OWSInventory.h"
 
 
 UOWSInventoryItemStack::UOWSInventoryItemStack(const FObjectInitializer& ObjectInitializer)
@@ -13,6 +14,11 @@ UOWSInventoryItemStack::UOWSInventoryItemStack(const FObjectInitializer& ObjectI
 void UOWSInventoryItemStack::AddToStack(AOWSInventoryItem* InventoryItem)
 {
 	InventoryItems.Push(InventoryItem);
+
+	if (UOWSInventory* Inventory = OwningInventory.Get())
+	{
+		Inventory->SyncSlotFromStack(this);
+	}
 }
 
 void UOWSInventoryItemStack::AddToStack(UOWSInventoryItemStack* InventoryItemStack)
@@ -27,11 +33,23 @@ void UOWSInventoryItemStack::AddToStack(UOWSInventoryItemStack* InventoryItemSta
 
 		curItem++;
 	}
+
+	if (UOWSInventory* Inventory = OwningInventory.Get())
+	{
+		Inventory->SyncSlotFromStack(this);
+	}
 }
 
 AOWSInventoryItem* UOWSInventoryItemStack::RemoveFromTopOfStack()
 {
-	return InventoryItems.Pop();
+	AOWSInventoryItem* RemovedItem = InventoryItems.Pop();
+
+	if (UOWSInventory* Inventory = OwningInventory.Get())
+	{
+		Inventory->SyncSlotFromStack(this);
+	}
+
+	return RemovedItem;
 }
 
 AOWSInventoryItem* UOWSInventoryItemStack::GetTopItemFromStack()
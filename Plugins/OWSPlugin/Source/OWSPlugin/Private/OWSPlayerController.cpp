@@ -597,6 +597,12 @@ void AOWSPlayerController::LaunchDungeon(FString MapName, ERPGPlayerGroupType::P
 
 void AOWSPlayerController::PlayerLogout()
 {
+	//Puts this player at the front of the next location save
+	if (HasAuthority())
+	{
+		bPendingDisconnect = true;
+	}
+
 	FString CharacterName = PlayerState->GetPlayerName();
 	OWSPlayerControllerComponent->PlayerLogout(CharacterName);
 }
@@ -607,6 +613,11 @@ void AOWSPlayerController::GetChatGroupsForPlayer()
 	OWSPlayerControllerComponent->GetChatGroupsForPlayer();
 }
 
+void AOWSPlayerController::Client_ReceiveChatMessage_Implementation(const FChatMessage& ChatMessage)
+{
+	NotifyChatMessageReceived(ChatMessage);
+}
+
 void AOWSPlayerController::IsPlayerOnline(FString PlayerName)
 {
 	/*
@@ -4,6 +4,11 @@
 #include "OWSTravelToMapActor.h"
 #include "OWSGameInstance.h"
 #include "OWSAPISubsystem.h"
+#include "OWSTransportSubsystem.h"
+#include "OWSCharacterPersistenceCache.h"
+#include "OWSResponseCache.h"
+#include "OWSResponseDecoder.h"
+#include "OWSZoneServerAssignmentCache.h"
 #include "OWS2API.h"
 #include "Runtime/Engine/Classes/Kismet/GameplayStatics.h"
 
@@ -194,45 +199,117 @@ void UOWSPlayerControllerComponent::TravelToMap2(const FString& ServerAndPort, c
 	PlayerController->ClientTravel(URL, TRAVEL_Absolute, false, FGuid());
 }
 
-/*
-Valid values for ApiModuleToCall:
-	PublicAPI
-	InstanceManagementAPI
-	CharacterPersistanceAPI
-*/
-void UOWSPlayerControllerComponent::ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+void UOWSPlayerControllerComponent::ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
 {
-	Http = &FHttpModule::Get();
-	Http->SetHttpTimeout(TravelTimeout); //Set timeout
-	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http->CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, InMethodPtr);
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	if (!GameInstance)
+	{
+		UE_LOG(OWS, Error, TEXT("UOWSPlayerControllerComponent::ProcessOWS2POSTRequest - No Game Instance Found!"));
+		return;
+	}
 
-	FString OWS2APIPathToUse = "";
+	GameInstance->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, TravelTimeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, InMethodPtr));
+}
 
-	if (ApiModuleToCall == "PublicAPI")
+UOWSCharacterPersistenceCache* UOWSPlayerControllerComponent::GetPersistenceCache() const
+{
+	//Only the server owns persistence, clients keep sending their requests directly
+	if (!bUseWriteBehindPersistence || !GetOwner() || !GetOwner()->HasAuthority())
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		return nullptr;
 	}
-	else if (ApiModuleToCall == "InstanceManagementAPI")
+
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	return GameInstance ? GameInstance->GetSubsystem<UOWSCharacterPersistenceCache>() : nullptr;
+}
+
+UOWSResponseCache* UOWSPlayerControllerComponent::GetResponseCache() const
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	return GameInstance ? GameInstance->GetSubsystem<UOWSResponseCache>() : nullptr;
+}
+
+UOWSZoneServerAssignmentCache* UOWSPlayerControllerComponent::GetZoneServerAssignmentCache() const
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	return GameInstance ? GameInstance->GetSubsystem<UOWSZoneServerAssignmentCache>() : nullptr;
+}
+
+FTravelToLastZoneServerJSONPost UOWSPlayerControllerComponent::MakeServerToConnectToRequest(const FString& CharacterName, const FString& ZoneName, int32 PlayerGroupType)
+{
+	//Prefetches and travel have to build the same request to share an assignment
+	FTravelToLastZoneServerJSONPost ServerToConnectToJSONPost;
+	ServerToConnectToJSONPost.CharacterName = CharacterName.TrimStartAndEnd();
+	ServerToConnectToJSONPost.ZoneName = ZoneName.TrimStartAndEnd();
+	ServerToConnectToJSONPost.PlayerGroupType = PlayerGroupType;
+	return ServerToConnectToJSONPost;
+}
+
+void UOWSPlayerControllerComponent::ResolveServerToConnectTo(const FTravelToLastZoneServerJSONPost& ServerToConnectToJSONPost, void (UOWSPlayerControllerComponent::* InHandlerPtr)(bool bWasSuccessful, const FString& ResponseContent))
+{
+	UOWSZoneServerAssignmentCache* AssignmentCache = GetZoneServerAssignmentCache();
+	if (!AssignmentCache)
 	{
-		OWS2APIPathToUse = OWS2InstanceManagementAPIPath;
+		UE_LOG(OWS, Error, TEXT("UOWSPlayerControllerComponent::ResolveServerToConnectTo - No Game Instance Found!"));
+		return;
 	}
-	else if (ApiModuleToCall == "CharacterPersistenceAPI")
+
+	AssignmentCache->Resolve(ServerToConnectToJSONPost, TravelTimeout, FOWSZoneServerResolvedDelegate::CreateUObject(this, InHandlerPtr));
+}
+
+void UOWSPlayerControllerComponent::PrefetchZoneServerToTravelTo(FString CharacterName, FString ZoneName)
+{
+	if (UOWSZoneServerAssignmentCache* AssignmentCache = GetZoneServerAssignmentCache())
 	{
-		OWS2APIPathToUse = OWS2CharacterPersistenceAPIPath;
+		AssignmentCache->Prefetch(MakeServerToConnectToRequest(CharacterName, ZoneName, 0), TravelTimeout);
 	}
-	else //When an ApiModuleToCall is not specified, use the PublicAPI
+}
+
+void UOWSPlayerControllerComponent::PrefetchLastZoneServer(FString CharacterName)
+{
+	PrefetchZoneServerToTravelTo(CharacterName, TEXT("GETLASTZONENAME"));
+}
+
+void UOWSPlayerControllerComponent::InvalidateCachedResponse(EOWSCachedLookup Lookup, const FString& CharName)
+{
+	if (UOWSResponseCache* ResponseCache = GetResponseCache())
 	{
-		OWS2APIPathToUse = OWS2APIPath;
+		ResponseCache->Invalidate(Lookup, CharName);
 	}
+}
+
+void UOWSPlayerControllerComponent::ProcessCachedOWS2POSTRequest(EOWSCachedLookup Lookup, const FString& CacheKey, const FOWSEndpoint& Endpoint, const FString& PostParameters,
+	void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+{
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(this);
+	if (!GameInstance)
+	{
+		UE_LOG(OWS, Error, TEXT("UOWSPlayerControllerComponent::ProcessCachedOWS2POSTRequest - No Game Instance Found!"));
+		return;
+	}
+
+	UOWSResponseCache* ResponseCache = GameInstance->GetSubsystem<UOWSResponseCache>();
+	const uint32 FetchGeneration = ResponseCache ? ResponseCache->GetGeneration(Lookup) : 0;
 
-	Request->SetURL(FString(OWS2APIPathToUse + ApiToCall));
-	Request->SetVerb("POST");
-	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
-	Request->SetHeader("Content-Type", TEXT("application/json"));
-	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
-	Request->SetContentAsString(PostParameters);
-	Request->ProcessRequest();
+	GameInstance->GetSubsystem<UOWSTransportSubsystem>()->ProcessOWS2Request(Endpoint, PostParameters, TravelTimeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSPlayerControllerComponent::OnCacheableResponseReceived, Lookup, FString(CacheKey), FetchGeneration, InMethodPtr));
+}
+
+void UOWSPlayerControllerComponent::OnCacheableResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, EOWSCachedLookup Lookup, FString CacheKey, uint32 FetchGeneration,
+	void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful))
+{
+	UOWSResponseCache* ResponseCache = GetResponseCache();
+	UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache();
+
+	//While writes for the character are still waiting to be flushed the backend copy is behind, so it is not worth caching
+	if (ResponseCache && bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())
+		&& !(PersistenceCache && PersistenceCache->HasPendingWrites(CacheKey)))
+	{
+		ResponseCache->Put(Lookup, CacheKey, Response->GetContentAsString(), FetchGeneration);
+	}
+
+	(this->*InMethodPtr)(Request, Response, bWasSuccessful);
 }
 
 //SetSelectedCharacterAndConnectToLastZone - Set character name and get user session
@@ -245,9 +322,16 @@ void UOWSPlayerControllerComponent::SetSelectedCharacterAndConnectToLastZone(FSt
 	SetSelectedCharacterAndConnectToLastZoneJSONPost.UserSessionGUID = UserSessionGUID;
 	SetSelectedCharacterAndConnectToLastZoneJSONPost.SelectedCharacterName = SelectedCharacterName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(SetSelectedCharacterAndConnectToLastZoneJSONPost, PostParameters))
+	if (OWSEndpoints::SetSelectedCharacterAndGetUserSession.SerializeRequest(SetSelectedCharacterAndConnectToLastZoneJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/SetSelectedCharacterAndGetUserSession", PostParameters, &UOWSPlayerControllerComponent::OnSetSelectedCharacterAndConnectToLastZoneResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::SetSelectedCharacterAndGetUserSession, PostParameters, &UOWSPlayerControllerComponent::OnSetSelectedCharacterAndConnectToLastZoneResponseReceived);
+
+		//The last zone is looked up by character name alone, so it can be resolved while the session is being set up
+		//instead of after it.  TravelToLastZoneServer then picks up this request.
+		if (bPrefetchZoneServerOnCharacterSelect)
+		{
+			PrefetchLastZoneServer(SelectedCharacterName);
+		}
 	}
 	else
 	{
@@ -300,22 +384,15 @@ void UOWSPlayerControllerComponent::OnSetSelectedCharacterAndConnectToLastZoneRe
 //TravelToLastZoneServer
 void UOWSPlayerControllerComponent::TravelToLastZoneServer(FString CharacterName)
 {
-	FTravelToLastZoneServerJSONPost TravelToLastZoneServerJSONPost;
-	TravelToLastZoneServerJSONPost.CharacterName = CharacterName;
-	TravelToLastZoneServerJSONPost.ZoneName = "GETLASTZONENAME";
-	TravelToLastZoneServerJSONPost.PlayerGroupType = 0;
-	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(TravelToLastZoneServerJSONPost, PostParameters))
-	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UOWSPlayerControllerComponent::OnTravelToLastZoneServerResponseReceived);
-	}
-	else
-	{
-		UE_LOG(OWS, Error, TEXT("TravelToLastZoneServer Error serializing TravelToLastZoneServerJSONPost!"));
-	}
+	ResolveServerToConnectTo(MakeServerToConnectToRequest(CharacterName, TEXT("GETLASTZONENAME"), 0), &UOWSPlayerControllerComponent::HandleTravelToLastZoneServerResponse);
 }
 
 void UOWSPlayerControllerComponent::OnTravelToLastZoneServerResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	HandleTravelToLastZoneServerResponse(bWasSuccessful, bWasSuccessful ? Response->GetContentAsString() : FString());
+}
+
+void UOWSPlayerControllerComponent::HandleTravelToLastZoneServerResponse(bool bWasSuccessful, const FString& ResponseContent)
 {
 	FString ServerAndPort;
 
@@ -334,7 +411,7 @@ void UOWSPlayerControllerComponent::OnTravelToLastZoneServerResponseReceived(FHt
 	if (bWasSuccessful)
 	{
 		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
 
 		if (FJsonSerializer::Deserialize(Reader, JsonObject))
 		{
@@ -381,29 +458,22 @@ void UOWSPlayerControllerComponent::OnTravelToLastZoneServerResponseReceived(FHt
 //GetZoneServerToTravelTo
 void UOWSPlayerControllerComponent::GetZoneServerToTravelTo(FString CharacterName, TEnumAsByte<ERPGSchemeToChooseMap::SchemeToChooseMap> SelectedSchemeToChooseMap, int32 WorldServerID, FString ZoneName)
 {
-	FTravelToLastZoneServerJSONPost TravelToLastZoneServerJSONPost;
-	TravelToLastZoneServerJSONPost.CharacterName = CharacterName;
-	TravelToLastZoneServerJSONPost.ZoneName = ZoneName;
-	TravelToLastZoneServerJSONPost.PlayerGroupType = 0;
-	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(TravelToLastZoneServerJSONPost, PostParameters))
-	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UOWSPlayerControllerComponent::OnGetZoneServerToTravelToResponseReceived);
-	}
-	else
-	{
-		UE_LOG(OWS, Error, TEXT("GetMapServerToTravelTo Error serializing TravelToLastZoneServerJSONPost!"));
-	}
+	ResolveServerToConnectTo(MakeServerToConnectToRequest(CharacterName, ZoneName, 0), &UOWSPlayerControllerComponent::HandleGetZoneServerToTravelToResponse);
 }
 
 void UOWSPlayerControllerComponent::OnGetZoneServerToTravelToResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	HandleGetZoneServerToTravelToResponse(bWasSuccessful, bWasSuccessful ? Response->GetContentAsString() : FString());
+}
+
+void UOWSPlayerControllerComponent::HandleGetZoneServerToTravelToResponse(bool bWasSuccessful, const FString& ResponseContent)
 {
 	FString ServerAndPort;
 
 	if (bWasSuccessful)
 	{
 		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
 
 		if (FJsonSerializer::Deserialize(Reader, JsonObject))
 		{
@@ -458,9 +528,9 @@ void UOWSPlayerControllerComponent::GetAllCharacters(FString UserSessionGUID)
 	FGetAllCharactersJSONPost GetAllCharactersJSONPost;
 	GetAllCharactersJSONPost.UserSessionGUID = UserSessionGUID;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetAllCharactersJSONPost, PostParameters))
+	if (OWSEndpoints::GetAllCharacters.SerializeRequest(GetAllCharactersJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetAllCharacters", PostParameters, &UOWSPlayerControllerComponent::OnGetAllCharactersResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetAllCharacters, PostParameters, &UOWSPlayerControllerComponent::OnGetAllCharactersResponseReceived);
 	}
 	else
 	{
@@ -472,15 +542,18 @@ void UOWSPlayerControllerComponent::OnGetAllCharactersResponseReceived(FHttpRequ
 {
 	if (bWasSuccessful)
 	{
-		TArray<FUserCharacter> UsersCharactersData;
-		if (FJsonObjectConverter::JsonArrayStringToUStruct(Response->GetContentAsString(), &UsersCharactersData, 0, 0))
-		{
-			OnNotifyGetAllCharactersDelegate.ExecuteIfBound(UsersCharactersData);
-		}
-		else
-		{
-			OnErrorGetAllCharactersDelegate.ExecuteIfBound(TEXT("OnGetAllCharactersResponseReceived Error Parsing JSON!"));
-		}
+		OWSResponseDecoder::DecodeEndpointResponse(this, OWSEndpoints::GetAllCharacters, Response,
+			[this](bool bDecoded, TArray<FUserCharacter>& UsersCharactersData)
+			{
+				if (bDecoded)
+				{
+					OnNotifyGetAllCharactersDelegate.ExecuteIfBound(UsersCharactersData);
+				}
+				else
+				{
+					OnErrorGetAllCharactersDelegate.ExecuteIfBound(TEXT("OnGetAllCharactersResponseReceived Error Parsing JSON!"));
+				}
+			});
 	}
 	else
 	{
@@ -492,12 +565,20 @@ void UOWSPlayerControllerComponent::OnGetAllCharactersResponseReceived(FHttpRequ
 //GetCharacterStats
 void UOWSPlayerControllerComponent::GetCharacterStats(FString CharName)
 {
+	FString CachedResponse;
+	UOWSResponseCache* ResponseCache = GetResponseCache();
+	if (ResponseCache && ResponseCache->TryGet(EOWSCachedLookup::CharacterStats, CharName, CachedResponse))
+	{
+		HandleGetCharacterStatsResponse(CachedResponse);
+		return;
+	}
+
 	FGetCharacterStatsJSONPost GetCharacterStatsJSONPost;
 	GetCharacterStatsJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCharacterStatsJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterStats.SerializeRequest(GetCharacterStatsJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/GetByName", PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterStatsResponseReceived);
+		ProcessCachedOWS2POSTRequest(EOWSCachedLookup::CharacterStats, CharName, OWSEndpoints::GetCharacterStats, PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterStatsResponseReceived);
 	}
 	else
 	{
@@ -509,13 +590,7 @@ void UOWSPlayerControllerComponent::OnGetCharacterStatsResponseReceived(FHttpReq
 {
 	if (bWasSuccessful)
 	{
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-
-		if (FJsonSerializer::Deserialize(Reader, JsonObject))
-		{
-			OnNotifyGetCharacterStatsDelegate.ExecuteIfBound(JsonObject);
-		}
+		HandleGetCharacterStatsResponse(Response->GetContentAsString());
 	}
 	else
 	{
@@ -524,6 +599,17 @@ void UOWSPlayerControllerComponent::OnGetCharacterStatsResponseReceived(FHttpReq
 	}
 }
 
+void UOWSPlayerControllerComponent::HandleGetCharacterStatsResponse(const FString& ResponseContent)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
+
+	if (FJsonSerializer::Deserialize(Reader, JsonObject))
+	{
+		OnNotifyGetCharacterStatsDelegate.ExecuteIfBound(JsonObject);
+	}
+}
+
 //GetCharacterDataAndCustomData - This makes a call to the OWS Public API and is usable from the Character Selection screen.
 void UOWSPlayerControllerComponent::GetCharacterDataAndCustomData(FString UserSessionGUID, FString CharName)
 {
@@ -531,9 +617,9 @@ void UOWSPlayerControllerComponent::GetCharacterDataAndCustomData(FString UserSe
 	GetCharacterDataAndCustomDataJSONPost.UserSessionGUID = UserSessionGUID;
 	GetCharacterDataAndCustomDataJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCharacterDataAndCustomDataJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterDataAndCustomData.SerializeRequest(GetCharacterDataAndCustomDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("OWSPublicAPI", "api/Characters/ByName", PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterDataAndCustomDataResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetCharacterDataAndCustomData, PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterDataAndCustomDataResponseReceived);
 	}
 	else
 	{
@@ -563,7 +649,23 @@ void UOWSPlayerControllerComponent::OnGetCharacterDataAndCustomDataResponseRecei
 //Update Character Stats
 void UOWSPlayerControllerComponent::UpdateCharacterStats(FString JSONString)
 {
-	ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/UpdateCharacterStats", JSONString, &UOWSPlayerControllerComponent::OnUpdateCharacterStatsResponseReceived);
+	AOWSPlayerState* OWSPlayerState = GetOWSPlayerState();
+	if (OWSPlayerState)
+	{
+		InvalidateCachedResponse(EOWSCachedLookup::CharacterStats, OWSPlayerState->GetPlayerName());
+	}
+
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
+	{
+		if (OWSPlayerState && !OWSPlayerState->GetPlayerName().IsEmpty())
+		{
+			PersistenceCache->QueueCharacterStats(OWSPlayerState->GetPlayerName(), JSONString);
+			OnNotifyUpdateCharacterStatsDelegate.ExecuteIfBound();
+			return;
+		}
+	}
+
+	ProcessOWS2POSTRequest(OWSEndpoints::UpdateCharacterStats, JSONString, &UOWSPlayerControllerComponent::OnUpdateCharacterStatsResponseReceived);
 }
 
 void UOWSPlayerControllerComponent::OnUpdateCharacterStatsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -571,17 +673,24 @@ void UOWSPlayerControllerComponent::OnUpdateCharacterStatsResponseReceived(FHttp
 	FString ErrorMsg;
 	TSharedPtr<FJsonObject> JsonObject;
 	GetJsonObjectFromResponse(Request, Response, bWasSuccessful, "OnUpdateCharacterStatsResponseReceived", ErrorMsg, JsonObject);
-	if (!ErrorMsg.IsEmpty())
+
+	TSharedPtr<FSuccessAndErrorMessage> SuccessAndErrorMessage;
+	if (ErrorMsg.IsEmpty())
 	{
-		OnErrorUpdateCharacterStatsDelegate.ExecuteIfBound(ErrorMsg);
-		return;
+		SuccessAndErrorMessage = GetStructFromJsonObject<FSuccessAndErrorMessage>(JsonObject);
+		ErrorMsg = SuccessAndErrorMessage->ErrorMessage;
 	}
 
-	TSharedPtr<FSuccessAndErrorMessage> SuccessAndErrorMessage = GetStructFromJsonObject<FSuccessAndErrorMessage>(JsonObject);
-
-	if (!SuccessAndErrorMessage->ErrorMessage.IsEmpty())
+	if (!ErrorMsg.IsEmpty())
 	{
-		OnErrorUpdateCharacterStatsDelegate.ExecuteIfBound(*SuccessAndErrorMessage->ErrorMessage);
+		//The stats were not saved, so the next update must not leave out the ones that have not changed since
+		APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+		if (AOWSCharacter* OWSCharacter = PlayerController ? Cast<AOWSCharacter>(PlayerController->GetPawn()) : nullptr)
+		{
+			OWSCharacter->ResetPersistedCharacterStats();
+		}
+
+		OnErrorUpdateCharacterStatsDelegate.ExecuteIfBound(ErrorMsg);
 		return;
 	}
 
@@ -591,12 +700,20 @@ void UOWSPlayerControllerComponent::OnUpdateCharacterStatsResponseReceived(FHttp
 //GetCustomCharacterData
 void UOWSPlayerControllerComponent::GetCustomCharacterData(FString CharName)
 {
+	FString CachedResponse;
+	UOWSResponseCache* ResponseCache = GetResponseCache();
+	if (ResponseCache && ResponseCache->TryGet(EOWSCachedLookup::CustomCharacterData, CharName, CachedResponse))
+	{
+		HandleGetCustomCharacterDataResponse(CachedResponse);
+		return;
+	}
+
 	FGetCustomCharacterDataJSONPost GetCustomCharacterDataJSONPost;
 	GetCustomCharacterDataJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetCustomCharacterDataJSONPost, PostParameters))
+	if (OWSEndpoints::GetCustomCharacterData.SerializeRequest(GetCustomCharacterDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/GetCustomData", PostParameters, &UOWSPlayerControllerComponent::OnGetCustomCharacterDataResponseReceived);
+		ProcessCachedOWS2POSTRequest(EOWSCachedLookup::CustomCharacterData, CharName, OWSEndpoints::GetCustomCharacterData, PostParameters, &UOWSPlayerControllerComponent::OnGetCustomCharacterDataResponseReceived);
 	}
 	else
 	{
@@ -608,13 +725,7 @@ void UOWSPlayerControllerComponent::OnGetCustomCharacterDataResponseReceived(FHt
 {
 	if (bWasSuccessful)
 	{
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-
-		if (FJsonSerializer::Deserialize(Reader, JsonObject))
-		{
-			OnNotifyGetCustomCharacterDataDelegate.ExecuteIfBound(JsonObject);
-		}
+		HandleGetCustomCharacterDataResponse(Response->GetContentAsString());
 	}
 	else
 	{
@@ -623,17 +734,37 @@ void UOWSPlayerControllerComponent::OnGetCustomCharacterDataResponseReceived(FHt
 	}
 }
 
+void UOWSPlayerControllerComponent::HandleGetCustomCharacterDataResponse(const FString& ResponseContent)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
+
+	if (FJsonSerializer::Deserialize(Reader, JsonObject))
+	{
+		OnNotifyGetCustomCharacterDataDelegate.ExecuteIfBound(JsonObject);
+	}
+}
+
 //AddOrUpdateCustomCharacterData
 void UOWSPlayerControllerComponent::AddOrUpdateCustomCharacterData(FString CharName, FString CustomFieldName, FString CustomValue)
 {
+	InvalidateCachedResponse(EOWSCachedLookup::CustomCharacterData, CharName);
+
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
+	{
+		PersistenceCache->QueueCustomCharacterData(CharName, CustomFieldName, CustomValue);
+		OnNotifyAddOrUpdateCustomCharacterDataDelegate.ExecuteIfBound();
+		return;
+	}
+
 	FAddOrUpdateCustomCharacterDataJSONPost AddOrUpdateCustomCharacterDataJSONPost;
 	AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.CharacterName = CharName;
 	AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.CustomFieldName = CustomFieldName;
 	AddOrUpdateCustomCharacterDataJSONPost.AddOrUpdateCustomCharacterData.FieldValue = CustomValue;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(AddOrUpdateCustomCharacterDataJSONPost, PostParameters))
+	if (OWSEndpoints::AddOrUpdateCustomCharacterData.SerializeRequest(AddOrUpdateCustomCharacterDataJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/AddOrUpdateCustomData", PostParameters, &UOWSPlayerControllerComponent::OnAddOrUpdateCustomCharacterDataResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddOrUpdateCustomCharacterData, PostParameters, &UOWSPlayerControllerComponent::OnAddOrUpdateCustomCharacterDataResponseReceived);
 	}
 	else
 	{
@@ -657,7 +788,12 @@ void UOWSPlayerControllerComponent::OnAddOrUpdateCustomCharacterDataResponseRece
 
 void UOWSPlayerControllerComponent::SaveAllPlayerData()
 {
-	//Not implemented
+	AOWSPlayerState* OWSPlayerState = GetOWSPlayerState();
+	UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache();
+	if (PersistenceCache && OWSPlayerState)
+	{
+		PersistenceCache->FlushCharacter(OWSPlayerState->GetPlayerName());
+	}
 }
 
 void UOWSPlayerControllerComponent::OnSaveAllPlayerDataResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -750,15 +886,25 @@ void UOWSPlayerControllerComponent::OnGetCharacterStatusesResponseReceived(FHttp
 //AddAbilityToCharacter
 void UOWSPlayerControllerComponent::AddAbilityToCharacter(FString CharName, FString AbilityName, int32 AbilityLevel, FString CustomJSON)
 {
+	InvalidateCachedResponse(EOWSCachedLookup::CharacterAbilities, CharName);
+	InvalidateCachedResponse(EOWSCachedLookup::AbilityBars, CharName);
+
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
+	{
+		PersistenceCache->QueueAbility(CharName, AbilityName, AbilityLevel, CustomJSON, true);
+		OnNotifyAddAbilityToCharacterDelegate.ExecuteIfBound();
+		return;
+	}
+
 	FAddAbilityToCharacterJSONPost AddAbilityToCharacterJSONPost;
 	AddAbilityToCharacterJSONPost.CharacterName = CharName;
 	AddAbilityToCharacterJSONPost.AbilityName = AbilityName;
 	AddAbilityToCharacterJSONPost.AbilityLevel = AbilityLevel;
 	AddAbilityToCharacterJSONPost.CharHasAbilitiesCustomJSON = CustomJSON;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(AddAbilityToCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::AddAbilityToCharacter.SerializeRequest(AddAbilityToCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/AddAbilityToCharacter", PostParameters, &UOWSPlayerControllerComponent::OnAddAbilityToCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::AddAbilityToCharacter, PostParameters, &UOWSPlayerControllerComponent::OnAddAbilityToCharacterResponseReceived);
 	}
 	else
 	{
@@ -782,12 +928,20 @@ void UOWSPlayerControllerComponent::OnAddAbilityToCharacterResponseReceived(FHtt
 //GetCharacterAbilities
 void UOWSPlayerControllerComponent::GetCharacterAbilities(FString CharName)
 {
+	FString CachedResponse;
+	UOWSResponseCache* ResponseCache = GetResponseCache();
+	if (ResponseCache && ResponseCache->TryGet(EOWSCachedLookup::CharacterAbilities, CharName, CachedResponse))
+	{
+		HandleGetCharacterAbilitiesResponse(CachedResponse);
+		return;
+	}
+
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (OWSEndpoints::GetCharacterAbilities.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/GetCharacterAbilities", PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterAbilitiesResponseReceived);
+		ProcessCachedOWS2POSTRequest(EOWSCachedLookup::CharacterAbilities, CharName, OWSEndpoints::GetCharacterAbilities, PostParameters, &UOWSPlayerControllerComponent::OnGetCharacterAbilitiesResponseReceived);
 	}
 	else
 	{
@@ -799,22 +953,8 @@ void UOWSPlayerControllerComponent::OnGetCharacterAbilitiesResponseReceived(FHtt
 {
 	if (bWasSuccessful)
 	{
-		TArray<TSharedPtr<FJsonValue>> JsonArray;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-
-		if (FJsonSerializer::Deserialize(Reader, JsonArray))
-		{
-			TArray<FAbility> Abilities;
-
-			FJsonObjectConverter::JsonArrayToUStruct(JsonArray, &Abilities, 0, 0);
-
-			OnNotifyGetCharacterAbilitiesDelegate.ExecuteIfBound(Abilities);
-		}
-		else
-		{
-			UE_LOG(OWS, Error, TEXT("OnGetCharacterAbilitiesResponseReceived Server returned no data!"));
-			OnErrorGetCharacterAbilitiesDelegate.ExecuteIfBound(TEXT("OnGetCharacterAbilitiesResponseReceived Server returned no data!"));
-		}
+		OWSResponseDecoder::DecodeEndpointResponse(this, OWSEndpoints::GetCharacterAbilities, Response,
+			[this](bool bDecoded, TArray<FAbility>& Abilities) { OnCharacterAbilitiesDecoded(bDecoded, Abilities); });
 	}
 	else
 	{
@@ -823,15 +963,42 @@ void UOWSPlayerControllerComponent::OnGetCharacterAbilitiesResponseReceived(FHtt
 	}
 }
 
+void UOWSPlayerControllerComponent::HandleGetCharacterAbilitiesResponse(const FString& ResponseContent)
+{
+	OWSResponseDecoder::DecodeEndpointResponse(this, OWSEndpoints::GetCharacterAbilities, ResponseContent,
+		[this](bool bDecoded, TArray<FAbility>& Abilities) { OnCharacterAbilitiesDecoded(bDecoded, Abilities); });
+}
+
+void UOWSPlayerControllerComponent::OnCharacterAbilitiesDecoded(bool bDecoded, TArray<FAbility>& Abilities)
+{
+	if (bDecoded)
+	{
+		OnNotifyGetCharacterAbilitiesDelegate.ExecuteIfBound(Abilities);
+	}
+	else
+	{
+		UE_LOG(OWS, Error, TEXT("OnGetCharacterAbilitiesResponseReceived Server returned no data!"));
+		OnErrorGetCharacterAbilitiesDelegate.ExecuteIfBound(TEXT("OnGetCharacterAbilitiesResponseReceived Server returned no data!"));
+	}
+}
+
 //GetAbilityBars
 void UOWSPlayerControllerComponent::GetAbilityBars(FString CharName)
 {
+	FString CachedResponse;
+	UOWSResponseCache* ResponseCache = GetResponseCache();
+	if (ResponseCache && ResponseCache->TryGet(EOWSCachedLookup::AbilityBars, CharName, CachedResponse))
+	{
+		HandleGetAbilityBarsResponse(CachedResponse);
+		return;
+	}
+
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (OWSEndpoints::GetAbilityBars.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/GetAbilityBars", PostParameters, &UOWSPlayerControllerComponent::OnGetAbilityBarsResponseReceived);
+		ProcessCachedOWS2POSTRequest(EOWSCachedLookup::AbilityBars, CharName, OWSEndpoints::GetAbilityBars, PostParameters, &UOWSPlayerControllerComponent::OnGetAbilityBarsResponseReceived);
 	}
 	else
 	{
@@ -843,22 +1010,8 @@ void UOWSPlayerControllerComponent::OnGetAbilityBarsResponseReceived(FHttpReques
 {
 	if (bWasSuccessful)
 	{
-		TArray<TSharedPtr<FJsonValue>> JsonArray;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-
-		if (FJsonSerializer::Deserialize(Reader, JsonArray))
-		{
-			TArray<FAbilityBar> AbilityBars;
-
-			FJsonObjectConverter::JsonArrayToUStruct(JsonArray, &AbilityBars, 0, 0);
-
-			OnNotifyGetAbilityBarsDelegate.ExecuteIfBound(AbilityBars);
-		}
-		else
-		{
-			UE_LOG(OWS, Error, TEXT("OnGetAbilityBarsResponseReceived Server returned no data!"));
-			OnErrorGetAbilityBarsDelegate.ExecuteIfBound(TEXT("OnGetAbilityBarsResponseReceived Server returned no data!"));
-		}
+		OWSResponseDecoder::DecodeEndpointResponse(this, OWSEndpoints::GetAbilityBars, Response,
+			[this](bool bDecoded, TArray<FAbilityBar>& AbilityBars) { OnAbilityBarsDecoded(bDecoded, AbilityBars); });
 	}
 	else
 	{
@@ -867,18 +1020,48 @@ void UOWSPlayerControllerComponent::OnGetAbilityBarsResponseReceived(FHttpReques
 	}
 }
 
+void UOWSPlayerControllerComponent::HandleGetAbilityBarsResponse(const FString& ResponseContent)
+{
+	OWSResponseDecoder::DecodeEndpointResponse(this, OWSEndpoints::GetAbilityBars, ResponseContent,
+		[this](bool bDecoded, TArray<FAbilityBar>& AbilityBars) { OnAbilityBarsDecoded(bDecoded, AbilityBars); });
+}
+
+void UOWSPlayerControllerComponent::OnAbilityBarsDecoded(bool bDecoded, TArray<FAbilityBar>& AbilityBars)
+{
+	if (bDecoded)
+	{
+		OnNotifyGetAbilityBarsDelegate.ExecuteIfBound(AbilityBars);
+	}
+	else
+	{
+		UE_LOG(OWS, Error, TEXT("OnGetAbilityBarsResponseReceived Server returned no data!"));
+		OnErrorGetAbilityBarsDelegate.ExecuteIfBound(TEXT("OnGetAbilityBarsResponseReceived Server returned no data!"));
+	}
+}
+
 //UpdateAbilityOnCharacter
 void UOWSPlayerControllerComponent::UpdateAbilityOnCharacter(FString CharName, FString AbilityName, int32 AbilityLevel, FString CustomJSON)
 {
+	InvalidateCachedResponse(EOWSCachedLookup::CharacterAbilities, CharName);
+	InvalidateCachedResponse(EOWSCachedLookup::AbilityBars, CharName);
+
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
+	{
+		PersistenceCache->QueueAbility(CharName, AbilityName, AbilityLevel, CustomJSON, false);
+		//OnUpdateAbilityOnCharacterResponseReceived reports through the add delegate as well
+		OnNotifyAddAbilityToCharacterDelegate.ExecuteIfBound();
+		return;
+	}
+
 	FUpdateAbilityOnCharacterJSONPost UpdateAbilityOnCharacterJSONPost;
 	UpdateAbilityOnCharacterJSONPost.CharacterName = CharName;
 	UpdateAbilityOnCharacterJSONPost.AbilityName = AbilityName;
 	UpdateAbilityOnCharacterJSONPost.AbilityLevel = AbilityLevel;
 	UpdateAbilityOnCharacterJSONPost.CharHasAbilitiesCustomJSON = CustomJSON;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(UpdateAbilityOnCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::UpdateAbilityOnCharacter.SerializeRequest(UpdateAbilityOnCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/UpdateAbilityOnCharacter", PostParameters, &UOWSPlayerControllerComponent::OnUpdateAbilityOnCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::UpdateAbilityOnCharacter, PostParameters, &UOWSPlayerControllerComponent::OnUpdateAbilityOnCharacterResponseReceived);
 	}
 	else
 	{
@@ -902,18 +1085,29 @@ void UOWSPlayerControllerComponent::OnUpdateAbilityOnCharacterResponseReceived(F
 //RemoveAbilityFromCharacter
 void UOWSPlayerControllerComponent::RemoveAbilityFromCharacter(FString CharName, FString AbilityName)
 {
+	InvalidateCachedResponse(EOWSCachedLookup::CharacterAbilities, CharName);
+	InvalidateCachedResponse(EOWSCachedLookup::AbilityBars, CharName);
+
 	FRemoveAbilityFromCharacterJSONPost RemoveAbilityFromCharacterJSONPost;
 	RemoveAbilityFromCharacterJSONPost.CharacterName = CharName;
 	RemoveAbilityFromCharacterJSONPost.AbilityName = AbilityName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(RemoveAbilityFromCharacterJSONPost, PostParameters))
+	if (!OWSEndpoints::RemoveAbilityFromCharacter.SerializeRequest(RemoveAbilityFromCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Abilities/RemoveAbilityFromCharacter", PostParameters, &UOWSPlayerControllerComponent::OnRemoveAbilityFromCharacterResponseReceived);
+		UE_LOG(OWS, Error, TEXT("RemoveAbilityFromCharacter Error serializing RemoveAbilityFromCharacterJSONPost!"));
+		return;
 	}
-	else
+
+	//An add or update for the ability that is still in flight must land before the remove, or it would bring the ability back
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
 	{
-		UE_LOG(OWS, Error, TEXT("RemoveAbilityFromCharacter Error serializing RemoveAbilityFromCharacterJSONPost!"));
+		PersistenceCache->DiscardAbility(CharName, AbilityName);
+		PersistenceCache->SendAfterFlush(CharName, OWSEndpoints::RemoveAbilityFromCharacter, PostParameters,
+			FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSPlayerControllerComponent::OnRemoveAbilityFromCharacterResponseReceived));
+		return;
 	}
+
+	ProcessOWS2POSTRequest(OWSEndpoints::RemoveAbilityFromCharacter, PostParameters, &UOWSPlayerControllerComponent::OnRemoveAbilityFromCharacterResponseReceived);
 }
 
 void UOWSPlayerControllerComponent::OnRemoveAbilityFromCharacterResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -941,14 +1135,21 @@ void UOWSPlayerControllerComponent::PlayerLogout(FString CharName)
 	FCharacterNameJSONPost CharacterNameJSONPost;
 	CharacterNameJSONPost.CharacterName = CharName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CharacterNameJSONPost, PostParameters))
+	if (!OWSEndpoints::PlayerLogout.SerializeRequest(CharacterNameJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("CharacterPersistenceAPI", "api/Characters/PlayerLogout", PostParameters, &UOWSPlayerControllerComponent::OnPlayerLogoutResponseReceived);
+		UE_LOG(OWS, Error, TEXT("PlayerLogout Error serializing GetCharacterStatsJSONPost!"));
+		return;
 	}
-	else
+
+	//Unsaved writes have to reach the backend before it marks the character as logged out
+	if (UOWSCharacterPersistenceCache* PersistenceCache = GetPersistenceCache())
 	{
-		UE_LOG(OWS, Error, TEXT("PlayerLogout Error serializing GetCharacterStatsJSONPost!"));
+		PersistenceCache->SendAfterFlush(CharName, OWSEndpoints::PlayerLogout, PostParameters,
+			FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSPlayerControllerComponent::OnPlayerLogoutResponseReceived));
+		return;
 	}
+
+	ProcessOWS2POSTRequest(OWSEndpoints::PlayerLogout, PostParameters, &UOWSPlayerControllerComponent::OnPlayerLogoutResponseReceived);
 }
 
 void UOWSPlayerControllerComponent::OnPlayerLogoutResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
@@ -984,9 +1185,9 @@ void UOWSPlayerControllerComponent::CreateCharacter(FString UserSessionGUID, FSt
 	CreateCharacterJSONPost.CharacterName = CharacterName;
 	CreateCharacterJSONPost.ClassName = ClassName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(CreateCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::CreateCharacter.SerializeRequest(CreateCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/CreateCharacter", PostParameters, &UOWSPlayerControllerComponent::OnCreateCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::CreateCharacter, PostParameters, &UOWSPlayerControllerComponent::OnCreateCharacterResponseReceived);
 	}
 	else
 	{
@@ -1045,9 +1246,9 @@ void UOWSPlayerControllerComponent::RemoveCharacter(FString UserSessionGUID, FSt
 	RemoveCharacterJSONPost.UserSessionGUID = UserSessionGUID;
 	RemoveCharacterJSONPost.CharacterName = CharacterName;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(RemoveCharacterJSONPost, PostParameters))
+	if (OWSEndpoints::RemoveCharacter.SerializeRequest(RemoveCharacterJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/RemoveCharacter", PostParameters, &UOWSPlayerControllerComponent::OnRemoveCharacterResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::RemoveCharacter, PostParameters, &UOWSPlayerControllerComponent::OnRemoveCharacterResponseReceived);
 	}
 	else
 	{
@@ -1091,9 +1292,9 @@ void UOWSPlayerControllerComponent::GetPlayerGroupsCharacterIsIn(FString UserSes
 	GetPlayerGroupsCharacterIsInJSONPost.CharacterName = CharacterName;
 	GetPlayerGroupsCharacterIsInJSONPost.PlayerGroupTypeID = PlayerGroupTypeID;
 	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(GetPlayerGroupsCharacterIsInJSONPost, PostParameters))
+	if (OWSEndpoints::GetPlayerGroupsCharacterIsIn.SerializeRequest(GetPlayerGroupsCharacterIsInJSONPost, PostParameters))
 	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetPlayerGroupsCharacterIsIn", PostParameters, &UOWSPlayerControllerComponent::OnGetPlayerGroupsCharacterIsInResponseReceived);
+		ProcessOWS2POSTRequest(OWSEndpoints::GetPlayerGroupsCharacterIsIn, PostParameters, &UOWSPlayerControllerComponent::OnGetPlayerGroupsCharacterIsInResponseReceived);
 	}
 	else
 	{
@@ -1101,55 +1302,83 @@ void UOWSPlayerControllerComponent::GetPlayerGroupsCharacterIsIn(FString UserSes
 	}
 }
 
-void UOWSPlayerControllerComponent::OnGetPlayerGroupsCharacterIsInResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+namespace
 {
-	if (bWasSuccessful)
+	struct FDecodedPlayerGroups
+	{
+		TArray<FPlayerGroup> PlayerGroups;
+		FString ErrorMessage;
+	};
+
+	//Runs on a worker, see OWSResponseDecoder
+	bool DecodePlayerGroups(const FString& Content, FDecodedPlayerGroups& OutDecoded)
 	{
 		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
 
-		if (FJsonSerializer::Deserialize(Reader, JsonObject))
+		if (!FJsonSerializer::Deserialize(Reader, JsonObject))
 		{
-			FString Success = JsonObject->GetStringField("success");
+			return false;
+		}
 
-			if (Success == "true")
-			{
-				if (JsonObject->HasField("rows"))
-				{
-					TArray<TSharedPtr<FJsonValue>> Rows = JsonObject->GetArrayField("rows");
-					TArray<FPlayerGroup> tempPlayerGroups;
-
-					for (int RowNum = 0; RowNum != Rows.Num(); RowNum++) {
-						FPlayerGroup tempPlayerGroup;
-						TSharedPtr<FJsonObject> tempRow = Rows[RowNum]->AsObject();
-						tempPlayerGroup.PlayerGroupID = tempRow->GetNumberField("PlayerGroupID");
-						tempPlayerGroup.PlayerGroupName = tempRow->GetStringField("PlayerGroupName");
-						tempPlayerGroup.PlayerGroupTypeID = tempRow->GetNumberField("PlayerGroupTypeID");
-						tempPlayerGroup.ReadyState = tempRow->GetNumberField("ReadyState");
-						tempPlayerGroup.TeamNumber = tempRow->GetNumberField("TeamNumber");
-
-						FDateTime OutDateTime;
-						FDateTime::Parse(tempRow->GetStringField("DateAdded"), OutDateTime);
-						tempPlayerGroup.DateAdded = OutDateTime;
-
-						tempPlayerGroups.Add(tempPlayerGroup);
-					}
-
-					OnNotifyGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(tempPlayerGroups);
-				}
-				OnErrorGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived No rows in JSON!"));
-			}
-			else
-			{
-				FString ErrorMessage = JsonObject->GetStringField("errmsg");
-				OnErrorGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(ErrorMessage);
-			}
+		FString Success = JsonObject->GetStringField("success");
+
+		if (Success != "true")
+		{
+			OutDecoded.ErrorMessage = JsonObject->GetStringField("errmsg");
+			return true;
 		}
-		else
+
+		if (!JsonObject->HasField("rows"))
 		{
-			UE_LOG(OWS, Error, TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived Server returned no data!"));
-			OnErrorGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived Server returned no data!"));
+			OutDecoded.ErrorMessage = TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived No rows in JSON!");
+			return true;
 		}
+
+		TArray<TSharedPtr<FJsonValue>> Rows = JsonObject->GetArrayField("rows");
+		OutDecoded.PlayerGroups.Reserve(Rows.Num());
+
+		for (int RowNum = 0; RowNum != Rows.Num(); RowNum++) {
+			FPlayerGroup tempPlayerGroup;
+			TSharedPtr<FJsonObject> tempRow = Rows[RowNum]->AsObject();
+			tempPlayerGroup.PlayerGroupID = tempRow->GetNumberField("PlayerGroupID");
+			tempPlayerGroup.PlayerGroupName = tempRow->GetStringField("PlayerGroupName");
+			tempPlayerGroup.PlayerGroupTypeID = tempRow->GetNumberField("PlayerGroupTypeID");
+			tempPlayerGroup.ReadyState = tempRow->GetNumberField("ReadyState");
+			tempPlayerGroup.TeamNumber = tempRow->GetNumberField("TeamNumber");
+
+			FDateTime OutDateTime;
+			FDateTime::Parse(tempRow->GetStringField("DateAdded"), OutDateTime);
+			tempPlayerGroup.DateAdded = OutDateTime;
+
+			OutDecoded.PlayerGroups.Add(tempPlayerGroup);
+		}
+
+		return true;
+	}
+}
+
+void UOWSPlayerControllerComponent::OnGetPlayerGroupsCharacterIsInResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	if (bWasSuccessful)
+	{
+		OWSResponseDecoder::DecodeAsync<FDecodedPlayerGroups>(this, Response, &DecodePlayerGroups,
+			[this](bool bDecoded, FDecodedPlayerGroups& Decoded)
+			{
+				if (!bDecoded)
+				{
+					UE_LOG(OWS, Error, TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived Server returned no data!"));
+					OnErrorGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(TEXT("OnGetPlayerGroupsCharacterIsInResponseReceived Server returned no data!"));
+				}
+				else if (!Decoded.ErrorMessage.IsEmpty())
+				{
+					OnErrorGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(Decoded.ErrorMessage);
+				}
+				else
+				{
+					OnNotifyGetPlayerGroupsCharacterIsInDelegate.ExecuteIfBound(Decoded.PlayerGroups);
+				}
+			});
 	}
 	else
 	{
@@ -1161,29 +1390,23 @@ void UOWSPlayerControllerComponent::OnGetPlayerGroupsCharacterIsInResponseReceiv
 //LaunchZoneInstance
 void UOWSPlayerControllerComponent::LaunchZoneInstance(FString CharacterName, FString ZoneName, ERPGPlayerGroupType::PlayerGroupType GroupType)
 {
-	FLaunchZoneInstance LaunchZoneInstance;
-	LaunchZoneInstance.CharacterName = CharacterName;
-	LaunchZoneInstance.ZoneName = ZoneName;
-	LaunchZoneInstance.PlayerGroupTypeID = GroupType;
-	FString PostParameters = "";
-	if (FJsonObjectConverter::UStructToJsonObjectString(LaunchZoneInstance, PostParameters))
-	{
-		ProcessOWS2POSTRequest("PublicAPI", "api/Users/GetServerToConnectTo", PostParameters, &UOWSPlayerControllerComponent::OnLaunchZoneInstanceResponseReceived);
-	}
-	else
-	{
-		UE_LOG(OWS, Error, TEXT("LaunchZoneInstance Error serializing LaunchZoneInstance!"));
-	}
+	//GetServerToConnectTo takes the same body as TravelToLastZoneServer, FLaunchZoneInstance sent PlayerGroupTypeID instead of PlayerGroupType
+	ResolveServerToConnectTo(MakeServerToConnectToRequest(CharacterName, ZoneName, GroupType), &UOWSPlayerControllerComponent::HandleLaunchZoneInstanceResponse);
 }
 
 void UOWSPlayerControllerComponent::OnLaunchZoneInstanceResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	HandleLaunchZoneInstanceResponse(bWasSuccessful, bWasSuccessful ? Response->GetContentAsString() : FString());
+}
+
+void UOWSPlayerControllerComponent::HandleLaunchZoneInstanceResponse(bool bWasSuccessful, const FString& ResponseContent)
 {
 	FString ServerAndPort;
 
 	if (bWasSuccessful)
 	{
 		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseContent);
 
 		if (FJsonSerializer::Deserialize(Reader, JsonObject))
 		{
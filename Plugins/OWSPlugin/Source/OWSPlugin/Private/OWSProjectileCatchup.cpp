@@ -0,0 +1,220 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSProjectileCatchup.h"
+#include "OWSAdvancedProjectile.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSProjectileCatchup> GOWSProjectileCatchupStatsCmd(
+	TEXT("OWS.ProjectileCatchup.Stats"),
+	TEXT("Dumps how much projectile catch-up ran, waited and was skipped.  Pass reset to clear them."));
+
+//More sub-steps than this and the step gets longer instead
+static constexpr int32 OWSProjectileCatchupMaxSubSteps = 16;
+
+//Projectiles this close to the camera always count as on screen, they can be in view before they have been rendered
+static constexpr float OWSProjectileCatchupNearDistance = 500.f;
+
+bool UOWSProjectileCatchup::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSProjectileCatchup::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSProjectileMaxCatchupTime"), MaxCatchupTime, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSProjectileCatchupTimePerFrame"), MaxCatchupTimePerFrame, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSProjectileCatchupSubStepTime"), SubStepTime, GGameIni);
+}
+
+TStatId UOWSProjectileCatchup::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOWSProjectileCatchup, STATGROUP_Tickables);
+}
+
+bool UOWSProjectileCatchup::RequestCatchup(UWorld* World, AOWSAdvancedProjectile* Projectile, float CatchupTime, bool bMatchFake)
+{
+	UOWSProjectileCatchup* ProjectileCatchup = World ? World->GetSubsystem<UOWSProjectileCatchup>() : nullptr;
+	if (!ProjectileCatchup)
+	{
+		return false;
+	}
+
+	ProjectileCatchup->AddRequest(Projectile, CatchupTime, bMatchFake);
+	return true;
+}
+
+void UOWSProjectileCatchup::AddRequest(AOWSAdvancedProjectile* Projectile, float CatchupTime, bool bMatchFake)
+{
+	Stats.Requests++;
+
+	//A newer location from the server replaces the catch-up still waiting, but a fake match that was asked for still has to happen
+	for (int32 Index = FirstUnprocessed; Index < Pending.Num(); Index++)
+	{
+		if (Pending[Index].Projectile.Get() == Projectile)
+		{
+			Pending[Index].CatchupTime = CatchupTime;
+			Pending[Index].PoolGeneration = Projectile->LocalPoolGeneration;
+			Pending[Index].bMatchFake |= bMatchFake;
+			return;
+		}
+	}
+
+	FPendingCatchup& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Projectile = Projectile;
+	Entry.CatchupTime = CatchupTime;
+	Entry.PoolGeneration = Projectile->LocalPoolGeneration;
+	Entry.bMatchFake = bMatchFake;
+
+	Stats.PeakQueued = FMath::Max(Stats.PeakQueued, Pending.Num() - FirstUnprocessed);
+}
+
+bool UOWSProjectileCatchup::IsStillPending(const FPendingCatchup& Entry) const
+{
+	const AOWSAdvancedProjectile* Projectile = Entry.Projectile.Get();
+	return IsValid(Projectile) && !Projectile->IsPendingKillPending() && !Projectile->bExploded && !Projectile->IsInPool()
+		&& Projectile->LocalPoolGeneration == Entry.PoolGeneration;
+}
+
+void UOWSProjectileCatchup::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Pending.Num() == 0)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	UpdateView();
+
+	float BudgetLeft = MaxCatchupTimePerFrame;
+	bool bRanAny = false;
+
+	for (FirstUnprocessed = 0; FirstUnprocessed < Pending.Num(); FirstUnprocessed++)
+	{
+		//Copied, a projectile that hits something while catching up can queue more work
+		const FPendingCatchup Entry = Pending[FirstUnprocessed];
+
+		if (!IsStillPending(Entry))
+		{
+			Stats.Cancelled++;
+			continue;
+		}
+
+		float CatchupTime = Entry.CatchupTime;
+		if (CatchupTime > MaxCatchupTime)
+		{
+			CatchupTime = MaxCatchupTime;
+			Stats.Clamped++;
+		}
+
+		if (bRanAny && CatchupTime > BudgetLeft)
+		{
+			break;
+		}
+
+		AOWSAdvancedProjectile* Projectile = Entry.Projectile.Get();
+		RunCatchup(Projectile, CatchupTime);
+		BudgetLeft -= CatchupTime;
+		bRanAny = true;
+		Stats.Processed++;
+
+		if (!IsStillPending(Entry))
+		{
+			continue;
+		}
+
+		const bool bOnScreen = IsOnScreen(Projectile);
+		if (!bOnScreen && !Entry.bMatchFake)
+		{
+			Stats.CosmeticTicksSkipped++;
+		}
+
+		Projectile->FinishCatchup(Entry.bMatchFake, bOnScreen);
+	}
+
+	Stats.Deferred += Pending.Num() - FirstUnprocessed;
+	Pending.RemoveAt(0, FirstUnprocessed, EAllowShrinking::No);
+	FirstUnprocessed = 0;
+
+	Stats.LastFrameMs = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UOWSProjectileCatchup::RunCatchup(AOWSAdvancedProjectile* Projectile, float CatchupTime)
+{
+	if (CatchupTime <= 0.f)
+	{
+		return;
+	}
+
+	const int32 NumberOfSteps = FMath::Clamp(FMath::CeilToInt(CatchupTime / FMath::Max(SubStepTime, KINDA_SMALL_NUMBER)), 1, OWSProjectileCatchupMaxSubSteps);
+	const float StepTime = CatchupTime / NumberOfSteps;
+
+	for (int32 Step = 0; Step < NumberOfSteps; Step++)
+	{
+		//Stop at the first hit, the projectile may already be back in its pool
+		if (Projectile->bExploded || Projectile->IsInPool() || Projectile->IsPendingKillPending())
+		{
+			break;
+		}
+
+		Projectile->CatchupTick(StepTime);
+		Stats.SubSteps++;
+	}
+}
+
+void UOWSProjectileCatchup::UpdateView()
+{
+	bHasView = false;
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	ViewDirection = ViewRotation.Vector();
+
+	//The FOV is horizontal, the margin covers wide screens and projectiles about to fly into view
+	const float FOVAngle = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() : 90.f;
+	CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Min(FOVAngle * 0.5f + 15.f, 89.f)));
+	bHasView = true;
+}
+
+bool UOWSProjectileCatchup::IsOnScreen(const AOWSAdvancedProjectile* Projectile) const
+{
+	if (!bHasView || Projectile->WasRecentlyRendered(0.2f))
+	{
+		return true;
+	}
+
+	const FVector ToProjectile = Projectile->GetActorLocation() - ViewLocation;
+	if (ToProjectile.SizeSquared() < FMath::Square(OWSProjectileCatchupNearDistance))
+	{
+		return true;
+	}
+
+	return (ToProjectile.GetSafeNormal() | ViewDirection) >= CosHalfFOV;
+}
+
+void UOWSProjectileCatchup::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Projectile Catchup: queued=%d peak=%d, max %.2fs per projectile, %.2fs per frame, %.3fs sub-steps"), Pending.Num(), Stats.PeakQueued,
+		MaxCatchupTime, MaxCatchupTimePerFrame, SubStepTime);
+	Ar.Logf(TEXT("  requests=%d processed=%d cancelled=%d deferred=%d clamped=%d sub-steps=%d cosmetic ticks skipped=%d last frame=%.3fms"),
+		Stats.Requests, Stats.Processed, Stats.Cancelled, Stats.Deferred, Stats.Clamped, Stats.SubSteps, Stats.CosmeticTicksSkipped, Stats.LastFrameMs);
+}
+
+void UOWSProjectileCatchup::ResetStats()
+{
+	Stats = FOWSProjectileCatchupStats();
+}
@@ -0,0 +1,194 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSProjectilePool.h"
+#include "OWSAdvancedProjectile.h"
+#include "Engine/World.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSProjectilePool> GOWSProjectilePoolStatsCmd(
+	TEXT("OWS.ProjectilePool.Stats"),
+	TEXT("Dumps per class hit rates of the projectile pool.  Pass reset to clear them."));
+
+bool UOWSProjectilePool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSProjectilePool::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSUseProjectilePool"), bUseProjectilePool, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSProjectilePoolMaxPerClass"), MaxPooledPerClass, GGameIni);
+}
+
+AOWSAdvancedProjectile* UOWSProjectilePool::SpawnProjectile(UWorld* World, TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	if (UOWSProjectilePool* ProjectilePool = World->GetSubsystem<UOWSProjectilePool>())
+	{
+		return ProjectilePool->AcquireProjectile(ProjectileClass, Location, Rotation, InInstigator);
+	}
+
+	FActorSpawnParameters Params;
+	Params.Instigator = InInstigator;
+	Params.Owner = InInstigator;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	return World->SpawnActor<AOWSAdvancedProjectile>(ProjectileClass, Location, Rotation, Params);
+}
+
+bool UOWSProjectilePool::CanPool(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass) const
+{
+	return bUseProjectilePool && MaxPooledPerClass > 0 && ProjectileClass && ProjectileClass->GetDefaultObject<AOWSAdvancedProjectile>()->bCanBePooled;
+}
+
+AOWSAdvancedProjectile* UOWSProjectilePool::AcquireProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator)
+{
+	if (!ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	if (!CanPool(ProjectileClass))
+	{
+		FActorSpawnParameters Params;
+		Params.Instigator = InInstigator;
+		Params.Owner = InInstigator;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		return GetWorld()->SpawnActor<AOWSAdvancedProjectile>(ProjectileClass, Location, Rotation, Params);
+	}
+
+	FOWSProjectilePoolBucket& Bucket = Pools.FindOrAdd(ProjectileClass.Get());
+	Bucket.Stats.Acquired++;
+
+	while (Bucket.Available.Num() > 0)
+	{
+		//Pooled actors can still be destroyed from elsewhere, e.g. by a blueprint or a level unload
+		AOWSAdvancedProjectile* Projectile = Bucket.Available.Pop(EAllowShrinking::No);
+		if (IsValid(Projectile))
+		{
+			Bucket.Stats.Reused++;
+			Projectile->ActivateFromPool(Location, Rotation, InInstigator);
+			return Projectile;
+		}
+	}
+
+	Bucket.Stats.Spawned++;
+	return SpawnPooledProjectile(ProjectileClass, Location, Rotation, InInstigator, false);
+}
+
+AOWSAdvancedProjectile* UOWSProjectilePool::SpawnPooledProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator, bool bWarmUp)
+{
+	FActorSpawnParameters Params;
+	Params.Instigator = InInstigator;
+	Params.Owner = InInstigator;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	Params.bDeferConstruction = true;
+
+	AOWSAdvancedProjectile* Projectile = GetWorld()->SpawnActor<AOWSAdvancedProjectile>(ProjectileClass, Location, Rotation, Params);
+	if (!Projectile)
+	{
+		return nullptr;
+	}
+
+	//A temporary actor's channel closes after the first update and cannot be reused for the next shot.  Dormancy gives the
+	//same single update per shot while keeping the channel.  Warmed up projectiles are not replicated until first used.
+	Projectile->bPooled = true;
+	Projectile->bNetTemporary = false;
+	Projectile->NetDormancy = bWarmUp ? DORM_Initial : DORM_DormantAll;
+
+	if (bWarmUp)
+	{
+		//So it cannot hit anything where it waits
+		Projectile->SetActorEnableCollision(false);
+	}
+
+	Projectile->FinishSpawning(FTransform(Rotation, Location));
+
+	if (bWarmUp)
+	{
+		Projectile->DeactivateForPool();
+	}
+
+	return Projectile;
+}
+
+void UOWSProjectilePool::ReleaseProjectile(AOWSAdvancedProjectile* Projectile)
+{
+	if (!IsValid(Projectile) || Projectile->IsInPool())
+	{
+		return;
+	}
+
+	FOWSProjectilePoolBucket& Bucket = Pools.FindOrAdd(Projectile->GetClass());
+	Bucket.Stats.Released++;
+
+	if (Bucket.Available.Num() >= MaxPooledPerClass)
+	{
+		Bucket.Stats.Discarded++;
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->DeactivateForPool();
+	Bucket.Available.Add(Projectile);
+}
+
+void UOWSProjectilePool::WarmUp(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, int32 Count)
+{
+	if (!CanPool(ProjectileClass))
+	{
+		return;
+	}
+
+	FOWSProjectilePoolBucket& Bucket = Pools.FindOrAdd(ProjectileClass.Get());
+	const int32 TargetCount = FMath::Min(Count, MaxPooledPerClass);
+
+	while (Bucket.Available.Num() < TargetCount)
+	{
+		AOWSAdvancedProjectile* Projectile = SpawnPooledProjectile(ProjectileClass, FVector::ZeroVector, FRotator::ZeroRotator, nullptr, true);
+		if (!Projectile)
+		{
+			break;
+		}
+
+		Bucket.Available.Add(Projectile);
+		Bucket.Stats.WarmedUp++;
+	}
+}
+
+FOWSProjectilePoolStats UOWSProjectilePool::GetStats(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass) const
+{
+	const FOWSProjectilePoolBucket* Bucket = Pools.Find(ProjectileClass.Get());
+	return Bucket ? Bucket->Stats : FOWSProjectilePoolStats();
+}
+
+void UOWSProjectilePool::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Projectile Pool: %s, %d classes, max %d idle per class"), bUseProjectilePool ? TEXT("on") : TEXT("off"), Pools.Num(), MaxPooledPerClass);
+
+	for (const TPair<TObjectPtr<UClass>, FOWSProjectilePoolBucket>& Pair : Pools)
+	{
+		const FOWSProjectilePoolStats& Stats = Pair.Value.Stats;
+		const float HitRate = Stats.Acquired > 0 ? 100.f * Stats.Reused / Stats.Acquired : 0.f;
+
+		Ar.Logf(TEXT("  %s: idle=%d acquired=%d reused=%d (%.1f%%) spawned=%d released=%d discarded=%d warmed up=%d"),
+			*GetNameSafe(Pair.Key), Pair.Value.Available.Num(), Stats.Acquired, Stats.Reused, HitRate, Stats.Spawned, Stats.Released,
+			Stats.Discarded, Stats.WarmedUp);
+	}
+}
+
+void UOWSProjectilePool::ResetStats()
+{
+	for (TPair<TObjectPtr<UClass>, FOWSProjectilePoolBucket>& Pair : Pools)
+	{
+		Pair.Value.Stats = FOWSProjectilePoolStats();
+	}
+}
@@ -0,0 +1,204 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSRegeneration.h"
+#include "OWSAttributeSet.h"
+#include "AbilitySystemComponent.h"
+#include "Engine/World.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSRegeneration> GOWSRegenerationStatsCmd(
+	TEXT("OWS.Regeneration.Stats"),
+	TEXT("Dumps how many attribute sets regenerate and how many attribute writes were saved.  Pass reset to clear them."));
+
+bool UOWSRegeneration::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSRegeneration::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSUseBatchedRegeneration"), bUseBatchedRegeneration, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSRegenerationInterval"), UpdateInterval, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSRegenerationBuckets"), NumberOfBuckets, GGameIni);
+
+	NumberOfBuckets = FMath::Max(1, NumberOfBuckets);
+	Buckets.SetNum(NumberOfBuckets);
+
+	Vitals = {
+		{ UOWSAttributeSet::GetHealthAttribute(), &UOWSAttributeSet::Health, &UOWSAttributeSet::MaxHealth, &UOWSAttributeSet::HealthRegenRate },
+		{ UOWSAttributeSet::GetManaAttribute(), &UOWSAttributeSet::Mana, &UOWSAttributeSet::MaxMana, &UOWSAttributeSet::ManaRegenRate },
+		{ UOWSAttributeSet::GetEnergyAttribute(), &UOWSAttributeSet::Energy, &UOWSAttributeSet::MaxEnergy, &UOWSAttributeSet::EnergyRegenRate },
+		{ UOWSAttributeSet::GetFatigueAttribute(), &UOWSAttributeSet::Fatigue, &UOWSAttributeSet::MaxFatigue, &UOWSAttributeSet::FatigueRegenRate },
+		{ UOWSAttributeSet::GetStaminaAttribute(), &UOWSAttributeSet::Stamina, &UOWSAttributeSet::MaxStamina, &UOWSAttributeSet::StaminaRegenRate },
+		{ UOWSAttributeSet::GetEnduranceAttribute(), &UOWSAttributeSet::Endurance, &UOWSAttributeSet::MaxEndurance, &UOWSAttributeSet::EnduranceRegenRate }
+	};
+}
+
+TStatId UOWSRegeneration::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOWSRegeneration, STATGROUP_Tickables);
+}
+
+void UOWSRegeneration::RegisterAttributeSet(UOWSAttributeSet* AttributeSet)
+{
+	if (!bUseBatchedRegeneration || !AttributeSet || BucketByAttributeSet.Contains(AttributeSet))
+	{
+		return;
+	}
+
+	//Keep the buckets even so every pass costs about the same
+	int32 SmallestBucket = 0;
+	for (int32 BucketIndex = 1; BucketIndex < Buckets.Num(); BucketIndex++)
+	{
+		if (Buckets[BucketIndex].AttributeSets.Num() < Buckets[SmallestBucket].AttributeSets.Num())
+		{
+			SmallestBucket = BucketIndex;
+		}
+	}
+
+	FBucket& Bucket = Buckets[SmallestBucket];
+	Bucket.AttributeSets.Add(AttributeSet);
+	Bucket.Carry.AddZeroed(Vitals.Num());
+	Bucket.LastUpdateTimes.Add(GetWorld()->GetTimeSeconds());
+	BucketByAttributeSet.Add(AttributeSet, SmallestBucket);
+
+	Stats.Registered = BucketByAttributeSet.Num();
+}
+
+void UOWSRegeneration::UnregisterAttributeSet(UOWSAttributeSet* AttributeSet)
+{
+	int32 BucketIndex = INDEX_NONE;
+	if (!BucketByAttributeSet.RemoveAndCopyValue(AttributeSet, BucketIndex))
+	{
+		return;
+	}
+
+	FBucket& Bucket = Buckets[BucketIndex];
+	const int32 Index = Bucket.AttributeSets.IndexOfByKey(AttributeSet);
+	if (Index != INDEX_NONE)
+	{
+		RemoveAt(Bucket, Index);
+	}
+
+	Stats.Registered = BucketByAttributeSet.Num();
+}
+
+void UOWSRegeneration::RemoveAt(FBucket& Bucket, int32 Index)
+{
+	Bucket.AttributeSets.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Bucket.Carry.RemoveAtSwap(Index * Vitals.Num(), Vitals.Num(), EAllowShrinking::No);
+	Bucket.LastUpdateTimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UOWSRegeneration::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (BucketByAttributeSet.Num() == 0)
+	{
+		return;
+	}
+
+	const float BucketInterval = FMath::Max(UpdateInterval, 0.01f) / Buckets.Num();
+
+	//A long frame catches up on at most one full round
+	TimeUntilNextBucket -= DeltaTime;
+	for (int32 Passes = 0; TimeUntilNextBucket <= 0.f && Passes < Buckets.Num(); Passes++)
+	{
+		ProcessBucket(Buckets[NextBucket]);
+		NextBucket = (NextBucket + 1) % Buckets.Num();
+		TimeUntilNextBucket += BucketInterval;
+	}
+
+	TimeUntilNextBucket = FMath::Max(TimeUntilNextBucket, 0.f);
+}
+
+void UOWSRegeneration::ProcessBucket(FBucket& Bucket)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumberOfVitals = Vitals.Num();
+
+	for (int32 Index = Bucket.AttributeSets.Num() - 1; Index >= 0; Index--)
+	{
+		UOWSAttributeSet* AttributeSet = Bucket.AttributeSets[Index].Get();
+		if (!AttributeSet)
+		{
+			//Destroyed without unregistering
+			BucketByAttributeSet.Remove(Bucket.AttributeSets[Index]);
+			RemoveAt(Bucket, Index);
+			Stats.Registered = BucketByAttributeSet.Num();
+			continue;
+		}
+
+		//Sets only regenerate for the time since they were registered or last updated
+		const float ElapsedTime = (float)(Now - Bucket.LastUpdateTimes[Index]);
+		Bucket.LastUpdateTimes[Index] = Now;
+
+		if (ElapsedTime <= 0.f || AttributeSet->Health.GetCurrentValue() <= 0.f)
+		{
+			continue;
+		}
+
+		UAbilitySystemComponent* AbilitySystemComponent = AttributeSet->GetOwningAbilitySystemComponent();
+		float* Carry = &Bucket.Carry[Index * NumberOfVitals];
+
+		for (int32 VitalIndex = 0; VitalIndex < NumberOfVitals; VitalIndex++)
+		{
+			const FVital& Vital = Vitals[VitalIndex];
+			const float RegenRate = (AttributeSet->*Vital.RegenRate).GetCurrentValue();
+			const float Current = (AttributeSet->*Vital.Value).GetCurrentValue();
+			const float Max = (AttributeSet->*Vital.Max).GetCurrentValue();
+
+			//Nothing to do, and nothing should be owed when it starts moving again
+			if (RegenRate == 0.f || (RegenRate > 0.f && Current >= Max) || (RegenRate < 0.f && Current <= 0.f))
+			{
+				Carry[VitalIndex] = 0.f;
+				continue;
+			}
+
+			Carry[VitalIndex] += RegenRate * ElapsedTime;
+
+			const float Target = FMath::Clamp(Current + Carry[VitalIndex], 0.f, Max);
+			const bool bReachedLimit = Target == Max || Target == 0.f;
+			if (FMath::FloorToInt(Target) == FMath::FloorToInt(Current) && !bReachedLimit)
+			{
+				Stats.WritesDeferred++;
+				continue;
+			}
+
+			if (AbilitySystemComponent)
+			{
+				const float BaseValue = (AttributeSet->*Vital.Value).GetBaseValue();
+				AbilitySystemComponent->SetNumericAttributeBase(Vital.Attribute, BaseValue + (Target - Current));
+				Stats.AttributeWrites++;
+			}
+
+			Carry[VitalIndex] = 0.f;
+		}
+	}
+
+	Stats.BucketPasses++;
+	Stats.LastPassMs = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UOWSRegeneration::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Regeneration: %s, %d attribute sets in %d buckets, every %.2fs"), bUseBatchedRegeneration ? TEXT("on") : TEXT("off"),
+		BucketByAttributeSet.Num(), Buckets.Num(), UpdateInterval);
+
+	const int32 Writes = Stats.AttributeWrites + Stats.WritesDeferred;
+	const float DeferredPercent = Writes > 0 ? 100.f * Stats.WritesDeferred / Writes : 0.f;
+
+	Ar.Logf(TEXT("  passes=%d writes=%d deferred=%d (%.1f%%) last pass=%.3fms"), Stats.BucketPasses, Stats.AttributeWrites, Stats.WritesDeferred,
+		DeferredPercent, Stats.LastPassMs);
+}
+
+void UOWSRegeneration::ResetStats()
+{
+	Stats = FOWSRegenerationStats();
+	Stats.Registered = BucketByAttributeSet.Num();
+}
@@ -0,0 +1,193 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSResponseCache.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSResponseCache> GOWSResponseCacheStatsCmd(
+	TEXT("OWS.Cache.Stats"),
+	TEXT("Dumps hit, miss and invalidation counters of the OWS response cache.  Pass reset to clear the counters or clear to drop every cached response."),
+	[](UOWSResponseCache& Cache, const FString& Arg)
+	{
+		if (Arg == TEXT("clear"))
+		{
+			Cache.Clear();
+		}
+	});
+
+void UOWSResponseCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	//Optional tuning, the defaults above are used when these are missing from DefaultGame.ini
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheCharacterStatsTTL"), CharacterStatsTTL, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheCustomCharacterDataTTL"), CustomCharacterDataTTL, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheCharacterAbilitiesTTL"), CharacterAbilitiesTTL, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheAbilityBarsTTL"), AbilityBarsTTL, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheGlobalDataItemTTL"), GlobalDataItemTTL, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSCacheMaxEntriesPerLookup"), MaxEntriesPerLookup, GGameIni);
+}
+
+void UOWSResponseCache::Deinitialize()
+{
+	Clear();
+}
+
+float UOWSResponseCache::GetTTL(EOWSCachedLookup Lookup) const
+{
+	switch (Lookup)
+	{
+	case EOWSCachedLookup::CharacterStats:
+		return CharacterStatsTTL;
+	case EOWSCachedLookup::CustomCharacterData:
+		return CustomCharacterDataTTL;
+	case EOWSCachedLookup::CharacterAbilities:
+		return CharacterAbilitiesTTL;
+	case EOWSCachedLookup::AbilityBars:
+		return AbilityBarsTTL;
+	case EOWSCachedLookup::GlobalDataItem:
+		return GlobalDataItemTTL;
+	default:
+		return 0.f;
+	}
+}
+
+bool UOWSResponseCache::TryGet(EOWSCachedLookup Lookup, const FString& Key, FString& OutContent)
+{
+	FLookupCache& LookupCache = Lookups[(int32)Lookup];
+
+	if (GetTTL(Lookup) <= 0.f)
+	{
+		return false;
+	}
+
+	if (const FCachedResponse* Cached = LookupCache.Entries.Find(Key))
+	{
+		if (Cached->ExpireTime > FPlatformTime::Seconds())
+		{
+			LookupCache.Stats.Hits++;
+			OutContent = Cached->Content;
+			return true;
+		}
+
+		LookupCache.Entries.Remove(Key);
+		LookupCache.Stats.Entries = LookupCache.Entries.Num();
+		LookupCache.Stats.Expired++;
+	}
+
+	LookupCache.Stats.Misses++;
+	return false;
+}
+
+uint32 UOWSResponseCache::GetGeneration(EOWSCachedLookup Lookup) const
+{
+	return Lookups[(int32)Lookup].Generation;
+}
+
+void UOWSResponseCache::Put(EOWSCachedLookup Lookup, const FString& Key, const FString& Content, uint32 FetchGeneration)
+{
+	FLookupCache& LookupCache = Lookups[(int32)Lookup];
+	const float TTL = GetTTL(Lookup);
+
+	//This key was written while the response was in flight, it may already be stale
+	if (TTL <= 0.f || FetchGeneration < LookupCache.OldestValidGeneration || LookupCache.KeyGenerations.FindRef(Key) > FetchGeneration)
+	{
+		return;
+	}
+
+	if (LookupCache.Entries.Num() >= MaxEntriesPerLookup && !LookupCache.Entries.Contains(Key))
+	{
+		PurgeExpired(LookupCache);
+
+		if (LookupCache.Entries.Num() >= MaxEntriesPerLookup)
+		{
+			return;
+		}
+	}
+
+	FCachedResponse& Cached = LookupCache.Entries.FindOrAdd(Key);
+	Cached.Content = Content;
+	Cached.ExpireTime = FPlatformTime::Seconds() + TTL;
+	LookupCache.Stats.Entries = LookupCache.Entries.Num();
+}
+
+void UOWSResponseCache::Invalidate(EOWSCachedLookup Lookup, const FString& Key)
+{
+	FLookupCache& LookupCache = Lookups[(int32)Lookup];
+	LookupCache.KeyGenerations.Add(Key, ++LookupCache.Generation);
+
+	//Forgetting the keys costs the fetches in flight their responses, nothing is served stale
+	if (LookupCache.KeyGenerations.Num() > MaxEntriesPerLookup)
+	{
+		LookupCache.KeyGenerations.Reset();
+		LookupCache.OldestValidGeneration = LookupCache.Generation;
+	}
+
+	if (LookupCache.Entries.Remove(Key) > 0)
+	{
+		LookupCache.Stats.Invalidations++;
+		LookupCache.Stats.Entries = LookupCache.Entries.Num();
+	}
+}
+
+void UOWSResponseCache::InvalidateCharacter(const FString& CharName)
+{
+	Invalidate(EOWSCachedLookup::CharacterStats, CharName);
+	Invalidate(EOWSCachedLookup::CustomCharacterData, CharName);
+	Invalidate(EOWSCachedLookup::CharacterAbilities, CharName);
+	Invalidate(EOWSCachedLookup::AbilityBars, CharName);
+}
+
+void UOWSResponseCache::Clear()
+{
+	for (FLookupCache& LookupCache : Lookups)
+	{
+		LookupCache.Entries.Empty();
+		LookupCache.KeyGenerations.Empty();
+		LookupCache.OldestValidGeneration = ++LookupCache.Generation;
+		LookupCache.Stats.Entries = 0;
+	}
+}
+
+void UOWSResponseCache::PurgeExpired(FLookupCache& LookupCache)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (auto It = LookupCache.Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Value().ExpireTime <= Now)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	LookupCache.Stats.Entries = LookupCache.Entries.Num();
+}
+
+FOWSResponseCacheStats UOWSResponseCache::GetStats(EOWSCachedLookup Lookup) const
+{
+	return Lookups[(int32)Lookup].Stats;
+}
+
+void UOWSResponseCache::DumpStats(FOutputDevice& Ar) const
+{
+	const UEnum* LookupEnum = StaticEnum<EOWSCachedLookup>();
+
+	Ar.Logf(TEXT("OWS Response Cache:"));
+	for (int32 LookupIndex = 0; LookupIndex < (int32)EOWSCachedLookup::MAX; LookupIndex++)
+	{
+		const FOWSResponseCacheStats& Stats = Lookups[LookupIndex].Stats;
+		const int32 Requests = Stats.Hits + Stats.Misses;
+		Ar.Logf(TEXT("  %s: entries=%d hits=%d misses=%d expired=%d invalidations=%d hit rate=%.1f%% ttl=%.0fs"),
+			*LookupEnum->GetNameStringByIndex(LookupIndex), Stats.Entries, Stats.Hits, Stats.Misses, Stats.Expired, Stats.Invalidations,
+			Requests > 0 ? 100.f * Stats.Hits / Requests : 0.f, GetTTL((EOWSCachedLookup)LookupIndex));
+	}
+}
+
+void UOWSResponseCache::ResetStats()
+{
+	for (FLookupCache& LookupCache : Lookups)
+	{
+		LookupCache.Stats = FOWSResponseCacheStats();
+		LookupCache.Stats.Entries = LookupCache.Entries.Num();
+	}
+}
@@ -0,0 +1,11 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSResponseDecoder.h"
+#include "HAL/IConsoleManager.h"
+
+int32 GOWSAsyncDecodeThreshold = 8 * 1024;
+static FAutoConsoleVariableRef CVarOWSAsyncDecodeThreshold(
+	TEXT("OWS.Decode.AsyncThreshold"),
+	GOWSAsyncDecodeThreshold,
+	TEXT("OWS responses of at least this many bytes are parsed on a worker thread instead of the game thread."),
+	ECVF_Default);
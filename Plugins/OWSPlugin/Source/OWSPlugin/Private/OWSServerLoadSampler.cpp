@@ -0,0 +1,77 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSServerLoadSampler.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetworkObjectList.h"
+#include "Misc/App.h"
+#include "HAL/PlatformMemory.h"
+
+FOWSServerLoadSampler::~FOWSServerLoadSampler()
+{
+	Stop();
+}
+
+void FOWSServerLoadSampler::Start()
+{
+	if (!TickerHandle.IsValid())
+	{
+		FrameTimesMs.Reset();
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FOWSServerLoadSampler::Tick));
+	}
+}
+
+void FOWSServerLoadSampler::Stop()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+bool FOWSServerLoadSampler::Tick(float DeltaTime)
+{
+	//A dedicated server sleeps out the rest of each frame under its max tick rate, that wait is not load
+	const double WorkTime = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0);
+
+	if (FrameTimesMs.Num() >= MaxFrameSamples)
+	{
+		FrameTimesMs.Reset();
+	}
+
+	FrameTimesMs.Add((float)(WorkTime * 1000.0));
+	return true;
+}
+
+FOWSZoneServerLoad FOWSServerLoadSampler::TakeSample(const UWorld* World)
+{
+	FOWSZoneServerLoad Load;
+
+	Load.FramesSampled = FrameTimesMs.Num();
+	if (FrameTimesMs.Num() > 0)
+	{
+		float TotalMs = 0.f;
+		for (const float FrameTimeMs : FrameTimesMs)
+		{
+			TotalMs += FrameTimeMs;
+		}
+
+		Load.AverageFrameTimeMs = TotalMs / FrameTimesMs.Num();
+
+		FrameTimesMs.Sort();
+		Load.P99FrameTimeMs = FrameTimesMs[FMath::Min(FMath::FloorToInt(FrameTimesMs.Num() * 0.99f), FrameTimesMs.Num() - 1)];
+		FrameTimesMs.Reset();
+	}
+
+	//The net driver's object list is kept with and without the replication graph, so this works for either
+	if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+	{
+		Load.ReplicatedActors = NetDriver->GetNetworkObjectList().GetActiveObjects().Num();
+		Load.OutgoingKBps = NetDriver->OutBytesPerSecond / 1024.f;
+	}
+
+	Load.UsedMemoryMB = FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f);
+
+	return Load;
+}
@@ -0,0 +1,189 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSTargetingQueries.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/OverlapResult.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSTargetingQueries> GOWSTargetingQueriesStatsCmd(
+	TEXT("OWS.Targeting.Stats"),
+	TEXT("Dumps how many targeting traces were requested, run and shared.  Pass reset to clear them."));
+
+bool UOWSTargetingQueries::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOWSTargetingQueries::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GConfig->GetBool(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTargetingAsyncCameraTraces"), bUseAsyncCameraTraces, GGameIni);
+}
+
+uint32 UOWSTargetingQueries::HashParams(const FCollisionQueryParams& Params)
+{
+	uint32 Hash = GetTypeHash(Params.bTraceComplex);
+	Hash = HashCombine(Hash, GetTypeHash(Params.bReturnPhysicalMaterial));
+	Hash = HashCombine(Hash, GetTypeHash(Params.bReturnFaceIndex));
+
+	for (const uint32 IgnoredActor : Params.GetIgnoredActors())
+	{
+		Hash = HashCombine(Hash, IgnoredActor);
+	}
+
+	//Keep ignored actors and components apart
+	Hash = HashCombine(Hash, Params.GetIgnoredActors().Num());
+
+	for (const uint32 IgnoredComponent : Params.GetIgnoredComponents())
+	{
+		Hash = HashCombine(Hash, IgnoredComponent);
+	}
+
+	return Hash;
+}
+
+void UOWSTargetingQueries::BeginFrame()
+{
+	CurrentFrame = GFrameCounter;
+	FrameTraces.Reset();
+
+	//A player that stopped aiming starts over with a fresh trace next time
+	for (auto It = AsyncCameraTraces.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid() || It.Value().LastRequestFrame + 1 < CurrentFrame)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+const TArray<FHitResult>& UOWSTargetingQueries::LineTraceMulti(const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams& Params,
+	const APlayerController* CameraOwner)
+{
+	if (CurrentFrame != GFrameCounter)
+	{
+		BeginFrame();
+	}
+
+	Stats.TracesRequested++;
+
+	FTraceKey Key;
+	Key.Start = Start;
+	Key.End = End;
+	Key.ProfileName = ProfileName;
+	Key.ParamsHash = HashParams(Params);
+
+	if (bUseAsyncCameraTraces && CameraOwner)
+	{
+		return AsyncCameraTrace(Key, Params, CameraOwner);
+	}
+
+	return TraceNow(Key, Params);
+}
+
+const TArray<FHitResult>& UOWSTargetingQueries::TraceNow(const FTraceKey& Key, const FCollisionQueryParams& Params)
+{
+	if (const TArray<FHitResult>* HitResults = FrameTraces.Find(Key))
+	{
+		return *HitResults;
+	}
+
+	TArray<FHitResult>& HitResults = FrameTraces.Add(Key);
+	GetWorld()->LineTraceMultiByProfile(HitResults, Key.Start, Key.End, Key.ProfileName, Params);
+	Stats.TracesRun++;
+
+	return HitResults;
+}
+
+const TArray<FHitResult>& UOWSTargetingQueries::AsyncCameraTrace(const FTraceKey& Key, const FCollisionQueryParams& Params, const APlayerController* CameraOwner)
+{
+	UWorld* World = GetWorld();
+	FAsyncCameraTrace& CameraTrace = AsyncCameraTraces.FindOrAdd(CameraOwner);
+
+	//Hits for another profile or other ignored actors are no use to this caller
+	if (CameraTrace.ProfileName != Key.ProfileName || CameraTrace.ParamsHash != Key.ParamsHash)
+	{
+		CameraTrace.ProfileName = Key.ProfileName;
+		CameraTrace.ParamsHash = Key.ParamsHash;
+		CameraTrace.Handle = FTraceHandle();
+		CameraTrace.bHasHitResults = false;
+	}
+
+	FTraceDatum TraceDatum;
+	if (CameraTrace.Handle.IsValid() && World->QueryTraceData(CameraTrace.Handle, TraceDatum))
+	{
+		CameraTrace.HitResults = MoveTemp(TraceDatum.OutHits);
+		CameraTrace.bHasHitResults = true;
+		CameraTrace.Handle = FTraceHandle();
+	}
+
+	//One async trace per player per frame, however many targeting actors aim through the camera
+	if (CameraTrace.LastRequestFrame != CurrentFrame)
+	{
+		CameraTrace.LastRequestFrame = CurrentFrame;
+
+		if (!CameraTrace.Handle.IsValid())
+		{
+			CameraTrace.Handle = World->AsyncLineTraceByProfile(EAsyncTraceType::Multi, Key.Start, Key.End, Key.ProfileName, Params);
+			Stats.AsyncCameraTracesStarted++;
+		}
+	}
+
+	if (CameraTrace.bHasHitResults)
+	{
+		Stats.AsyncCameraTracesUsed++;
+		return CameraTrace.HitResults;
+	}
+
+	//Nothing back yet on the first frame of aiming
+	return TraceNow(Key, Params);
+}
+
+void UOWSTargetingQueries::OverlapPawns(const FVector& Origin, float Radius, const FCollisionQueryParams& Params, TArray<APawn*>& OutPawns)
+{
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, Origin, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Radius), Params);
+	Stats.Overlaps++;
+
+	TSet<APawn*> FoundPawns;
+	FoundPawns.Reserve(Overlaps.Num());
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		APawn* Pawn = Cast<APawn>(Overlap.GetActor());
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		bool bAlreadyFound = false;
+		FoundPawns.Add(Pawn, &bAlreadyFound);
+
+		if (bAlreadyFound)
+		{
+			Stats.DuplicateOverlapsRemoved++;
+			continue;
+		}
+
+		OutPawns.Add(Pawn);
+	}
+}
+
+void UOWSTargetingQueries::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Targeting Queries: %s camera traces, %d players aiming"), bUseAsyncCameraTraces ? TEXT("async") : TEXT("sync"), AsyncCameraTraces.Num());
+
+	const int32 TracesShared = Stats.TracesRequested - Stats.TracesRun - Stats.AsyncCameraTracesUsed;
+	const float SharedPercent = Stats.TracesRequested > 0 ? 100.f * TracesShared / Stats.TracesRequested : 0.f;
+
+	Ar.Logf(TEXT("  traces requested=%d run=%d shared=%d (%.1f%%) async started=%d async used=%d overlaps=%d duplicates removed=%d"), Stats.TracesRequested,
+		Stats.TracesRun, TracesShared, SharedPercent, Stats.AsyncCameraTracesStarted, Stats.AsyncCameraTracesUsed, Stats.Overlaps, Stats.DuplicateOverlapsRemoved);
+}
+
+void UOWSTargetingQueries::ResetStats()
+{
+	Stats = FOWSTargetingQueryStats();
+}
@@ -0,0 +1,377 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSTransportSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "OWSDebugCommands.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSTransportSubsystem> GOWSTransportStatsCmd(
+	TEXT("OWS.Transport.Stats"),
+	TEXT("Dumps per endpoint request, retry, dedup and latency counters of the OWS transport.  Pass reset to clear them."));
+
+void UOWSTransportSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	GConfig->GetString(
+		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
+		TEXT("OWSAPICustomerKey"),
+		OWSAPICustomerKey,
+		GGameIni
+	);
+
+	GConfig->GetString(
+		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
+		TEXT("OWS2APIPath"),
+		OWS2APIPath,
+		GGameIni
+	);
+
+	GConfig->GetString(
+		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
+		TEXT("OWS2InstanceManagementAPIPath"),
+		OWS2InstanceManagementAPIPath,
+		GGameIni
+	);
+
+	GConfig->GetString(
+		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
+		TEXT("OWS2CharacterPersistenceAPIPath"),
+		OWS2CharacterPersistenceAPIPath,
+		GGameIni
+	);
+
+	GConfig->GetString(
+		TEXT("/Script/EngineSettings.GeneralProjectSettings"),
+		TEXT("OWS2GlobalDataAPIPath"),
+		OWS2GlobalDataAPIPath,
+		GGameIni
+	);
+
+	//Optional tuning, the defaults above are used when these are missing from DefaultGame.ini
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportDefaultRequestTimeout"), DefaultRequestTimeout, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportMaxQueuedRequests"), MaxQueuedRequests, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportMaxConcurrentRequests"), MaxConcurrentRequests, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportMaxConcurrentRequestsPerEndpoint"), MaxConcurrentRequestsPerEndpoint, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportMaxRetries"), MaxRetries, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportRetryBaseDelay"), RetryBaseDelay, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSTransportRetryMaxDelay"), RetryMaxDelay, GGameIni);
+
+	ComposeEndpointURLs();
+}
+
+void UOWSTransportSubsystem::Deinitialize()
+{
+	for (const TSharedPtr<FPendingRequest>& Pending : WaitingForRetry)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Pending->RetryHandle);
+	}
+
+	for (const TSharedPtr<FPendingRequest>& Pending : InFlight)
+	{
+		if (Pending->HttpRequest.IsValid())
+		{
+			Pending->HttpRequest->OnProcessRequestComplete().Unbind();
+			Pending->HttpRequest->CancelRequest();
+		}
+	}
+
+	Queue.Empty();
+	InFlight.Empty();
+	WaitingForRetry.Empty();
+	PendingByDedupKey.Empty();
+
+	for (int32& EndpointInFlight : InFlightPerEndpoint)
+	{
+		EndpointInFlight = 0;
+	}
+}
+
+const FString& UOWSTransportSubsystem::GetAPIPathForModule(EOWSApiModule Module) const
+{
+	switch (Module)
+	{
+	case EOWSApiModule::InstanceManagementAPI:
+		return OWS2InstanceManagementAPIPath;
+	case EOWSApiModule::CharacterPersistenceAPI:
+		return OWS2CharacterPersistenceAPIPath;
+	case EOWSApiModule::GlobalDataAPI:
+		return OWS2GlobalDataAPIPath;
+	default:
+		return OWS2APIPath;
+	}
+}
+
+void UOWSTransportSubsystem::ComposeEndpointURLs()
+{
+	const TArray<const FOWSEndpoint*>& Endpoints = FOWSEndpoint::GetAll();
+
+	EndpointURLs.SetNum(Endpoints.Num());
+	InFlightPerEndpoint.SetNumZeroed(Endpoints.Num());
+	StatsPerEndpoint.SetNum(Endpoints.Num());
+
+	for (const FOWSEndpoint* Endpoint : Endpoints)
+	{
+		const FString& APIPath = GetAPIPathForModule(Endpoint->Module);
+		if (APIPath.IsEmpty())
+		{
+			UE_LOG(OWS, Warning, TEXT("OWS Transport - No base path is configured for %s, %s will not reach the backend"), LexToString(Endpoint->Module), *Endpoint->Name);
+		}
+
+		EndpointURLs[Endpoint->Index] = APIPath + Endpoint->Path;
+	}
+}
+
+void UOWSTransportSubsystem::ProcessOWS2Request(const FOWSEndpoint& Endpoint, const FString& Content, float Timeout, FOWSTransportRequestCompleteDelegate OnComplete)
+{
+	//Endpoints declared by a module that loaded after Initialize
+	if (!EndpointURLs.IsValidIndex(Endpoint.Index))
+	{
+		ComposeEndpointURLs();
+	}
+
+	FDedupKey DedupKey;
+	if (Endpoint.bIdempotent)
+	{
+		DedupKey = FDedupKey(Endpoint.Index, Content);
+	}
+
+	QueueRequest(Endpoint, CopyTemp(EndpointURLs[Endpoint.Index]), MoveTemp(DedupKey), Content, Timeout, MoveTemp(OnComplete));
+}
+
+void UOWSTransportSubsystem::ProcessOWS2RequestWithPathParameter(const FOWSEndpoint& Endpoint, const FString& PathParameter, const FString& Content, float Timeout,
+	FOWSTransportRequestCompleteDelegate OnComplete)
+{
+	if (!EndpointURLs.IsValidIndex(Endpoint.Index))
+	{
+		ComposeEndpointURLs();
+	}
+
+	FString URL = EndpointURLs[Endpoint.Index] / PathParameter;
+
+	FDedupKey DedupKey;
+	if (Endpoint.bIdempotent)
+	{
+		DedupKey = FDedupKey(Endpoint.Index, PathParameter + TEXT("\n") + Content);
+	}
+
+	QueueRequest(Endpoint, MoveTemp(URL), MoveTemp(DedupKey), Content, Timeout, MoveTemp(OnComplete));
+}
+
+void UOWSTransportSubsystem::QueueRequest(const FOWSEndpoint& Endpoint, FString&& URL, FDedupKey&& DedupKey, const FString& Content, float Timeout,
+	FOWSTransportRequestCompleteDelegate&& OnComplete)
+{
+	FOWSEndpointStats& Stats = StatsPerEndpoint[Endpoint.Index];
+
+	if (Endpoint.bIdempotent)
+	{
+		if (TSharedPtr<FPendingRequest>* Existing = PendingByDedupKey.Find(DedupKey))
+		{
+			(*Existing)->Waiters.Add(MoveTemp(OnComplete));
+			Stats.DedupHits++;
+			return;
+		}
+	}
+
+	if (Queue.Num() >= MaxQueuedRequests)
+	{
+		UE_LOG(OWS, Error, TEXT("OWS Transport - Request queue is full (%d), rejecting %s"), MaxQueuedRequests, *Endpoint.Name);
+		Stats.Rejected++;
+		OnComplete.ExecuteIfBound(nullptr, nullptr, false);
+		return;
+	}
+
+	TSharedPtr<FPendingRequest> Pending = MakeShared<FPendingRequest>();
+	Pending->Endpoint = &Endpoint;
+	Pending->DedupKey = MoveTemp(DedupKey);
+	Pending->URL = MoveTemp(URL);
+	Pending->Content = Content;
+	Pending->Timeout = Timeout > 0.f ? Timeout : DefaultRequestTimeout;
+	Pending->bIdempotent = Endpoint.bIdempotent;
+	Pending->StartTime = FPlatformTime::Seconds();
+	Pending->Waiters.Add(MoveTemp(OnComplete));
+
+	if (Pending->bIdempotent)
+	{
+		PendingByDedupKey.Add(Pending->DedupKey, Pending);
+	}
+
+	Queue.Add(Pending);
+	PumpQueue();
+}
+
+void UOWSTransportSubsystem::PumpQueue()
+{
+	for (int32 QueueIndex = 0; QueueIndex < Queue.Num() && InFlight.Num() < MaxConcurrentRequests;)
+	{
+		TSharedPtr<FPendingRequest> Pending = Queue[QueueIndex];
+		int32& EndpointInFlight = InFlightPerEndpoint[Pending->Endpoint->Index];
+
+		//Skip endpoints that are saturated so one busy endpoint does not block the others
+		if (EndpointInFlight >= MaxConcurrentRequestsPerEndpoint)
+		{
+			QueueIndex++;
+			continue;
+		}
+
+		EndpointInFlight++;
+		Queue.RemoveAt(QueueIndex);
+		Dispatch(Pending);
+	}
+}
+
+void UOWSTransportSubsystem::Dispatch(TSharedPtr<FPendingRequest> Pending)
+{
+	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->OnProcessRequestComplete().BindUObject(this, &UOWSTransportSubsystem::OnRequestComplete, Pending);
+	Request->SetURL(Pending->URL);
+	Request->SetVerb(Pending->Endpoint->Verb);
+	Request->SetTimeout(Pending->Timeout);
+	Request->SetHeader(TEXT("User-Agent"), "X-UnrealEngine-Agent");
+	Request->SetHeader("Content-Type", TEXT("application/json"));
+	Request->SetHeader(TEXT("X-CustomerGUID"), OWSAPICustomerKey);
+	if (!Pending->Content.IsEmpty())
+	{
+		Request->SetContentAsString(Pending->Content);
+	}
+
+	Pending->HttpRequest = Request;
+	Pending->Attempt++;
+	InFlight.Add(Pending);
+	StatsPerEndpoint[Pending->Endpoint->Index].RequestsSent++;
+
+	Request->ProcessRequest();
+}
+
+void UOWSTransportSubsystem::OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedPtr<FPendingRequest> Pending)
+{
+	InFlight.Remove(Pending);
+	Pending->HttpRequest.Reset();
+
+	int32& EndpointInFlight = InFlightPerEndpoint[Pending->Endpoint->Index];
+	EndpointInFlight = FMath::Max(0, EndpointInFlight - 1);
+
+	//Handlers read the response whenever bWasSuccessful is set, so a request that completed without one has failed
+	if (!Response.IsValid())
+	{
+		bWasSuccessful = false;
+	}
+
+	if (ShouldRetry(*Pending, Response, bWasSuccessful))
+	{
+		ScheduleRetry(Pending);
+	}
+	else
+	{
+		Finish(Pending, Request, Response, bWasSuccessful);
+	}
+
+	PumpQueue();
+}
+
+bool UOWSTransportSubsystem::ShouldRetry(const FPendingRequest& Pending, FHttpResponsePtr Response, bool bWasSuccessful) const
+{
+	if (!Pending.bIdempotent || Pending.Attempt > MaxRetries)
+	{
+		return false;
+	}
+
+	if (!bWasSuccessful || !Response.IsValid())
+	{
+		return true;
+	}
+
+	const int32 ResponseCode = Response->GetResponseCode();
+	return ResponseCode >= EHttpResponseCodes::ServerError || ResponseCode == EHttpResponseCodes::TooManyRequests;
+}
+
+void UOWSTransportSubsystem::ScheduleRetry(TSharedPtr<FPendingRequest> Pending)
+{
+	const float Delay = FMath::Min(RetryBaseDelay * FMath::Pow(2.f, (float)(Pending->Attempt - 1)), RetryMaxDelay);
+	//Jitter so a backend hiccup during a login wave does not produce a synchronized retry wave
+	const float JitteredDelay = Delay * FMath::FRandRange(0.75f, 1.25f);
+
+	StatsPerEndpoint[Pending->Endpoint->Index].Retries++;
+	UE_LOG(OWS, Verbose, TEXT("OWS Transport - Retrying %s in %f seconds (attempt %d)"), *Pending->Endpoint->Name, JitteredDelay, Pending->Attempt + 1);
+
+	WaitingForRetry.Add(Pending);
+	Pending->RetryHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, Pending](float)
+	{
+		WaitingForRetry.Remove(Pending);
+		//Retries go to the front of the queue, they have already waited their turn once
+		Queue.Insert(Pending, 0);
+		PumpQueue();
+		return false;
+	}), JitteredDelay);
+}
+
+void UOWSTransportSubsystem::Finish(TSharedPtr<FPendingRequest> Pending, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+{
+	if (Pending->bIdempotent)
+	{
+		PendingByDedupKey.Remove(Pending->DedupKey);
+	}
+
+	FOWSEndpointStats& Stats = StatsPerEndpoint[Pending->Endpoint->Index];
+	Stats.AddLatencySample(FPlatformTime::Seconds() - Pending->StartTime);
+
+	if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		Stats.Succeeded++;
+	}
+	else
+	{
+		Stats.Failed++;
+	}
+
+	//Waiters may queue new requests from their handlers, so take ownership of the list first
+	TArray<FOWSTransportRequestCompleteDelegate> Waiters = MoveTemp(Pending->Waiters);
+	for (FOWSTransportRequestCompleteDelegate& Waiter : Waiters)
+	{
+		Waiter.ExecuteIfBound(Request, Response, bWasSuccessful);
+	}
+}
+
+FOWSEndpointStats UOWSTransportSubsystem::GetEndpointStats(const FString& Endpoint) const
+{
+	for (const FOWSEndpoint* RegisteredEndpoint : FOWSEndpoint::GetAll())
+	{
+		if (RegisteredEndpoint->Name == Endpoint && StatsPerEndpoint.IsValidIndex(RegisteredEndpoint->Index))
+		{
+			return StatsPerEndpoint[RegisteredEndpoint->Index];
+		}
+	}
+
+	return FOWSEndpointStats();
+}
+
+const FOWSEndpointStats& UOWSTransportSubsystem::GetEndpointStats(const FOWSEndpoint& Endpoint) const
+{
+	return StatsPerEndpoint[Endpoint.Index];
+}
+
+void UOWSTransportSubsystem::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("OWS Transport: %d queued, %d in flight, %d waiting to retry"), Queue.Num(), InFlight.Num(), WaitingForRetry.Num());
+
+	for (const FOWSEndpoint* Endpoint : FOWSEndpoint::GetAll())
+	{
+		const FOWSEndpointStats& Stats = StatsPerEndpoint[Endpoint->Index];
+		if (Stats.RequestsSent == 0 && Stats.DedupHits == 0 && Stats.Rejected == 0)
+		{
+			continue;
+		}
+
+		Ar.Logf(TEXT("  %s: sent=%d ok=%d failed=%d retries=%d dedup=%d rejected=%d avg=%.1fms max=%.1fms"),
+			*Endpoint->Name, Stats.RequestsSent, Stats.Succeeded, Stats.Failed, Stats.Retries, Stats.DedupHits, Stats.Rejected,
+			Stats.AverageLatencyMs, Stats.MaxLatencyMs);
+	}
+}
+
+void UOWSTransportSubsystem::ResetStats()
+{
+	for (FOWSEndpointStats& Stats : StatsPerEndpoint)
+	{
+		Stats = FOWSEndpointStats();
+	}
+}
@@ -2,6 +2,9 @@
 
 #include "OWSTravelToMapActor.h"
 #include "Runtime/Engine/Classes/GameFramework/PlayerState.h"
+#include "Runtime/Engine/Classes/GameFramework/PlayerController.h"
+#include "Runtime/Engine/Classes/GameFramework/Pawn.h"
+#include "Engine/Engine.h"
 #include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
 
 
@@ -30,6 +33,43 @@ void AOWSTravelToMapActor::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
+	TimeUntilPrefetchCheck -= DeltaTime;
+	if (TimeUntilPrefetchCheck <= 0.f)
+	{
+		TimeUntilPrefetchCheck = PrefetchCheckInterval;
+		PrefetchIfLocalPlayerIsNear();
+	}
+}
+
+void AOWSTravelToMapActor::PrefetchIfLocalPlayerIsNear()
+{
+	//Travel is requested by the owning client, a dedicated server has nobody to prefetch for
+	if (PrefetchRadius <= 0.f || ZoneName.IsEmpty() || GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = GEngine->GetFirstLocalPlayerController(GetWorld());
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (!Pawn || !PlayerController->PlayerState)
+	{
+		return;
+	}
+
+	if (FVector::DistSquared(Pawn->GetActorLocation(), GetActorLocation()) > FMath::Square(PrefetchRadius))
+	{
+		bPrefetchedForLocalPlayer = false;
+		return;
+	}
+
+	//Once per approach, a player idling by the portal does not ask again each time the assignment expires
+	if (bPrefetchedForLocalPlayer)
+	{
+		return;
+	}
+
+	bPrefetchedForLocalPlayer = true;
+	OWSPlayerControllerComponent->PrefetchZoneServerToTravelTo(PlayerController->PlayerState->GetPlayerName(), ZoneName);
 }
 
 
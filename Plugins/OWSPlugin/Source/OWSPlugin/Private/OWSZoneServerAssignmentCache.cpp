@@ -0,0 +1,287 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSZoneServerAssignmentCache.h"
+#include "OWSTransportSubsystem.h"
+#include "OWSEndpoints.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "OWSDebugCommands.h"
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+static TOWSStatsConsoleCommand<UOWSZoneServerAssignmentCache> GOWSZoneServerAssignmentStatsCmd(
+	TEXT("OWS.Travel.Stats"),
+	TEXT("Dumps prefetch, hit and miss counters of the zone server assignment cache.  Pass reset to clear the counters or clear to drop every held assignment."),
+	[](UOWSZoneServerAssignmentCache& AssignmentCache, const FString& Arg)
+	{
+		if (Arg == TEXT("clear"))
+		{
+			AssignmentCache.Clear();
+		}
+	});
+
+void UOWSZoneServerAssignmentCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Collection.InitializeDependency(UOWSTransportSubsystem::StaticClass());
+
+	//Optional tuning, the defaults above are used when these are missing from DefaultGame.ini
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSZoneServerAssignmentTTL"), AssignmentTTL, GGameIni);
+	GConfig->GetInt(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSMaxZoneServerAssignments"), MaxAssignments, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSZoneServerPrefetchRetryDelay"), PrefetchRetryDelay, GGameIni);
+	GConfig->GetFloat(TEXT("/Script/EngineSettings.GeneralProjectSettings"), TEXT("OWSZoneServerMaxPrefetchRetryDelay"), MaxPrefetchRetryDelay, GGameIni);
+}
+
+void UOWSZoneServerAssignmentCache::Deinitialize()
+{
+	Assignments.Empty();
+	PrefetchBackoffs.Empty();
+}
+
+FString UOWSZoneServerAssignmentCache::MakeKey(const FTravelToLastZoneServerJSONPost& Request)
+{
+	return Request.CharacterName + TEXT("\n") + Request.ZoneName + TEXT("\n") + FString::FromInt(Request.PlayerGroupType);
+}
+
+bool UOWSZoneServerAssignmentCache::HasServerAndPort(const FString& Content)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	if (!OWSEndpoints::GetServerToConnectTo.DecodeResponse(Content, JsonObject))
+	{
+		return false;
+	}
+
+	return !JsonObject->GetStringField(TEXT("serverip")).IsEmpty() && !JsonObject->GetStringField(TEXT("port")).IsEmpty();
+}
+
+void UOWSZoneServerAssignmentCache::Prefetch(const FTravelToLastZoneServerJSONPost& Request, float Timeout)
+{
+	if (AssignmentTTL <= 0.f)
+	{
+		return;
+	}
+
+	const FString Key = MakeKey(Request);
+	if (const FAssignment* Assignment = Assignments.Find(Key))
+	{
+		if (Assignment->bInFlight || Assignment->ExpireTime > FPlatformTime::Seconds())
+		{
+			return;
+		}
+
+		Assignments.Remove(Key);
+		Stats.Expired++;
+	}
+
+	if (const FPrefetchBackoff* Backoff = PrefetchBackoffs.Find(Key))
+	{
+		if (Backoff->RetryTime > FPlatformTime::Seconds())
+		{
+			Stats.PrefetchesBackedOff++;
+			return;
+		}
+	}
+
+	if (Assignments.Num() >= MaxAssignments)
+	{
+		PurgeExpired();
+
+		if (Assignments.Num() >= MaxAssignments)
+		{
+			return;
+		}
+	}
+
+	Stats.Prefetches++;
+	SendRequest(Key, Request, Timeout, FOWSZoneServerResolvedDelegate());
+}
+
+void UOWSZoneServerAssignmentCache::Resolve(const FTravelToLastZoneServerJSONPost& Request, float Timeout, FOWSZoneServerResolvedDelegate OnResolved)
+{
+	const FString Key = MakeKey(Request);
+	if (FAssignment* Assignment = Assignments.Find(Key))
+	{
+		if (Assignment->bInFlight)
+		{
+			Stats.InFlightJoins++;
+			Assignment->Waiters.Add(MoveTemp(OnResolved));
+			return;
+		}
+
+		//Assignments are used once, the next hop asks again
+		const bool bFresh = Assignment->ExpireTime > FPlatformTime::Seconds();
+		const FString Content = MoveTemp(Assignment->Content);
+		Assignments.Remove(Key);
+
+		if (bFresh)
+		{
+			Stats.Hits++;
+			OnResolved.ExecuteIfBound(true, Content);
+			return;
+		}
+
+		Stats.Expired++;
+	}
+
+	Stats.Misses++;
+	SendRequest(Key, Request, Timeout, MoveTemp(OnResolved));
+}
+
+bool UOWSZoneServerAssignmentCache::HasAssignment(const FTravelToLastZoneServerJSONPost& Request) const
+{
+	const FAssignment* Assignment = Assignments.Find(MakeKey(Request));
+	return Assignment && (Assignment->bInFlight || Assignment->ExpireTime > FPlatformTime::Seconds());
+}
+
+void UOWSZoneServerAssignmentCache::SendRequest(const FString& Key, const FTravelToLastZoneServerJSONPost& Request, float Timeout, FOWSZoneServerResolvedDelegate OnResolved)
+{
+	UOWSTransportSubsystem* Transport = GetGameInstance()->GetSubsystem<UOWSTransportSubsystem>();
+	FString PostParameters = "";
+	if (!Transport || !OWSEndpoints::GetServerToConnectTo.SerializeRequest(Request, PostParameters))
+	{
+		UE_LOG(OWS, Error, TEXT("UOWSZoneServerAssignmentCache - Unable to request a zone server for %s in %s"), *Request.CharacterName, *Request.ZoneName);
+		Stats.Failures++;
+		OnResolved.ExecuteIfBound(false, FString());
+		return;
+	}
+
+	FAssignment& Assignment = Assignments.Add(Key);
+	Assignment.CharacterName = Request.CharacterName;
+	if (OnResolved.IsBound())
+	{
+		Assignment.Waiters.Add(MoveTemp(OnResolved));
+	}
+
+	//The transport may complete synchronously if its queue is full, so Assignment is not touched after this
+	Transport->ProcessOWS2Request(OWSEndpoints::GetServerToConnectTo, PostParameters, Timeout,
+		FOWSTransportRequestCompleteDelegate::CreateUObject(this, &UOWSZoneServerAssignmentCache::OnResponseReceived, FString(Key)));
+}
+
+void UOWSZoneServerAssignmentCache::OnResponseReceived(FHttpRequestPtr HttpRequest, FHttpResponsePtr Response, bool bWasSuccessful, FString Key)
+{
+	FAssignment* Assignment = Assignments.Find(Key);
+	if (!Assignment || !Assignment->bInFlight)
+	{
+		return;
+	}
+
+	FString Content;
+	const bool bResolved = bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+	if (bResolved)
+	{
+		Content = Response->GetContentAsString();
+	}
+	else
+	{
+		Stats.Failures++;
+	}
+
+	TArray<FOWSZoneServerResolvedDelegate> Waiters = MoveTemp(Assignment->Waiters);
+	const bool bHasServer = bResolved && HasServerAndPort(Content);
+
+	if (bHasServer)
+	{
+		PrefetchBackoffs.Remove(Key);
+	}
+	else
+	{
+		FPrefetchBackoff& Backoff = PrefetchBackoffs.FindOrAdd(Key);
+		Backoff.CharacterName = Assignment->CharacterName;
+		Backoff.Failures++;
+		const float RetryDelay = FMath::Min(PrefetchRetryDelay * FMath::Pow(2.f, (float)FMath::Min(Backoff.Failures - 1, 16)), MaxPrefetchRetryDelay);
+		Backoff.RetryTime = FPlatformTime::Seconds() + RetryDelay;
+	}
+
+	//Hold a successful prefetch nobody has asked for yet, anything else is handed out or dropped right away
+	if (bHasServer && Waiters.Num() == 0 && Assignment->bKeepResponse)
+	{
+		Assignment->bInFlight = false;
+		Assignment->Content = MoveTemp(Content);
+		Assignment->ExpireTime = FPlatformTime::Seconds() + AssignmentTTL;
+		return;
+	}
+
+	Assignments.Remove(Key);
+
+	for (FOWSZoneServerResolvedDelegate& Waiter : Waiters)
+	{
+		Waiter.ExecuteIfBound(bResolved, Content);
+	}
+}
+
+void UOWSZoneServerAssignmentCache::InvalidateCharacter(const FString& CharacterName)
+{
+	for (auto It = PrefetchBackoffs.CreateIterator(); It; ++It)
+	{
+		if (It.Value().CharacterName == CharacterName)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = Assignments.CreateIterator(); It; ++It)
+	{
+		if (It.Value().CharacterName != CharacterName)
+		{
+			continue;
+		}
+
+		//Travel already waiting on the request still gets its answer
+		if (It.Value().bInFlight)
+		{
+			It.Value().bKeepResponse = false;
+		}
+		else
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UOWSZoneServerAssignmentCache::Clear()
+{
+	PrefetchBackoffs.Empty();
+
+	for (auto It = Assignments.CreateIterator(); It; ++It)
+	{
+		if (It.Value().bInFlight)
+		{
+			It.Value().bKeepResponse = false;
+		}
+		else
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UOWSZoneServerAssignmentCache::PurgeExpired()
+{
+	const double Now = FPlatformTime::Seconds();
+	for (auto It = Assignments.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().bInFlight && It.Value().ExpireTime <= Now)
+		{
+			It.RemoveCurrent();
+			Stats.Expired++;
+		}
+	}
+}
+
+void UOWSZoneServerAssignmentCache::DumpStats(FOutputDevice& Ar) const
+{
+	int32 InFlight = 0;
+	for (const TPair<FString, FAssignment>& Pair : Assignments)
+	{
+		InFlight += Pair.Value.bInFlight ? 1 : 0;
+	}
+
+	const int32 Travels = Stats.Hits + Stats.InFlightJoins + Stats.Misses;
+	Ar.Logf(TEXT("OWS Zone Server Assignments: held=%d in flight=%d ttl=%.0fs"), Assignments.Num() - InFlight, InFlight, AssignmentTTL);
+	Ar.Logf(TEXT("  prefetches=%d backed off=%d hits=%d in flight joins=%d misses=%d expired=%d failures=%d prefetched travel=%.1f%%"),
+		Stats.Prefetches, Stats.PrefetchesBackedOff, Stats.Hits, Stats.InFlightJoins, Stats.Misses, Stats.Expired, Stats.Failures,
+		Travels > 0 ? 100.f * (Stats.Hits + Stats.InFlightJoins) / Travels : 0.f);
+}
+
+void UOWSZoneServerAssignmentCache::ResetStats()
+{
+	Stats = FOWSZoneServerAssignmentStats();
+}
@@ -0,0 +1,123 @@
+// Copyright 2022 Sabre Dart Studios
+
+#include "OWSChatRouter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace OWSChatRouterTests
+{
+	//Each router gets a world of its own, so they talk to each other as separate zone servers would
+	struct FZoneServer
+	{
+		UWorld* World = nullptr;
+		UOWSChatRouter* Router = nullptr;
+
+		FZoneServer()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+			Router = World->GetSubsystem<UOWSChatRouter>();
+		}
+
+		~FZoneServer()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		void SendGlobalChat(int32 NumberOfMessages)
+		{
+			for (int32 MessageIndex = 0; MessageIndex < NumberOfMessages; MessageIndex++)
+			{
+				Router->SendGlobalChat(TEXT("Sender"), FString::Printf(TEXT("Message %d"), MessageIndex));
+			}
+		}
+
+		int32 GetNumberReceived() const
+		{
+			return Router->GetStats().RemoteMessagesReceived;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOWSLocalChatBacklogTest, "OWS.Chat.LocalBackend.Backlog",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOWSLocalChatBacklogTest::RunTest(const FString& Parameters)
+{
+	using namespace OWSChatRouterTests;
+
+	FZoneServer ServerA;
+	FZoneServer ServerB;
+	if (!TestNotNull(TEXT("Router A"), ServerA.Router) || !TestNotNull(TEXT("Router B"), ServerB.Router))
+	{
+		return false;
+	}
+
+	TSharedRef<FOWSLocalChatBackend> Backend = MakeShared<FOWSLocalChatBackend>();
+	ServerA.Router->SetBackend(Backend);
+	ServerB.Router->SetBackend(Backend);
+
+	ServerA.SendGlobalChat(3);
+	ServerA.Router->Flush();
+
+	TestEqual(TEXT("The sender is not handed its own messages"), ServerA.GetNumberReceived(), 0);
+	TestEqual(TEXT("Messages wait for the other router to flush"), ServerB.GetNumberReceived(), 0);
+	TestEqual(TEXT("Messages are held until the other router has them"), Backend->GetBacklogNum(), 3);
+
+	//Connected after the messages were sent
+	FZoneServer ServerC;
+	ServerC.Router->SetBackend(Backend);
+
+	ServerB.Router->Flush();
+	ServerC.Router->Flush();
+
+	TestEqual(TEXT("The other router is handed the backlog on its flush"), ServerB.GetNumberReceived(), 3);
+	TestEqual(TEXT("A router that connects late is not handed earlier messages"), ServerC.GetNumberReceived(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOWSLocalChatAcknowledgementTest, "OWS.Chat.LocalBackend.Acknowledgement",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOWSLocalChatAcknowledgementTest::RunTest(const FString& Parameters)
+{
+	using namespace OWSChatRouterTests;
+
+	FZoneServer ServerA;
+	FZoneServer ServerB;
+	if (!TestNotNull(TEXT("Router A"), ServerA.Router) || !TestNotNull(TEXT("Router B"), ServerB.Router))
+	{
+		return false;
+	}
+
+	TSharedRef<FOWSLocalChatBackend> Backend = MakeShared<FOWSLocalChatBackend>();
+	ServerA.Router->SetBackend(Backend);
+	ServerB.Router->SetBackend(Backend);
+
+	ServerA.SendGlobalChat(2);
+	ServerA.Router->Flush();
+	ServerB.Router->Flush();
+
+	TestEqual(TEXT("Messages are handed over once"), ServerB.GetNumberReceived(), 2);
+	TestEqual(TEXT("Messages every router has acknowledged are dropped"), Backend->GetBacklogNum(), 0);
+
+	ServerB.Router->Flush();
+	TestEqual(TEXT("Acknowledged messages are not handed over again"), ServerB.GetNumberReceived(), 2);
+
+	//A router that leaves no longer holds messages back
+	ServerA.SendGlobalChat(1);
+	ServerA.Router->Flush();
+	TestEqual(TEXT("Unacknowledged messages are held"), Backend->GetBacklogNum(), 1);
+
+	ServerB.Router->SetBackend(nullptr);
+	TestEqual(TEXT("Messages only a disconnected router had not acknowledged are dropped"), Backend->GetBacklogNum(), 0);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
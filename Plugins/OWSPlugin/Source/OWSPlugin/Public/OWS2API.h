@@ -521,6 +521,31 @@ public:
 		FString MapName;
 };
 
+//Compact form of FUpdateAllPlayerPositionsJSONPost.  Player i owns Locations[3i..3i+2] (X, Y, Z divided by LocationQuantization)
+//and Rotations[3i..3i+2] (Roll, Pitch, Yaw compressed to 0..65535 with FRotator::CompressAxisToShort).
+USTRUCT()
+struct FUpdateAllPlayerPositionsCompactJSONPost
+{
+	GENERATED_BODY()
+
+public:
+	FUpdateAllPlayerPositionsCompactJSONPost() {
+		LocationQuantization = 1.f;
+		MapName = "";
+	}
+
+	UPROPERTY()
+		TArray<FString> CharacterNames;
+	UPROPERTY()
+		TArray<int32> Locations;
+	UPROPERTY()
+		TArray<int32> Rotations;
+	UPROPERTY()
+		float LocationQuantization;
+	UPROPERTY()
+		FString MapName;
+};
+
 
 USTRUCT()
 struct FUpdateNumberOfPlayersJSONPost
@@ -531,12 +556,32 @@ public:
 	FUpdateNumberOfPlayersJSONPost() {
 		ZoneInstanceId = 0;
 		NumberOfConnectedPlayers = "";
+		AverageFrameTimeMs = 0.f;
+		P99FrameTimeMs = 0.f;
+		ReplicatedActors = 0;
+		OutgoingKBps = 0.f;
+		UsedMemoryMB = 0.f;
+		bSoftFull = false;
 	}
 
 	UPROPERTY()
 		int32 ZoneInstanceId;
 	UPROPERTY()
 		FString NumberOfConnectedPlayers;
+
+	//Load figures, see FOWSZoneServerLoad.  Backends that do not route by load ignore them.
+	UPROPERTY()
+		float AverageFrameTimeMs;
+	UPROPERTY()
+		float P99FrameTimeMs;
+	UPROPERTY()
+		int32 ReplicatedActors;
+	UPROPERTY()
+		float OutgoingKBps;
+	UPROPERTY()
+		float UsedMemoryMB;
+	UPROPERTY()
+		bool bSoftFull;
 };
 
 USTRUCT()
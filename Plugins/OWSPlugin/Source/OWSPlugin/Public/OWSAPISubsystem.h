@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "OWSPlugin.h"
 #include "OWS2API.h"
+#include "OWSEndpoints.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Runtime/Online/HTTP/Public/Http.h"
 #include "JsonObjectConverter.h"
@@ -58,15 +59,14 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Config")
 		float OWS2APIRequestTimeout;
 
-protected:
-	FHttpModule* Http;
-
 public:
 	//Get Global Data Item
 	UFUNCTION(BlueprintCallable, Category = "GlobalData")
 		void GetGlobalDataItem(FString GlobalDataKey);
 
 	void OnGetGlobalDataItemResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void OnGetGlobalDataItemCacheableResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString GlobalDataKey, uint32 FetchGeneration);
+	void HandleGetGlobalDataItemResponse(const FString& ResponseContent);
 
 	FNotifyGetGlobalDataItemDelegate OnNotifyGetGlobalDataItemDelegate;
 	FErrorGetGlobalDataItemDelegate OnErrorGetGlobalDataItemDelegate;
@@ -99,8 +99,7 @@ public:
 	FErrorLogoutDelegate OnErrorLogoutDelegate;
 
 protected:
-	void ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
-	void ProcessOWS2GETRequest(FString ApiModuleToCall, FString ApiToCall, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
+	void ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UOWSAPISubsystem::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
 	void GetJsonObjectFromResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CallingMethodName, FString& ErrorMsg, TSharedPtr<FJsonObject>& JsonObject);
 
 	template <typename T>
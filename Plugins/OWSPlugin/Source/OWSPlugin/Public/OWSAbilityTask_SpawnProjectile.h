@@ -66,6 +66,9 @@ class OWSPLUGIN_API UOWSAbilityTask_SpawnProjectile : public UAbilityTask
 
 	void GetAimTransform(FTransform& SpawnTransform);
 
+	//For abilities with UOWSGameplayAbility::bSimulateProjectilesInBatch
+	bool SpawnBatchedProjectile(UWorld* World);
+
 	virtual void Activate() override;
 
 protected:
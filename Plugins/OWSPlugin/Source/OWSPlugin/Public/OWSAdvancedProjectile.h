@@ -189,12 +189,56 @@ protected:
 	UPROPERTY()
 		bool bHasSpawnedFully;
 
+	/** Set on projectiles spawned by UOWSProjectilePool */
+	UPROPERTY(Replicated)
+		bool bPooled;
+
+	/** True while waiting in the pool.  Only the server writes it, replicated so clients put their copy away too. */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+		bool bInPool;
+
+	/** Bumped each time the server takes this projectile from its pool, so clients know to start their copy again */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+		uint8 PoolGeneration;
+
+	/** PoolGeneration this copy was last started for */
+	uint8 LocalPoolGeneration;
+
+	/** Set by DeactivateForPool, so a copy a client already put away is not put away again when the server's state arrives.
+	 *  This is the client's own "put away" state, bInPool is left to the server. */
+	bool bDeactivatedForPool;
+
+	UFUNCTION()
+		virtual void OnRep_PoolState();
+
+	/** Undoes ShutDown and puts the projectile back in the state it spawned in */
+	virtual void ResetForReuse();
+
+	/** Starts movement along the new rotation the way UProjectileMovementComponent does on spawn */
+	void RestartMovement();
+
+	/** Client side start of a replicated projectile: catch up to the server and take over the matching fake projectile */
+	void CatchupAndMatchFake(AOWSPlayerController* MyPlayer);
+
+	/** Looks for the fake projectile MyPlayer fired for this one and synchronizes with it */
+	void MatchFake(AOWSPlayerController* MyPlayer);
+
+	/** Called by UOWSProjectileCatchup once this projectile has caught up to the server */
+	void FinishCatchup(bool bMatchFake, bool bOnScreen);
+
+	/** Moves the fake projectile to this one, or ticks particle systems for e.g. SpawnPerUnit trails if there is none */
+	void SyncFakeOrTickParticles(bool bTickParticles);
+
+	friend class UOWSProjectilePool;
+	friend class UOWSProjectileCatchup;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
 	virtual void PostNetReceiveLocationAndRotation() override;
 	virtual void PostNetReceiveVelocity(const FVector& NewVelocity) override;
 	virtual void PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker) override;
+	virtual void LifeSpanExpired() override;
 
 public:	
 	// Called every frame
@@ -241,6 +285,30 @@ public:
 		FPredictionKey ProjectilePredictionKey;
 	*/
 
+	/** Lets UOWSProjectilePool recycle this class.  Turn off for projectiles with blueprint state OnTakenFromPool does not reset. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+		bool bCanBePooled;
+
+	/** Returns the projectile to its pool, or destroys it if it did not come from one */
+	UFUNCTION(BlueprintCallable, Category = Projectile)
+		void ReleaseProjectile();
+
+	bool IsPooled() const { return bPooled; }
+	bool IsInPool() const { return bInPool || bDeactivatedForPool; }
+
+	/** Called by UOWSProjectilePool when a pooled projectile is fired again */
+	virtual void ActivateFromPool(const FVector& Location, const FRotator& Rotation, APawn* InInstigator);
+
+	/** Called by UOWSProjectilePool when the projectile goes back in the pool.  Hides it and turns off collision, movement and effects. */
+	virtual void DeactivateForPool();
+
+	/** Blueprint hook for resetting state on a pooled projectile before it is fired again */
+	UFUNCTION(BlueprintImplementableEvent, Category = Projectile)
+		void OnTakenFromPool();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = Projectile)
+		void OnReturnedToPool();
+
 	/** Perform any custom initialization for this projectile as fake client side projectile */
 	virtual void InitFakeProjectile(class AOWSPlayerController* OwningPlayer);
 
@@ -38,6 +38,55 @@
 		PropertyName.SetCurrentValue(NewVal); \
 	}
 
+//Which connections UOWSAttributeSet sends its attributes to, set with OWSAttributeReplicationMode in the game ini
+UENUM(BlueprintType)
+enum class EOWSAttributeReplicationMode : uint8
+{
+	//Every attribute to every connection
+	Full,
+	//Health and mana to everyone, every other attribute to the owner only
+	RelevancySplit,
+	//Like RelevancySplit, but everyone except the owner gets health and mana rounded to whole points in QuantizedBars
+	Quantized
+};
+
+//Health and mana bars of a character as other players see them in EOWSAttributeReplicationMode::Quantized
+USTRUCT()
+struct FOWSQuantizedAttributeBars
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		int32 Health = 0;
+
+	UPROPERTY()
+		int32 MaxHealth = 0;
+
+	UPROPERTY()
+		int32 Mana = 0;
+
+	UPROPERTY()
+		int32 MaxMana = 0;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FOWSQuantizedAttributeBars& Other) const
+	{
+		return Health == Other.Health && MaxHealth == Other.MaxHealth && Mana == Other.Mana && MaxMana == Other.MaxMana;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FOWSQuantizedAttributeBars> : public TStructOpsTypeTraitsBase2<FOWSQuantizedAttributeBars>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
 /**
  * 
  */
@@ -1663,6 +1712,23 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AttributeTest", meta = (HideFromLevelInfos))		// You can't make a GameplayEffect 'powered' by Healing (Its transient)
 		FGameplayAttributeData	Healing;
 
+	/** Health and mana for everyone but the owner in EOWSAttributeReplicationMode::Quantized.  Push model, only marked dirty when a whole point changes. */
+	UPROPERTY(ReplicatedUsing = OnRep_QuantizedBars)
+		FOWSQuantizedAttributeBars QuantizedBars;
+
+	UFUNCTION()
+		void OnRep_QuantizedBars(const FOWSQuantizedAttributeBars& OldQuantizedBars);
+
+	/** Read once from OWSAttributeReplicationMode, only the server's setting matters */
+	static EOWSAttributeReplicationMode GetReplicationMode();
+
+	/** Server only, copies health and mana into QuantizedBars if a whole point changed */
+	void UpdateQuantizedBars();
+
 	virtual bool PreGameplayEffectExecute(struct FGameplayEffectModCallbackData &Data) override;
 	virtual void PostGameplayEffectExecute(const struct FGameplayEffectModCallbackData &Data) override;
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+
+private:
+	void SetQuantizedAttribute(const FGameplayAttribute& Attribute, FGameplayAttributeData& AttributeData, int32 NewValue);
 };
@@ -0,0 +1,177 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "GameplayEffectTypes.h"
+#include "Engine/NetSerialization.h"
+#include "WorldCollision.h"
+#include "OWSBatchedProjectileManager.generated.h"
+
+class AOWSAdvancedProjectile;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOWSBatchedProjectileEvent, int32, ProjectileID, TSubclassOf<AOWSAdvancedProjectile>, ProjectileClass, FVector, Location);
+
+//Sent to clients when the server fires a batched projectile
+USTRUCT()
+struct FOWSBatchedProjectileSpawn
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		int32 ProjectileID = INDEX_NONE;
+
+	UPROPERTY()
+		TSubclassOf<AOWSAdvancedProjectile> ProjectileClass;
+
+	UPROPERTY()
+		FVector_NetQuantize10 Location;
+
+	UPROPERTY()
+		FVector_NetQuantize10 Velocity;
+
+	//Server world time of the shot, clients move the projectile forward by the time it took to reach them
+	UPROPERTY()
+		float ServerSpawnTime = 0.f;
+};
+
+USTRUCT(BlueprintType)
+struct FOWSBatchedProjectileStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Spawned = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Impacts = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Expired = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Sweeps = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 PeakLive = 0;
+
+	//Time the last frame spent moving projectiles and resolving hits
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		float LastFrameMs = 0.f;
+};
+
+/**
+ * Simulates simple ballistic projectiles without an actor per shot.
+ *
+ * Projectiles are kept as parallel arrays and moved in one pass per frame, in parallel once there are ParallelThreshold or
+ * more.  On the server every projectile's movement this frame is swept as one batch of async sweeps, read back at the start
+ * of the next frame, so a hit lands at most one frame late.  Hits apply the same effects AOWSAdvancedProjectile does.
+ * Clients only receive the spawn and impact, through the instigating AOWSCharacterWithAbilities, and move the projectile in
+ * between for OnProjectileSpawned and OnProjectileImpact to draw.
+ *
+ * Flight parameters are read from the defaults of an AOWSAdvancedProjectile class: the projectile movement's speed and
+ * gravity scale, OverlapRadius, InitialLifeSpan and the explosion settings.  Abilities opt in with
+ * UOWSGameplayAbility::bSimulateProjectilesInBatch.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSBatchedProjectileManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//From this many live projectiles the move pass runs in parallel
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 ParallelThreshold = 256;
+
+	//Sweep with async traces read back next frame.  When false every projectile is swept right away.
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		bool bUseAsyncSweeps = true;
+
+	//For drawing the projectiles, not broadcast on a dedicated server
+	UPROPERTY(BlueprintAssignable, Category = "Projectiles")
+		FOWSBatchedProjectileEvent OnProjectileSpawned;
+
+	UPROPERTY(BlueprintAssignable, Category = "Projectiles")
+		FOWSBatchedProjectileEvent OnProjectileImpact;
+
+	//Server only.  Returns the new projectile's ID, or INDEX_NONE.
+	int32 SpawnProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator,
+		const FGameplayEffectSpecHandle& DamageEffect, const FGameplayEffectSpecHandle& AoEDamageEffect, const FGameplayTag& ActivateAbilityTagOnImpact);
+
+	//Called on clients from AOWSCharacterWithAbilities' multicasts
+	void ReceiveSpawn(const FOWSBatchedProjectileSpawn& Spawn, APawn* InInstigator);
+	void ReceiveImpact(int32 ProjectileID, const FVector& Location);
+
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+		bool GetProjectileLocation(int32 ProjectileID, FVector& OutLocation) const;
+
+	int32 GetNumberOfProjectiles() const { return IDs.Num(); }
+
+	const FOWSBatchedProjectileStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+	//Per class values read from the projectile class defaults
+	struct FDefinition
+	{
+		TSubclassOf<AOWSAdvancedProjectile> ProjectileClass;
+		float Speed = 0.f;
+		float MaxSpeed = 0.f;
+		float GravityScale = 1.f;
+		float Radius = 0.f;
+		float LifeSpan = 0.f;
+		float ExplosionDamageRadius = 0.f;
+		FGameplayTag ExplosionGameplayCueTag;
+		FGameplayTag ActivateAbilityTagOnImpact;
+	};
+
+	int32 FindOrAddDefinition(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass);
+	int32 AddProjectile(int32 ID, int32 Definition, const FVector& Location, const FVector& Velocity, APawn* InInstigator);
+	void RemoveProjectileAt(int32 Index);
+
+	void ResolvePendingSweeps(TArray<TPair<int32, FHitResult>>& OutImpacts);
+	void MoveProjectiles(float DeltaTime);
+	void StepProjectile(int32 Index, float DeltaTime, float GravityZ);
+	void SweepProjectiles(TArray<TPair<int32, FHitResult>>& OutImpacts);
+	bool PickImpact(const TArray<FHitResult>& Hits, FHitResult& OutHit) const;
+	void Impact(int32 Index, const FHitResult& Hit);
+
+	FCollisionQueryParams MakeQueryParams(int32 Index) const;
+
+	TArray<FDefinition> Definitions;
+	TMap<TObjectPtr<UClass>, int32> DefinitionIndexByClass;
+
+	//One entry per live projectile in each array
+	TArray<int32> IDs;
+	TArray<int32> DefinitionIndices;
+	TArray<FVector> Locations;
+	TArray<FVector> PreviousLocations;
+	TArray<FVector> Velocities;
+	TArray<float> LifeLeft;
+	TArray<TWeakObjectPtr<APawn>> Instigators;
+	TArray<FTraceHandle> PendingSweeps;
+
+	//Only set on the server
+	TArray<FGameplayEffectSpecHandle> DamageEffects;
+	TArray<FGameplayEffectSpecHandle> AoEDamageEffects;
+	TArray<FGameplayTag> ImpactAbilityTags;
+
+	TMap<int32, int32> IndexByID;
+	int32 NextProjectileID = 0;
+
+	FOWSBatchedProjectileStats Stats;
+};
@@ -345,6 +345,18 @@ private:
 protected:
 	FHttpModule* Http;
 
+	//Posts CurrentStats for PC's character.  With bSendOnlyChangedCharacterStats only CharName, CustomerGUID and the fields
+	//that differ from the last update are sent, and nothing is sent if no field changed.
+	void SendCharacterStats(AOWSPlayerController* PC, const FCharacterStats& CurrentStats);
+
+	//Stats as of the last update that was sent, the next update is diffed against them
+	FCharacterStats LastPersistedStats;
+	bool bHasPersistedStats = false;
+
+	//The write-behind cache gave up on unsaved stats, which may include some of the ones LastPersistedStats holds
+	void OnCharacterStatsDropped(const FString& CharName);
+	FDelegateHandle CharacterStatsDroppedHandle;
+
 public:
 	UPROPERTY(BlueprintReadWrite)
 		FString OWSAPICustomerKey;
@@ -376,6 +388,8 @@ public:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	// Called every frame
 	virtual void Tick( float DeltaSeconds ) override;
@@ -403,6 +417,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Stats")
 		void UpdateCharacterStatsBase();
 
+	//Only send the stats that changed since the last update.  Read from OWSPartialCharacterStatsUpdates, off by default because
+	//the backend has to leave the fields missing from an update as they are.
+	UPROPERTY(BlueprintReadWrite, Category = "Stats")
+		bool bSendOnlyChangedCharacterStats;
+
+	//The next stats update sends every field, used when an update may not have been saved
+	UFUNCTION(BlueprintCallable, Category = "Stats")
+		void ResetPersistedCharacterStats();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
 		bool bShouldAutoLoadCustomCharacterStats;
 
@@ -464,10 +487,12 @@ public:
 	UPROPERTY(Transient)
 		TArray<FInventoryItemStruct> LocalInventoryItems;
 
-	//UPROPERTY(Transient, ReplicatedUsing = OnRep_InventoriesToManage)
-	UPROPERTY(Transient)
+	//Replicated to the owner along with the inventories themselves, see ReplicateSubobjects
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_InventoriesToManage)
 		TArray<UOWSInventory*> InventoriesToManage;
 
+	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
+
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		UOWSInventory* CreateHUDInventory(FName InventoryName, int32 Size, int32 NumberOfColumns);
 
@@ -478,16 +503,21 @@ public:
 		void Client_AddItemToLocalInventoryItems(const FString& ItemName, const bool ItemCanStack, const bool IsUsable, const bool IsConsumedOnUse, const int32 ItemTypeID, 
 			const FString& TextureToUseForIcon, const int32 IconSlotWidth, const int32 IconSlotHeight, const int32 ItemMeshID, const FString& CustomData);
 
-	UFUNCTION(Client, Reliable)
-		void Client_CreateHUDInventory(FName InventoryName, int32 Size, int32 NumberOfColumns);
-
-	UFUNCTION(Client, Reliable)
-		void Client_AddItemToInventory(const FName& InventoryName, const FString& ItemName, const int32 StackSize, const int32 InSlotNumber, const int32 NumberOfUsesLeft, const int32 Condition,
-			const FString& PerInstanceCustomData, const FGuid UniqueItemGUID, const int32 ItemMeshID);
-
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		UOWSInventory* GetHUDInventoryFromName(FName InventoryName);
 
+	//Inventory moves asked for by the owning client, the result replicates back with the slots
+	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Inventory")
+		void Server_SwapSlots(FName InventoryName, int32 SlotA, int32 SlotB);
+
+	//Puts the stack onto a matching stack in ToSlot when there is room, otherwise swaps the two slots
+	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Inventory")
+		void Server_MoveStack(FName FromInventoryName, int32 FromSlot, FName ToInventoryName, int32 ToSlot);
+
+	//Moves the top item of the stack to the first empty slot it fits in
+	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Inventory")
+		void Server_SplitStack(FName InventoryName, int32 Slot);
+
 	FString SerializeInventory(FName InventoryName);
 
 	//Get Character Inventory
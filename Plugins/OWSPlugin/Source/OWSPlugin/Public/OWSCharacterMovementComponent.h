@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "OWSPlugin.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "WorldCollision.h"
 #include "OWSCharacterMovementComponent.generated.h"
 
 UENUM(BlueprintType)
@@ -153,10 +154,17 @@ public:
 
 	bool CheckForExitToClimbing(FVector CheckPoint, FVector& WallNormal);
 
+	//Sweep for the wall asynchronously while climbing and use the result a frame late.  Only characters whose moves no client
+	//predicts do this, such as AI on the server, everyone else sweeps on the spot.  Read from OWSAsyncClimbingChecks.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Climbing")
+		bool bUseAsyncClimbingChecks;
+
 	//Animation Distance Matching
+	//Calls with the same location and velocity in the same frame reuse the first prediction, unless Debug is set
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 		void PredictJumpApex(const FVector& CharacterLocation, FVector& outApexLocation, FVector& outLandLocation, float& outTimeToApex, bool Debug);
 
+	//Calls with the same inputs in the same frame reuse the first result, unless Debug is set
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 		FVector GetStoppingDistance(const FVector& CharacterLocation, float Local_WorldDeltaSecond, bool Debug);
 
@@ -167,4 +175,41 @@ protected:
 	void PhysCustomWalk(float deltaTime, int32 Iterations);
 	void OnMovementUpdated(float DeltaTime, const FVector& OldLocation, const FVector& OldVelocity);
 	void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations);
+
+	bool CanUseAsyncClimbingChecks() const;
+	//Result of the sweep started on an earlier frame, starts the next one
+	bool AsyncClimbingWallCheck(const FVector& Start, const FVector& End, ECollisionChannel CollisionChannel, const FCollisionShape& CapsuleShape,
+		const FCollisionQueryParams& CapsuleParams, const FCollisionResponseParams& ResponseParam);
+	void ResetClimbingWallCheck();
+
+private:
+	FTraceHandle ClimbingWallSweep;
+	uint64 ClimbingWallSweepFrame = 0;
+	bool bHasClimbingWallResult = false;
+	bool bClimbingWallHit = false;
+
+	struct FJumpApexPrediction
+	{
+		FVector CharacterLocation;
+		FVector Velocity;
+		FVector ApexLocation;
+		FVector LandLocation;
+		float TimeToApex = 0.f;
+		bool bLands = false;
+	};
+
+	struct FStoppingDistancePrediction
+	{
+		FVector CharacterLocation;
+		FVector Velocity;
+		float DeltaSeconds = 0.f;
+		FVector StopLocation;
+	};
+
+	//Predictions made this frame, cleared on the first call of a new frame
+	TArray<FJumpApexPrediction, TInlineAllocator<2>> JumpApexPredictions;
+	TArray<FStoppingDistancePrediction, TInlineAllocator<2>> StoppingDistancePredictions;
+	uint64 PredictionFrame = 0;
+
+	void BeginPredictionFrame();
 };
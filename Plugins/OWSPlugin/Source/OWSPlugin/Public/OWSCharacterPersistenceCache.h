@@ -0,0 +1,187 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Runtime/Online/HTTP/Public/Http.h"
+#include "OWSTransportSubsystem.h"
+#include "OWSCharacterPersistenceCache.generated.h"
+
+USTRUCT(BlueprintType)
+struct FOWSPersistenceCacheStats
+{
+	GENERATED_BODY()
+
+public:
+	//Characters that currently have at least one unsaved write
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 DirtyCharacters = 0;
+
+	//Unsaved fields waiting for the next flush
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 PendingWrites = 0;
+
+	//Approximate size of the unsaved payloads
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int64 PendingBytes = 0;
+
+	//Largest PendingBytes seen since the stats were reset
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int64 PeakPendingBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 WritesQueued = 0;
+
+	//Writes that replaced an unsaved write to the same field and never needed their own request
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 WritesCoalesced = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 RequestsSent = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 RequestsFailed = 0;
+
+	//Writes given up on after MaxFlushAttempts failed requests
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int32 WritesDropped = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Persistence")
+		int64 BytesFlushed = 0;
+};
+
+//CharName whose unsaved stats were given up on
+DECLARE_MULTICAST_DELEGATE_OneParam(FOWSCharacterStatsDroppedDelegate, const FString&);
+
+/**
+ * Server side write-behind cache for character persistence.
+ *
+ * Stat, custom data and ability writes are recorded per character and field.  A write to a field that has not been
+ * saved yet replaces the older value, so a burst of edits costs one request per field.  Dirty characters are flushed
+ * on a timer, when the character logs out and when the game instance shuts down.  Only one request per field is in flight
+ * at a time, a newer value stays dirty until the backend has answered the one before it, so writes land in order.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSCharacterPersistenceCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//Seconds between timed flushes
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float FlushInterval = 5.f;
+
+	//Requests sent per timed flush.  Anything left over stays dirty for the next flush, oldest characters go first.
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxWritesPerFlush = 256;
+
+	//A write that failed this many times is dropped instead of being put back for the next flush
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxFlushAttempts = 3;
+
+	//How long the final flush on shutdown waits for the backend before giving up
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float FinalFlushTimeout = 10.f;
+
+	//JSONString is a serialized FUpdateCharacterStatsJSONPost, or the part of one that changed.  Its fields replace the same
+	//fields of any unsaved stats for CharName.
+	void QueueCharacterStats(const FString& CharName, const FString& JSONString);
+	void QueueCustomCharacterData(const FString& CharName, const FString& CustomFieldName, const FString& CustomValue);
+	//An unsaved add followed by an update is still sent as an add, with the newest level and custom JSON
+	void QueueAbility(const FString& CharName, const FString& AbilityName, int32 AbilityLevel, const FString& CustomJSON, bool bAddAbility);
+	//Forget an unsaved add or update, used before the ability is removed so a later flush does not bring it back
+	void DiscardAbility(const FString& CharName, const FString& AbilityName);
+
+	//Broadcast when a stats write is dropped, so characters that only send changed stats send all of them next time
+	FOWSCharacterStatsDroppedDelegate OnCharacterStatsDropped;
+
+	//Send everything dirty for CharName.  OnFlushed runs once none of the character's writes are in flight any more.
+	void FlushCharacter(const FString& CharName, FSimpleDelegate OnFlushed = FSimpleDelegate());
+
+	//Flush CharName and then post to Endpoint.  Used for logout and ability removal, which must not overtake the character's last writes.
+	//The request is sent even if whoever asked for it is gone by then.
+	void SendAfterFlush(const FString& CharName, const FOWSEndpoint& Endpoint, const FString& PostParameters, FOWSTransportRequestCompleteDelegate OnComplete);
+
+	//Send every dirty write now, ignoring MaxWritesPerFlush.  With bWaitForCompletion the HTTP manager is pumped until the
+	//writes complete or FinalFlushTimeout passes, which is what the shutdown paths use.
+	UFUNCTION(BlueprintCallable, Category = "Persistence")
+		void FlushAll(bool bWaitForCompletion = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Persistence")
+		bool HasPendingWrites(const FString& CharName) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Persistence")
+		FOWSPersistenceCacheStats GetStats() const { return Stats; }
+
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+protected:
+
+	enum class EPendingWriteType : uint8
+	{
+		Stats,
+		CustomData,
+		AddAbility,
+		UpdateAbility
+	};
+
+	struct FPendingWrite
+	{
+		EPendingWriteType Type = EPendingWriteType::Stats;
+		//Custom field name or ability name, empty for stats
+		FString Key;
+		//Stats JSON, custom field value or ability custom JSON
+		FString Value;
+		int32 AbilityLevel = 0;
+		int32 Attempts = 0;
+
+		int64 GetPayloadSize() const { return Key.Len() + Value.Len(); }
+	};
+
+	struct FDirtyCharacter
+	{
+		//Keyed by field, see GetFieldKey
+		TMap<FString, FPendingWrite> Writes;
+		double FirstDirtyTime = 0.0;
+	};
+
+	static FString GetFieldKey(EPendingWriteType Type, const FString& Key);
+	//Fields in NewerJSON win, nested objects are merged one level down
+	static FString MergeCharacterStats(const FString& OlderJSON, const FString& NewerJSON);
+
+	void QueueWrite(const FString& CharName, FPendingWrite&& Write);
+	//Returns the number of requests sent
+	int32 SendDirtyWrites(const FString& CharName, int32 MaxWrites);
+	void SendWrite(const FString& CharName, const FString& FieldKey, const FPendingWrite& Write);
+	void OnWriteResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CharName, FString FieldKey, FPendingWrite Write);
+	void OnCharacterWritesComplete(const FString& CharName);
+	void DropWrite(const FString& CharName, const FString& FieldKey, const FPendingWrite& Write);
+
+	void OnFlushTimer();
+	void EnsureFlushTimer();
+	void UpdatePendingStats(int64 BytesDelta, int32 WritesDelta);
+
+	TMap<FString, FDirtyCharacter> DirtyCharacters;
+
+	//Fields with a request sent by this cache that has not completed yet, per character
+	TMap<FString, TSet<FString>> InFlightFields;
+	int32 NumInFlight = 0;
+
+	//Set while FlushAll waits, writes held back behind an in flight request are then sent as soon as it completes
+	bool bWaitingForFinalFlush = false;
+
+	TMap<FString, TArray<FSimpleDelegate>> FlushWaiters;
+
+	FTimerHandle FlushTimerHandle;
+
+	FOWSPersistenceCacheStats Stats;
+};
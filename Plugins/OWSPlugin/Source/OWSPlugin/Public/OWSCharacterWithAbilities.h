@@ -7,6 +7,7 @@
 #include "OWSAttributeSet.h"
 //#include "OWSGameplayAbility.h"
 #include "GameplayEffectTypes.h"
+#include "OWSBatchedProjectileManager.h"
 #include "OWSCharacterWithAbilities.generated.h"
 
 class AOWSAdvancedProjectile;
@@ -57,6 +58,7 @@ public:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void PostInitializeComponents() override;
 
@@ -95,6 +97,16 @@ public:
 
 	void HandleProjectileDamage(AOWSAdvancedProjectile* Projectile, bool UseExplosionEffect);
 
+	//Server only, for hits from UOWSBatchedProjectileManager
+	void ApplyProjectileDamageEffect(const FGameplayEffectSpecHandle& DamageEffect);
+
+	//Batched projectiles have no actor to replicate, so their spawn and impact go through the character that fired them
+	UFUNCTION(NetMulticast, Unreliable)
+		void Multicast_BatchedProjectileSpawned(const FOWSBatchedProjectileSpawn& Spawn);
+
+	UFUNCTION(NetMulticast, Unreliable)
+		void Multicast_BatchedProjectileImpact(int32 ProjectileID, FVector_NetQuantize Location);
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "Init")
 		void OnOWSAttributeInitalizationComplete();
 
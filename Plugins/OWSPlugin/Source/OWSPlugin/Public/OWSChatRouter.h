@@ -0,0 +1,246 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Runtime/Online/HTTP/Public/Http.h"
+#include "OWSChatManager.h"
+#include "OWSChatRouter.generated.h"
+
+class UOWSChatRouter;
+
+USTRUCT(BlueprintType)
+struct FOWSChatRouterStats
+{
+	GENERATED_BODY()
+
+public:
+	//Messages handed to a player on this zone server
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 LocalDeliveries = 0;
+
+	//Private messages whose recipient was on this zone server, so the chat service never saw them
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 PrivateMessagesKeptLocal = 0;
+
+	//Messages queued for other zone servers
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 RemoteMessagesQueued = 0;
+
+	//Messages that arrived from other zone servers
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 RemoteMessagesReceived = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 Flushes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 RateLimited = 0;
+
+	//Remote messages dropped because no chat service is configured or the queue was full
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+		int32 RemoteMessagesDropped = 0;
+};
+
+//Body posted to OWSChatServiceURL on each flush
+USTRUCT()
+struct FOWSChatFlushRequest
+{
+	GENERATED_BODY()
+
+public:
+	//Messages sent by this server are not handed back to it
+	UPROPERTY()
+		FString ServerID;
+
+	//Highest ChatMessageID this server has already been given
+	UPROPERTY()
+		int32 LastMessageID = 0;
+
+	UPROPERTY()
+		TArray<FChatMessage> Messages;
+};
+
+//Other zone servers' messages since LastMessageID in the request
+USTRUCT()
+struct FOWSChatFlushResponse
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		int32 LastMessageID = 0;
+
+	UPROPERTY()
+		TArray<FChatMessage> Messages;
+};
+
+/**
+ * Carries chat between zone servers.  A router hands its backend everything queued since the previous flush, and the
+ * backend gives messages from other zone servers back through UOWSChatRouter::ReceiveRemoteMessages.
+ */
+class OWSPLUGIN_API IOWSChatBackend
+{
+public:
+	virtual ~IOWSChatBackend() {}
+
+	virtual void Connect(UOWSChatRouter* Router) {}
+	virtual void Disconnect(UOWSChatRouter* Router) {}
+
+	//Called every flush interval, with an empty array if nothing was queued so backends that poll can do so
+	virtual void Flush(UOWSChatRouter* Router, TArray<FChatMessage>&& Messages) = 0;
+};
+
+//Posts each flush as one FOWSChatFlushRequest and delivers the FOWSChatFlushResponse.  Only one post is in flight at a time.
+class OWSPLUGIN_API FOWSHttpChatBackend : public IOWSChatBackend, public TSharedFromThis<FOWSHttpChatBackend>
+{
+public:
+	FOWSHttpChatBackend(const FString& InURL, const FString& InCustomerKey);
+
+	virtual void Flush(UOWSChatRouter* Router, TArray<FChatMessage>&& Messages) override;
+
+private:
+	void OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TWeakObjectPtr<UOWSChatRouter> Router);
+
+	const FString URL;
+	const FString CustomerKey;
+	const FString ServerID;
+
+	//Messages waiting for the post in flight to finish, or sent again after it failed
+	TArray<FChatMessage> Outgoing;
+	int32 NumberInFlight = 0;
+	int32 LastMessageID = 0;
+	bool bInFlight = false;
+};
+
+/**
+ * Stands in for the chat service inside one process, so several PIE worlds or a test that creates more than one router
+ * exchange chat as separate zone servers would.  Like the service it keeps a backlog of messages and hands each router the
+ * ones from other routers since its last flush, which acknowledges them.  Messages every router has acknowledged are dropped.
+ */
+class OWSPLUGIN_API FOWSLocalChatBackend : public IOWSChatBackend
+{
+public:
+	static TSharedRef<FOWSLocalChatBackend> Get();
+
+	virtual void Connect(UOWSChatRouter* Router) override;
+	virtual void Disconnect(UOWSChatRouter* Router) override;
+	virtual void Flush(UOWSChatRouter* Router, TArray<FChatMessage>&& Messages) override;
+
+	//Messages some connected router has not been handed yet
+	int32 GetBacklogNum() const { return Backlog.Num(); }
+
+private:
+	struct FBacklogMessage
+	{
+		int32 MessageID = 0;
+		TWeakObjectPtr<UOWSChatRouter> Sender;
+		FChatMessage ChatMessage;
+	};
+
+	void TrimBacklog();
+
+	//Oldest first
+	TArray<FBacklogMessage> Backlog;
+	//Highest MessageID handed to each connected router
+	TMap<TWeakObjectPtr<UOWSChatRouter>, int32> AcknowledgedMessageIDs;
+	int32 LastMessageID = 0;
+};
+
+/**
+ * Routes chat on a zone server.
+ *
+ * Global and channel messages go straight to the players on this server that should see them, private messages go
+ * straight to their recipient when the recipient is here.  Anything that may have readers on other zone servers is queued
+ * and handed to the chat backend every FlushInterval seconds, so a busy channel costs one backend round trip per flush
+ * instead of one per line.  Players are limited to MessageBurst messages at once, refilled at MessagesPerSecond.
+ *
+ * The backend is FOWSHttpChatBackend when OWSChatServiceURL is set and FOWSLocalChatBackend when OWSUseLocalChatService is
+ * true.  Without either, chat stays on this server.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSChatRouter : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float MessagesPerSecond = 1.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MessageBurst = 5;
+
+	//Longer messages are cut to this many characters
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxMessageLength = 512;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float FlushInterval = 0.5f;
+
+	//Remote messages beyond this are dropped until the next flush
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxQueuedRemoteMessages = 1024;
+
+	//These return false if the sender is over their rate limit
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+		bool SendGlobalChat(const FString& SentFromCharacterName, const FString& Message);
+
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+		bool SendChatToChannel(const FString& SentFromCharacterName, const FString& Message, const FString& ChatChannelName);
+
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+		bool SendPrivateChatMessage(const FString& SentFromCharacterName, const FString& SendToCharacterName, const FString& Message);
+
+	//Channel membership is only known for characters on this zone server
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+		void JoinChannel(const FString& CharacterName, const FString& ChatChannelName);
+
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+		void LeaveChannel(const FString& CharacterName, const FString& ChatChannelName);
+
+	//Called when the character leaves this zone server
+	void RemoveCharacter(const FString& CharacterName);
+
+	//Called by the backend with messages sent on other zone servers
+	void ReceiveRemoteMessages(const TArray<FChatMessage>& Messages);
+
+	//Replaces the backend picked from config, e.g. with a FOWSLocalChatBackend in a test.  Null keeps chat on this server.
+	void SetBackend(TSharedPtr<IOWSChatBackend> InBackend);
+
+	void Flush();
+
+	const FOWSChatRouterStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+private:
+	bool PassesRateLimit(const FString& CharacterName);
+	FChatMessage MakeMessage(const FString& SentFromCharacterName, const FString& Message) const;
+	bool SendToChannelMembers(const FChatMessage& ChatMessage);
+	bool SendToCharacter(const FString& CharacterName, const FChatMessage& ChatMessage);
+	void SendToEveryone(const FChatMessage& ChatMessage);
+	void QueueRemote(const FChatMessage& ChatMessage);
+	void PruneRateLimits();
+
+	struct FRateLimit
+	{
+		float Tokens = 0.f;
+		double LastRefillTime = 0.0;
+	};
+
+	TMap<FString, FRateLimit> RateLimits;
+	TMap<FString, TSet<FString>> ChannelMembers;
+	TArray<FChatMessage> PendingRemoteMessages;
+	TSharedPtr<IOWSChatBackend> Backend;
+	FTimerHandle FlushTimerHandle;
+	FOWSChatRouterStats Stats;
+};
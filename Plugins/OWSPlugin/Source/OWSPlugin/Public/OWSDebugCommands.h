@@ -0,0 +1,83 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameModeBase.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+namespace OWSDebugCommands
+{
+	//The object a stats command runs on: a world subsystem, a game instance subsystem or the authority game mode
+	template <typename TargetType>
+	TargetType* FindTarget(UWorld* World)
+	{
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		if constexpr (TIsDerivedFrom<TargetType, UWorldSubsystem>::Value)
+		{
+			return World->GetSubsystem<TargetType>();
+		}
+		else if constexpr (TIsDerivedFrom<TargetType, UGameInstanceSubsystem>::Value)
+		{
+			UGameInstance* GameInstance = World->GetGameInstance();
+			return GameInstance ? GameInstance->GetSubsystem<TargetType>() : nullptr;
+		}
+		else
+		{
+			static_assert(TIsDerivedFrom<TargetType, AGameModeBase>::Value, "OWS stats commands run on subsystems or the game mode");
+			return World->GetAuthGameMode<TargetType>();
+		}
+	}
+}
+
+/**
+ * An OWS.<Area>.Stats console command.  Dumps the target's stats to the log, or clears them when passed reset.
+ *
+ * Any other argument goes to ExtraCommand, when there is one, before the stats are dumped.  The caches use it for clear and flush.
+ */
+template <typename TargetType, void (TargetType::*DumpStatsFunc)(FOutputDevice&) const = &TargetType::DumpStats, void (TargetType::*ResetStatsFunc)() = &TargetType::ResetStats>
+class TOWSStatsConsoleCommand
+{
+public:
+	typedef TFunction<void(TargetType&, const FString&)> FExtraCommand;
+
+	TOWSStatsConsoleCommand(const TCHAR* Name, const TCHAR* Help, FExtraCommand ExtraCommand = nullptr)
+		: Command(Name, Help, FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+			[ExtraCommand = MoveTemp(ExtraCommand)](const TArray<FString>& Args, UWorld* World)
+			{
+				TargetType* Target = OWSDebugCommands::FindTarget<TargetType>(World);
+
+				if (!Target)
+				{
+					return;
+				}
+
+				if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+				{
+					(Target->*ResetStatsFunc)();
+					return;
+				}
+
+				if (Args.Num() > 0 && ExtraCommand)
+				{
+					ExtraCommand(*Target, Args[0]);
+				}
+
+				(Target->*DumpStatsFunc)(*GLog);
+			}),
+			ECVF_Default)
+	{
+	}
+
+private:
+	FAutoConsoleCommandWithWorldAndArgs Command;
+};
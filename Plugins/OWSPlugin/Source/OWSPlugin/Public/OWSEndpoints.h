@@ -0,0 +1,183 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "OWS2API.h"
+#include "JsonObjectConverter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+//The OWS 2 services.  Each one has its own base path in DefaultGame.ini.
+enum class EOWSApiModule : uint8
+{
+	PublicAPI,
+	InstanceManagementAPI,
+	CharacterPersistenceAPI,
+	GlobalDataAPI,
+	MAX
+};
+
+OWSPLUGIN_API const TCHAR* LexToString(EOWSApiModule Module);
+
+/**
+ * One OWS 2 API endpoint.
+ *
+ * Endpoints are declared once in OWSEndpoints.cpp and register themselves during static init, which gives each one a
+ * dense Index.  UOWSTransportSubsystem composes every endpoint's URL once at Initialize and keeps its stats by Index, so
+ * sending a request does no string building or module lookups.
+ */
+struct OWSPLUGIN_API FOWSEndpoint
+{
+	FOWSEndpoint(EOWSApiModule InModule, const TCHAR* InPath, const TCHAR* InVerb, bool bInIdempotent);
+	UE_NONCOPYABLE(FOWSEndpoint);
+
+	const EOWSApiModule Module;
+
+	//Relative to the module's base path, e.g. api/Characters/GetByName
+	const TCHAR* const Path;
+
+	const TCHAR* const Verb;
+
+	//Idempotent requests are de-duplicated against identical requests in flight and retried on failure
+	const bool bIdempotent;
+
+	const int32 Index;
+
+	//Module:Path, used in logs and stats
+	const FString Name;
+
+	static const TArray<const FOWSEndpoint*>& GetAll();
+};
+
+namespace OWSEndpoints
+{
+	namespace Private
+	{
+		//Request bodies are USTRUCTs, except for the few endpoints whose JSON is built by hand
+		template <typename StructType>
+		bool SerializeBody(const StructType& Body, FString& OutContent)
+		{
+			return FJsonObjectConverter::UStructToJsonObjectString(Body, OutContent);
+		}
+
+		inline bool SerializeBody(const FString& Body, FString& OutContent)
+		{
+			OutContent = Body;
+			return true;
+		}
+
+		template <typename StructType>
+		bool DecodeBody(const FString& Content, StructType& OutBody)
+		{
+			return FJsonObjectConverter::JsonObjectStringToUStruct(Content, &OutBody, 0, 0);
+		}
+
+		//A malformed element is skipped with a warning instead of failing the whole list
+		template <typename StructType>
+		bool DecodeBody(const FString& Content, TArray<StructType>& OutBody)
+		{
+			TArray<TSharedPtr<FJsonValue>> JsonArray;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+			if (!FJsonSerializer::Deserialize(Reader, JsonArray))
+			{
+				return false;
+			}
+
+			OutBody.Reset(JsonArray.Num());
+			for (int32 Index = 0; Index < JsonArray.Num(); Index++)
+			{
+				const TSharedPtr<FJsonObject>* JsonObject = nullptr;
+				StructType Element;
+				if (!JsonArray[Index].IsValid() || !JsonArray[Index]->TryGetObject(JsonObject)
+					|| !FJsonObjectConverter::JsonObjectToUStruct(JsonObject->ToSharedRef(), &Element, 0, 0))
+				{
+					UE_LOG(OWS, Warning, TEXT("OWS - Skipping element %d of a %s list that could not be decoded"), Index, *StructType::StaticStruct()->GetName());
+					continue;
+				}
+
+				OutBody.Add(MoveTemp(Element));
+			}
+
+			return true;
+		}
+
+		inline bool DecodeBody(const FString& Content, TSharedPtr<FJsonObject>& OutBody)
+		{
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+			return FJsonSerializer::Deserialize(Reader, OutBody) && OutBody.IsValid();
+		}
+	}
+}
+
+/**
+ * An endpoint together with the types it is called with.  RequestType is the body that is posted (FString for hand built
+ * JSON) and ResponseType is what the body that comes back decodes to (TSharedPtr<FJsonObject> when the handler reads
+ * fields directly).  Serializing the wrong struct for an endpoint, or decoding its response into the wrong type, does
+ * not compile.
+ */
+template <typename InRequestType, typename InResponseType>
+struct TOWSEndpoint : public FOWSEndpoint
+{
+	using RequestType = InRequestType;
+	using ResponseType = InResponseType;
+
+	using FOWSEndpoint::FOWSEndpoint;
+
+	bool SerializeRequest(const RequestType& Request, FString& OutContent) const
+	{
+		return OWSEndpoints::Private::SerializeBody(Request, OutContent);
+	}
+
+	//Safe to call off the game thread
+	static bool DecodeResponse(const FString& Content, ResponseType& OutResponse)
+	{
+		return OWSEndpoints::Private::DecodeBody(Content, OutResponse);
+	}
+};
+
+//Every endpoint the plugin calls
+namespace OWSEndpoints
+{
+	//PublicAPI
+	extern OWSPLUGIN_API const TOWSEndpoint<FLoginAndCreateSessionJSONPost, FLoginAndCreateSession> LoginAndCreateSession;
+	extern OWSPLUGIN_API const TOWSEndpoint<FLogout, FSuccessAndErrorMessage> Logout;
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetAllCharactersJSONPost, TArray<FUserCharacter>> GetAllCharacters;
+	extern OWSPLUGIN_API const TOWSEndpoint<FSetSelectedCharacterAndConnectToLastZoneJSONPost, TSharedPtr<FJsonObject>> SetSelectedCharacterAndGetUserSession;
+	extern OWSPLUGIN_API const TOWSEndpoint<FTravelToLastZoneServerJSONPost, TSharedPtr<FJsonObject>> GetServerToConnectTo;
+	extern OWSPLUGIN_API const TOWSEndpoint<FCreateCharacterJSONPost, FCreateCharacter> CreateCharacter;
+	extern OWSPLUGIN_API const TOWSEndpoint<FCreateCharacterUsingDefaultCharacterValues, FSuccessAndErrorMessage> CreateCharacterUsingDefaultCharacterValues;
+	extern OWSPLUGIN_API const TOWSEndpoint<FRemoveCharacterJSONPost, FSuccessAndErrorMessage> RemoveCharacter;
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetPlayerGroupsCharacterIsInJSONPost, TSharedPtr<FJsonObject>> GetPlayerGroupsCharacterIsIn;
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetCharacterDataAndCustomData, TSharedPtr<FJsonObject>> GetCharacterDataAndCustomData;
+
+	//CharacterPersistenceAPI
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetCharacterStatsJSONPost, TSharedPtr<FJsonObject>> GetCharacterStats;
+	//The body is a serialized FUpdateCharacterStatsJSONPost built by the character
+	extern OWSPLUGIN_API const TOWSEndpoint<FString, FSuccessAndErrorMessage> UpdateCharacterStats;
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetCustomCharacterDataJSONPost, TSharedPtr<FJsonObject>> GetCustomCharacterData;
+	extern OWSPLUGIN_API const TOWSEndpoint<FAddOrUpdateCustomCharacterDataJSONPost, FSuccessAndErrorMessage> AddOrUpdateCustomCharacterData;
+	extern OWSPLUGIN_API const TOWSEndpoint<FCharacterNameJSONPost, FSuccessAndErrorMessage> PlayerLogout;
+	extern OWSPLUGIN_API const TOWSEndpoint<FUpdateAllPlayerPositionsJSONPost, FSuccessAndErrorMessage> UpdateAllPlayerPositions;
+	extern OWSPLUGIN_API const TOWSEndpoint<FUpdateAllPlayerPositionsCompactJSONPost, FSuccessAndErrorMessage> UpdateAllPlayerPositionsCompact;
+	extern OWSPLUGIN_API const TOWSEndpoint<FAddAbilityToCharacterJSONPost, FSuccessAndErrorMessage> AddAbilityToCharacter;
+	extern OWSPLUGIN_API const TOWSEndpoint<FUpdateAbilityOnCharacterJSONPost, FSuccessAndErrorMessage> UpdateAbilityOnCharacter;
+	extern OWSPLUGIN_API const TOWSEndpoint<FRemoveAbilityFromCharacterJSONPost, FSuccessAndErrorMessage> RemoveAbilityFromCharacter;
+	extern OWSPLUGIN_API const TOWSEndpoint<FCharacterNameJSONPost, TArray<FAbility>> GetCharacterAbilities;
+	extern OWSPLUGIN_API const TOWSEndpoint<FCharacterNameJSONPost, TArray<FAbilityBar>> GetAbilityBars;
+
+	//InstanceManagementAPI
+	extern OWSPLUGIN_API const TOWSEndpoint<FGetZoneInstancesForZoneJSONPost, TArray<FZoneInstance>> GetZoneInstancesForZone;
+	//The body is { "ZoneInstanceId": n }
+	extern OWSPLUGIN_API const TOWSEndpoint<FString, FGetServerInstanceFromPort> GetZoneInstance;
+	extern OWSPLUGIN_API const TOWSEndpoint<FUpdateNumberOfPlayersJSONPost, FSuccessAndErrorMessage> UpdateNumberOfPlayers;
+	extern OWSPLUGIN_API const TOWSEndpoint<FString, TSharedPtr<FJsonObject>> GetCurrentWorldTime;
+	extern OWSPLUGIN_API const TOWSEndpoint<FAddZoneJSONPost, FSuccessAndErrorMessage> AddZone;
+	extern OWSPLUGIN_API const TOWSEndpoint<FUpdateZoneJSONPost, FSuccessAndErrorMessage> UpdateZone;
+
+	//GlobalDataAPI
+	extern OWSPLUGIN_API const TOWSEndpoint<FGlobalDataItem, FSuccessAndErrorMessage> AddOrUpdateGlobalDataItem;
+	//GET, the global data key is appended to the path
+	extern OWSPLUGIN_API const TOWSEndpoint<FString, FGlobalDataItem> GetGlobalDataItem;
+}
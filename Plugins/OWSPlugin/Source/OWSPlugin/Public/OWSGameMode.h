@@ -4,9 +4,11 @@
 
 #include "GameFramework/GameMode.h"
 #include "OWS2API.h"
+#include "OWSEndpoints.h"
 #include "OWSGameModeComponent.h"
 #include "OWSCharacter.h"
 #include "OWSPlayerController.h"
+#include "OWSServerLoadSampler.h"
 #include "OWSGameMode.generated.h"
 
 USTRUCT(BlueprintType)
@@ -93,6 +95,38 @@ public:
 };
 
 
+USTRUCT(BlueprintType)
+struct FOWSLocationSaveStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		int32 Flushes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		int32 PlayersSaved = 0;
+
+	//Players that had unsaved movement but did not fit under MaxLocationSaveBytesPerFlush
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		int32 PlayersDeferred = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		int32 BytesSent = 0;
+
+	//Longest any current player's movement had gone unsaved at the last save, and who it was
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		float WorstUnsavedSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		FString WorstUnsavedCharacterName;
+
+	//Highest WorstUnsavedSeconds seen since the stats were reset
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+		float PeakUnsavedSeconds = 0.f;
+};
+
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FItemLibraryLoadedSignature);
 /**
  * 
@@ -106,8 +140,59 @@ protected:
 
 	FHttpModule* Http;
 
-	//Used to keep track of the batch for SaveAllPlayerLocations
-	int NextSaveGroupIndex = -1;
+	struct FPendingLocationSave
+	{
+		TWeakObjectPtr<AOWSPlayerController> PlayerController;
+		FString CharacterName;
+		FVector Location;
+		FRotator Rotation;
+	};
+
+	struct FLocationSaveCandidate
+	{
+		AOWSPlayerController* PlayerController;
+		float Priority;
+		int32 EstimatedBytes;
+	};
+
+	//Location saves sent to the persistence API and waiting for a response, by batch
+	TMap<int32, TArray<FPendingLocationSave>> LocationSavesInFlight;
+	int32 NextLocationSaveBatchID = 0;
+
+	FOWSLocationSaveStats LocationSaveStats;
+
+	//Online player registry.  CharactersOnline holds the entries, this maps each character name to its slot in it.
+	struct FOnlinePlayerEntry
+	{
+		int32 Index;
+		TWeakObjectPtr<AOWSPlayerController> PlayerController;
+	};
+
+	FOWSServerLoadSampler ServerLoadSampler;
+	FOWSZoneServerLoad LastServerLoad;
+
+	bool IsSoftFull(const FOWSZoneServerLoad& Load) const;
+
+	TMap<FString, FOnlinePlayerEntry> OnlinePlayersByName;
+	FTimerHandle OnlinePlayersSyncTimerHandle;
+
+	//Rebuilds OnlinePlayersByName after CharactersOnline was replaced, keeping the known player controllers
+	void ReindexCharactersOnline();
+	//Reindexes first if CharactersOnline no longer matches the index
+	FOnlinePlayerEntry* FindOnlinePlayerEntry(const FString& CharacterName);
+	void AddCharacterOnline(AOWSPlayerController* PlayerController);
+	void RemoveCharacterOnline(AOWSPlayerController* PlayerController);
+	//Reports the new player count to the backend shortly after logins and logouts instead of waiting for the next status update
+	void ScheduleOnlinePlayersSync();
+
+	bool HasMovedSinceLastSave(const AOWSPlayerController* PlayerController) const;
+	float GetLocationSavePriority(const AOWSPlayerController* PlayerController, double Now) const;
+	int32 EstimateLocationSaveBytes(const FString& CharacterName) const;
+	static FPendingLocationSave MakePendingLocationSave(AOWSPlayerController* PlayerController);
+	//Builds the compact or delimited payload for Batch and sends it
+	void SaveLocations(TArray<FPendingLocationSave>&& Batch);
+	void SendLocationSaveBatch(const FOWSEndpoint& Endpoint, const FString& PostParameters, TArray<FPendingLocationSave>&& Batch);
+	void OnLocationSaveBatchResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, int32 BatchID);
 
 	FString InitNewPlayer(APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal);	
 
@@ -119,6 +204,9 @@ public:
 //		UOWSGameModeComponent* OWSGameModeComponent;
 
 	virtual void StartPlay();
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PostLogin(APlayerController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
 
 	APawn * SpawnDefaultPawnFor_Implementation(AController * NewPlayer, class AActor * StartSpot);
 
@@ -143,18 +231,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		FInventoryItemStruct& FindItemDefinition(FString ItemName);
 	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+	//Characters connected to this zone server, kept up to date by PostLogin and Logout.  Blueprints that set it go through
+	//SetCharactersOnline.  Use IsPlayerOnline or FindCharacterOnline to look one up.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetCharactersOnline, Category = "Zones")
 		TArray<FCharactersOnlineStruct> CharactersOnline;
 
+	//Replaces CharactersOnline and rebuilds the name index, a character listed twice is kept once
+	UFUNCTION(BlueprintSetter)
+		void SetCharactersOnline(const TArray<FCharactersOnlineStruct>& InCharactersOnline);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
 		FString IAmZoneName;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
 		int32 ZoneInstanceID;
 
+	//No longer used, CharactersOnline is maintained from logins and logouts instead of being reloaded on a timer
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character")
 		float GetCharactersOnlineIntervalInSeconds = 10.f;
 
+	//Delay before a login or logout is reported to the backend, so a burst of them is sent as one update.  < 0 disables it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float OnlinePlayersSyncDelayInSeconds = 1.f;
+
 	FTimerHandle OnGetAllCharactersOnlineTimerHandle;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
@@ -162,13 +261,66 @@ public:
 
 	FTimerHandle UpdateServerStatusEveryXSecondsTimerHandle;
 
+	//Send frame time, replication, bandwidth and memory figures with every UpdateNumberOfPlayers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		bool bReportServerLoad = true;
+
+	//The server reports itself soft-full once any of these is exceeded, so the instance manager can send new players
+	//elsewhere before the server is full by head count.  0 disables a threshold.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float SoftFullP99FrameTimeMs = 50.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float SoftFullAverageFrameTimeMs = 25.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float SoftFullOutgoingKBps = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float SoftFullMemoryMB = 0.f;
+
+	//Once soft-full, the server only clears it when every figure is back under this fraction of its threshold
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Zones")
+		float SoftFullRecoveryFraction = 0.8f;
+
+	UFUNCTION(BlueprintCallable, Category = "Zones")
+		FOWSZoneServerLoad GetLastServerLoad() const { return LastServerLoad; }
+
 	//SaveAllPlayerLocations Batch Saving Process
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
 		float SaveIntervalInSeconds;
 
+	//No longer used.  Each save picks players by priority up to MaxLocationSaveBytesPerFlush instead of a fixed group.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
 		int SplitSaveIntoHowManyGroups;
 
+	//Players are saved in order of SaveDistanceWeight * cm moved + SaveAgeWeight * seconds their movement has gone unsaved,
+	//players that are logging out go first.  Each save sends at most about MaxLocationSaveBytesPerFlush bytes, the rest
+	//wait for the next one with a higher priority.  0 means no limit.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		int32 MaxLocationSaveBytesPerFlush = 16384;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		float SaveDistanceWeight = 0.01f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		float SaveAgeWeight = 1.f;
+
+	//Players who have not moved or turned more than these thresholds since their last acknowledged save are skipped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		float SaveLocationThreshold = 10.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		float SaveRotationThreshold = 5.f;
+
+	//Send quantized numeric arrays to UpdateAllPlayerPositionsCompact instead of the delimited string to UpdateAllPlayerPositions
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		bool bUseCompactLocationSave = false;
+
+	//Size in cm of one quantization step for the compact location save
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
+		float LocationSaveQuantization = 1.f;
+
 	FTimerHandle SaveAllPlayerLocationsTimerHandle;
 
 
@@ -252,6 +404,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Character")
 		void SaveAllPlayerLocations();
 
+	UFUNCTION(BlueprintCallable, Category = "Save")
+		FOWSLocationSaveStats GetLocationSaveStats() const { return LocationSaveStats; }
+
+	void DumpLocationSaveStats(FOutputDevice& Ar) const;
+	void ResetLocationSaveStats();
+
 	void OnSaveAllPlayerLocationsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
 
 	//Get all players online
@@ -267,7 +425,11 @@ public:
 
 	//Is player online
 	UFUNCTION(BlueprintCallable, Category = "Character")
-		bool IsPlayerOnline(FString CharacterName);
+		bool IsPlayerOnline(const FString& CharacterName) const;
+
+	//Null if the character is not connected to this zone server
+	const FCharactersOnlineStruct* FindCharacterOnline(const FString& CharacterName) const;
+	AOWSPlayerController* FindOnlinePlayerController(const FString& CharacterName) const;
 
 	//Get all running zone instances for a Zone
 	UFUNCTION(BlueprintCallable, Category = "Zones")
@@ -340,7 +502,7 @@ public:
 	void InitializeOWSAPISubsystemOnGameMode();
 	AOWSPlayerController* GetPlayerControllerFromCharacterName(const FString CharacterName);
 
-	void ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (AOWSGameMode::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
+	void ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (AOWSGameMode::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
 
 protected:
 	void BroadcastItemLibraryLoaded()
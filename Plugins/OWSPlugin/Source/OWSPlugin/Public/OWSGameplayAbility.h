@@ -16,6 +16,19 @@ UCLASS()
 class OWSPLUGIN_API UOWSGameplayAbility : public UGameplayAbility
 {
 	GENERATED_BODY()
+
+public:
+
+	//Projectiles this ability fires and how many of each to have waiting in the projectile pool once it is granted
+	UPROPERTY(EditDefaultsOnly, Category = "Ability|OWS")
+		TMap<TSubclassOf<AOWSAdvancedProjectile>, int32> ProjectilePoolWarmUp;
+
+	//Fire projectiles through UOWSBatchedProjectileManager instead of spawning an actor per shot.  Only for projectiles
+	//that just fly and hit, since the projectile actor and its blueprint logic never exist.
+	UPROPERTY(EditDefaultsOnly, Category = "Ability|OWS")
+		bool bSimulateProjectilesInBatch = false;
+
+	virtual void OnGiveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	
 protected:
 
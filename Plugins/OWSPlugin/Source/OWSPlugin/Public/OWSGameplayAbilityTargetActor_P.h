@@ -23,6 +23,8 @@ class OWSPLUGIN_API AOWSGameplayAbilityTargetActor_P : public AGameplayAbilityTa
 
 	virtual void StartTargeting(UGameplayAbility* InAbility) override;
 
+	virtual void Tick(float DeltaSeconds) override;
+
 	/** Actor we intend to place. */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = true), Category = Targeting)
 		UClass* PlacedActorClass;		//Using a special class for replication purposes. (Not implemented yet)
@@ -50,4 +52,8 @@ class OWSPLUGIN_API AOWSGameplayAbilityTargetActor_P : public AGameplayAbilityTa
 	void ConfirmTargeting();
 	void BindToConfirmCancelInputs();
 	static bool ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection, FVector AbilityCenter, float AbilityRange, float MinimumTargetingDistance, FVector& ClippedPosition);
+
+protected:
+	//Set while Tick traces for the reticle, see UOWSTargetingQueries
+	bool bIsReticleTrace = false;
 };
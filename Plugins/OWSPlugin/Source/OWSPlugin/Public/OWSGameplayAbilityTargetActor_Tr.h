@@ -57,5 +57,8 @@ protected:
 	FGameplayAbilityTargetDataHandle MakeTargetData(const FHitResult& HitResult) const;
 
 	TWeakObjectPtr<AGameplayAbilityWorldReticle> ReticleActor;
+
+	//Set while Tick traces for the reticle, see UOWSTargetingQueries
+	bool bIsReticleTrace = false;
 };
 
@@ -6,14 +6,147 @@
 #include "UObject/NoExportTypes.h"
 #include "OWSInventoryItem.h"
 #include "OWSInventoryItemStack.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "OWSInventory.generated.h"
 
 class AOWSCharacter;
+class UOWSInventory;
 
 #define OWS_MAXNUMBEROFITEMSINSTACK 999
+//Each row of the occupancy bitmap is one uint64
+#define OWS_MAXNUMBEROFINVENTORYCOLUMNS 64
+
+//What every slot holding the same item shares, stored once per inventory
+USTRUCT()
+struct FOWSInventoryItemType
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		FString ItemName;
+
+	UPROPERTY()
+		UTexture2D* IconTexture = nullptr;
+
+	UPROPERTY()
+		int32 IconSlotWidth = 1;
+
+	UPROPERTY()
+		int32 IconSlotHeight = 1;
+
+	UPROPERTY()
+		int32 StackSize = 0;
+
+	UPROPERTY()
+		bool bCanStack = false;
+};
+
+//The contents of an inventory, one entry per slot in each array.  A slot holds a count of one item, so a stack is its top item times Counts.
+USTRUCT()
+struct OWSPLUGIN_API FOWSInventorySlots
+{
+	GENERATED_BODY()
+
+public:
+	//Index into UOWSInventory::ItemTypes, INDEX_NONE when the slot is empty
+	UPROPERTY()
+		TArray<int32> ItemTypes;
+
+	UPROPERTY()
+		TArray<int32> Counts;
+
+	UPROPERTY()
+		TArray<int32> Conditions;
+
+	UPROPERTY()
+		TArray<int32> NumberOfUsesLeft;
+
+	UPROPERTY()
+		TArray<FGuid> UniqueItemGUIDs;
+
+	UPROPERTY()
+		TArray<int32> ItemMeshIDs;
+
+	UPROPERTY()
+		TArray<FString> PerInstanceCustomData;
+
+	int32 Num() const { return Counts.Num(); }
+	bool IsValidIndex(int32 Slot) const { return Counts.IsValidIndex(Slot); }
+	bool IsFilled(int32 Slot) const { return Counts[Slot] > 0; }
+
+	void Init(int32 NumberOfSlots);
+	void Clear(int32 Slot);
+	void Swap(int32 SlotA, int32 SlotB);
+};
+
+//A filled slot as the owning client sees it
+USTRUCT()
+struct FOWSInventorySlotEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		int32 Slot = INDEX_NONE;
+
+	//Index into UOWSInventory::ItemTypes, which replicates alongside the slots
+	UPROPERTY()
+		int32 ItemType = INDEX_NONE;
+
+	UPROPERTY()
+		int32 Count = 0;
+
+	UPROPERTY()
+		int32 Condition = 0;
+
+	UPROPERTY()
+		int32 NumberOfUsesLeft = 0;
+
+	UPROPERTY()
+		FGuid UniqueItemGUID;
+
+	UPROPERTY()
+		int32 ItemMeshID = 0;
+
+	UPROPERTY()
+		FString PerInstanceCustomData;
+};
+
+//One entry per filled slot, so only slots that change are sent
+USTRUCT()
+struct FOWSInventorySlotList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FOWSInventorySlotEntry, FOWSInventorySlotList>(Entries, DeltaParms, *this);
+	}
+
+	UPROPERTY()
+		TArray<FOWSInventorySlotEntry> Entries;
+
+	UPROPERTY(NotReplicated)
+		UOWSInventory* OwningInventory = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FOWSInventorySlotList> : public TStructOpsTypeTraitsBase2<FOWSInventorySlotList>
+{
+	enum { WithNetDeltaSerializer = true };
+};
 
 /**
- * 
+ * Items are kept in FOWSInventorySlots.  UOWSInventoryItemStack and AOWSInventoryItem objects are only created for a slot when
+ * something asks for its stack, so filling the inventories of a server full of characters does not allocate an object per item.
+ * Inventories created by AOWSCharacter::CreateHUDInventory replicate to the owning client as subobjects of the character.  Only the
+ * server changes slots, the owning client asks for moves through AOWSCharacter::Server_SwapSlots, Server_MoveStack and Server_SplitStack.
  */
 UCLASS(Blueprintable, BlueprintType)
 class OWSPLUGIN_API UOWSInventory : public UObject
@@ -24,28 +157,38 @@ protected:
 	AOWSCharacter* OwningPlayerCharacter;
 
 public:
+	virtual bool IsSupportedForNetworking() const override { return true; }
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		void SetOwningPlayerCharacter(AOWSCharacter* inOwningPlayerCharacter);
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
+	//Stacks handed out by GetStackInSlot, nullptr for slots nobody has asked for yet.  Blueprints reading it go through
+	//GetInventoryItemStacks, which creates a stack for every slot first.
+	UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, BlueprintGetter = GetInventoryItemStacks, Category = "Inventory")
 		TArray<UOWSInventoryItemStack*> InventoryItemStacks;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
+	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Inventory")
 		FName InventoryName;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
 		int32 NumberOfGroupsUnlocked;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
 		int32 SlotsPerGroup;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UPROPERTY(ReplicatedUsing = OnRep_InventorySize, VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
 		int32 NumberOfSlots;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
+	UPROPERTY(ReplicatedUsing = OnRep_InventorySize, VisibleAnywhere, BlueprintReadWrite, Category = "Inventory")
 		int32 NumberOfColumns;
 
+	UFUNCTION()
+		void OnRep_InventorySize();
+
+	UFUNCTION()
+		void OnRep_ItemTypes();
+
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		void SetInventorySize(int32 Size, int32 inNumberOfColumns);
 
@@ -68,9 +211,12 @@ public:
 
 		void AddItemToSlot_Internal(AOWSInventoryItem* Item, int32 Slot);
 
+	//Fills the inventory from the rows in one pass
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		void AddItemsFromInventoryItemStruct(const TArray<FInventoryItemStruct>& ItemsToAdd);
 
+		void AddItemsFromInventoryItemStruct_Internal(const TArray<FInventoryItemStruct>& ItemsToAdd);
+
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		AOWSInventoryItem* RemoveOneItemFromSlot(int32 Slot);
 
@@ -80,9 +226,38 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		UOWSInventoryItemStack* GetStackInSlot(int32 Slot);
 
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+		TArray<UOWSInventoryItemStack*> GetAllStacks();
+
+	UFUNCTION(BlueprintGetter)
+		TArray<UOWSInventoryItemStack*> GetInventoryItemStacks() const;
+
+	//Reads the slot without creating its stack
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+		int32 GetItemCountInSlot(int32 Slot) const;
+
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+		FString GetItemNameInSlot(int32 Slot) const;
+
+	const FOWSInventorySlots& GetSlots() const { return Slots; }
+
+	//Called by a stack handed out by GetStackInSlot after it has been changed directly
+	void SyncSlotFromStack(UOWSInventoryItemStack* ItemStack);
+
+	//Called on clients as ReplicatedSlots changes
+	void ApplyReplicatedSlot(const FOWSInventorySlotEntry& Entry);
+	void ClearReplicatedSlot(const FOWSInventorySlotEntry& Entry);
+
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		int32 FindFirstEmptySlotToFitItemOfSize(int32 IconSlotWidth, int32 IconSlotHeight);
 
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+		bool CanFitItemOfSize(int32 IconSlotWidth, int32 IconSlotHeight);
+
+	//True when every cell the item would cover from Slot is free
+	UFUNCTION(BlueprintPure, Category = "Inventory")
+		bool CanFitItemOfSizeAtSlot(int32 Slot, int32 IconSlotWidth, int32 IconSlotHeight) const;
+
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 		int32 FindItemIndex(FString ItemName);
 
@@ -90,6 +265,50 @@ public:
 		bool IsSlotFilled(int32 SlotNumber);
 	
 protected:
-	void UpdateSlotsFilled();
-	TArray<bool> SlotsFilled;
+	//Cells covered by an item's icon footprint, one bit per column in each row.  Cells past NumberOfSlots in a partial last row are always set.
+	TArray<uint64> OccupiedRows;
+
+	//How many footprints cover each cell
+	TArray<uint8> CellCoverage;
+
+	//Footprint currently stamped into OccupiedRows for each slot, zero when the slot is empty
+	TArray<FIntPoint> StampedFootprints;
+
+	//FindFirstEmptySlotToFitItemOfSize results by item size, emptied whenever a footprint changes
+	TMap<FIntPoint, int32> FirstFitCache;
+
+	int32 GetNumberOfRows() const;
+	void RebuildOccupancy();
+	//Call after changing a slot
+	void SlotChanged(int32 Slot);
+	//Brings the bitmap in line with what is in the slot now
+	void UpdateSlotOccupancy(int32 Slot);
+	//False on the owning client, whose copy only ever changes through replication
+	bool HasSlotAuthority() const;
+	bool CanChangeSlots(const TCHAR* Caller) const;
+	bool IsReplicatingSlots() const;
+	void UpdateReplicatedSlot(int32 Slot);
+	void StampFootprint(int32 Slot, FIntPoint Footprint, int32 Delta);
+
+	UPROPERTY()
+		FOWSInventorySlots Slots;
+
+	//Only ever appended to, slots and ReplicatedSlots refer to entries by index
+	UPROPERTY(ReplicatedUsing = OnRep_ItemTypes)
+		TArray<FOWSInventoryItemType> ItemTypes;
+
+	//Server copy of the filled slots for the owning client, kept up to date by SlotChanged
+	UPROPERTY(Replicated)
+		FOWSInventorySlotList ReplicatedSlots;
+
+	TMap<FString, int32> ItemTypeIndexByName;
+
+	int32 FindOrAddItemType(const FString& ItemName, UTexture2D* IconTexture, int32 IconSlotWidth, int32 IconSlotHeight, int32 StackSize, bool bCanStack);
+	void WriteSlotFromItem(int32 Slot, const AOWSInventoryItem* Item, int32 Count);
+	void WriteSlotFromStack(int32 Slot, UOWSInventoryItemStack* ItemStack);
+	AOWSInventoryItem* MaterializeItem(int32 Slot) const;
+	void RefreshStack(int32 Slot);
+
+	//Sends the owning client the item definition the first time it sees the item, returns false without a game mode
+	bool ReplicateItemDefinition(const FString& ItemName);
 };
@@ -7,6 +7,8 @@
 #include "OWSInventoryItem.h"
 #include "OWSInventoryItemStack.generated.h"
 
+class UOWSInventory;
+
 /**
  * 
  */
@@ -24,6 +26,9 @@ public:
 
 	bool IsBeingDragged;
 
+	//Set while this stack is the one an inventory handed out for SlotNumber, changes are written back to it
+	TWeakObjectPtr<UOWSInventory> OwningInventory;
+
 	UFUNCTION(BlueprintCallable, Category = "InventoryStack")
 		void AddToStack(AOWSInventoryItem* InventoryItem);
 
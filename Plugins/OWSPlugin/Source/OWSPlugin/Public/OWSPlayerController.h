@@ -8,6 +8,7 @@
 //#include "OWSCharacterWithAbilities.h"
 #include "OWSPlayerState.h"
 #include "OWSPlayerControllerComponent.h"
+#include "OWSChatManager.h"
 #include "OWSPlayerController.generated.h"
 
 class AOWSCharacterWithAbilities;
@@ -57,6 +58,17 @@ public:
 	FVector LastCharacterLocation;
 	FRotator LastCharacterRotation;
 
+	//Last location and rotation the persistence API acknowledged for this player
+	FVector LastSavedCharacterLocation;
+	FRotator LastSavedCharacterRotation;
+	bool bHasSavedCharacterLocation = false;
+
+	//Kept by AOWSGameMode's location save scheduler.  UnsavedLocationSince is the time the player was first seen to have
+	//moved since its last acknowledged save, 0 while there is nothing to save.
+	double UnsavedLocationSince = 0.0;
+	bool bLocationSaveInFlight = false;
+	bool bPendingDisconnect = false;
+
 	UPROPERTY()
 		TMap<FString, int32> LocalMeshItemsMap;
 
@@ -185,6 +197,13 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Chat")
 		void ErrorGetChatGroupsForPlayer(const FString &ErrorMsg);
 
+	//Sent by UOWSChatRouter for each chat message this player should see
+	UFUNCTION(Client, Reliable)
+		void Client_ReceiveChatMessage(const FChatMessage& ChatMessage);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Chat")
+		void NotifyChatMessageReceived(const FChatMessage& ChatMessage);
+
 	//Is Player Online?
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 		void IsPlayerOnline(FString PlayerName);
@@ -7,6 +7,8 @@
 #include "Runtime/Online/HTTP/Public/Http.h"
 #include "OWSCharacter.h"
 #include "OWSPlayerState.h"
+#include "OWSResponseCache.h"
+#include "OWSEndpoints.h"
 #include "OWSPlayerControllerComponent.generated.h"
 
 
@@ -101,8 +103,6 @@ class OWSPLUGIN_API UOWSPlayerControllerComponent : public UActorComponent
 {
 	GENERATED_BODY()
 
-	FHttpModule* Http;
-
 public:	
 	// Sets default values for this component's properties
 	UOWSPlayerControllerComponent();
@@ -126,15 +126,25 @@ public:
 	//Travel to Last Zone Server
 		void TravelToLastZoneServer(FString CharacterName);
 		void OnTravelToLastZoneServerResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+		void HandleTravelToLastZoneServerResponse(bool bWasSuccessful, const FString& ResponseContent);
 
 	//Get Zone Server to Travel To
 	UFUNCTION(BlueprintCallable, Category = "Travel")
 		void GetZoneServerToTravelTo(FString CharacterName, TEnumAsByte<ERPGSchemeToChooseMap::SchemeToChooseMap> SelectedSchemeToChooseMap, int32 WorldServerID, FString ZoneName);
 
 	void OnGetZoneServerToTravelToResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleGetZoneServerToTravelToResponse(bool bWasSuccessful, const FString& ResponseContent);
 	FNotifyGetZoneServerToTravelToDelegate OnNotifyGetZoneServerToTravelToDelegate;
 	FErrorGetZoneServerToTravelToDelegate OnErrorGetZoneServerToTravelToDelegate;
 
+	//Prefetch Zone Server - Resolve the server GetZoneServerToTravelTo or TravelToLastZoneServer will need before travel
+	//is requested, so travel does not wait on the backend.  See UOWSZoneServerAssignmentCache.
+	UFUNCTION(BlueprintCallable, Category = "Travel")
+		void PrefetchZoneServerToTravelTo(FString CharacterName, FString ZoneName);
+
+	UFUNCTION(BlueprintCallable, Category = "Travel")
+		void PrefetchLastZoneServer(FString CharacterName);
+
 	//Save Player Location
 	UFUNCTION(BlueprintCallable, Category = "Save")
 		void SavePlayerLocation();
@@ -161,6 +171,7 @@ public:
 		void GetCharacterStats(FString CharName);
 
 	void OnGetCharacterStatsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleGetCharacterStatsResponse(const FString& ResponseContent);
 
 	FNotifyGetCharacterStatsDelegate OnNotifyGetCharacterStatsDelegate;
 	FErrorGetCharacterStatsDelegate OnErrorGetCharacterStatsDelegate;
@@ -188,6 +199,7 @@ public:
 		void GetCustomCharacterData(FString CharName);
 
 	void OnGetCustomCharacterDataResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleGetCustomCharacterDataResponse(const FString& ResponseContent);
 
 	FNotifyGetCustomCharacterDataDelegate OnNotifyGetCustomCharacterDataDelegate;
 	FErrorGetCustomCharacterDataDelegate OnErrorGetCustomCharacterDataDelegate;
@@ -230,6 +242,8 @@ public:
 		void GetCharacterAbilities(FString CharName);
 
 	void OnGetCharacterAbilitiesResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleGetCharacterAbilitiesResponse(const FString& ResponseContent);
+	void OnCharacterAbilitiesDecoded(bool bDecoded, TArray<FAbility>& Abilities);
 
 	FNotifyGetCharacterAbilitiesDelegate OnNotifyGetCharacterAbilitiesDelegate;
 	FErrorGetCharacterAbilitiesDelegate OnErrorGetCharacterAbilitiesDelegate;
@@ -239,6 +253,8 @@ public:
 		void GetAbilityBars(FString CharName);
 
 	void OnGetAbilityBarsResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleGetAbilityBarsResponse(const FString& ResponseContent);
+	void OnAbilityBarsDecoded(bool bDecoded, TArray<FAbilityBar>& AbilityBars);
 
 	FNotifyGetAbilityBarsDelegate OnNotifyGetAbilityBarsDelegate;
 	FErrorGetAbilityBarsDelegate OnErrorGetAbilityBarsDelegate;
@@ -311,6 +327,7 @@ public:
 	void LaunchZoneInstance(FString CharacterName, FString ZoneName, ERPGPlayerGroupType::PlayerGroupType GroupType);
 
 	void OnLaunchZoneInstanceResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+	void HandleLaunchZoneInstanceResponse(bool bWasSuccessful, const FString& ResponseContent);
 
 	FNotifyLaunchZoneInstanceDelegate OnNotifyLaunchZoneInstanceDelegate;
 	FErrorLaunchZoneInstanceDelegate OnErrorLaunchZoneInstanceDelegate;
@@ -331,8 +348,23 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-	void ProcessOWS2POSTRequest(FString ApiModuleToCall, FString ApiToCall, FString PostParameters, void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
+	void ProcessOWS2POSTRequest(const FOWSEndpoint& Endpoint, const FString& PostParameters, void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
 	void GetPlayerNameAndOWSCharacter(AOWSCharacter* OWSCharacter, FString& PlayerName);
+	class UOWSCharacterPersistenceCache* GetPersistenceCache() const;
+	UOWSResponseCache* GetResponseCache() const;
+	void InvalidateCachedResponse(EOWSCachedLookup Lookup, const FString& CharName);
+	class UOWSZoneServerAssignmentCache* GetZoneServerAssignmentCache() const;
+
+	static FTravelToLastZoneServerJSONPost MakeServerToConnectToRequest(const FString& CharacterName, const FString& ZoneName, int32 PlayerGroupType);
+
+	//All GetServerToConnectTo lookups go through UOWSZoneServerAssignmentCache, which answers from a prefetch when it has one
+	void ResolveServerToConnectTo(const FTravelToLastZoneServerJSONPost& ServerToConnectToJSONPost, void (UOWSPlayerControllerComponent::* InHandlerPtr)(bool bWasSuccessful, const FString& ResponseContent));
+
+	//Like ProcessOWS2POSTRequest for an idempotent lookup, but a successful response is also stored in UOWSResponseCache under Lookup and CacheKey
+	void ProcessCachedOWS2POSTRequest(EOWSCachedLookup Lookup, const FString& CacheKey, const FOWSEndpoint& Endpoint, const FString& PostParameters,
+		void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
+	void OnCacheableResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, EOWSCachedLookup Lookup, FString CacheKey, uint32 FetchGeneration,
+		void (UOWSPlayerControllerComponent::* InMethodPtr)(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful));
 	void GetJsonObjectFromResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString CallingMethodName, FString& ErrorMsg, TSharedPtr<FJsonObject>& JsonObject);
 
 	template <typename T>
@@ -361,6 +393,16 @@ protected:
 	UPROPERTY(BlueprintReadWrite)
 		float TravelTimeout = 60.f;
 
+	//On the server, stat, custom data and ability writes go through UOWSCharacterPersistenceCache instead of one request
+	//per call.  The notify delegates then fire once the write has been accepted by the cache.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+		bool bUseWriteBehindPersistence = true;
+
+	//Resolve the last zone server while SetSelectedCharacterAndConnectToLastZone is still setting up the session.  Off by default,
+	//since GetServerToConnectTo may start a zone instance the player never travels to.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+		bool bPrefetchZoneServerOnCharacterSelect = false;
+
 	FString ServerTravelUserSessionGUID;
 	FString ServerTravelCharacterName;
 	float ServerTravelX;
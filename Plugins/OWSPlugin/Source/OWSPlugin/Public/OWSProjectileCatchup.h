@@ -0,0 +1,119 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OWSProjectileCatchup.generated.h"
+
+class AOWSAdvancedProjectile;
+
+USTRUCT(BlueprintType)
+struct FOWSProjectileCatchupStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Requests = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Processed = 0;
+
+	//Projectiles that hit something, were pooled or destroyed before their turn
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Cancelled = 0;
+
+	//Times a projectile had to wait for the next frame because the frame's budget was used up
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Deferred = 0;
+
+	//Catch-ups cut down to MaxCatchupTime
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Clamped = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 SubSteps = 0;
+
+	//Particle ticks skipped for projectiles the local player could not see
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 CosmeticTicksSkipped = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 PeakQueued = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		float LastFrameMs = 0.f;
+};
+
+/**
+ * Moves replicated projectiles forward by the owning player's prediction time on clients.
+ *
+ * AOWSAdvancedProjectile queues itself here from BeginPlay, OnRep_PoolState and PostNetReceiveLocationAndRotation instead of
+ * ticking its movement by the whole prediction time on the spot.  Once a frame every queued projectile is caught up in
+ * sub-steps of at most SubStepTime, with each one capped at MaxCatchupTime and the whole frame capped at
+ * MaxCatchupTimePerFrame.  Projectiles beyond that wait for the next frame, at least one always runs.  Particle systems are
+ * only ticked afterwards for projectiles that are on screen.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSProjectileCatchup : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//No projectile is moved forward by more than this, whatever the ping
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float MaxCatchupTime = 0.4f;
+
+	//Total catch-up time simulated in one frame across all projectiles
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float MaxCatchupTimePerFrame = 2.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float SubStepTime = 1.f / 30.f;
+
+	//Queues Projectile to be caught up by CatchupTime this frame.  Returns false if World has no catch-up subsystem, in which
+	//case the caller has to catch up on its own.
+	static bool RequestCatchup(UWorld* World, AOWSAdvancedProjectile* Projectile, float CatchupTime, bool bMatchFake);
+
+	const FOWSProjectileCatchupStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+	struct FPendingCatchup
+	{
+		TWeakObjectPtr<AOWSAdvancedProjectile> Projectile;
+		float CatchupTime = 0.f;
+		uint8 PoolGeneration = 0;
+		bool bMatchFake = false;
+	};
+
+	void AddRequest(AOWSAdvancedProjectile* Projectile, float CatchupTime, bool bMatchFake);
+	bool IsStillPending(const FPendingCatchup& Entry) const;
+	void RunCatchup(AOWSAdvancedProjectile* Projectile, float CatchupTime);
+	void UpdateView();
+	bool IsOnScreen(const AOWSAdvancedProjectile* Projectile) const;
+
+	TArray<FPendingCatchup> Pending;
+
+	//Entries before this one are being run this frame, requests made meanwhile are queued after them
+	int32 FirstUnprocessed = 0;
+
+	//Local player's view, refreshed each frame there is something to catch up
+	FVector ViewLocation = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	float CosHalfFOV = 0.f;
+	bool bHasView = false;
+
+	FOWSProjectileCatchupStats Stats;
+};
@@ -0,0 +1,105 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "OWSProjectilePool.generated.h"
+
+class AOWSAdvancedProjectile;
+
+USTRUCT(BlueprintType)
+struct FOWSProjectilePoolStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Acquired = 0;
+
+	//Acquires served from the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Reused = 0;
+
+	//Acquires that found the pool empty and spawned a new actor
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Spawned = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Released = 0;
+
+	//Released projectiles destroyed because the pool was full
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 Discarded = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Projectiles")
+		int32 WarmedUp = 0;
+};
+
+USTRUCT()
+struct FOWSProjectilePoolBucket
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+		TArray<TObjectPtr<AOWSAdvancedProjectile>> Available;
+
+	UPROPERTY()
+		FOWSProjectilePoolStats Stats;
+};
+
+/**
+ * Recycles AOWSAdvancedProjectile actors per class so a shot does not cost a spawn and a destroy.
+ *
+ * On the server the pool holds the replicated projectiles, on clients it holds the fake projectiles fired ahead of the server.
+ * A released projectile is hidden, its collision and movement are turned off and it waits in the pool until the next shot of
+ * its class.  Server projectiles stay dormant while pooled, see AOWSAdvancedProjectile::ActivateFromPool.
+ *
+ * Pooling is on unless OWSUseProjectilePool is false, and classes can opt out with AOWSAdvancedProjectile::bCanBePooled.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSProjectilePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//Released projectiles beyond this many idle ones of a class are destroyed
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxPooledPerClass = 64;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		bool bUseProjectilePool = true;
+
+	//Uses World's pool when it has one and spawns the projectile otherwise
+	static AOWSAdvancedProjectile* SpawnProjectile(UWorld* World, TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator);
+
+	//Takes an idle projectile of ProjectileClass from the pool, or spawns one if there is none.  InInstigator is also the owner.
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+		AOWSAdvancedProjectile* AcquireProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator);
+
+	//Use AOWSAdvancedProjectile::ReleaseProjectile, which also handles projectiles that did not come from a pool
+	void ReleaseProjectile(AOWSAdvancedProjectile* Projectile);
+
+	//Spawns idle projectiles until Count of ProjectileClass are waiting in the pool
+	UFUNCTION(BlueprintCallable, Category = "Projectiles")
+		void WarmUp(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, int32 Count);
+
+	FOWSProjectilePoolStats GetStats(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass) const;
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+	bool CanPool(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass) const;
+	AOWSAdvancedProjectile* SpawnPooledProjectile(TSubclassOf<AOWSAdvancedProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* InInstigator, bool bWarmUp);
+
+	UPROPERTY()
+		TMap<TObjectPtr<UClass>, FOWSProjectilePoolBucket> Pools;
+};
@@ -0,0 +1,114 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AttributeSet.h"
+#include "OWSRegeneration.generated.h"
+
+class UOWSAttributeSet;
+
+USTRUCT(BlueprintType)
+struct FOWSRegenerationStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Regeneration")
+		int32 Registered = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Regeneration")
+		int32 BucketPasses = 0;
+
+	//Vitals written to their attribute set, each one replicates
+	UPROPERTY(BlueprintReadOnly, Category = "Regeneration")
+		int32 AttributeWrites = 0;
+
+	//Vitals that regenerated less than a whole point and were carried to the next pass instead of written
+	UPROPERTY(BlueprintReadOnly, Category = "Regeneration")
+		int32 WritesDeferred = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Regeneration")
+		float LastPassMs = 0.f;
+};
+
+/**
+ * Regenerates the vitals of every registered UOWSAttributeSet on the server, in place of a periodic gameplay effect per
+ * character.
+ *
+ * Health, Mana, Energy, Fatigue, Stamina and Endurance move by their RegenRate per second, clamped between zero and their
+ * Max attribute.  Attribute sets are spread over NumberOfBuckets buckets and one bucket is advanced every
+ * UpdateInterval / NumberOfBuckets seconds, so each set is updated once per UpdateInterval and the work is spread over the
+ * interval.  Regeneration is carried until the whole number a player sees changes, or the vital reaches zero or its max,
+ * so fractional rates do not write and replicate the attribute every pass.  Characters with no health left do not regenerate.
+ *
+ * Off unless OWSUseBatchedRegeneration is true, since games that regenerate with gameplay effects would regenerate twice.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSRegeneration : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		bool bUseBatchedRegeneration = false;
+
+	//Seconds between updates of one attribute set
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float UpdateInterval = 1.f;
+
+	//Only read on Initialize
+	UPROPERTY(BlueprintReadOnly, Category = "Config")
+		int32 NumberOfBuckets = 4;
+
+	//Server only.  Does nothing unless bUseBatchedRegeneration is set.
+	void RegisterAttributeSet(UOWSAttributeSet* AttributeSet);
+	void UnregisterAttributeSet(UOWSAttributeSet* AttributeSet);
+
+	const FOWSRegenerationStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+	//A vital with its max and regeneration rate
+	struct FVital
+	{
+		FGameplayAttribute Attribute;
+		FGameplayAttributeData UOWSAttributeSet::* Value;
+		FGameplayAttributeData UOWSAttributeSet::* Max;
+		FGameplayAttributeData UOWSAttributeSet::* RegenRate;
+	};
+
+	struct FBucket
+	{
+		TArray<TWeakObjectPtr<UOWSAttributeSet>> AttributeSets;
+
+		//Regeneration not written yet, Vitals.Num() entries per attribute set
+		TArray<float> Carry;
+
+		//World time each attribute set was last regenerated, starting from when it was registered
+		TArray<double> LastUpdateTimes;
+	};
+
+	void ProcessBucket(FBucket& Bucket);
+	void RemoveAt(FBucket& Bucket, int32 Index);
+
+	TArray<FVital> Vitals;
+	TArray<FBucket> Buckets;
+	TMap<TWeakObjectPtr<UOWSAttributeSet>, int32> BucketByAttributeSet;
+
+	int32 NextBucket = 0;
+	float TimeUntilNextBucket = 0.f;
+
+	FOWSRegenerationStats Stats;
+};
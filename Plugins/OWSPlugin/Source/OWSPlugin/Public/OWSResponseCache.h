@@ -0,0 +1,130 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "OWSResponseCache.generated.h"
+
+//Lookups whose responses can be served from UOWSResponseCache
+UENUM(BlueprintType)
+enum class EOWSCachedLookup : uint8
+{
+	CharacterStats,
+	CustomCharacterData,
+	CharacterAbilities,
+	AbilityBars,
+	GlobalDataItem,
+	MAX UMETA(Hidden)
+};
+
+USTRUCT(BlueprintType)
+struct FOWSResponseCacheStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Cache")
+		int32 Hits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Cache")
+		int32 Misses = 0;
+
+	//Misses caused by an entry that was present but past its TTL
+	UPROPERTY(BlueprintReadOnly, Category = "Cache")
+		int32 Expired = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Cache")
+		int32 Invalidations = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Cache")
+		int32 Entries = 0;
+};
+
+/**
+ * Per process read-through cache for OWS lookups that are requested far more often than they change.
+ *
+ * Raw response bodies are kept per lookup and key (character name or global data key) for a configurable TTL.  Writes
+ * made through this game instance invalidate the matching entry, and a response that was in flight while its lookup was
+ * invalidated is not cached.  Writes made by other servers are only picked up once the TTL runs out.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSResponseCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//Seconds a response stays valid.  A TTL <= 0 disables caching for that lookup.
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float CharacterStatsTTL = 30.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float CustomCharacterDataTTL = 30.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float CharacterAbilitiesTTL = 120.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float AbilityBarsTTL = 120.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float GlobalDataItemTTL = 300.f;
+
+	//Expired entries are purged once a lookup holds this many, beyond that new responses are not cached
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxEntriesPerLookup = 4096;
+
+	bool TryGet(EOWSCachedLookup Lookup, const FString& Key, FString& OutContent);
+
+	//Capture before sending the request and hand it back to Put, so a response that raced an invalidation is dropped
+	uint32 GetGeneration(EOWSCachedLookup Lookup) const;
+	void Put(EOWSCachedLookup Lookup, const FString& Key, const FString& Content, uint32 FetchGeneration);
+
+	UFUNCTION(BlueprintCallable, Category = "Cache")
+		void Invalidate(EOWSCachedLookup Lookup, const FString& Key);
+
+	//Drop everything cached for a character
+	UFUNCTION(BlueprintCallable, Category = "Cache")
+		void InvalidateCharacter(const FString& CharName);
+
+	UFUNCTION(BlueprintCallable, Category = "Cache")
+		void Clear();
+
+	UFUNCTION(BlueprintCallable, Category = "Cache")
+		FOWSResponseCacheStats GetStats(EOWSCachedLookup Lookup) const;
+
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+protected:
+
+	struct FCachedResponse
+	{
+		FString Content;
+		double ExpireTime = 0.0;
+	};
+
+	struct FLookupCache
+	{
+		TMap<FString, FCachedResponse> Entries;
+		//Bumped by every invalidation, a fetch captures it when it starts
+		uint32 Generation = 0;
+		//Generation of the latest invalidation of each key, so a write only drops fetches for its own key
+		TMap<FString, uint32> KeyGenerations;
+		//Fetches started before this may have raced an invalidation KeyGenerations no longer holds
+		uint32 OldestValidGeneration = 0;
+		FOWSResponseCacheStats Stats;
+	};
+
+	float GetTTL(EOWSCachedLookup Lookup) const;
+	void PurgeExpired(FLookupCache& LookupCache);
+
+	FLookupCache Lookups[(int32)EOWSCachedLookup::MAX];
+};
@@ -0,0 +1,98 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Async/Async.h"
+#include "Runtime/Online/HTTP/Public/Http.h"
+#include "JsonObjectConverter.h"
+#include "OWSEndpoints.h"
+
+//Responses smaller than this many bytes are decoded inline, the round trip through the task graph costs more than the parse
+extern OWSPLUGIN_API int32 GOWSAsyncDecodeThreshold;
+
+/**
+ * Decodes OWS responses on a worker thread and hands the finished result back on the game thread.
+ *
+ * Decode is called as bool(const FString& Content, ResultType& OutResult) off the game thread, so it may only touch its
+ * arguments: JSON parsing and USTRUCT conversion are fine, creating or loading UObjects is not.
+ * OnDecoded is called as void(bool bDecoded, ResultType& Result) on the game thread, and only if Owner is still alive.
+ */
+namespace OWSResponseDecoder
+{
+	template <typename ResultType, typename ContentSourceType, typename DecodeFuncType, typename CompleteFuncType>
+	void DecodeWithContentSource(const UObject* Owner, int64 ContentLength, ContentSourceType&& ContentSource, DecodeFuncType&& Decode, CompleteFuncType&& OnDecoded)
+	{
+		if (ContentLength < GOWSAsyncDecodeThreshold || !FPlatformProcess::SupportsMultithreading())
+		{
+			ResultType Result;
+			const bool bDecoded = Decode(ContentSource(), Result);
+			OnDecoded(bDecoded, Result);
+			return;
+		}
+
+		TWeakObjectPtr<const UObject> WeakOwner(Owner);
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+			[WeakOwner, ContentSource = Forward<ContentSourceType>(ContentSource), Decode = Forward<DecodeFuncType>(Decode), OnDecoded = Forward<CompleteFuncType>(OnDecoded)]() mutable
+		{
+			ResultType Result;
+			bool bDecoded = false;
+			{
+				SCOPED_NAMED_EVENT(OWS_DecodeResponse, FColor::Cyan);
+				bDecoded = Decode(ContentSource(), Result);
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakOwner, bDecoded, Result = MoveTemp(Result), OnDecoded = MoveTemp(OnDecoded)]() mutable
+			{
+				if (WeakOwner.IsValid())
+				{
+					OnDecoded(bDecoded, Result);
+				}
+			});
+		});
+	}
+
+	//Decode the body of an HTTP response.  The body is only converted to a string on the worker.
+	template <typename ResultType, typename DecodeFuncType, typename CompleteFuncType>
+	void DecodeAsync(const UObject* Owner, FHttpResponsePtr Response, DecodeFuncType&& Decode, CompleteFuncType&& OnDecoded)
+	{
+		if (!Response.IsValid())
+		{
+			ResultType Result;
+			OnDecoded(false, Result);
+			return;
+		}
+
+		DecodeWithContentSource<ResultType>(Owner, (int64)Response->GetContentLength(), [Response]() { return Response->GetContentAsString(); },
+			Forward<DecodeFuncType>(Decode), Forward<CompleteFuncType>(OnDecoded));
+	}
+
+	//Decode a response body that is already in memory, e.g. one served from UOWSResponseCache
+	template <typename ResultType, typename DecodeFuncType, typename CompleteFuncType>
+	void DecodeAsync(const UObject* Owner, const FString& Content, DecodeFuncType&& Decode, CompleteFuncType&& OnDecoded)
+	{
+		DecodeWithContentSource<ResultType>(Owner, (int64)Content.Len(), [Content]() { return Content; },
+			Forward<DecodeFuncType>(Decode), Forward<CompleteFuncType>(OnDecoded));
+	}
+
+	//Decode into the response type declared for Endpoint, OnDecoded has to accept that type or this does not compile
+	template <typename RequestType, typename ResponseType, typename CompleteFuncType>
+	void DecodeEndpointResponse(const UObject* Owner, const TOWSEndpoint<RequestType, ResponseType>& Endpoint, FHttpResponsePtr Response, CompleteFuncType&& OnDecoded)
+	{
+		DecodeAsync<ResponseType>(Owner, Response, &TOWSEndpoint<RequestType, ResponseType>::DecodeResponse, Forward<CompleteFuncType>(OnDecoded));
+	}
+
+	template <typename RequestType, typename ResponseType, typename CompleteFuncType>
+	void DecodeEndpointResponse(const UObject* Owner, const TOWSEndpoint<RequestType, ResponseType>& Endpoint, const FString& Content, CompleteFuncType&& OnDecoded)
+	{
+		DecodeAsync<ResponseType>(Owner, Content, &TOWSEndpoint<RequestType, ResponseType>::DecodeResponse, Forward<CompleteFuncType>(OnDecoded));
+	}
+
+	//Decode a JSON array of USTRUCTs, the shape most OWS list endpoints return.  Malformed elements are skipped.
+	template <typename StructType>
+	bool DecodeStructArray(const FString& Content, TArray<StructType>& OutStructs)
+	{
+		return OWSEndpoints::Private::DecodeBody(Content, OutStructs);
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Containers/Ticker.h"
+#include "OWSServerLoadSampler.generated.h"
+
+//Load of a zone server over one reporting window
+USTRUCT(BlueprintType)
+struct FOWSZoneServerLoad
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		int32 NumberOfConnectedPlayers = 0;
+
+	//Game thread time per frame, not counting the time spent waiting for the next tick under the server's max tick rate
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		float AverageFrameTimeMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		float P99FrameTimeMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		int32 FramesSampled = 0;
+
+	//Actors the net driver is actively considering for replication
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		int32 ReplicatedActors = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		float OutgoingKBps = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		float UsedMemoryMB = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Load")
+		bool bSoftFull = false;
+};
+
+/**
+ * Records the game thread cost of every frame and summarises it, together with net driver and memory figures, each time
+ * the zone server reports its status to the InstanceManagementAPI.
+ */
+class OWSPLUGIN_API FOWSServerLoadSampler
+{
+public:
+	~FOWSServerLoadSampler();
+
+	void Start();
+	void Stop();
+
+	//Summarises the frames recorded since the previous call and starts a new window.  bSoftFull is left for the caller.
+	FOWSZoneServerLoad TakeSample(const UWorld* World);
+
+private:
+	bool Tick(float DeltaTime);
+
+	//Bounds memory if nobody takes a sample, the oldest window is dropped
+	static constexpr int32 MaxFrameSamples = 8192;
+
+	TArray<float> FrameTimesMs;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,152 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+#include "OWSTargetingQueries.generated.h"
+
+class APawn;
+class APlayerController;
+
+USTRUCT(BlueprintType)
+struct FOWSTargetingQueryStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 TracesRequested = 0;
+
+	//Traces that went to the scene, the rest were answered from this frame's results
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 TracesRun = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 AsyncCameraTracesStarted = 0;
+
+	//Reticle camera traces answered with the async trace started the frame before
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 AsyncCameraTracesUsed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 Overlaps = 0;
+
+	//Overlap results for a pawn that was already in the results, one per extra component of the pawn
+	UPROPERTY(BlueprintReadOnly, Category = "Targeting")
+		int32 DuplicateOverlapsRemoved = 0;
+};
+
+/**
+ * Scene queries for the OWS targeting actors, shared across every targeting actor in the world.
+ *
+ * Line traces are kept for the rest of the frame, keyed by ray, profile and query params, so a targeting actor that traces
+ * from its tick and again on confirm, or several targeting actors aiming through the same camera, pay for one trace.
+ * Callers filter the shared hits themselves.  With OWSTargetingAsyncCameraTraces set, reticle ticks use the camera trace
+ * started for their player controller the frame before and start the next one as an async trace.  Confirming a target
+ * always traces on the spot.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSTargetingQueries : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		bool bUseAsyncCameraTraces = false;
+
+	//Multi hit line trace by profile.  With a CameraOwner the ray is that player's camera trace, which may come from the async
+	//trace started last frame.  The returned array is only valid until the next query.
+	const TArray<FHitResult>& LineTraceMulti(const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams& Params,
+		const APlayerController* CameraOwner = nullptr);
+
+	//Pawns overlapping a sphere, each pawn once however many of its components overlap
+	void OverlapPawns(const FVector& Origin, float Radius, const FCollisionQueryParams& Params, TArray<APawn*>& OutPawns);
+
+	//First hit that passes FilterHandle, treated as a blocking hit.  Works with both the engine's and the OWS filter handles.
+	template <typename FilterHandleType>
+	static void LineTraceWithFilter(FHitResult& OutHitResult, const UWorld* World, const FilterHandleType& FilterHandle, const FVector& Start, const FVector& End,
+		FName ProfileName, const FCollisionQueryParams& Params, const APlayerController* CameraOwner = nullptr)
+	{
+		check(World);
+
+		OutHitResult.TraceStart = Start;
+		OutHitResult.TraceEnd = End;
+
+		TArray<FHitResult> LocalHitResults;
+		const TArray<FHitResult>* HitResults = &LocalHitResults;
+
+		if (UOWSTargetingQueries* TargetingQueries = World->GetSubsystem<UOWSTargetingQueries>())
+		{
+			HitResults = &TargetingQueries->LineTraceMulti(Start, End, ProfileName, Params, CameraOwner);
+		}
+		else
+		{
+			World->LineTraceMultiByProfile(LocalHitResults, Start, End, ProfileName, Params);
+		}
+
+		for (const FHitResult& Hit : *HitResults)
+		{
+			if (!Hit.HitObjectHandle.IsValid() || FilterHandle.FilterPassesForActor(Hit.HitObjectHandle.FetchActor()))
+			{
+				OutHitResult = Hit;
+				OutHitResult.bBlockingHit = true; // treat it as a blocking hit
+				return;
+			}
+		}
+	}
+
+	const FOWSTargetingQueryStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+	struct FTraceKey
+	{
+		FVector Start;
+		FVector End;
+		FName ProfileName;
+		uint32 ParamsHash = 0;
+
+		bool operator==(const FTraceKey& Other) const
+		{
+			return Start == Other.Start && End == Other.End && ProfileName == Other.ProfileName && ParamsHash == Other.ParamsHash;
+		}
+
+		friend uint32 GetTypeHash(const FTraceKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Start), GetTypeHash(Key.End)), HashCombine(GetTypeHash(Key.ProfileName), Key.ParamsHash));
+		}
+	};
+
+	struct FAsyncCameraTrace
+	{
+		FTraceHandle Handle;
+		FName ProfileName;
+		uint32 ParamsHash = 0;
+		TArray<FHitResult> HitResults;
+		bool bHasHitResults = false;
+		uint64 LastRequestFrame = 0;
+	};
+
+	static uint32 HashParams(const FCollisionQueryParams& Params);
+
+	//Forgets last frame's traces and async camera traces nobody asked for last frame
+	void BeginFrame();
+	const TArray<FHitResult>& TraceNow(const FTraceKey& Key, const FCollisionQueryParams& Params);
+	const TArray<FHitResult>& AsyncCameraTrace(const FTraceKey& Key, const FCollisionQueryParams& Params, const APlayerController* CameraOwner);
+
+	TMap<FTraceKey, TArray<FHitResult>> FrameTraces;
+	TMap<TWeakObjectPtr<const APlayerController>, FAsyncCameraTrace> AsyncCameraTraces;
+	uint64 CurrentFrame = 0;
+
+	FOWSTargetingQueryStats Stats;
+};
@@ -0,0 +1,196 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Runtime/Online/HTTP/Public/Http.h"
+#include "Containers/Ticker.h"
+#include "OWSEndpoints.h"
+#include "OWSTransportSubsystem.generated.h"
+
+//Called once per caller when a (possibly shared or retried) OWS request completes
+DECLARE_DELEGATE_ThreeParams(FOWSTransportRequestCompleteDelegate, FHttpRequestPtr, FHttpResponsePtr, bool)
+
+USTRUCT(BlueprintType)
+struct FOWSEndpointStats
+{
+	GENERATED_BODY()
+
+public:
+	//Number of HTTP requests actually sent to the backend, including retries
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 RequestsSent = 0;
+
+	//Number of logical requests completed successfully
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 Succeeded = 0;
+
+	//Number of logical requests that failed after all retries
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 Failed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 Retries = 0;
+
+	//Number of calls that were collapsed onto an identical request already queued or in flight
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 DedupHits = 0;
+
+	//Number of calls rejected because the request queue was full
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		int32 Rejected = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		float AverageLatencyMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Transport")
+		float MaxLatencyMs = 0.f;
+
+	double TotalLatencySeconds = 0.0;
+	int32 LatencySamples = 0;
+
+	void AddLatencySample(double LatencySeconds)
+	{
+		TotalLatencySeconds += LatencySeconds;
+		LatencySamples++;
+		AverageLatencyMs = (float)(TotalLatencySeconds / LatencySamples * 1000.0);
+		MaxLatencyMs = FMath::Max(MaxLatencyMs, (float)(LatencySeconds * 1000.0));
+	}
+};
+
+/**
+ * Shared HTTP transport for every OWS 2 API call made by this game instance.
+ *
+ * Requests are queued, dispatched under a global and a per-endpoint concurrency limit, identical idempotent requests
+ * that are already queued or in flight are collapsed into one, and idempotent requests are retried with exponential
+ * backoff on transport errors and 5xx/429 responses.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSTransportSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadWrite)
+		FString OWSAPICustomerKey;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		FString OWS2APIPath = "";
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		FString OWS2InstanceManagementAPIPath = "";
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		FString OWS2CharacterPersistenceAPIPath = "";
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		FString OWS2GlobalDataAPIPath = "";
+
+	//Timeout used when a caller does not specify one
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float DefaultRequestTimeout = 30.f;
+
+	//Requests waiting for a free slot beyond this are rejected
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxQueuedRequests = 1024;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxConcurrentRequests = 32;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxConcurrentRequestsPerEndpoint = 8;
+
+	//Only idempotent requests are retried
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxRetries = 3;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float RetryBaseDelay = 0.5f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float RetryMaxDelay = 8.f;
+
+	/*
+	Queue a call to one of the endpoints in OWSEndpoints.  Idempotent endpoints are de-duplicated against identical queued or
+	in flight requests and retried on failure.  A Timeout <= 0 uses DefaultRequestTimeout.
+	*/
+	void ProcessOWS2Request(const FOWSEndpoint& Endpoint, const FString& Content, float Timeout, FOWSTransportRequestCompleteDelegate OnComplete);
+
+	//Same as ProcessOWS2Request for endpoints that take a parameter in the path, e.g. api/GlobalData/GetGlobalDataItem/<key>
+	void ProcessOWS2RequestWithPathParameter(const FOWSEndpoint& Endpoint, const FString& PathParameter, const FString& Content, float Timeout,
+		FOWSTransportRequestCompleteDelegate OnComplete);
+
+	//Base path configured for a module, e.g. OWS2CharacterPersistenceAPIPath
+	const FString& GetAPIPathForModule(EOWSApiModule Module) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Transport")
+		FOWSEndpointStats GetEndpointStats(const FString& Endpoint) const;
+
+	const FOWSEndpointStats& GetEndpointStats(const FOWSEndpoint& Endpoint) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Transport")
+		int32 GetNumQueuedRequests() const { return Queue.Num(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Transport")
+		int32 GetNumInFlightRequests() const { return InFlight.Num(); }
+
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+protected:
+
+	//Endpoint index plus path parameter and body, identical keys are the same request
+	using FDedupKey = TTuple<int32, FString>;
+
+	struct FPendingRequest
+	{
+		const FOWSEndpoint* Endpoint = nullptr;
+		FDedupKey DedupKey;
+		FString URL;
+		FString Content;
+		float Timeout = 0.f;
+		bool bIdempotent = false;
+		int32 Attempt = 0;
+		double StartTime = 0.0;
+		FHttpRequestPtr HttpRequest;
+		FTSTicker::FDelegateHandle RetryHandle;
+		TArray<FOWSTransportRequestCompleteDelegate> Waiters;
+	};
+
+	void ComposeEndpointURLs();
+	void QueueRequest(const FOWSEndpoint& Endpoint, FString&& URL, FDedupKey&& DedupKey, const FString& Content, float Timeout, FOWSTransportRequestCompleteDelegate&& OnComplete);
+
+	void PumpQueue();
+	void Dispatch(TSharedPtr<FPendingRequest> Pending);
+	void OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedPtr<FPendingRequest> Pending);
+	bool ShouldRetry(const FPendingRequest& Pending, FHttpResponsePtr Response, bool bWasSuccessful) const;
+	void ScheduleRetry(TSharedPtr<FPendingRequest> Pending);
+	void Finish(TSharedPtr<FPendingRequest> Pending, FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+
+	//Requests waiting for a concurrency slot, in submission order
+	TArray<TSharedPtr<FPendingRequest>> Queue;
+
+	//Requests currently on the wire
+	TSet<TSharedPtr<FPendingRequest>> InFlight;
+
+	//Requests waiting for a retry timer
+	TSet<TSharedPtr<FPendingRequest>> WaitingForRetry;
+
+	//Idempotent requests that are queued, in flight or waiting to retry
+	TMap<FDedupKey, TSharedPtr<FPendingRequest>> PendingByDedupKey;
+
+	//Composed once at Initialize, the rest are indexed by FOWSEndpoint::Index as well
+	TArray<FString> EndpointURLs;
+
+	TArray<int32> InFlightPerEndpoint;
+
+	TArray<FOWSEndpointStats> StatsPerEndpoint;
+};
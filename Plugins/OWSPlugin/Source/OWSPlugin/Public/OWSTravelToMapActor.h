@@ -58,6 +58,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Map")
 		FRotator DynamicSpawnRotationOffeset;
 
+	//When the local player's pawn comes within this distance the zone server is resolved ahead of travel, once each time the
+	//pawn comes near.  0 disables it, which is the default since GetServerToConnectTo may start a zone instance.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Travel")
+		float PrefetchRadius = 0.f;
+
+	//Seconds between distance checks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Travel")
+		float PrefetchCheckInterval = 0.5f;
+
 	UFUNCTION(BlueprintCallable, Category = "Travel")
 		void GetMapServerToTravelTo(APlayerController* PlayerController, TEnumAsByte<ERPGSchemeToChooseMap::SchemeToChooseMap> SelectedSchemeToChooseMap, int32 WorldServerID);
 
@@ -71,5 +80,12 @@ public:
 		void NotifyMapServerToTravelTo(const FString &ServerAndPort);
 	UFUNCTION(BlueprintImplementableEvent, Category = "Travel")
 		void ErrorMapServerToTravelTo(const FString &ErrorMsg);
-	
+
+private:
+	void PrefetchIfLocalPlayerIsNear();
+
+	float TimeUntilPrefetchCheck = 0.f;
+
+	//Set once the local player has been prefetched for, cleared when the pawn moves back out of PrefetchRadius
+	bool bPrefetchedForLocalPlayer = false;
 };
@@ -0,0 +1,139 @@
+// Copyright 2022 Sabre Dart Studios
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OWSPlugin.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Runtime/Online/HTTP/Public/Http.h"
+#include "OWS2API.h"
+#include "OWSZoneServerAssignmentCache.generated.h"
+
+//Called with the raw GetServerToConnectTo response body, or bWasSuccessful false and an empty body
+DECLARE_DELEGATE_TwoParams(FOWSZoneServerResolvedDelegate, bool, const FString&)
+
+USTRUCT(BlueprintType)
+struct FOWSZoneServerAssignmentStats
+{
+	GENERATED_BODY()
+
+public:
+	//Requests sent ahead of travel
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 Prefetches = 0;
+
+	//Travel served from an assignment that had already arrived
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 Hits = 0;
+
+	//Travel that attached to a prefetch still in flight
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 InFlightJoins = 0;
+
+	//Travel that had to ask the backend itself
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 Misses = 0;
+
+	//Assignments dropped unused because they were past their TTL
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 Expired = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 Failures = 0;
+
+	//Prefetches skipped because the last request for the same zone failed or found no server
+	UPROPERTY(BlueprintReadOnly, Category = "Travel")
+		int32 PrefetchesBackedOff = 0;
+};
+
+/**
+ * Resolves api/Users/GetServerToConnectTo ahead of travel and holds the answer until the player actually travels.
+ *
+ * Prefetch sends the request as soon as a hop becomes likely (the player nears an AOWSTravelToMapActor or picks a
+ * character), Resolve hands travel the prefetched answer, attaches it to the prefetch if that is still in flight, or sends
+ * the request itself.  Assignments are keyed by character, zone and player group type, are used at most once and are
+ * dropped after AssignmentTTL seconds, since the zone instance they point at may have shut down in the meantime.
+ *
+ * GetServerToConnectTo can start a zone instance, so after a request fails or finds no server, prefetches for the same key
+ * wait PrefetchRetryDelay seconds, doubling with each further failure up to MaxPrefetchRetryDelay.  Travel itself always asks.
+ */
+UCLASS()
+class OWSPLUGIN_API UOWSZoneServerAssignmentCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//Seconds a prefetched assignment may be used for travel.  A TTL <= 0 disables prefetching.
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float AssignmentTTL = 30.f;
+
+	//Prefetches are ignored while this many assignments are held
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		int32 MaxAssignments = 64;
+
+	//Seconds before a prefetch that failed or found no server is tried again
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float PrefetchRetryDelay = 5.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Config")
+		float MaxPrefetchRetryDelay = 120.f;
+
+	//Does nothing if a fresh or in flight assignment for the same request already exists
+	void Prefetch(const FTravelToLastZoneServerJSONPost& Request, float Timeout);
+
+	//OnResolved is always called, either right away or once the backend answers
+	void Resolve(const FTravelToLastZoneServerJSONPost& Request, float Timeout, FOWSZoneServerResolvedDelegate OnResolved);
+
+	bool HasAssignment(const FTravelToLastZoneServerJSONPost& Request) const;
+
+	//Drop every assignment held for a character, e.g. after it logs out or changes group
+	UFUNCTION(BlueprintCallable, Category = "Travel")
+		void InvalidateCharacter(const FString& CharacterName);
+
+	UFUNCTION(BlueprintCallable, Category = "Travel")
+		void Clear();
+
+	UFUNCTION(BlueprintCallable, Category = "Travel")
+		FOWSZoneServerAssignmentStats GetStats() const { return Stats; }
+
+	void DumpStats(FOutputDevice& Ar) const;
+	void ResetStats();
+
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+protected:
+
+	struct FAssignment
+	{
+		FString CharacterName;
+		bool bInFlight = true;
+		//Cleared when the assignment is invalidated while in flight, the response then only goes to the waiters
+		bool bKeepResponse = true;
+		FString Content;
+		double ExpireTime = 0.0;
+		TArray<FOWSZoneServerResolvedDelegate> Waiters;
+	};
+
+	struct FPrefetchBackoff
+	{
+		FString CharacterName;
+		int32 Failures = 0;
+		double RetryTime = 0.0;
+	};
+
+	static FString MakeKey(const FTravelToLastZoneServerJSONPost& Request);
+	static bool HasServerAndPort(const FString& Content);
+
+	//OnResolved may be unbound for a prefetch nobody is waiting on yet
+	void SendRequest(const FString& Key, const FTravelToLastZoneServerJSONPost& Request, float Timeout, FOWSZoneServerResolvedDelegate OnResolved);
+	void OnResponseReceived(FHttpRequestPtr HttpRequest, FHttpResponsePtr Response, bool bWasSuccessful, FString Key);
+	void PurgeExpired();
+
+	TMap<FString, FAssignment> Assignments;
+	TMap<FString, FPrefetchBackoff> PrefetchBackoffs;
+	FOWSZoneServerAssignmentStats Stats;
+};
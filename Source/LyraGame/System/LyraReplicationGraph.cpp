@@ -26,6 +26,8 @@
 *		UReplicationGraphNode_GridSpatialization2D: 
 *		This is the spatialization node. All "distance based relevant" actors will be routed here. This node divides the map into a 2D grid. Each cell in the grid contains 
 *		children nodes that hold lists of actors based on how they update/go dormant. Actors are put in multiple cells. Connections pull from the single cell they are in.
+*		When Lyra.RepGraph.Adaptive.Enable is 1, ULyraReplicationGraph::UpdateAdaptiveSpatialGrid periodically resizes the cells to how crowded the busiest spot is and
+*		rebuilds the grid. Per class cull distances can be set with FRepGraphActorClassSettings::CullDistance.
 *		
 *		UReplicationGraphNode_ActorList
 *		This is an actor list node that contains the always relevant actors. These actors are always relevant to every connection.
@@ -38,7 +40,8 @@
 *		ULyraReplicationGraphNode_PlayerStateFrequencyLimiter
 *		A custom node for handling player state replication. This replicates a small rolling set of player states (currently 2/frame). This is so player states replicate
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
-*		owning connection only) via ULyraReplicationGraphNode_AlwaysRelevant_ForConnection.
+*		owning connection only) via ULyraReplicationGraphNode_AlwaysRelevant_ForConnection. The rolling buckets are persistent and are compacted as players leave. Each connection
+*		also gets a short list of nearby and same team player states that is returned every few frames, see the Lyra.RepGraph.PlayerState.* cvars.
 *		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
@@ -65,6 +68,13 @@
 *		Net.RepGraph.PrintAllActorInfo <ActorMatchString> - will print the class, global, and connection replication info associated with an actor/class. If MatchString is empty will print everything. Call directly from client.
 *		
 *		Lyra.RepGraph.PrintRouting - will print the EClassRepNodeMapping for each class. That is, how a given actor class is routed (or not) in the Replication Graph.
+*		
+*		Lyra.RepGraph.Benchmark.Spawn <Count> <Radius> - spawns replicated dummy actors on the server (see ALyraRepGraphBenchmarkSpawner, which can also be placed in a map).
+*		Lyra.RepGraph.Benchmark.Report [reset] - prints the average and peak replication cost per connection.
+*		
+*		Lyra.RepGraph.Profile 1 - records GatherActorListsForConnection time, gathered actors and starved actors per node and per connection.
+*		Lyra.RepGraph.Profile.Dump [reset] - prints what was recorded. Lyra.RepGraph.Profile.Csv start/stop - writes it per frame to Saved/Profiling/RepGraph.
+*		Classes with FRepGraphActorClassSettings::bTrackReplicationCost get their own replication time and bits in csvprofile captures.
 *	
 */
 
@@ -85,11 +95,15 @@
 #include "GameFramework/Pawn.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/NetConnection.h"
+#include "Engine/NetworkObjectList.h"
 #include "UObject/UObjectIterator.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
 
 #include "LyraReplicationGraphSettings.h"
 #include "Character/LyraCharacter.h"
 #include "Player/LyraPlayerController.h"
+#include "Player/LyraPlayerState.h"
 
 DEFINE_LOG_CATEGORY( LogLyraRepGraph );
 
@@ -132,6 +146,55 @@ namespace Lyra::RepGraph
 	int32 EnableFastSharedPath = 1;
 	static FAutoConsoleVariableRef CVarLyraRepEnableFastSharedPath(TEXT("Lyra.RepGraph.EnableFastSharedPath"), EnableFastSharedPath, TEXT(""), ECVF_Default);
 
+	// Owning connections get their own player state every N frames. 2 is the original 50% throttle.
+	int32 OwnerPlayerStatePeriodFrames = 2;
+	static FAutoConsoleVariableRef CVarLyraRepOwnerPlayerStatePeriodFrames(TEXT("Lyra.RepGraph.PlayerState.OwnerPeriodFrames"), OwnerPlayerStatePeriodFrames, TEXT("Frames between replicating a player state to its owning connection"), ECVF_Default);
+
+	// How many nearby/same team player states each connection gets on top of the rolling buckets. 0 disables the priority lists.
+	int32 PriorityPlayerStatesPerConnection = 8;
+	static FAutoConsoleVariableRef CVarLyraRepPriorityPlayerStatesPerConnection(TEXT("Lyra.RepGraph.PlayerState.PriorityPerConnection"), PriorityPlayerStatesPerConnection, TEXT("Max player states in each connection's priority list"), ECVF_Default);
+
+	float PriorityPlayerStateDistance = 5000.f;
+	static FAutoConsoleVariableRef CVarLyraRepPriorityPlayerStateDistance(TEXT("Lyra.RepGraph.PlayerState.PriorityDistance"), PriorityPlayerStateDistance, TEXT("Player states whose pawn is within this distance of the viewer are considered for the priority list"), ECVF_Default);
+
+	// Team mates are always considered, and rank as if they were this much closer
+	float PriorityPlayerStateTeamDistanceScale = 0.5f;
+	static FAutoConsoleVariableRef CVarLyraRepPriorityPlayerStateTeamDistanceScale(TEXT("Lyra.RepGraph.PlayerState.PriorityTeamDistanceScale"), PriorityPlayerStateTeamDistanceScale, TEXT(""), ECVF_Default);
+
+	// Connections are staggered so only 1/N of them rebuild their priority list in any one frame
+	int32 PriorityPlayerStateRebuildFrames = 15;
+	static FAutoConsoleVariableRef CVarLyraRepPriorityPlayerStateRebuildFrames(TEXT("Lyra.RepGraph.PlayerState.PriorityRebuildFrames"), PriorityPlayerStateRebuildFrames, TEXT("Frames between rebuilds of a connection's priority list"), ECVF_Default);
+
+	int32 PriorityPlayerStatePeriodFrames = 2;
+	static FAutoConsoleVariableRef CVarLyraRepPriorityPlayerStatePeriodFrames(TEXT("Lyra.RepGraph.PlayerState.PriorityPeriodFrames"), PriorityPlayerStatePeriodFrames, TEXT("Frames between returning a connection's priority list"), ECVF_Default);
+
+	int32 EnableAdaptiveGrid = 0;
+	static FAutoConsoleVariableRef CVarLyraRepEnableAdaptiveGrid(TEXT("Lyra.RepGraph.Adaptive.Enable"), EnableAdaptiveGrid, TEXT("Re-partition the spatial grid as players gather and spread out"), ECVF_Default);
+
+	float AdaptiveMinCellSize = 5000.f;
+	static FAutoConsoleVariableRef CVarLyraRepAdaptiveMinCellSize(TEXT("Lyra.RepGraph.Adaptive.MinCellSize"), AdaptiveMinCellSize, TEXT(""), ECVF_Default);
+
+	float AdaptiveMaxCellSize = 40000.f;
+	static FAutoConsoleVariableRef CVarLyraRepAdaptiveMaxCellSize(TEXT("Lyra.RepGraph.Adaptive.MaxCellSize"), AdaptiveMaxCellSize, TEXT(""), ECVF_Default);
+
+	// Cells are sized so the most crowded one holds about this many players
+	int32 AdaptiveTargetViewersPerCell = 8;
+	static FAutoConsoleVariableRef CVarLyraRepAdaptiveTargetViewersPerCell(TEXT("Lyra.RepGraph.Adaptive.TargetViewersPerCell"), AdaptiveTargetViewersPerCell, TEXT(""), ECVF_Default);
+
+	float AdaptiveInterval = 10.f;
+	static FAutoConsoleVariableRef CVarLyraRepAdaptiveInterval(TEXT("Lyra.RepGraph.Adaptive.Interval"), AdaptiveInterval, TEXT("Seconds between re-partition checks"), ECVF_Default);
+
+	// The grid is only rebuilt when the wanted cell size differs from the current one by more than this fraction
+	float AdaptiveHysteresis = 0.25f;
+	static FAutoConsoleVariableRef CVarLyraRepAdaptiveHysteresis(TEXT("Lyra.RepGraph.Adaptive.Hysteresis"), AdaptiveHysteresis, TEXT(""), ECVF_Default);
+
+	int32 EnableProfiling = 0;
+	static FAutoConsoleVariableRef CVarLyraRepEnableProfiling(TEXT("Lyra.RepGraph.Profile"), EnableProfiling, TEXT("Record gather time and gathered actors per node and per connection. See Lyra.RepGraph.Profile.Dump and Lyra.RepGraph.Profile.Csv"), ECVF_Default);
+
+	// A gathered actor counts as starved when it is this many frames past its own replication period
+	int32 ProfileStarvedFrames = 30;
+	static FAutoConsoleVariableRef CVarLyraRepProfileStarvedFrames(TEXT("Lyra.RepGraph.Profile.StarvedFrames"), ProfileStarvedFrames, TEXT(""), ECVF_Default);
+
 	UReplicationDriver* ConditionalCreateReplicationDriver(UNetDriver* ForNetDriver, UWorld* World)
 	{
 		// Only create for GameNetDriver
@@ -217,6 +280,12 @@ EClassRepNodeMapping ULyraReplicationGraph::GetClassNodeMapping(UClass* Class) c
 		return *Ptr;
 	}
 	
+	// Player states are replicated by ULyraReplicationGraphNode_PlayerStateFrequencyLimiter, which only sees NotRouted actors
+	if (Class->IsChildOf(APlayerState::StaticClass()))
+	{
+		return EClassRepNodeMapping::NotRouted;
+	}
+
 	AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
 	if (!ActorCDO || !ActorCDO->GetIsReplicated())
 	{
@@ -457,6 +526,24 @@ void ULyraReplicationGraph::InitGlobalActorClassSettings()
 
 	SetClassInfo(ALyraCharacter::StaticClass(), CharacterClassRepInfo);
 
+	// ---------------------------------------------------------------------
+	//	Per class cull distances. These start from what the class would otherwise get, so an ACharacter subclass
+	//	keeps the character settings above and only its cull distance changes.
+	// ---------------------------------------------------------------------
+	for (const FRepGraphActorClassSettings& ActorClassSettings : LyraRepGraphSettings->ClassSettings)
+	{
+		if (ActorClassSettings.bOverrideCullDistance)
+		{
+			if (UClass* StaticActorClass = ActorClassSettings.GetStaticActorClass())
+			{
+				FClassReplicationInfo ClassInfo = GlobalActorReplicationInfoMap.GetClassInfo(StaticActorClass);
+				ClassInfo.SetCullDistanceSquared(FMath::Square(ActorClassSettings.CullDistance));
+				UE_LOG(LogLyraRepGraph, Log, TEXT("ActorClassSettings -- CullDistance - %s :: %.0f"), *StaticActorClass->GetName(), ActorClassSettings.CullDistance);
+				SetClassInfo(StaticActorClass, ClassInfo);
+			}
+		}
+	}
+
 	// ---------------------------------------------------------------------
 	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = 12;
 	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = Lyra::RepGraph::DynamicActorFrequencyBuckets;
@@ -510,6 +597,23 @@ void ULyraReplicationGraph::InitGlobalActorClassSettings()
 	AGameplayDebuggerCategoryReplicator::NotifyDebuggerOwnerChange.AddUObject(this, &ThisClass::OnGameplayDebuggerOwnerChange);
 #endif
 
+#if CSV_PROFILER
+	// Per class replication time and bits for csvprofile captures. Children are tracked under their closest tracked parent.
+	CSVTracker.SetImplicitClassTracking(APawn::StaticClass(), FName(TEXT("Pawn")));
+	CSVTracker.SetImplicitClassTracking(APlayerState::StaticClass(), FName(TEXT("PlayerState")));
+
+	for (const FRepGraphActorClassSettings& ActorClassSettings : LyraRepGraphSettings->ClassSettings)
+	{
+		if (ActorClassSettings.bTrackReplicationCost)
+		{
+			if (UClass* StaticActorClass = ActorClassSettings.GetStaticActorClass())
+			{
+				CSVTracker.SetImplicitClassTracking(StaticActorClass, StaticActorClass->GetFName());
+			}
+		}
+	}
+#endif
+
 	// Add to RPC_Multicast_OpenChannelForClass map
 	RPC_Multicast_OpenChannelForClass.Reset();
 	RPC_Multicast_OpenChannelForClass.Set(AActor::StaticClass(), true); // Open channels for multicast RPCs by default
@@ -535,13 +639,13 @@ void ULyraReplicationGraph::InitGlobalGraphNodes()
 	//	Spatial Actors
 	// -----------------------------------------------
 
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode = CreateNewNode<ULyraReplicationGraphNode_GridSpatialization2D>();
 	GridNode->CellSize = Lyra::RepGraph::CellSize;
 	GridNode->SpatialBias = FVector2D(Lyra::RepGraph::SpatialBiasX, Lyra::RepGraph::SpatialBiasY);
 
 	if (Lyra::RepGraph::DisableSpatialRebuilds)
 	{
-		GridNode->AddToClassRebuildDenyList(AActor::StaticClass()); // Disable All spatial rebuilding
+		GridNode->AddToClassRebuildDenyList(AActor::StaticClass()); // Disable All spatial rebuilding. UpdateAdaptiveSpatialGrid still forces rebuilds of its own.
 	}
 	
 	AddGlobalGraphNode(GridNode);
@@ -549,13 +653,13 @@ void ULyraReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	//	Always Relevant (to everyone) Actors
 	// -----------------------------------------------
-	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AlwaysRelevantNode = CreateNewNode<ULyraReplicationGraphNode_ActorList>();
 	AddGlobalGraphNode(AlwaysRelevantNode);
 
 	// -----------------------------------------------
 	//	Player State specialization. This will return a rolling subset of the player states to replicate
 	// -----------------------------------------------
-	ULyraReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode = CreateNewNode<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
 }
 
@@ -586,6 +690,11 @@ void ULyraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActo
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			// Player states are handled by ULyraReplicationGraphNode_PlayerStateFrequencyLimiter
+			if (ActorInfo.Actor->IsA<APlayerState>())
+			{
+				PlayerStateNode->NotifyAddNetworkActor(ActorInfo);
+			}
 			break;
 		}
 		
@@ -623,6 +732,130 @@ void ULyraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActo
 	};
 }
 
+int32 ULyraReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	UpdateAdaptiveSpatialGrid();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	if (Connections.Num() > 0)
+	{
+		ReplicationCost.TotalSeconds += ElapsedSeconds;
+		ReplicationCost.PeakSecondsPerConnection = FMath::Max(ReplicationCost.PeakSecondsPerConnection, ElapsedSeconds / Connections.Num());
+		ReplicationCost.Frames++;
+		ReplicationCost.ConnectionFrames += Connections.Num();
+	}
+
+	if (Lyra::RepGraph::EnableProfiling)
+	{
+		Profiler.EndFrame();
+	}
+
+	return NumReplicated;
+}
+
+void ULyraReplicationGraph::UpdateAdaptiveSpatialGrid()
+{
+	if (Lyra::RepGraph::EnableAdaptiveGrid == 0 || GridNode == nullptr)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now < NextAdaptiveGridUpdateTime)
+	{
+		return;
+	}
+
+	NextAdaptiveGridUpdateTime = Now + FMath::Max(Lyra::RepGraph::AdaptiveInterval, 1.f);
+
+	const float MinCellSize = FMath::Max(Lyra::RepGraph::AdaptiveMinCellSize, 1000.f);
+	const float MaxCellSize = FMath::Max(Lyra::RepGraph::AdaptiveMaxCellSize, MinCellSize);
+
+	// Bin the view targets into the largest cells allowed to find the most crowded spot
+	TMap<FIntPoint, int32> ViewersPerCell;
+	FBox2D ViewerBounds(ForceInit);
+	int32 PeakViewers = 0;
+
+	for (UNetReplicationGraphConnection* ConnManager : Connections)
+	{
+		const AActor* ViewTarget = ConnManager->NetConnection ? ConnManager->NetConnection->ViewTarget : nullptr;
+		if (ViewTarget == nullptr)
+		{
+			continue;
+		}
+
+		const FVector Location = ViewTarget->GetActorLocation();
+		ViewerBounds += FVector2D(Location.X, Location.Y);
+
+		const FIntPoint Cell(FMath::FloorToInt32(Location.X / MaxCellSize), FMath::FloorToInt32(Location.Y / MaxCellSize));
+		PeakViewers = FMath::Max(PeakViewers, ++ViewersPerCell.FindOrAdd(Cell));
+	}
+
+	if (PeakViewers == 0)
+	{
+		return;
+	}
+
+	// Split the most crowded cell until each piece holds about TargetViewersPerCell players. The engine grid is uniform,
+	// so the hot spot decides the cell size for the whole zone, while quiet zones get large cells.
+	const float TargetViewers = (float)FMath::Max(Lyra::RepGraph::AdaptiveTargetViewersPerCell, 1);
+	const float WantedCellSize = FMath::Clamp(MaxCellSize / FMath::Sqrt(PeakViewers / TargetViewers), MinCellSize, MaxCellSize);
+	const bool bCellSizeChanged = FMath::Abs(WantedCellSize - GridNode->CellSize) > GridNode->CellSize * Lyra::RepGraph::AdaptiveHysteresis;
+
+	// The grid only grows toward +X/+Y, keep the bias a couple of cells ahead of the players so it does not have to clamp them
+	FVector2D WantedBias = GridNode->SpatialBias;
+	const double BiasMargin = MaxCellSize * 2.0;
+	bool bBiasChanged = false;
+
+	if (ViewerBounds.Min.X - MaxCellSize < WantedBias.X)
+	{
+		WantedBias.X = ViewerBounds.Min.X - BiasMargin;
+		bBiasChanged = true;
+	}
+
+	if (ViewerBounds.Min.Y - MaxCellSize < WantedBias.Y)
+	{
+		WantedBias.Y = ViewerBounds.Min.Y - BiasMargin;
+		bBiasChanged = true;
+	}
+
+	if (!bCellSizeChanged && !bBiasChanged)
+	{
+		return;
+	}
+
+	UE_LOG(LogLyraRepGraph, Log, TEXT("Re-partitioning spatial grid. CellSize %.0f -> %.0f, SpatialBias %s -> %s (%d viewers, peak %d in a %.0f cell)"),
+		GridNode->CellSize, bCellSizeChanged ? WantedCellSize : GridNode->CellSize, *GridNode->SpatialBias.ToString(), *WantedBias.ToString(), Connections.Num(), PeakViewers, MaxCellSize);
+
+	if (bCellSizeChanged)
+	{
+		GridNode->CellSize = WantedCellSize;
+	}
+
+	GridNode->SpatialBias = WantedBias;
+	GridNode->ForceRebuild();
+}
+
+void ULyraReplicationGraph::DumpReplicationCost(FOutputDevice& Ar) const
+{
+	const int32 NumActors = NetDriver ? NetDriver->GetNetworkObjectList().GetActiveObjects().Num() : 0;
+
+	Ar.Logf(TEXT("%s: connections=%d actors=%d cell size=%.0f bias=%s"), *GetName(), Connections.Num(), NumActors, GridNode ? GridNode->CellSize : 0.f, GridNode ? *GridNode->SpatialBias.ToString() : TEXT(""));
+	Ar.Logf(TEXT("  frames=%lld avg=%.3fms/frame avg=%.1fus/connection peak=%.1fus/connection"),
+		ReplicationCost.Frames,
+		ReplicationCost.Frames > 0 ? 1000.0 * ReplicationCost.TotalSeconds / ReplicationCost.Frames : 0.0,
+		ReplicationCost.ConnectionFrames > 0 ? 1000000.0 * ReplicationCost.TotalSeconds / ReplicationCost.ConnectionFrames : 0.0,
+		1000000.0 * ReplicationCost.PeakSecondsPerConnection);
+}
+
+void ULyraReplicationGraph::ResetReplicationCost()
+{
+	ReplicationCost = FReplicationCost();
+}
+
 void ULyraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
 {
 	EClassRepNodeMapping Policy = GetMappingPolicy(ActorInfo.Class);
@@ -630,6 +863,10 @@ void ULyraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedA
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			if (ActorInfo.Actor->IsA<APlayerState>())
+			{
+				PlayerStateNode->NotifyRemoveNetworkActor(ActorInfo);
+			}
 			break;
 		}
 		
@@ -726,6 +963,193 @@ void ULyraReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCateg
 
 // ------------------------------------------------------------------------------
 
+FLyraRepGraphGatherScope::FLyraRepGraphGatherScope(const UReplicationGraphNode& InNode, const FConnectionGatherActorListParameters& InParams)
+	: Node(InNode)
+	, Params(InParams)
+{
+	if (Lyra::RepGraph::EnableProfiling == 0)
+	{
+		return;
+	}
+
+	bActive = true;
+	NumListsBefore = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default).Num();
+	StartTime = FPlatformTime::Seconds();
+}
+
+FLyraRepGraphGatherScope::~FLyraRepGraphGatherScope()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+	// Counting happens outside the timed section
+	int32 NumActors = 0;
+	int32 NumStarved = 0;
+	const uint32 StarvedFrames = (uint32)FMath::Max(Lyra::RepGraph::ProfileStarvedFrames, 1);
+	const TArray<FActorRepListRefView>& Lists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default);
+
+	for (int32 ListIdx = NumListsBefore; ListIdx < Lists.Num(); ++ListIdx)
+	{
+		for (FActorRepListType Actor : Lists[ListIdx])
+		{
+			NumActors++;
+
+			const FConnectionReplicationActorInfo* ActorInfo = Params.ConnectionManager.ActorInfoMap.Find(Actor);
+			if (ActorInfo && !ActorInfo->bDormantOnConnection && ActorInfo->LastRepFrameNum > 0
+				&& Params.ReplicationFrameNum - ActorInfo->LastRepFrameNum > ActorInfo->ReplicationPeriodFrame + StarvedFrames)
+			{
+				NumStarved++;
+			}
+		}
+	}
+
+	ULyraReplicationGraph* LyraGraph = CastChecked<ULyraReplicationGraph>(Node.GetOuter());
+	LyraGraph->Profiler.RecordGather(Node, Params.ConnectionManager, Seconds, NumActors, NumStarved);
+}
+
+void FLyraRepGraphProfiler::RecordGather(const UReplicationGraphNode& Node, UNetReplicationGraphConnection& ConnectionManager, double Seconds, int32 Actors, int32 Starved)
+{
+	// Nodes are grouped by class, otherwise every connection node would get its own entry
+	FGatherStats& NodeStat = NodeStats.FindOrAdd(FObjectKey(Node.GetClass()));
+	if (NodeStat.Name.IsEmpty())
+	{
+		NodeStat.Name = Node.GetClass()->GetName();
+	}
+
+	NodeStat.FrameSeconds += Seconds;
+	NodeStat.FrameActors += Actors;
+	NodeStat.FrameStarved += Starved;
+
+	FGatherStats& ConnectionStat = ConnectionStats.FindOrAdd(FObjectKey(&ConnectionManager));
+	if (ConnectionStat.Name.IsEmpty())
+	{
+		const APlayerController* PC = ConnectionManager.NetConnection ? ConnectionManager.NetConnection->PlayerController : nullptr;
+		if (PC && PC->PlayerState)
+		{
+			ConnectionStat.Name = PC->PlayerState->GetPlayerName();
+		}
+	}
+
+	ConnectionStat.FrameSeconds += Seconds;
+	ConnectionStat.FrameActors += Actors;
+	ConnectionStat.FrameStarved += Starved;
+}
+
+void FLyraRepGraphProfiler::EndFrame()
+{
+	EndFrameStats(NodeStats, TEXT("Node"));
+	EndFrameStats(ConnectionStats, TEXT("Connection"));
+	Frames++;
+}
+
+void FLyraRepGraphProfiler::EndFrameStats(TMap<FObjectKey, FGatherStats>& StatsMap, const TCHAR* Type)
+{
+	for (TPair<FObjectKey, FGatherStats>& Pair : StatsMap)
+	{
+		FGatherStats& Stats = Pair.Value;
+		if (Stats.FrameSeconds <= 0.0 && Stats.FrameActors == 0)
+		{
+			continue;
+		}
+
+		if (CsvWriter)
+		{
+			const FString Row = FString::Printf(TEXT("%lld,%s,\"%s\",%.1f,%d,%d\n"), Frames, Type, *Stats.Name.Replace(TEXT("\""), TEXT("\"\"")), Stats.FrameSeconds * 1000000.0, Stats.FrameActors, Stats.FrameStarved);
+			const FTCHARToUTF8 Utf8Row(*Row);
+			CsvWriter->Serialize((void*)Utf8Row.Get(), Utf8Row.Length());
+		}
+
+		Stats.GatherSeconds += Stats.FrameSeconds;
+		Stats.PeakFrameSeconds = FMath::Max(Stats.PeakFrameSeconds, Stats.FrameSeconds);
+		Stats.ActorsGathered += Stats.FrameActors;
+		Stats.StarvedActors += Stats.FrameStarved;
+		Stats.Frames++;
+
+		Stats.FrameSeconds = 0.0;
+		Stats.FrameActors = 0;
+		Stats.FrameStarved = 0;
+	}
+}
+
+void FLyraRepGraphProfiler::Reset()
+{
+	NodeStats.Reset();
+	ConnectionStats.Reset();
+	Frames = 0;
+}
+
+void FLyraRepGraphProfiler::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Lyra RepGraph gather profile: %lld frames%s. Per frame averages, starved = gathered but more than %d frames late"), Frames, CsvWriter ? TEXT(", writing csv") : TEXT(""), Lyra::RepGraph::ProfileStarvedFrames);
+
+	auto DumpStatsMap = [&Ar](const TMap<FObjectKey, FGatherStats>& StatsMap, const TCHAR* Title, int32 MaxRows)
+	{
+		TArray<const FGatherStats*> SortedStats;
+		for (const TPair<FObjectKey, FGatherStats>& Pair : StatsMap)
+		{
+			SortedStats.Add(&Pair.Value);
+		}
+
+		SortedStats.Sort([](const FGatherStats& A, const FGatherStats& B) { return A.GatherSeconds > B.GatherSeconds; });
+
+		Ar.Logf(TEXT("  %s (%d)"), Title, SortedStats.Num());
+		for (int32 Idx = 0; Idx < FMath::Min(MaxRows, SortedStats.Num()); ++Idx)
+		{
+			const FGatherStats& Stats = *SortedStats[Idx];
+			const double NumFrames = (double)FMath::Max<int64>(Stats.Frames, 1);
+			Ar.Logf(TEXT("    %-48s avg=%8.1fus peak=%8.1fus actors=%7.1f starved=%6.1f"), Stats.Name.IsEmpty() ? TEXT("(unnamed)") : *Stats.Name,
+				1000000.0 * Stats.GatherSeconds / NumFrames, 1000000.0 * Stats.PeakFrameSeconds, Stats.ActorsGathered / NumFrames, Stats.StarvedActors / NumFrames);
+		}
+	};
+
+	DumpStatsMap(NodeStats, TEXT("Nodes"), NodeStats.Num());
+	DumpStatsMap(ConnectionStats, TEXT("Connections, most expensive first"), 16);
+}
+
+bool FLyraRepGraphProfiler::StartCsv(const FString& Filename)
+{
+	StopCsv();
+
+	CsvWriter.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!CsvWriter)
+	{
+		return false;
+	}
+
+	static const ANSICHAR CsvHeader[] = "Frame,Type,Name,GatherUs,Actors,Starved\n";
+	CsvWriter->Serialize((void*)CsvHeader, sizeof(CsvHeader) - 1);
+	return true;
+}
+
+void FLyraRepGraphProfiler::StopCsv()
+{
+	if (CsvWriter)
+	{
+		CsvWriter->Close();
+		CsvWriter.Reset();
+	}
+}
+
+// ------------------------------------------------------------------------------
+
+void ULyraReplicationGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	FLyraRepGraphGatherScope GatherScope(*this, Params);
+	Super::GatherActorListsForConnection(Params);
+}
+
+void ULyraReplicationGraphNode_ActorList::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	FLyraRepGraphGatherScope GatherScope(*this, Params);
+	Super::GatherActorListsForConnection(Params);
+}
+
+// ------------------------------------------------------------------------------
+
 void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
 {
 	ReplicationActorList.Reset();
@@ -734,6 +1158,8 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState
 
 void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	FLyraRepGraphGatherScope GatherScope(*this, Params);
+
 	ULyraReplicationGraph* LyraGraph = CastChecked<ULyraReplicationGraph>(GetOuter());
 
 	ReplicationActorList.Reset();
@@ -745,8 +1171,9 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsFor
 
 		if (ALyraPlayerController* PC = Cast<ALyraPlayerController>(CurViewer.InViewer))
 		{
-			// 50% throttling of PlayerStates.
-			const bool bReplicatePS = (Params.ConnectionManager.ConnectionOrderNum % 2) == (Params.ReplicationFrameNum % 2);
+			// Throttling of PlayerStates, 50% by default.
+			const uint32 OwnerPeriodFrames = (uint32)FMath::Max(Lyra::RepGraph::OwnerPlayerStatePeriodFrames, 1);
+			const bool bReplicatePS = (Params.ConnectionManager.ConnectionOrderNum % OwnerPeriodFrames) == (Params.ReplicationFrameNum % OwnerPeriodFrames);
 			if (bReplicatePS)
 			{
 				// Always return the player state to the owning player. Simulated proxy player states are handled by ULyraReplicationGraphNode_PlayerStateFrequencyLimiter
@@ -880,46 +1307,179 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplicatio
 ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::ULyraReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
+
+	// There is always at least one bucket, so GatherActorListsForConnection can index without checking
+	ReplicationActorLists.AddDefaulted();
 }
 
-void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
-	ReplicationActorLists.Reset();
-	ForceNetUpdateReplicationActorList.Reset();
+	if (BucketIndexMap.Contains(ActorInfo.Actor))
+	{
+		return;
+	}
 
-	ReplicationActorLists.AddDefaulted();
-	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
+	if (ReplicationActorLists.Last().Num() >= TargetActorsPerFrame)
+	{
+		ReplicationActorLists.AddDefaulted();
+	}
 
-	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
-	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
+	ReplicationActorLists.Last().Add(ActorInfo.Actor);
+	BucketIndexMap.Add(ActorInfo.Actor, ReplicationActorLists.Num() - 1);
+}
 
-	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+bool ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 BucketIdx = INDEX_NONE;
+	if (!BucketIndexMap.RemoveAndCopyValue(ActorInfo.Actor, BucketIdx))
 	{
-		APlayerState* PS = *It;
-		if (IsActorValidForReplicationGather(PS) == false)
+		UE_CLOG(bWarnIfNotFound, LogLyraRepGraph, Warning, TEXT("ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor - %s was not found"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+		return false;
+	}
+
+	ReplicationActorLists[BucketIdx].RemoveFast(ActorInfo.Actor);
+
+	// Fill the hole from the last bucket so every bucket but the last stays full
+	const int32 LastIdx = ReplicationActorLists.Num() - 1;
+	FActorRepListRefView& LastList = ReplicationActorLists[LastIdx];
+	if (BucketIdx != LastIdx && LastList.Num() > 0)
+	{
+		FActorRepListType MovedActor = LastList[LastList.Num() - 1];
+		LastList.RemoveFast(MovedActor);
+		ReplicationActorLists[BucketIdx].Add(MovedActor);
+		BucketIndexMap.FindChecked(MovedActor) = BucketIdx;
+	}
+
+	if (LastList.Num() == 0 && ReplicationActorLists.Num() > 1)
+	{
+		ReplicationActorLists.Pop(EAllowShrinking::No);
+	}
+
+	// A player state leaving usually means a connection left too, drop its priority list along with the player state
+	for (auto It = PriorityPlayerStatesMap.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
 		{
+			It.RemoveCurrent();
 			continue;
 		}
 
-		if (CurrentList->Num() >= TargetActorsPerFrame)
-		{
-			ReplicationActorLists.AddDefaulted();
-			CurrentList = &ReplicationActorLists.Last(); 
-		}
-		
-		CurrentList->Add(PS);
-	}	
+		It.Value().ReplicationActorList.RemoveFast(ActorInfo.Actor);
+	}
+
+	return true;
+}
+
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyResetAllNetworkActors()
+{
+	ReplicationActorLists.Reset();
+	ReplicationActorLists.AddDefaulted();
+	ForceNetUpdateReplicationActorList.Reset();
+	BucketIndexMap.Reset();
+	PriorityPlayerStatesMap.Reset();
+}
+
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	ForceNetUpdateReplicationActorList.Reset();
 }
 
 void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	FLyraRepGraphGatherScope GatherScope(*this, Params);
+
 	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
 	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
 
 	if (ForceNetUpdateReplicationActorList.Num() > 0)
 	{
 		Params.OutGatheredReplicationLists.AddReplicationActorList(ForceNetUpdateReplicationActorList);
-	}	
+	}
+
+	// With a single bucket every player state is already returned every frame
+	if (Lyra::RepGraph::PriorityPlayerStatesPerConnection <= 0 || ReplicationActorLists.Num() <= 1)
+	{
+		return;
+	}
+
+	const uint32 ConnectionOrderNum = Params.ConnectionManager.ConnectionOrderNum;
+	FPriorityPlayerStates& PriorityPlayerStates = PriorityPlayerStatesMap.FindOrAdd(FObjectKey(&Params.ConnectionManager));
+
+	const uint32 RebuildFrames = (uint32)FMath::Max(Lyra::RepGraph::PriorityPlayerStateRebuildFrames, 1);
+	if (!PriorityPlayerStates.bBuilt || ((Params.ReplicationFrameNum + ConnectionOrderNum) % RebuildFrames) == 0)
+	{
+		RebuildPriorityPlayerStates(Params, PriorityPlayerStates.ReplicationActorList);
+		PriorityPlayerStates.bBuilt = true;
+	}
+
+	const uint32 PeriodFrames = (uint32)FMath::Max(Lyra::RepGraph::PriorityPlayerStatePeriodFrames, 1);
+	if (PriorityPlayerStates.ReplicationActorList.Num() > 0 && ((Params.ReplicationFrameNum + ConnectionOrderNum) % PeriodFrames) == 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(PriorityPlayerStates.ReplicationActorList);
+	}
+}
+
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::RebuildPriorityPlayerStates(const FConnectionGatherActorListParameters& Params, FActorRepListRefView& OutList) const
+{
+	OutList.Reset();
+
+	if (Params.Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	const FNetViewer& Viewer = Params.Viewers[0];
+	const APlayerController* ViewerPC = Cast<APlayerController>(Viewer.InViewer);
+	const APlayerState* ViewerPS = ViewerPC ? ViewerPC->PlayerState : nullptr;
+	const ALyraPlayerState* ViewerLyraPS = Cast<ALyraPlayerState>(ViewerPS);
+	const int32 ViewerTeamId = ViewerLyraPS ? ViewerLyraPS->GetTeamId() : INDEX_NONE;
+
+	const FVector::FReal MaxDistSq = FMath::Square(Lyra::RepGraph::PriorityPlayerStateDistance);
+	const FVector::FReal TeamScaleSq = FMath::Square(Lyra::RepGraph::PriorityPlayerStateTeamDistanceScale);
+
+	struct FCandidate
+	{
+		FActorRepListType Actor;
+		FVector::FReal Score;
+	};
+
+	TArray<FCandidate, TInlineAllocator<64>> Candidates;
+
+	for (const FActorRepListRefView& List : ReplicationActorLists)
+	{
+		for (FActorRepListType Actor : List)
+		{
+			// The owning connection's own player state is handled by ULyraReplicationGraphNode_AlwaysRelevant_ForConnection
+			if (Actor == ViewerPS)
+			{
+				continue;
+			}
+
+			const APlayerState* PS = CastChecked<APlayerState>(Actor);
+			const APawn* Pawn = PS->GetPawn();
+			const FVector::FReal DistSq = Pawn ? FVector::DistSquared(Viewer.ViewLocation, Pawn->GetActorLocation()) : MaxDistSq;
+
+			const ALyraPlayerState* LyraPS = Cast<ALyraPlayerState>(PS);
+			const bool bSameTeam = ViewerTeamId != INDEX_NONE && LyraPS && LyraPS->GetTeamId() == ViewerTeamId;
+
+			if (bSameTeam)
+			{
+				Candidates.Add({ Actor, DistSq * TeamScaleSq });
+			}
+			else if (Pawn && DistSq <= MaxDistSq)
+			{
+				Candidates.Add({ Actor, DistSq });
+			}
+		}
+	}
+
+	Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Score < B.Score; });
+
+	const int32 NumToAdd = FMath::Min(Candidates.Num(), Lyra::RepGraph::PriorityPlayerStatesPerConnection);
+	for (int32 Idx = 0; Idx < NumToAdd; ++Idx)
+	{
+		OutList.Add(Candidates[Idx].Actor);
+	}
 }
 
 void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
@@ -933,6 +1493,8 @@ void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplication
 		LogActorRepList(DebugInfo, FString::Printf(TEXT("Bucket[%d]"), i++), List);
 	}
 
+	DebugInfo.Log(FString::Printf(TEXT("PlayerStates: %d Buckets: %d PriorityLists: %d"), BucketIndexMap.Num(), ReplicationActorLists.Num(), PriorityPlayerStatesMap.Num()));
+
 	DebugInfo.PopIndent();
 }
 
@@ -960,6 +1522,69 @@ void ULyraReplicationGraph::PrintRepNodePolicies()
 	}
 }
 
+FAutoConsoleCommandWithWorldAndArgs LyraRepGraphBenchmarkReportCmd(TEXT("Lyra.RepGraph.Benchmark.Report"),TEXT("Prints how long replication took per frame and per connection. Pass reset to start a new measurement."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<ULyraReplicationGraph> It; It; ++It)
+		{
+			if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+			{
+				It->ResetReplicationCost();
+			}
+			else
+			{
+				It->DumpReplicationCost(*GLog);
+			}
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs LyraRepGraphProfileDumpCmd(TEXT("Lyra.RepGraph.Profile.Dump"),TEXT("Prints gather cost per node and per connection recorded while Lyra.RepGraph.Profile is on. Pass reset to start over."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<ULyraReplicationGraph> It; It; ++It)
+		{
+			if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+			{
+				It->Profiler.Reset();
+			}
+			else
+			{
+				It->Profiler.Dump(*GLog);
+			}
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs LyraRepGraphProfileCsvCmd(TEXT("Lyra.RepGraph.Profile.Csv"),TEXT("Lyra.RepGraph.Profile.Csv start [Filename] turns on Lyra.RepGraph.Profile and writes every replication frame to a csv in the profiling directory. Lyra.RepGraph.Profile.Csv stop closes it."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bStart = Args.Num() > 0 && Args[0] == TEXT("start");
+
+		for (TObjectIterator<ULyraReplicationGraph> It; It; ++It)
+		{
+			if (!bStart)
+			{
+				It->Profiler.StopCsv();
+				continue;
+			}
+
+			const FString BaseName = Args.Num() > 1 ? Args[1] : FString::Printf(TEXT("RepGraph-%s"), *FDateTime::Now().ToString());
+			const FString Filename = FPaths::ProfilingDir() / TEXT("RepGraph") / FString::Printf(TEXT("%s-%s.csv"), *BaseName, *It->GetName());
+
+			if (It->Profiler.StartCsv(Filename))
+			{
+				Lyra::RepGraph::EnableProfiling = 1;
+				UE_LOG(LogLyraRepGraph, Display, TEXT("Writing replication graph profile to %s"), *Filename);
+			}
+			else
+			{
+				UE_LOG(LogLyraRepGraph, Warning, TEXT("Unable to open %s for the replication graph profile"), *Filename);
+			}
+		}
+	})
+);
+
 FAutoConsoleCommandWithWorldAndArgs LyraPrintRepNodePoliciesCmd(TEXT("Lyra.RepGraph.PrintRouting"),TEXT("Prints how actor classes are routed to RepGraph nodes"),
 	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
 	{
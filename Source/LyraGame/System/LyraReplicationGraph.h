@@ -7,9 +7,60 @@
 #include "LyraReplicationGraph.generated.h"
 
 class AGameplayDebuggerCategoryReplicator;
+class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogLyraRepGraph, Display, All);
 
+/** Gather costs per node and per connection, recorded while Lyra.RepGraph.Profile is enabled. Nodes report through FLyraRepGraphGatherScope. */
+struct FLyraRepGraphProfiler
+{
+	struct FGatherStats
+	{
+		FString Name;
+		double GatherSeconds = 0.0;
+		double PeakFrameSeconds = 0.0;
+		int64 ActorsGathered = 0;
+		int64 StarvedActors = 0;
+		int64 Frames = 0;
+
+		// Current replication frame only
+		double FrameSeconds = 0.0;
+		int32 FrameActors = 0;
+		int32 FrameStarved = 0;
+	};
+
+	void RecordGather(const UReplicationGraphNode& Node, UNetReplicationGraphConnection& ConnectionManager, double Seconds, int32 Actors, int32 Starved);
+	void EndFrame();
+	void Reset();
+	void Dump(FOutputDevice& Ar) const;
+
+	/** Writes one row per node and per connection for every replication frame until StopCsv */
+	bool StartCsv(const FString& Filename);
+	void StopCsv();
+
+private:
+	void EndFrameStats(TMap<FObjectKey, FGatherStats>& StatsMap, const TCHAR* Type);
+
+	TMap<FObjectKey, FGatherStats> NodeStats;
+	TMap<FObjectKey, FGatherStats> ConnectionStats;
+	int64 Frames = 0;
+	TUniquePtr<FArchive> CsvWriter;
+};
+
+/** Times a node's GatherActorListsForConnection and counts the actors it gathered. Does nothing unless Lyra.RepGraph.Profile is enabled. */
+struct FLyraRepGraphGatherScope
+{
+	FLyraRepGraphGatherScope(const UReplicationGraphNode& InNode, const FConnectionGatherActorListParameters& InParams);
+	~FLyraRepGraphGatherScope();
+
+private:
+	const UReplicationGraphNode& Node;
+	const FConnectionGatherActorListParameters& Params;
+	double StartTime = 0.0;
+	int32 NumListsBefore = 0;
+	bool bActive = false;
+};
+
 /** Lyra Replication Graph implementation. See additional notes in LyraReplicationGraph.cpp! */
 UCLASS(transient, config=Engine)
 class ULyraReplicationGraph : public UReplicationGraph
@@ -26,6 +77,7 @@ public:
 	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
 	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
 	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
 
 	UPROPERTY()
 	TArray<TObjectPtr<UClass>>	AlwaysRelevantClasses;
@@ -36,6 +88,9 @@ public:
 	UPROPERTY()
 	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
 
+	UPROPERTY()
+	TObjectPtr<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -44,6 +99,12 @@ public:
 
 	void PrintRepNodePolicies();
 
+	/** Prints the time ServerReplicateActors took per frame and per connection since the last reset. See Lyra.RepGraph.Benchmark.Report */
+	void DumpReplicationCost(FOutputDevice& Ar) const;
+	void ResetReplicationCost();
+
+	FLyraRepGraphProfiler Profiler;
+
 private:
 	void AddClassRepInfo(UClass* Class, EClassRepNodeMapping Mapping);
 	void RegisterClassRepNodeMapping(UClass* Class);
@@ -55,12 +116,47 @@ private:
 
 	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
 
+	/** Picks a new GridNode cell size and bias from where the connections' view targets are, and rebuilds the grid when they change enough */
+	void UpdateAdaptiveSpatialGrid();
+
 	bool IsSpatialized(EClassRepNodeMapping Mapping) const { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
 
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
 
 	/** Classes that had their replication settings explictly set by code in ULyraReplicationGraph::InitGlobalActorClassSettings */
 	TArray<UClass*> ExplicitlySetClasses;
+
+	double NextAdaptiveGridUpdateTime = 0.0;
+
+	struct FReplicationCost
+	{
+		double TotalSeconds = 0.0;
+		double PeakSecondsPerConnection = 0.0;
+		int64 Frames = 0;
+		int64 ConnectionFrames = 0;
+	};
+
+	FReplicationCost ReplicationCost;
+};
+
+/** The engine grid with its gather reported to FLyraRepGraphProfiler */
+UCLASS()
+class ULyraReplicationGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+};
+
+/** The engine actor list with its gather reported to FLyraRepGraphProfiler */
+UCLASS()
+class ULyraReplicationGraphNode_ActorList : public UReplicationGraphNode_ActorList
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 };
 
 UCLASS()
@@ -95,6 +191,10 @@ private:
 /** 
 	This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. 
 	This is an optimization for large player connection counts, and not a requirement.
+
+	The buckets are persistent: player states are added and removed through NotifyAddNetworkActor/NotifyRemoveNetworkActor and the last bucket is used to fill
+	the hole a leaving player state makes, so every bucket but the last stays full. On top of the rolling buckets each connection gets a small priority list of
+	nearby and same team player states that is returned more often.
 */
 UCLASS()
 class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicationGraphNode
@@ -103,9 +203,10 @@ class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicatio
 
 	ULyraReplicationGraphNode_PlayerStateFrequencyLimiter();
 
-	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
-	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
 	virtual bool NotifyActorRenamed(const FRenamedReplicatedActorInfo& Actor, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override;
 
 	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 
@@ -117,7 +218,21 @@ class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicatio
 	int32 TargetActorsPerFrame = 2;
 
 private:
+
+	struct FPriorityPlayerStates
+	{
+		FActorRepListRefView ReplicationActorList;
+		bool bBuilt = false;
+	};
+
+	void RebuildPriorityPlayerStates(const FConnectionGatherActorListParameters& Params, FActorRepListRefView& OutList) const;
 	
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
+
+	/** Bucket each tracked player state is in, so removal does not have to search the buckets */
+	TMap<FActorRepListType, int32> BucketIndexMap;
+
+	/** Per connection priority lists, keyed by the UNetReplicationGraphConnection */
+	TMap<FObjectKey, FPriorityPlayerStates> PriorityPlayerStatesMap;
 };
\ No newline at end of file
@@ -0,0 +1,166 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraReplicationGraphBenchmark.h"
+#include "LyraReplicationGraph.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraReplicationGraphBenchmark)
+
+ALyraRepGraphBenchmarkActor::ALyraRepGraphBenchmarkActor()
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetUpdateFrequency = 10.0f;
+}
+
+void ALyraRepGraphBenchmarkActor::StartMoving(float InRadius, float InAngularSpeed)
+{
+	Center = GetActorLocation();
+	Radius = InRadius;
+	AngularSpeed = InAngularSpeed;
+	SetActorTickEnabled(true);
+}
+
+void ALyraRepGraphBenchmarkActor::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	Angle = FMath::Fmod(Angle + AngularSpeed * DeltaSeconds, UE_TWO_PI);
+	SetActorLocation(Center + FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 0.f));
+}
+
+// ------------------------------------------------------------------------------
+
+ALyraRepGraphBenchmarkSpawner::ALyraRepGraphBenchmarkSpawner()
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void ALyraRepGraphBenchmarkSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bSpawnOnBeginPlay && HasAuthority())
+	{
+		SpawnActors();
+	}
+}
+
+void ALyraRepGraphBenchmarkSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DestroyActors();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ALyraRepGraphBenchmarkSpawner::SpawnActors()
+{
+	UWorld* World = GetWorld();
+	if (!World || !HasAuthority())
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// Fixed seed so runs are comparable
+	FRandomStream Random(ActorCount);
+	const FVector Origin = GetActorLocation();
+	const int32 HotSpotCount = FMath::RoundToInt32(ActorCount * HotSpotFraction);
+
+	SpawnedActors.Reserve(SpawnedActors.Num() + ActorCount);
+
+	for (int32 Idx = 0; Idx < ActorCount; ++Idx)
+	{
+		const float Radius = (Idx < HotSpotCount) ? HotSpotRadius : SpawnRadius;
+		const FVector2D Offset = FVector2D(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)) * Radius;
+		const FVector Location = Origin + FVector(Offset.X, Offset.Y, 0.f);
+
+		ALyraRepGraphBenchmarkActor* Actor = World->SpawnActor<ALyraRepGraphBenchmarkActor>(Location, FRotator::ZeroRotator, SpawnParams);
+		if (!Actor)
+		{
+			continue;
+		}
+
+		if (Random.FRand() < MovingFraction)
+		{
+			Actor->StartMoving(Random.FRandRange(200.f, 2000.f), Random.FRandRange(0.2f, 1.f));
+		}
+
+		SpawnedActors.Add(Actor);
+	}
+
+	UE_LOG(LogLyraRepGraph, Display, TEXT("%s spawned %d replication benchmark actors (%d in the hot spot)"), *GetName(), ActorCount, HotSpotCount);
+}
+
+void ALyraRepGraphBenchmarkSpawner::DestroyActors()
+{
+	for (ALyraRepGraphBenchmarkActor* Actor : SpawnedActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+
+	SpawnedActors.Reset();
+}
+
+// ------------------------------------------------------------------------------
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+FAutoConsoleCommandWithWorldAndArgs LyraRepGraphBenchmarkSpawnCmd(TEXT("Lyra.RepGraph.Benchmark.Spawn"), TEXT("Spawns replicated benchmark actors at the world origin. Usage: Lyra.RepGraph.Benchmark.Spawn <Count> <Radius>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World || World->GetNetMode() == NM_Client)
+		{
+			return;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.bDeferConstruction = true;
+
+		if (ALyraRepGraphBenchmarkSpawner* Spawner = World->SpawnActor<ALyraRepGraphBenchmarkSpawner>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams))
+		{
+			if (Args.Num() > 0)
+			{
+				LexFromString(Spawner->ActorCount, *Args[0]);
+			}
+
+			if (Args.Num() > 1)
+			{
+				LexFromString(Spawner->SpawnRadius, *Args[1]);
+			}
+
+			Spawner->FinishSpawning(FTransform::Identity);
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs LyraRepGraphBenchmarkClearCmd(TEXT("Lyra.RepGraph.Benchmark.Clear"), TEXT("Destroys every benchmark spawner and the actors it spawned"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		for (TActorIterator<ALyraRepGraphBenchmarkSpawner> It(World); It; ++It)
+		{
+			It->Destroy();
+		}
+	})
+);
+
+#endif
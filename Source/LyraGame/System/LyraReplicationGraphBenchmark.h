@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+
+#include "LyraReplicationGraphBenchmark.generated.h"
+
+/** A replicated actor with no gameplay, used to load the replication graph. Moving ones circle around where they were spawned. */
+UCLASS(NotBlueprintable)
+class ALyraRepGraphBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ALyraRepGraphBenchmarkActor();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void StartMoving(float InRadius, float InAngularSpeed);
+
+private:
+	FVector Center = FVector::ZeroVector;
+	float Radius = 0.f;
+	float AngularSpeed = 0.f;
+	float Angle = 0.f;
+};
+
+/**
+ * Spawns ActorCount replicated ALyraRepGraphBenchmarkActors on the server when play begins. A benchmark map is an otherwise empty
+ * level with one of these in it: connect clients and read the replication cost with Lyra.RepGraph.Benchmark.Report.
+ * Part of the actors are packed into a hot spot at the spawner so the adaptive spatial grid has a town to deal with.
+ */
+UCLASS()
+class ALyraRepGraphBenchmarkSpawner : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ALyraRepGraphBenchmarkSpawner();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Benchmark")
+	void SpawnActors();
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Benchmark")
+	void DestroyActors();
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (ClampMin = 0))
+	int32 ActorCount = 5000;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (ForceUnits = cm))
+	float SpawnRadius = 200000.f;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (ClampMin = 0, ClampMax = 1))
+	float HotSpotFraction = 0.3f;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (ForceUnits = cm))
+	float HotSpotRadius = 10000.f;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark", meta = (ClampMin = 0, ClampMax = 1))
+	float MovingFraction = 0.5f;
+
+	UPROPERTY(EditAnywhere, Category = "Benchmark")
+	bool bSpawnOnBeginPlay = true;
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ALyraRepGraphBenchmarkActor>> SpawnedActors;
+};
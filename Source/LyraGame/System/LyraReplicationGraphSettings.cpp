@@ -8,4 +8,21 @@ ULyraReplicationGraphSettings::ULyraReplicationGraphSettings()
 {
 	CategoryName = TEXT("Game");
 	DefaultReplicationGraphClass = ULyraReplicationGraph::StaticClass();
+
+	// OWS zones are large open worlds. These only change cull distances and stat tracking, and are replaced entirely by any ClassSettings in the config.
+	FRepGraphActorClassSettings OWSCharacterSettings;
+	OWSCharacterSettings.ActorClass = FSoftClassPath(TEXT("/Script/OWSPlugin.OWSCharacter"));
+	OWSCharacterSettings.bAddClassRepInfoToMap = false;
+	OWSCharacterSettings.bOverrideCullDistance = true;
+	OWSCharacterSettings.CullDistance = 20000.f;
+	OWSCharacterSettings.bTrackReplicationCost = true;
+	ClassSettings.Add(OWSCharacterSettings);
+
+	FRepGraphActorClassSettings OWSProjectileSettings;
+	OWSProjectileSettings.ActorClass = FSoftClassPath(TEXT("/Script/OWSPlugin.OWSAdvancedProjectile"));
+	OWSProjectileSettings.bAddClassRepInfoToMap = false;
+	OWSProjectileSettings.bOverrideCullDistance = true;
+	OWSProjectileSettings.CullDistance = 10000.f;
+	OWSProjectileSettings.bTrackReplicationCost = true;
+	ClassSettings.Add(OWSProjectileSettings);
 }
\ No newline at end of file
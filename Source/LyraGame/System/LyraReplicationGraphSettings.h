@@ -53,6 +53,27 @@ public:
 	UPROPERTY(EditAnywhere, Category=SpatialGrid, meta = (ConsoleVariable = "Lyra.RepGraph.DisableSpatialRebuilds"))
 	bool bDisableSpatialRebuilds = true;
 
+	// Re-partition the spatial grid as players gather and spread out. SpatialGridCellSize and SpatialBias are then only the initial layout. Off by default so existing maps keep their CellSize.
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ConsoleVariable = "Lyra.RepGraph.Adaptive.Enable"))
+	bool bEnableAdaptiveSpatialGrid = false;
+
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ForceUnits=cm, ConsoleVariable = "Lyra.RepGraph.Adaptive.MinCellSize"))
+	float AdaptiveMinCellSize = 5000.0f;
+
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ForceUnits=cm, ConsoleVariable = "Lyra.RepGraph.Adaptive.MaxCellSize"))
+	float AdaptiveMaxCellSize = 40000.0f;
+
+	// Cells are sized so the most crowded one holds about this many players
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ConsoleVariable = "Lyra.RepGraph.Adaptive.TargetViewersPerCell"))
+	int32 AdaptiveTargetViewersPerCell = 8;
+
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ForceUnits=s, ConsoleVariable = "Lyra.RepGraph.Adaptive.Interval"))
+	float AdaptiveInterval = 10.0f;
+
+	// The grid is only rebuilt when the wanted cell size differs from the current one by more than this fraction
+	UPROPERTY(EditAnywhere, Category=AdaptiveSpatialGrid, meta = (ConsoleVariable = "Lyra.RepGraph.Adaptive.Hysteresis"))
+	float AdaptiveHysteresis = 0.25f;
+
 	// How many buckets to spread dynamic, spatialized actors across.
 	// High number = more buckets = smaller effective replication frequency.
 	// This happens before individual actors do their own NetUpdateFrequency check.
@@ -47,6 +47,18 @@ struct FRepGraphActorClassSettings
 	UPROPERTY(EditAnywhere, meta = (EditCondition = "bAddToRPC_Multicast_OpenChannelForClassMap"))
 	bool bRPC_Multicast_OpenChannelForClass = true;
 
+	// Should spatialized actors of this Class use CullDistance instead of the Class' NetCullDistanceSquared
+	UPROPERTY(EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideCullDistance = false;
+
+	// Replication cull distance for this Class and its children. Also overrides the cull distance ACharacter subclasses otherwise inherit from ALyraCharacter
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bOverrideCullDistance", ForceUnits = cm))
+	float CullDistance = 15000.f;
+
+	// Track replication time and bits of this Class and its children as their own stat in csvprofile captures
+	UPROPERTY(EditAnywhere)
+	bool bTrackReplicationCost = false;
+
 	UClass* GetStaticActorClass() const
 	{
 		UClass* StaticActorClass = nullptr;